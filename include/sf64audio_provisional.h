@@ -562,6 +562,7 @@ typedef struct {
     /* 0x18 */ s16 curVolRLeft;
     /* 0x1A */ s16 curVolRRight;
     /* 0x1C */ char unk_14[0xC];
+    f32 lfeFilterState; // @port: subwoofer low-pass state, kept per note so the mix does not depend on the threads
 } NoteSynthesisState; // size = 0x1E
 
 typedef struct {
@@ -1071,7 +1072,6 @@ void* AudioHeap_AllocPersistentSampleCache(s32 size, s32 fontId, uintptr_t sampl
 void AudioLoad_DecreaseSampleDmaTtls(void);
 void AudioLoad_ProcessLoads(s32 resetStatus);
 void AudioLoad_SyncInitSeqPlayer(s32 playerIdx, s32 seqId, s32 arg2);
-void* AudioLoad_DmaSampleData(uintptr_t devAddr, u32 size, u32 arg2, u8* dmaIndexRef, s32 medium);
 void AudioLoad_InitSampleDmaBuffers(s32 numNotes);
 void AudioLoad_SyncLoadSeqParts(s32 seqId, s32 flags);
 s32 AudioLoad_SyncLoadInstrument(s32 fontId, s32 instId, s32 drumId);
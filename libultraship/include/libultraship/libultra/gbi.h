@@ -193,6 +193,7 @@
 #define G_LOAD_SHADER 0x43
 #define G_SETTILESIZE_INTERP 0x44
 #define G_SETTARGETINTERPINDEX 0x45
+#define G_STARFIELD 0x46
 
 /*
  * The following commands are the "generated" RDP commands; the user
@@ -1037,6 +1038,16 @@ typedef union Vtx {
     long long int force_structure_alignment;
 } Vtx;
 
+/*
+ * Starfield point, drawn as a 1x1 primitive colored quad (see gSPStarfield)
+ */
+typedef struct {
+    float x, y;          /* position */
+    float prevX, prevY;  /* position on the previous game frame */
+    unsigned char cn[4]; /* color & alpha */
+    int interpolate;     /* lerp from prevX, prevY on interpolated frames */
+} Gstar;
+
 /*
  * Sprite structure
  */
@@ -2801,6 +2812,8 @@ typedef union Gfx {
 #define gSPLoadShader(pkt, shader, type) gDma1p(pkt, G_LOAD_SHADER, shader, 0, type)
 #define gSPUnloadShader(pkt) gDma1p(pkt, G_LOAD_SHADER, 0, 0, 0)
 
+#define gSPStarfield(pkt, stars, count) gDma1p(pkt, G_STARFIELD, stars, count, 0)
+
 #define gSPExtraGeometryMode(pkt, c, s)                                                 \
     _DW({                                                                               \
         Gfx* _g = (Gfx*)(pkt);                                                          \
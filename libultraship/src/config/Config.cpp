@@ -318,6 +318,9 @@ void Config::SetWindowBackend(WindowBackend backend) {
         case WindowBackend::FAST3D_SDL_METAL:
             SetString("Window.Backend.Name", "Metal");
             break;
+        case WindowBackend::FAST3D_NULL:
+            SetString("Window.Backend.Name", "Headless");
+            break;
         default:
             SetString("Window.Backend.Name", "");
     }
@@ -11,6 +11,7 @@
 #include "graphic/Fast3D/backends/gfx_metal.h"
 #include "graphic/Fast3D/backends/gfx_direct3d_common.h"
 #include "graphic/Fast3D/backends/gfx_direct3d11.h"
+#include "graphic/Fast3D/backends/gfx_null.h"
 #include "backends/gfx_window_manager_api.h"
 
 #include <fstream>
@@ -115,8 +116,21 @@ uint16_t Fast3dWindow::GetPixelDepth(float x, float y) {
     return mInterpreter->GetPixelDepth(x, y);
 }
 
+void Fast3dWindow::SetHeadless(bool headless) {
+    mHeadless = headless;
+}
+
+bool Fast3dWindow::IsHeadless() const {
+    return mHeadless;
+}
+
 void Fast3dWindow::InitWindowManager() {
-    SetWindowBackend(Ship::Context::GetInstance()->GetConfig()->GetWindowBackend());
+    if (mHeadless) {
+        // Not an available backend, so it never shows up in the menus or ends up in the config
+        SetWindowBackend(Ship::WindowBackend::FAST3D_NULL, false);
+    } else {
+        SetWindowBackend(Ship::Context::GetInstance()->GetConfig()->GetWindowBackend());
+    }
 
     switch (GetWindowBackend()) {
 #ifdef ENABLE_DX11
@@ -137,6 +151,10 @@ void Fast3dWindow::InitWindowManager() {
             mWindowManagerApi = new GfxWindowBackendSDL2();
             break;
 #endif
+        case Ship::WindowBackend::FAST3D_NULL:
+            mRenderingApi = new GfxRenderingAPINull();
+            mWindowManagerApi = new GfxWindowBackendNull();
+            break;
         default:
             SPDLOG_ERROR("Could not load the correct rendering backend");
             break;
@@ -171,7 +189,7 @@ bool Fast3dWindow::IsFrameReady() {
     return mWindowManagerApi->IsFrameReady();
 }
 
-bool Fast3dWindow::DrawAndRunGraphicsCommands(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtxReplacements) {
+bool Fast3dWindow::DrawAndRunGraphicsCommands(Gfx* commands, const MtxReplacementMap& mtxReplacements) {
     std::shared_ptr<Window> wnd = Ship::Context::GetInstance()->GetWindow();
 
     // Skip dropped frames
@@ -48,6 +48,9 @@ class Fast3dWindow : public Ship::Window {
     const char* GetKeyName(int32_t scancode) override;
 
     void InitWindowManager();
+    // Runs without a window or GPU for this session only, has to be set before Init
+    void SetHeadless(bool headless);
+    bool IsHeadless() const;
     void SetTargetFps(int32_t fps);
     void SetMaximumFrameLatency(int32_t latency);
     void GetPixelDepthPrepare(float x, float y);
@@ -55,7 +58,7 @@ class Fast3dWindow : public Ship::Window {
     void SetTextureFilter(FilteringMode filteringMode);
     void SetRendererUCode(UcodeHandlers ucode);
     void EnableSRGBMode();
-    bool DrawAndRunGraphicsCommands(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtxReplacements);
+    bool DrawAndRunGraphicsCommands(Gfx* commands, const MtxReplacementMap& mtxReplacements);
 
     std::weak_ptr<Interpreter> GetInterpreterWeak() const;
 
@@ -71,5 +74,6 @@ class Fast3dWindow : public Ship::Window {
     GfxRenderingAPI* mRenderingApi;
     GfxWindowBackend* mWindowManagerApi;
     std::shared_ptr<Interpreter> mInterpreter = nullptr;
+    bool mHeadless = false;
 };
 } // namespace Fast
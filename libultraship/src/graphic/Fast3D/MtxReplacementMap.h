@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "libultraship/libultra/types.h"
+
+namespace Fast {
+
+// Mtx* -> MtxF table used to swap in interpolated matrices. Entries are stored densely in insertion order and
+// looked up through an open addressing index. clear() keeps both allocations, so a table that is reused between
+// frames stops allocating once it has grown to the number of matrices in a frame.
+class MtxReplacementMap {
+  public:
+    struct Entry {
+        Mtx* first;
+        MtxF second;
+    };
+
+    const Entry* find(const Mtx* key) const {
+        if (mEntries.empty()) {
+            return end();
+        }
+
+        size_t mask = mSlots.size() - 1;
+        for (size_t slot = Hash(key) & mask;; slot = (slot + 1) & mask) {
+            uint32_t index = mSlots[slot];
+            if (index == 0) {
+                return end();
+            }
+            if (mEntries[index - 1].first == key) {
+                return &mEntries[index - 1];
+            }
+        }
+    }
+
+    const Entry* end() const {
+        return nullptr;
+    }
+
+    MtxF& operator[](Mtx* key) {
+        if ((mEntries.size() + 1) * 2 > mSlots.size()) {
+            Grow();
+        }
+
+        size_t mask = mSlots.size() - 1;
+        size_t slot = Hash(key) & mask;
+        for (; mSlots[slot] != 0; slot = (slot + 1) & mask) {
+            if (mEntries[mSlots[slot] - 1].first == key) {
+                return mEntries[mSlots[slot] - 1].second;
+            }
+        }
+
+        mEntries.push_back({ key, {} });
+        mSlots[slot] = (uint32_t)mEntries.size();
+        return mEntries.back().second;
+    }
+
+    void clear() {
+        if (!mEntries.empty()) {
+            mEntries.clear();
+            std::fill(mSlots.begin(), mSlots.end(), 0);
+        }
+    }
+
+    size_t size() const {
+        return mEntries.size();
+    }
+
+    bool empty() const {
+        return mEntries.empty();
+    }
+
+  private:
+    static size_t Hash(const Mtx* key) {
+        return (size_t)(((uintptr_t)key >> 4) * 0x9E3779B97F4A7C15ull >> 16);
+    }
+
+    void Grow() {
+        mSlots.assign(std::max<size_t>(mSlots.size() * 2, 256), 0);
+
+        size_t mask = mSlots.size() - 1;
+        for (size_t i = 0; i < mEntries.size(); i++) {
+            size_t slot = Hash(mEntries[i].first) & mask;
+            while (mSlots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            mSlots[slot] = (uint32_t)(i + 1);
+        }
+    }
+
+    std::vector<Entry> mEntries;
+    std::vector<uint32_t> mSlots;
+};
+
+} // namespace Fast
@@ -0,0 +1,141 @@
+#include "VertexTransform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VERTEX_TRANSFORM_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include "sse2neon.h"
+#define VERTEX_TRANSFORM_SSE2
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef VERTEX_TRANSFORM_SSE2
+
+#include "VertexTransformKernel.h"
+
+namespace {
+
+struct Sse2 {
+    typedef __m128 F;
+    typedef __m128i I;
+    static constexpr size_t kLanes = 4;
+
+    static F Set1(float v) {
+        return _mm_set1_ps(v);
+    }
+    static I Set1I(int32_t v) {
+        return _mm_set1_epi32(v);
+    }
+    static F Load(const float* p) {
+        return _mm_loadu_ps(p);
+    }
+    static void Store(float* p, F v) {
+        _mm_storeu_ps(p, v);
+    }
+    static void StoreI(int32_t* p, I v) {
+        _mm_storeu_si128((__m128i*)p, v);
+    }
+    static F Add(F a, F b) {
+        return _mm_add_ps(a, b);
+    }
+    static F Mul(F a, F b) {
+        return _mm_mul_ps(a, b);
+    }
+    static F Div(F a, F b) {
+        return _mm_div_ps(a, b);
+    }
+    static F Min(F a, F b) {
+        return _mm_min_ps(a, b);
+    }
+    static F Max(F a, F b) {
+        return _mm_max_ps(a, b);
+    }
+    static F Neg(F v) {
+        return _mm_xor_ps(v, _mm_set1_ps(-0.0f));
+    }
+    static F Abs(F v) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+    static F CmpLt(F a, F b) {
+        return _mm_cmplt_ps(a, b);
+    }
+    static F CmpGt(F a, F b) {
+        return _mm_cmpgt_ps(a, b);
+    }
+    static F Select(F mask, F a, F b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    static I SelectI(F mask, I a, I b) {
+        const I m = _mm_castps_si128(mask);
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+    static I MaskBits(F mask, int32_t bits) {
+        return _mm_and_si128(_mm_castps_si128(mask), _mm_set1_epi32(bits));
+    }
+    static I Or(I a, I b) {
+        return _mm_or_si128(a, b);
+    }
+    static F ToFloat(I v) {
+        return _mm_cvtepi32_ps(v);
+    }
+    static I Truncate(F v) {
+        return _mm_cvttps_epi32(v);
+    }
+};
+
+void TransformVerticesSse2(const Fast::VertexTransformParams& params, Fast::VertexSoA& soa, size_t count) {
+    TransformVertices<Sse2>(params, soa, count);
+}
+
+} // namespace
+
+#endif
+
+namespace Fast {
+
+static bool CpuSupportsAvx2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // The OS has to save the YMM registers as well
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+VertexTransformFn GetVertexTransformSse2() {
+#ifdef VERTEX_TRANSFORM_SSE2
+    return TransformVerticesSse2;
+#else
+    return nullptr;
+#endif
+}
+
+VertexTransformFn GetVertexTransformFn() {
+    static const VertexTransformFn sTransform = []() -> VertexTransformFn {
+        if (CpuSupportsAvx2() && GetVertexTransformAvx2() != nullptr) {
+            return GetVertexTransformAvx2();
+        }
+        return GetVertexTransformSse2();
+    }();
+    return sTransform;
+}
+
+} // namespace Fast
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Fast {
+
+// Vertices are staged as structure of arrays so several of them can be transformed per instruction. The capacity
+// covers a whole vertex load and is a multiple of every vector width in use.
+constexpr size_t VERTEX_SOA_CAPACITY = 64;
+constexpr size_t VERTEX_SOA_MAX_LIGHTS = 32;
+
+struct VertexSoA {
+    // Inputs
+    alignas(32) float obX[VERTEX_SOA_CAPACITY];
+    alignas(32) float obY[VERTEX_SOA_CAPACITY];
+    alignas(32) float obZ[VERTEX_SOA_CAPACITY];
+    alignas(32) float nX[VERTEX_SOA_CAPACITY];
+    alignas(32) float nY[VERTEX_SOA_CAPACITY];
+    alignas(32) float nZ[VERTEX_SOA_CAPACITY];
+
+    // Outputs
+    alignas(32) float x[VERTEX_SOA_CAPACITY];
+    alignas(32) float y[VERTEX_SOA_CAPACITY];
+    alignas(32) float z[VERTEX_SOA_CAPACITY];
+    alignas(32) float w[VERTEX_SOA_CAPACITY];
+    alignas(32) float fog[VERTEX_SOA_CAPACITY];
+    alignas(32) int32_t r[VERTEX_SOA_CAPACITY];
+    alignas(32) int32_t g[VERTEX_SOA_CAPACITY];
+    alignas(32) int32_t b[VERTEX_SOA_CAPACITY];
+    alignas(32) int32_t clipRej[VERTEX_SOA_CAPACITY];
+};
+
+// RSP state the vectorized transform depends on, captured once per vertex load
+struct VertexTransformParams {
+    float mpMatrix[4][4];
+    bool adjustAspect;
+    float aspectRatio; // Width / height of the current target, used when adjustAspect is set
+    bool fog;
+    float fogMul, fogOffset;
+    bool lighting;                                  // Directional lights only, positional lights use the scalar path
+    int numLights;                                  // Without the ambient light
+    float lightCoeffs[VERTEX_SOA_MAX_LIGHTS][3];    // Normalized light directions
+    float lightColors[VERTEX_SOA_MAX_LIGHTS][3];
+    int32_t ambient[3];
+};
+
+// Transforms, clip-classifies, fogs and lights count vertices of soa. Lanes past count up to the next multiple of
+// the vector width are processed as well, so they need to hold finite values.
+typedef void (*VertexTransformFn)(const VertexTransformParams& params, VertexSoA& soa, size_t count);
+
+// Picks the widest implementation the running CPU supports, nullptr if none was compiled in.
+VertexTransformFn GetVertexTransformFn();
+
+// Per instruction set entry points, nullptr when the translation unit was built without support for it.
+VertexTransformFn GetVertexTransformSse2();
+VertexTransformFn GetVertexTransformAvx2();
+
+} // namespace Fast
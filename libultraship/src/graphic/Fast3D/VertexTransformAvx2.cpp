@@ -0,0 +1,97 @@
+// Built with AVX2 enabled (see src/CMakeLists.txt) and only called after GetVertexTransformFn checked the CPU,
+// nothing outside of this file may be compiled with these flags.
+#include "VertexTransform.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+#include "VertexTransformKernel.h"
+
+namespace {
+
+struct Avx2 {
+    typedef __m256 F;
+    typedef __m256i I;
+    static constexpr size_t kLanes = 8;
+
+    static F Set1(float v) {
+        return _mm256_set1_ps(v);
+    }
+    static I Set1I(int32_t v) {
+        return _mm256_set1_epi32(v);
+    }
+    static F Load(const float* p) {
+        return _mm256_loadu_ps(p);
+    }
+    static void Store(float* p, F v) {
+        _mm256_storeu_ps(p, v);
+    }
+    static void StoreI(int32_t* p, I v) {
+        _mm256_storeu_si256((__m256i*)p, v);
+    }
+    static F Add(F a, F b) {
+        return _mm256_add_ps(a, b);
+    }
+    static F Mul(F a, F b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static F Div(F a, F b) {
+        return _mm256_div_ps(a, b);
+    }
+    static F Min(F a, F b) {
+        return _mm256_min_ps(a, b);
+    }
+    static F Max(F a, F b) {
+        return _mm256_max_ps(a, b);
+    }
+    static F Neg(F v) {
+        return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f));
+    }
+    static F Abs(F v) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    }
+    static F CmpLt(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static F CmpGt(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+    static F Select(F mask, F a, F b) {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+    static I SelectI(F mask, I a, I b) {
+        return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), mask));
+    }
+    static I MaskBits(F mask, int32_t bits) {
+        return _mm256_and_si256(_mm256_castps_si256(mask), _mm256_set1_epi32(bits));
+    }
+    static I Or(I a, I b) {
+        return _mm256_or_si256(a, b);
+    }
+    static F ToFloat(I v) {
+        return _mm256_cvtepi32_ps(v);
+    }
+    static I Truncate(F v) {
+        return _mm256_cvttps_epi32(v);
+    }
+};
+
+void TransformVerticesAvx2(const Fast::VertexTransformParams& params, Fast::VertexSoA& soa, size_t count) {
+    TransformVertices<Avx2>(params, soa, count);
+}
+
+} // namespace
+
+#endif
+
+namespace Fast {
+
+VertexTransformFn GetVertexTransformAvx2() {
+#ifdef __AVX2__
+    return TransformVerticesAvx2;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace Fast
@@ -0,0 +1,103 @@
+#pragma once
+
+// Shared body of the vectorized vertex transform. Every instruction set gets its own translation unit, built with
+// the matching compiler flags, which provides a lane type V and instantiates TransformVertices with it. Everything
+// here has internal linkage so instantiations built for different instruction sets are never merged by the linker.
+//
+// The operations mirror Interpreter::GfxSpVertex one by one (same order, no fused multiply-add) so the results
+// match the scalar path.
+
+#include "VertexTransform.h"
+
+namespace {
+
+template <typename V> void TransformVertices(const Fast::VertexTransformParams& p, Fast::VertexSoA& s, size_t count) {
+    typedef typename V::F F;
+    typedef typename V::I I;
+
+    const F m00 = V::Set1(p.mpMatrix[0][0]), m01 = V::Set1(p.mpMatrix[0][1]), m02 = V::Set1(p.mpMatrix[0][2]),
+            m03 = V::Set1(p.mpMatrix[0][3]);
+    const F m10 = V::Set1(p.mpMatrix[1][0]), m11 = V::Set1(p.mpMatrix[1][1]), m12 = V::Set1(p.mpMatrix[1][2]),
+            m13 = V::Set1(p.mpMatrix[1][3]);
+    const F m20 = V::Set1(p.mpMatrix[2][0]), m21 = V::Set1(p.mpMatrix[2][1]), m22 = V::Set1(p.mpMatrix[2][2]),
+            m23 = V::Set1(p.mpMatrix[2][3]);
+    const F m30 = V::Set1(p.mpMatrix[3][0]), m31 = V::Set1(p.mpMatrix[3][1]), m32 = V::Set1(p.mpMatrix[3][2]),
+            m33 = V::Set1(p.mpMatrix[3][3]);
+
+    const F zero = V::Set1(0.0f);
+    const F aspectMul = V::Set1(4.0f / 3.0f);
+    const F aspectRatio = V::Set1(p.aspectRatio);
+    const F fogMul = V::Set1(p.fogMul);
+    const F fogOffset = V::Set1(p.fogOffset);
+
+    for (size_t i = 0; i < count; i += V::kLanes) {
+        const F ox = V::Load(&s.obX[i]);
+        const F oy = V::Load(&s.obY[i]);
+        const F oz = V::Load(&s.obZ[i]);
+
+        F x = V::Add(V::Add(V::Add(V::Mul(ox, m00), V::Mul(oy, m10)), V::Mul(oz, m20)), m30);
+        const F y = V::Add(V::Add(V::Add(V::Mul(ox, m01), V::Mul(oy, m11)), V::Mul(oz, m21)), m31);
+        const F z = V::Add(V::Add(V::Add(V::Mul(ox, m02), V::Mul(oy, m12)), V::Mul(oz, m22)), m32);
+        const F w = V::Add(V::Add(V::Add(V::Mul(ox, m03), V::Mul(oy, m13)), V::Mul(oz, m23)), m33);
+
+        if (p.adjustAspect) {
+            x = V::Div(V::Mul(x, aspectMul), aspectRatio);
+        }
+
+        // Trivial clip rejection, CLIP_NEAR is not used
+        const F negW = V::Neg(w);
+        I clip = V::MaskBits(V::CmpLt(x, negW), 1);
+        clip = V::Or(clip, V::MaskBits(V::CmpGt(x, w), 2));
+        clip = V::Or(clip, V::MaskBits(V::CmpLt(y, negW), 4));
+        clip = V::Or(clip, V::MaskBits(V::CmpGt(y, w), 8));
+        clip = V::Or(clip, V::MaskBits(V::CmpGt(z, w), 32));
+
+        V::Store(&s.x[i], x);
+        V::Store(&s.y[i], y);
+        V::Store(&s.z[i], z);
+        V::Store(&s.w[i], w);
+        V::StoreI(&s.clipRej[i], clip);
+
+        if (p.fog) {
+            F fw = V::Select(V::CmpLt(V::Abs(w), V::Set1(0.001f)), V::Set1(0.001f), w);
+            F winv = V::Div(V::Set1(1.0f), fw);
+            winv = V::Select(V::CmpLt(winv, zero), V::Set1(32767.0f), winv);
+
+            F fogZ = V::Add(V::Mul(V::Mul(z, winv), fogMul), fogOffset);
+            fogZ = V::Min(V::Set1(255.0f), V::Max(zero, fogZ));
+            V::Store(&s.fog[i], fogZ);
+        }
+
+        if (p.lighting) {
+            const F nx = V::Load(&s.nX[i]);
+            const F ny = V::Load(&s.nY[i]);
+            const F nz = V::Load(&s.nZ[i]);
+            const F normalScale = V::Set1(127.0f);
+
+            I r = V::Set1I(p.ambient[0]);
+            I g = V::Set1I(p.ambient[1]);
+            I b = V::Set1I(p.ambient[2]);
+
+            for (int l = 0; l < p.numLights; l++) {
+                F intensity = V::Add(V::Add(V::Mul(nx, V::Set1(p.lightCoeffs[l][0])),
+                                            V::Mul(ny, V::Set1(p.lightCoeffs[l][1]))),
+                                     V::Mul(nz, V::Set1(p.lightCoeffs[l][2])));
+                intensity = V::Div(intensity, normalScale);
+
+                const F lit = V::CmpGt(intensity, zero);
+                const F sumR = V::Add(V::ToFloat(r), V::Mul(intensity, V::Set1(p.lightColors[l][0])));
+                const F sumG = V::Add(V::ToFloat(g), V::Mul(intensity, V::Set1(p.lightColors[l][1])));
+                const F sumB = V::Add(V::ToFloat(b), V::Mul(intensity, V::Set1(p.lightColors[l][2])));
+                r = V::SelectI(lit, V::Truncate(sumR), r);
+                g = V::SelectI(lit, V::Truncate(sumG), g);
+                b = V::SelectI(lit, V::Truncate(sumB), b);
+            }
+
+            V::StoreI(&s.r[i], r);
+            V::StoreI(&s.g[i], g);
+            V::StoreI(&s.b[i], b);
+        }
+    }
+}
+
+} // namespace
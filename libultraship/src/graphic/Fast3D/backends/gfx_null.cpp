@@ -0,0 +1,285 @@
+#include "gfx_null.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "Context.h"
+#include "window/Window.h"
+#include "../interpreter.h"
+
+namespace Fast {
+
+const char* GfxRenderingAPINull::GetName() {
+    return "Headless";
+}
+
+int GfxRenderingAPINull::GetMaxTextureSize() {
+    return 8192;
+}
+
+GfxClipParameters GfxRenderingAPINull::GetClipParameters() {
+    return { false, false };
+}
+
+void GfxRenderingAPINull::UnloadShader(ShaderProgram* oldPrg) {
+}
+
+void GfxRenderingAPINull::LoadShader(ShaderProgram* newPrg) {
+}
+
+ShaderProgram* GfxRenderingAPINull::CreateAndLoadNewShader(uint64_t shaderId0, uint32_t shaderId1) {
+    // The interpreter still needs the number of inputs and the used textures to fill the vertex buffer
+    CCFeatures ccFeatures;
+    gfx_cc_get_features(shaderId0, shaderId1, &ccFeatures);
+
+    ShaderProgramNull* prg = &mShaderProgramPool[std::make_pair(shaderId0, shaderId1)];
+    prg->numInputs = ccFeatures.numInputs;
+    prg->usedTextures[0] = ccFeatures.usedTextures[0];
+    prg->usedTextures[1] = ccFeatures.usedTextures[1];
+    return reinterpret_cast<ShaderProgram*>(prg);
+}
+
+ShaderProgram* GfxRenderingAPINull::LookupShader(uint64_t shaderId0, uint32_t shaderId1) {
+    auto it = mShaderProgramPool.find(std::make_pair(shaderId0, shaderId1));
+    return it == mShaderProgramPool.end() ? nullptr : reinterpret_cast<ShaderProgram*>(&it->second);
+}
+
+void GfxRenderingAPINull::ShaderGetInfo(ShaderProgram* prg, uint8_t* numInputs, bool usedTextures[2]) {
+    ShaderProgramNull* p = reinterpret_cast<ShaderProgramNull*>(prg);
+    *numInputs = p->numInputs;
+    usedTextures[0] = p->usedTextures[0];
+    usedTextures[1] = p->usedTextures[1];
+}
+
+uint32_t GfxRenderingAPINull::NewTexture() {
+    return mNextTextureId++;
+}
+
+void GfxRenderingAPINull::SelectTexture(int tile, uint32_t textureId) {
+}
+
+void GfxRenderingAPINull::UploadTexture(const uint8_t* rgba32Buf, uint32_t width, uint32_t height) {
+}
+
+void GfxRenderingAPINull::SetSamplerParameters(int sampler, bool linear_filter, uint32_t cms, uint32_t cmt) {
+}
+
+void GfxRenderingAPINull::SetDepthTestAndMask(bool depth_test, bool z_upd) {
+}
+
+void GfxRenderingAPINull::SetZmodeDecal(bool decal) {
+}
+
+void GfxRenderingAPINull::SetViewport(int x, int y, int width, int height) {
+}
+
+void GfxRenderingAPINull::SetScissor(int x, int y, int width, int height) {
+}
+
+void GfxRenderingAPINull::SetUseAlpha(bool useAlpha) {
+}
+
+void GfxRenderingAPINull::DrawTriangles(float buf_vbo[], size_t buf_vbo_len, size_t buf_vbo_num_tris) {
+}
+
+void GfxRenderingAPINull::Init() {
+}
+
+void GfxRenderingAPINull::OnResize() {
+}
+
+void GfxRenderingAPINull::StartFrame() {
+}
+
+void GfxRenderingAPINull::EndFrame() {
+}
+
+void GfxRenderingAPINull::FinishRender() {
+}
+
+int GfxRenderingAPINull::CreateFramebuffer() {
+    return mFramebufferCount++;
+}
+
+void GfxRenderingAPINull::UpdateFramebufferParameters(int fb_id, uint32_t width, uint32_t height,
+                                                      uint32_t msaa_level, bool opengl_invertY, bool render_target,
+                                                      bool has_depth_buffer, bool can_extract_depth) {
+}
+
+void GfxRenderingAPINull::StartDrawToFramebuffer(int fbId, float noiseScale) {
+}
+
+void GfxRenderingAPINull::CopyFramebuffer(int fbDstId, int fbSrcId, int srcX0, int srcY0, int srcX1, int srcY1,
+                                          int dstX0, int dstY0, int dstX1, int dstY1) {
+}
+
+void GfxRenderingAPINull::ClearFramebuffer(bool color, bool depth) {
+}
+
+void GfxRenderingAPINull::ReadFramebufferToCPU(int fbId, uint32_t width, uint32_t height, uint16_t* rgba16Buf) {
+    memset(rgba16Buf, 0, width * height * sizeof(uint16_t));
+}
+
+void GfxRenderingAPINull::ResolveMSAAColorBuffer(int fbIdTarger, int fbIdSrc) {
+}
+
+std::unordered_map<std::pair<float, float>, uint16_t, hash_pair_ff>
+GfxRenderingAPINull::GetPixelDepth(int fb_id, const std::set<std::pair<float, float>>& coordinates) {
+    std::unordered_map<std::pair<float, float>, uint16_t, hash_pair_ff> res;
+
+    for (const auto& coord : coordinates) {
+        res.emplace(coord, 0);
+    }
+    return res;
+}
+
+void* GfxRenderingAPINull::GetFramebufferTextureId(int fbId) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(fbId));
+}
+
+void GfxRenderingAPINull::SelectTextureFb(int fbId) {
+}
+
+void GfxRenderingAPINull::DeleteTexture(uint32_t texId) {
+}
+
+void GfxRenderingAPINull::SetTextureFilter(FilteringMode mode) {
+    mCurrentFilterMode = mode;
+}
+
+FilteringMode GfxRenderingAPINull::GetTextureFilter() {
+    return mCurrentFilterMode;
+}
+
+void GfxRenderingAPINull::SetSrgbMode() {
+    mSrgbMode = true;
+}
+
+ImTextureID GfxRenderingAPINull::GetTextureById(int id) {
+    return reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(id));
+}
+
+static double GetSteadyTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void GfxWindowBackendNull::Init(const char* gameName, const char* apiName, bool startFullScreen, uint32_t width,
+                                uint32_t height, int32_t posX, int32_t posY) {
+    mWidth = width;
+    mHeight = height;
+    mFullScreen = false;
+    mStartTime = GetSteadyTime();
+
+    // ImGui still builds its frames, there is just nothing to attach it to
+    Ship::Context::GetInstance()->GetWindow()->GetGui()->Init({});
+}
+
+void GfxWindowBackendNull::Close() {
+    mIsRunning = false;
+}
+
+void GfxWindowBackendNull::SetKeyboardCallbacks(bool (*onKeyDown)(int scancode), bool (*onKeyUp)(int scancode),
+                                                void (*onAllKeysUp)()) {
+    mOnKeyDown = onKeyDown;
+    mOnKeyUp = onKeyUp;
+}
+
+void GfxWindowBackendNull::SetMouseCallbacks(bool (*onMouseButtonDown)(int btn), bool (*onMouseButtonUp)(int btn)) {
+    mOnMouseButtonDown = onMouseButtonDown;
+    mOnMouseButtonUp = onMouseButtonUp;
+}
+
+void GfxWindowBackendNull::SetFullscreenChangedCallback(void (*onFullscreenChanged)(bool is_now_fullscreen)) {
+    mOnFullscreenChanged = onFullscreenChanged;
+}
+
+void GfxWindowBackendNull::SetFullscreen(bool fullscreen) {
+}
+
+void GfxWindowBackendNull::GetActiveWindowRefreshRate(uint32_t* refreshRate) {
+    *refreshRate = 60;
+}
+
+void GfxWindowBackendNull::SetCursorVisability(bool visability) {
+}
+
+void GfxWindowBackendNull::SetMousePos(int32_t posX, int32_t posY) {
+}
+
+void GfxWindowBackendNull::GetMousePos(int32_t* x, int32_t* y) {
+    *x = 0;
+    *y = 0;
+}
+
+void GfxWindowBackendNull::GetMouseDelta(int32_t* x, int32_t* y) {
+    *x = 0;
+    *y = 0;
+}
+
+void GfxWindowBackendNull::GetMouseWheel(float* x, float* y) {
+    *x = 0.0f;
+    *y = 0.0f;
+}
+
+bool GfxWindowBackendNull::GetMouseState(uint32_t btn) {
+    return false;
+}
+
+void GfxWindowBackendNull::SetMouseCapture(bool capture) {
+}
+
+bool GfxWindowBackendNull::IsMouseCaptured() {
+    return false;
+}
+
+void GfxWindowBackendNull::GetDimensions(uint32_t* width, uint32_t* height, int32_t* posX, int32_t* posY) {
+    *width = mWidth;
+    *height = mHeight;
+    *posX = 0;
+    *posY = 0;
+}
+
+void GfxWindowBackendNull::HandleEvents() {
+}
+
+bool GfxWindowBackendNull::IsFrameReady() {
+    return true;
+}
+
+void GfxWindowBackendNull::SwapBuffersBegin() {
+}
+
+void GfxWindowBackendNull::SwapBuffersEnd() {
+}
+
+double GfxWindowBackendNull::GetTime() {
+    return GetSteadyTime() - mStartTime;
+}
+
+void GfxWindowBackendNull::SetTargetFPS(int fps) {
+    mTargetFps = fps;
+}
+
+void GfxWindowBackendNull::SetMaxFrameLatency(int latency) {
+}
+
+const char* GfxWindowBackendNull::GetKeyName(int scancode) {
+    return "";
+}
+
+bool GfxWindowBackendNull::CanDisableVsync() {
+    return true;
+}
+
+bool GfxWindowBackendNull::IsRunning() {
+    return mIsRunning;
+}
+
+void GfxWindowBackendNull::Destroy() {
+}
+
+bool GfxWindowBackendNull::IsFullscreen() {
+    return false;
+}
+
+} // namespace Fast
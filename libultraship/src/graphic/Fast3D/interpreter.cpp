@@ -447,6 +447,7 @@ void Interpreter::TextureCacheClear() {
     }
     mTextureCache.map.clear();
     mTextureCache.lru.clear();
+    mRdp->render_state_changed = true;
 }
 
 bool Interpreter::TextureCacheLookup(int i, const TextureCacheKey& key) {
@@ -490,6 +491,7 @@ bool Interpreter::TextureCacheLookup(int i, const TextureCacheKey& key) {
     mRapi->SelectTexture(i, texture_id);
     mRapi->SetSamplerParameters(i, false, 0, 0);
     *n = node;
+    mTextureUploadCount++;
     return false;
 }
 
@@ -519,6 +521,7 @@ void Interpreter::TextureCacheDelete(const uint8_t* origAddr) {
             break;
         }
     }
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::ImportTextureRgba16(int tile, bool importReplacement) {
@@ -1221,192 +1224,385 @@ void Interpreter::AdjustWidthHeightForScale(uint32_t& width, uint32_t& height, u
     }
 }
 
-void Interpreter::GfxSpVertex(size_t n_vertices, size_t dest_index, const F3DVtx* vertices) {
-    for (size_t i = 0; i < n_vertices; i++, dest_index++) {
-        const F3DVtx_t* v = &vertices[i].v;
-        const F3DVtx_tn* vn = &vertices[i].n;
-        struct LoadedVertex* d = &mRsp->loaded_vertices[dest_index];
+void Interpreter::CaptureVertexBatch(VertexBatch& batch, size_t n_vertices, size_t dest_index,
+                                     const F3DVtx* vertices) {
+    batch.vertices = vertices;
+    batch.numVertices = n_vertices;
+    batch.destIndex = dest_index;
+    batch.geometryMode = mRsp->geometry_mode;
+    batch.textureScaleS = mRsp->texture_scaling_factor.s;
+    batch.textureScaleT = mRsp->texture_scaling_factor.t;
+    batch.fogMul = mRsp->fog_mul;
+    batch.fogOffset = mRsp->fog_offset;
+    batch.aspectScale = AdjXForAspectRatio(1.0f);
+    memcpy(batch.mpMatrix, mRsp->MP_matrix, sizeof(batch.mpMatrix));
+    memcpy(batch.modelviewMatrix, mRsp->modelview_matrix_stack[mRsp->modelview_matrix_stack_size - 1],
+           sizeof(batch.modelviewMatrix));
+
+    if (mRsp->geometry_mode & G_LIGHTING) {
+        batch.numLights = mRsp->current_num_lights;
+        batch.lights.assign(mRsp->current_lights, mRsp->current_lights + mRsp->current_num_lights);
+        memcpy(batch.lightsCoeffs, mRsp->current_lights_coeffs, sizeof(batch.lightsCoeffs));
+        memcpy(batch.lookatCoeffs, mRsp->current_lookat_coeffs, sizeof(batch.lookatCoeffs));
+    } else {
+        batch.numLights = 0;
+        batch.lights.clear();
+    }
+}
 
-        if (v == nullptr) {
-            return;
+bool Interpreter::VertexBatchMatches(const VertexBatch& a, const VertexBatch& b) const {
+    if (a.vertices != b.vertices || a.numVertices != b.numVertices || a.destIndex != b.destIndex ||
+        a.geometryMode != b.geometryMode || a.textureScaleS != b.textureScaleS ||
+        a.textureScaleT != b.textureScaleT || a.fogMul != b.fogMul || a.fogOffset != b.fogOffset ||
+        a.aspectScale != b.aspectScale || a.numLights != b.numLights) {
+        return false;
+    }
+
+    if (memcmp(a.mpMatrix, b.mpMatrix, sizeof(a.mpMatrix)) != 0) {
+        return false;
+    }
+
+    // The modelview matrix is only read directly for positional lights
+    if ((a.geometryMode & G_LIGHTING_POSITIONAL) &&
+        memcmp(a.modelviewMatrix, b.modelviewMatrix, sizeof(a.modelviewMatrix)) != 0) {
+        return false;
+    }
+
+    if (a.geometryMode & G_LIGHTING) {
+        if (memcmp(a.lights.data(), b.lights.data(), a.numLights * sizeof(F3DLight)) != 0 ||
+            memcmp(a.lightsCoeffs, b.lightsCoeffs, sizeof(a.lightsCoeffs)) != 0 ||
+            memcmp(a.lookatCoeffs, b.lookatCoeffs, sizeof(a.lookatCoeffs)) != 0) {
+            return false;
         }
+    }
 
-        float x = v->ob[0] * mRsp->MP_matrix[0][0] + v->ob[1] * mRsp->MP_matrix[1][0] +
-                  v->ob[2] * mRsp->MP_matrix[2][0] + mRsp->MP_matrix[3][0];
-        float y = v->ob[0] * mRsp->MP_matrix[0][1] + v->ob[1] * mRsp->MP_matrix[1][1] +
-                  v->ob[2] * mRsp->MP_matrix[2][1] + mRsp->MP_matrix[3][1];
-        float z = v->ob[0] * mRsp->MP_matrix[0][2] + v->ob[1] * mRsp->MP_matrix[1][2] +
-                  v->ob[2] * mRsp->MP_matrix[2][2] + mRsp->MP_matrix[3][2];
-        float w = v->ob[0] * mRsp->MP_matrix[0][3] + v->ob[1] * mRsp->MP_matrix[1][3] +
-                  v->ob[2] * mRsp->MP_matrix[2][3] + mRsp->MP_matrix[3][3];
+    return true;
+}
 
-        float world_pos[3] = { 0.0 };
-        if (mRsp->geometry_mode & G_LIGHTING_POSITIONAL) {
-            float(*mtx)[4] = mRsp->modelview_matrix_stack[mRsp->modelview_matrix_stack_size - 1];
-            world_pos[0] = v->ob[0] * mtx[0][0] + v->ob[1] * mtx[1][0] + v->ob[2] * mtx[2][0] + mtx[3][0];
-            world_pos[1] = v->ob[0] * mtx[0][1] + v->ob[1] * mtx[1][1] + v->ob[2] * mtx[2][1] + mtx[3][1];
-            world_pos[2] = v->ob[0] * mtx[0][2] + v->ob[1] * mtx[1][2] + v->ob[2] * mtx[2][2] + mtx[3][2];
+void Interpreter::CalculateTexGen(const F3DVtx_tn* vn, short* u, short* v) {
+    float dotx = 0, doty = 0;
+    dotx += vn->n[0] * mRsp->current_lookat_coeffs[0][0];
+    dotx += vn->n[1] * mRsp->current_lookat_coeffs[0][1];
+    dotx += vn->n[2] * mRsp->current_lookat_coeffs[0][2];
+    doty += vn->n[0] * mRsp->current_lookat_coeffs[1][0];
+    doty += vn->n[1] * mRsp->current_lookat_coeffs[1][1];
+    doty += vn->n[2] * mRsp->current_lookat_coeffs[1][2];
+
+    dotx /= 127.0f;
+    doty /= 127.0f;
+
+    dotx = Ship::Math::clamp(dotx, -1.0f, 1.0f);
+    doty = Ship::Math::clamp(doty, -1.0f, 1.0f);
+
+    if (mRsp->geometry_mode & G_TEXTURE_GEN_LINEAR) {
+        // Not sure exactly what formula we should use to get accurate values
+        /*dotx = (2.906921f * dotx * dotx + 1.36114f) * dotx;
+        doty = (2.906921f * doty * doty + 1.36114f) * doty;
+        dotx = (dotx + 1.0f) / 4.0f;
+        doty = (doty + 1.0f) / 4.0f;*/
+        dotx = acosf(-dotx) /* M_PI */ * 0.159155f;
+        doty = acosf(-doty) /* M_PI */ * 0.159155f;
+    } else {
+        dotx = (dotx + 1.0f) / 4.0f;
+        doty = (doty + 1.0f) / 4.0f;
+    }
+
+    *u = (int32_t)(dotx * mRsp->texture_scaling_factor.s);
+    *v = (int32_t)(doty * mRsp->texture_scaling_factor.t);
+}
+
+void Interpreter::GfxSpVertex(size_t n_vertices, size_t dest_index, const F3DVtx* vertices) {
+    if (vertices == nullptr || n_vertices == 0) {
+        return;
+    }
+
+    if ((mRsp->geometry_mode & G_LIGHTING) && mRsp->lights_changed) {
+        for (int i = 0; i < mRsp->current_num_lights - 1; i++) {
+            CalculateNormalDir(&mRsp->current_lights[i].l, mRsp->current_lights_coeffs[i]);
+        }
+        /*static const Light_t lookat_x = {{0, 0, 0}, 0, {0, 0, 0}, 0, {127, 0, 0}, 0};
+        static const Light_t lookat_y = {{0, 0, 0}, 0, {0, 0, 0}, 0, {0, 127, 0}, 0};*/
+        CalculateNormalDir(&mRsp->lookat[0], mRsp->current_lookat_coeffs[0]);
+        CalculateNormalDir(&mRsp->lookat[1], mRsp->current_lookat_coeffs[1]);
+        mRsp->lights_changed = false;
+    }
+
+    // Later sub-frames walk the same display list, so vertex loads line up with the ones recorded on the first
+    // sub-frame. Only loads whose inputs changed (i.e. depend on a replaced matrix) need to be transformed again.
+    if (mVertexBatchCacheEnabled && mInterpolationIndex > 0) {
+        size_t cursor = mVertexBatchCursor++;
+        if (cursor < mVertexBatchCount) {
+            const VertexBatch& batch = mVertexBatches[cursor];
+            CaptureVertexBatch(mVertexBatchScratch, n_vertices, dest_index, vertices);
+            if (VertexBatchMatches(batch, mVertexBatchScratch)) {
+                memcpy(&mRsp->loaded_vertices[dest_index], batch.result.data(),
+                       batch.result.size() * sizeof(LoadedVertex));
+                return;
+            }
         }
+    }
 
-        x = AdjXForAspectRatio(x);
+    const size_t first_index = dest_index;
 
-        short U = v->tc[0] * mRsp->texture_scaling_factor.s >> 16;
-        short V = v->tc[1] * mRsp->texture_scaling_factor.t >> 16;
+    if (!mVertexSimdEnabled || !GfxSpVertexSimd(n_vertices, dest_index, vertices)) {
+        for (size_t i = 0; i < n_vertices; i++, dest_index++) {
+            const F3DVtx_t* v = &vertices[i].v;
+            const F3DVtx_tn* vn = &vertices[i].n;
+            struct LoadedVertex* d = &mRsp->loaded_vertices[dest_index];
 
-        if (mRsp->geometry_mode & G_LIGHTING) {
-            if (mRsp->lights_changed) {
-                for (int i = 0; i < mRsp->current_num_lights - 1; i++) {
-                    CalculateNormalDir(&mRsp->current_lights[i].l, mRsp->current_lights_coeffs[i]);
-                }
-                /*static const Light_t lookat_x = {{0, 0, 0}, 0, {0, 0, 0}, 0, {127, 0, 0}, 0};
-                static const Light_t lookat_y = {{0, 0, 0}, 0, {0, 0, 0}, 0, {0, 127, 0}, 0};*/
-                CalculateNormalDir(&mRsp->lookat[0], mRsp->current_lookat_coeffs[0]);
-                CalculateNormalDir(&mRsp->lookat[1], mRsp->current_lookat_coeffs[1]);
-                mRsp->lights_changed = false;
+            if (v == nullptr) {
+                return;
             }
 
-            int r = mRsp->current_lights[mRsp->current_num_lights - 1].l.col[0];
-            int g = mRsp->current_lights[mRsp->current_num_lights - 1].l.col[1];
-            int b = mRsp->current_lights[mRsp->current_num_lights - 1].l.col[2];
-
-            for (int i = 0; i < mRsp->current_num_lights - 1; i++) {
-                float intensity = 0;
-                if ((mRsp->geometry_mode & G_LIGHTING_POSITIONAL) && (mRsp->current_lights[i].p.unk3 != 0)) {
-                    // Calculate distance from the light to the vertex
-                    float dist_vec[3] = { mRsp->current_lights[i].p.pos[0] - world_pos[0],
-                                          mRsp->current_lights[i].p.pos[1] - world_pos[1],
-                                          mRsp->current_lights[i].p.pos[2] - world_pos[2] };
-                    float dist_sq =
-                        dist_vec[0] * dist_vec[0] + dist_vec[1] * dist_vec[1] +
-                        dist_vec[2] * dist_vec[2] * 2; // The *2 comes from GLideN64, unsure of why it does it
-                    float dist = sqrt(dist_sq);
-
-                    // Transform distance vector (which acts as a direction light vector) into model's space
-                    float light_model[3];
-                    TransposedMatrixMul(light_model, dist_vec,
-                                        mRsp->modelview_matrix_stack[mRsp->modelview_matrix_stack_size - 1]);
-
-                    // Calculate intensity for each axis using standard formula for intensity
-                    float light_intensity[3];
-                    for (int light_i = 0; light_i < 3; light_i++) {
-                        light_intensity[light_i] = 4.0f * light_model[light_i] / dist_sq;
-                        light_intensity[light_i] = std::clamp(light_intensity[light_i], -1.0f, 1.0f);
-                    }
+            float x = v->ob[0] * mRsp->MP_matrix[0][0] + v->ob[1] * mRsp->MP_matrix[1][0] +
+                      v->ob[2] * mRsp->MP_matrix[2][0] + mRsp->MP_matrix[3][0];
+            float y = v->ob[0] * mRsp->MP_matrix[0][1] + v->ob[1] * mRsp->MP_matrix[1][1] +
+                      v->ob[2] * mRsp->MP_matrix[2][1] + mRsp->MP_matrix[3][1];
+            float z = v->ob[0] * mRsp->MP_matrix[0][2] + v->ob[1] * mRsp->MP_matrix[1][2] +
+                      v->ob[2] * mRsp->MP_matrix[2][2] + mRsp->MP_matrix[3][2];
+            float w = v->ob[0] * mRsp->MP_matrix[0][3] + v->ob[1] * mRsp->MP_matrix[1][3] +
+                      v->ob[2] * mRsp->MP_matrix[2][3] + mRsp->MP_matrix[3][3];
+
+            float world_pos[3] = { 0.0 };
+            if (mRsp->geometry_mode & G_LIGHTING_POSITIONAL) {
+                float(*mtx)[4] = mRsp->modelview_matrix_stack[mRsp->modelview_matrix_stack_size - 1];
+                world_pos[0] = v->ob[0] * mtx[0][0] + v->ob[1] * mtx[1][0] + v->ob[2] * mtx[2][0] + mtx[3][0];
+                world_pos[1] = v->ob[0] * mtx[0][1] + v->ob[1] * mtx[1][1] + v->ob[2] * mtx[2][1] + mtx[3][1];
+                world_pos[2] = v->ob[0] * mtx[0][2] + v->ob[1] * mtx[1][2] + v->ob[2] * mtx[2][2] + mtx[3][2];
+            }
 
-                    // Adjust intensity based on surface normal and sum up total
-                    float total_intensity =
-                        light_intensity[0] * vn->n[0] + light_intensity[1] * vn->n[1] + light_intensity[2] * vn->n[2];
-                    total_intensity = std::clamp(total_intensity, -1.0f, 1.0f);
-
-                    // Attenuate intensity based on attenuation values.
-                    // Example formula found at https://ogldev.org/www/tutorial20/tutorial20.html
-                    // Specific coefficients for MM's microcode sourced from GLideN64
-                    // https://github.com/gonetz/GLideN64/blob/3b43a13a80dfc2eb6357673440b335e54eaa3896/src/gSP.cpp#L636
-                    float distf = floorf(dist);
-                    float attenuation = (distf * mRsp->current_lights[i].p.unk7 * 2.0f +
-                                         distf * distf * mRsp->current_lights[i].p.unkE / 8.0f) /
-                                            (float)0xFFFF +
-                                        1.0f;
-                    intensity = total_intensity / attenuation;
-                } else {
-                    intensity += vn->n[0] * mRsp->current_lights_coeffs[i][0];
-                    intensity += vn->n[1] * mRsp->current_lights_coeffs[i][1];
-                    intensity += vn->n[2] * mRsp->current_lights_coeffs[i][2];
-                    intensity /= 127.0f;
+            x = AdjXForAspectRatio(x);
+
+            short U = v->tc[0] * mRsp->texture_scaling_factor.s >> 16;
+            short V = v->tc[1] * mRsp->texture_scaling_factor.t >> 16;
+
+            if (mRsp->geometry_mode & G_LIGHTING) {
+                int r = mRsp->current_lights[mRsp->current_num_lights - 1].l.col[0];
+                int g = mRsp->current_lights[mRsp->current_num_lights - 1].l.col[1];
+                int b = mRsp->current_lights[mRsp->current_num_lights - 1].l.col[2];
+
+                for (int i = 0; i < mRsp->current_num_lights - 1; i++) {
+                    float intensity = 0;
+                    if ((mRsp->geometry_mode & G_LIGHTING_POSITIONAL) && (mRsp->current_lights[i].p.unk3 != 0)) {
+                        // Calculate distance from the light to the vertex
+                        float dist_vec[3] = { mRsp->current_lights[i].p.pos[0] - world_pos[0],
+                                              mRsp->current_lights[i].p.pos[1] - world_pos[1],
+                                              mRsp->current_lights[i].p.pos[2] - world_pos[2] };
+                        float dist_sq =
+                            dist_vec[0] * dist_vec[0] + dist_vec[1] * dist_vec[1] +
+                            dist_vec[2] * dist_vec[2] * 2; // The *2 comes from GLideN64, unsure of why it does it
+                        float dist = sqrt(dist_sq);
+
+                        // Transform distance vector (which acts as a direction light vector) into model's space
+                        float light_model[3];
+                        TransposedMatrixMul(light_model, dist_vec,
+                                            mRsp->modelview_matrix_stack[mRsp->modelview_matrix_stack_size - 1]);
+
+                        // Calculate intensity for each axis using standard formula for intensity
+                        float light_intensity[3];
+                        for (int light_i = 0; light_i < 3; light_i++) {
+                            light_intensity[light_i] = 4.0f * light_model[light_i] / dist_sq;
+                            light_intensity[light_i] = std::clamp(light_intensity[light_i], -1.0f, 1.0f);
+                        }
+
+                        // Adjust intensity based on surface normal and sum up total
+                        float total_intensity = light_intensity[0] * vn->n[0] + light_intensity[1] * vn->n[1] +
+                                                light_intensity[2] * vn->n[2];
+                        total_intensity = std::clamp(total_intensity, -1.0f, 1.0f);
+
+                        // Attenuate intensity based on attenuation values.
+                        // Example formula found at https://ogldev.org/www/tutorial20/tutorial20.html
+                        // Specific coefficients for MM's microcode sourced from GLideN64
+                        // https://github.com/gonetz/GLideN64/blob/3b43a13a80dfc2eb6357673440b335e54eaa3896/src/gSP.cpp#L636
+                        float distf = floorf(dist);
+                        float attenuation = (distf * mRsp->current_lights[i].p.unk7 * 2.0f +
+                                             distf * distf * mRsp->current_lights[i].p.unkE / 8.0f) /
+                                                (float)0xFFFF +
+                                            1.0f;
+                        intensity = total_intensity / attenuation;
+                    } else {
+                        intensity += vn->n[0] * mRsp->current_lights_coeffs[i][0];
+                        intensity += vn->n[1] * mRsp->current_lights_coeffs[i][1];
+                        intensity += vn->n[2] * mRsp->current_lights_coeffs[i][2];
+                        intensity /= 127.0f;
+                    }
+                    if (intensity > 0.0f) {
+                        r += intensity * mRsp->current_lights[i].l.col[0];
+                        g += intensity * mRsp->current_lights[i].l.col[1];
+                        b += intensity * mRsp->current_lights[i].l.col[2];
+                    }
                 }
-                if (intensity > 0.0f) {
-                    r += intensity * mRsp->current_lights[i].l.col[0];
-                    g += intensity * mRsp->current_lights[i].l.col[1];
-                    b += intensity * mRsp->current_lights[i].l.col[2];
+
+                d->color.r = r > 255 ? 255 : r;
+                d->color.g = g > 255 ? 255 : g;
+                d->color.b = b > 255 ? 255 : b;
+
+                if (mRsp->geometry_mode & G_TEXTURE_GEN) {
+                    CalculateTexGen(vn, &U, &V);
                 }
+            } else {
+                d->color.r = v->cn[0];
+                d->color.g = v->cn[1];
+                d->color.b = v->cn[2];
             }
 
-            d->color.r = r > 255 ? 255 : r;
-            d->color.g = g > 255 ? 255 : g;
-            d->color.b = b > 255 ? 255 : b;
-
-            if (mRsp->geometry_mode & G_TEXTURE_GEN) {
-                float dotx = 0, doty = 0;
-                dotx += vn->n[0] * mRsp->current_lookat_coeffs[0][0];
-                dotx += vn->n[1] * mRsp->current_lookat_coeffs[0][1];
-                dotx += vn->n[2] * mRsp->current_lookat_coeffs[0][2];
-                doty += vn->n[0] * mRsp->current_lookat_coeffs[1][0];
-                doty += vn->n[1] * mRsp->current_lookat_coeffs[1][1];
-                doty += vn->n[2] * mRsp->current_lookat_coeffs[1][2];
-
-                dotx /= 127.0f;
-                doty /= 127.0f;
-
-                dotx = Ship::Math::clamp(dotx, -1.0f, 1.0f);
-                doty = Ship::Math::clamp(doty, -1.0f, 1.0f);
-
-                if (mRsp->geometry_mode & G_TEXTURE_GEN_LINEAR) {
-                    // Not sure exactly what formula we should use to get accurate values
-                    /*dotx = (2.906921f * dotx * dotx + 1.36114f) * dotx;
-                    doty = (2.906921f * doty * doty + 1.36114f) * doty;
-                    dotx = (dotx + 1.0f) / 4.0f;
-                    doty = (doty + 1.0f) / 4.0f;*/
-                    dotx = acosf(-dotx) /* M_PI */ * 0.159155f;
-                    doty = acosf(-doty) /* M_PI */ * 0.159155f;
-                } else {
-                    dotx = (dotx + 1.0f) / 4.0f;
-                    doty = (doty + 1.0f) / 4.0f;
+            d->u = U;
+            d->v = V;
+
+            // trivial clip rejection
+            d->clip_rej = 0;
+            if (x < -w) {
+                d->clip_rej |= 1; // CLIP_LEFT
+            }
+            if (x > w) {
+                d->clip_rej |= 2; // CLIP_RIGHT
+            }
+            if (y < -w) {
+                d->clip_rej |= 4; // CLIP_BOTTOM
+            }
+            if (y > w) {
+                d->clip_rej |= 8; // CLIP_TOP
+            }
+            // if (z < -w) d->clip_rej |= 16; // CLIP_NEAR
+            if (z > w) {
+                d->clip_rej |= 32; // CLIP_FAR
+            }
+
+            d->x = x;
+            d->y = y;
+            d->z = z;
+            d->w = w;
+
+            if (mRsp->geometry_mode & G_FOG) {
+                if (fabsf(w) < 0.001f) {
+                    // To avoid division by zero
+                    w = 0.001f;
                 }
 
-                U = (int32_t)(dotx * mRsp->texture_scaling_factor.s);
-                V = (int32_t)(doty * mRsp->texture_scaling_factor.t);
+                float winv = 1.0f / w;
+                if (winv < 0.0f) {
+                    winv = std::numeric_limits<int16_t>::max();
+                }
+
+                float fog_z = z * winv * mRsp->fog_mul + mRsp->fog_offset;
+                fog_z = Ship::Math::clamp(fog_z, 0.0f, 255.0f);
+                d->color.a = fog_z; // Use alpha variable to store fog factor
+            } else {
+                d->color.a = v->cn[3];
             }
-        } else {
-            d->color.r = v->cn[0];
-            d->color.g = v->cn[1];
-            d->color.b = v->cn[2];
         }
+    }
 
-        d->u = U;
-        d->v = V;
+    if (mVertexBatchCacheEnabled && mInterpolationIndex == 0) {
+        if (mVertexBatchCount == mVertexBatches.size()) {
+            mVertexBatches.emplace_back();
+        }
+        VertexBatch& batch = mVertexBatches[mVertexBatchCount++];
+        CaptureVertexBatch(batch, n_vertices, first_index, vertices);
+        batch.result.assign(&mRsp->loaded_vertices[first_index], &mRsp->loaded_vertices[first_index + n_vertices]);
+    }
+}
 
-        // trivial clip rejection
-        d->clip_rej = 0;
-        if (x < -w) {
-            d->clip_rej |= 1; // CLIP_LEFT
+// Vectorized GfxSpVertex, returns false when the current state needs the scalar path
+bool Interpreter::GfxSpVertexSimd(size_t n_vertices, size_t dest_index, const F3DVtx* vertices) {
+    const Fast::VertexTransformFn transform = Fast::GetVertexTransformFn();
+    if (transform == nullptr) {
+        return false;
+    }
+
+    const bool lighting = mRsp->geometry_mode & G_LIGHTING;
+    const int num_lights = mRsp->current_num_lights - 1;
+    if (lighting) {
+        if (num_lights < 0 || num_lights > (int)Fast::VERTEX_SOA_MAX_LIGHTS) {
+            return false;
         }
-        if (x > w) {
-            d->clip_rej |= 2; // CLIP_RIGHT
+        // Point lights depend on the world position and need a per vertex square root, leave them to the scalar path
+        if (mRsp->geometry_mode & G_LIGHTING_POSITIONAL) {
+            for (int i = 0; i < num_lights; i++) {
+                if (mRsp->current_lights[i].p.unk3 != 0) {
+                    return false;
+                }
+            }
         }
-        if (y < -w) {
-            d->clip_rej |= 4; // CLIP_BOTTOM
+    }
+
+    Fast::VertexTransformParams& params = mVertexSimdParams;
+    memcpy(params.mpMatrix, mRsp->MP_matrix, sizeof(params.mpMatrix));
+    params.adjustAspect = !mFbActive;
+    params.aspectRatio = (float)mCurDimensions.width / (float)mCurDimensions.height;
+    params.fog = mRsp->geometry_mode & G_FOG;
+    params.fogMul = mRsp->fog_mul;
+    params.fogOffset = mRsp->fog_offset;
+    params.lighting = lighting;
+    params.numLights = lighting ? num_lights : 0;
+    if (lighting) {
+        for (int i = 0; i < num_lights; i++) {
+            memcpy(params.lightCoeffs[i], mRsp->current_lights_coeffs[i], sizeof(params.lightCoeffs[i]));
+            for (int c = 0; c < 3; c++) {
+                params.lightColors[i][c] = mRsp->current_lights[i].l.col[c];
+            }
+        }
+        for (int c = 0; c < 3; c++) {
+            params.ambient[c] = mRsp->current_lights[num_lights].l.col[c];
         }
-        if (y > w) {
-            d->clip_rej |= 8; // CLIP_TOP
+    }
+
+    Fast::VertexSoA& soa = mVertexSimdStaging;
+    for (size_t base = 0; base < n_vertices; base += Fast::VERTEX_SOA_CAPACITY) {
+        const size_t count = std::min(n_vertices - base, Fast::VERTEX_SOA_CAPACITY);
+        // The kernel works on whole vectors, pad the last one with zeroes
+        const size_t padded = std::min((count + 7) & ~(size_t)7, Fast::VERTEX_SOA_CAPACITY);
+
+        for (size_t i = 0; i < count; i++) {
+            const F3DVtx* vtx = &vertices[base + i];
+            soa.obX[i] = vtx->v.ob[0];
+            soa.obY[i] = vtx->v.ob[1];
+            soa.obZ[i] = vtx->v.ob[2];
+            soa.nX[i] = vtx->n.n[0];
+            soa.nY[i] = vtx->n.n[1];
+            soa.nZ[i] = vtx->n.n[2];
         }
-        // if (z < -w) d->clip_rej |= 16; // CLIP_NEAR
-        if (z > w) {
-            d->clip_rej |= 32; // CLIP_FAR
+        for (size_t i = count; i < padded; i++) {
+            soa.obX[i] = soa.obY[i] = soa.obZ[i] = 0.0f;
+            soa.nX[i] = soa.nY[i] = soa.nZ[i] = 0.0f;
         }
 
-        d->x = x;
-        d->y = y;
-        d->z = z;
-        d->w = w;
+        transform(params, soa, count);
 
-        if (mRsp->geometry_mode & G_FOG) {
-            if (fabsf(w) < 0.001f) {
-                // To avoid division by zero
-                w = 0.001f;
-            }
+        for (size_t i = 0; i < count; i++) {
+            const F3DVtx_t* v = &vertices[base + i].v;
+            const F3DVtx_tn* vn = &vertices[base + i].n;
+            struct LoadedVertex* d = &mRsp->loaded_vertices[dest_index + base + i];
+
+            short U = v->tc[0] * mRsp->texture_scaling_factor.s >> 16;
+            short V = v->tc[1] * mRsp->texture_scaling_factor.t >> 16;
+
+            if (lighting) {
+                d->color.r = soa.r[i] > 255 ? 255 : soa.r[i];
+                d->color.g = soa.g[i] > 255 ? 255 : soa.g[i];
+                d->color.b = soa.b[i] > 255 ? 255 : soa.b[i];
 
-            float winv = 1.0f / w;
-            if (winv < 0.0f) {
-                winv = std::numeric_limits<int16_t>::max();
+                if (mRsp->geometry_mode & G_TEXTURE_GEN) {
+                    CalculateTexGen(vn, &U, &V);
+                }
+            } else {
+                d->color.r = v->cn[0];
+                d->color.g = v->cn[1];
+                d->color.b = v->cn[2];
             }
 
-            float fog_z = z * winv * mRsp->fog_mul + mRsp->fog_offset;
-            fog_z = Ship::Math::clamp(fog_z, 0.0f, 255.0f);
-            d->color.a = fog_z; // Use alpha variable to store fog factor
-        } else {
-            d->color.a = v->cn[3];
+            d->u = U;
+            d->v = V;
+            d->clip_rej = soa.clipRej[i];
+            d->x = soa.x[i];
+            d->y = soa.y[i];
+            d->z = soa.z[i];
+            d->w = soa.w[i];
+            d->color.a = params.fog ? (uint8_t)soa.fog[i] : v->cn[3];
         }
     }
+
+    return true;
 }
 
 void Interpreter::GfxSpModifyVertex(uint16_t vtx_idx, uint8_t where, uint32_t val) {
@@ -1420,57 +1616,87 @@ void Interpreter::GfxSpModifyVertex(uint16_t vtx_idx, uint8_t where, uint32_t va
     v->v = t;
 }
 
-void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bool is_rect) {
-    struct LoadedVertex* v1 = &mRsp->loaded_vertices[vtx1_idx];
-    struct LoadedVertex* v2 = &mRsp->loaded_vertices[vtx2_idx];
-    struct LoadedVertex* v3 = &mRsp->loaded_vertices[vtx3_idx];
-    struct LoadedVertex* v_arr[3] = { v1, v2, v3 };
-
-    // if (rand()%2) return;
+void Interpreter::GfxSpStarfield(const F3DStar* stars, size_t count) {
+    // Same layout as the quad the game used to draw per star: bottom-left, top-left, bottom-right, top-right
+    static const float corners[4][2] = { { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
 
-    if (v1->clip_rej & v2->clip_rej & v3->clip_rej) {
-        // The whole triangle lies outside the visible area
+    if (stars == nullptr) {
         return;
     }
 
-    const uint32_t cull_both = get_attr(CULL_BOTH);
-    const uint32_t cull_front = get_attr(CULL_FRONT);
-    const uint32_t cull_back = get_attr(CULL_BACK);
+    for (size_t i = 0; i < count; i++) {
+        const F3DStar* star = &stars[i];
+        float sx = star->x;
+        float sy = star->y;
 
-    if ((mRsp->geometry_mode & cull_both) != 0) {
-        float dx1 = v1->x / (v1->w) - v2->x / (v2->w);
-        float dy1 = v1->y / (v1->w) - v2->y / (v2->w);
-        float dx2 = v3->x / (v3->w) - v2->x / (v2->w);
-        float dy2 = v3->y / (v3->w) - v2->y / (v2->w);
-        float cross = dx1 * dy2 - dy1 * dx2;
-
-        if ((v1->w < 0) ^ (v2->w < 0) ^ (v3->w < 0)) {
-            // If one vertex lies behind the eye, negating cross will give the correct result.
-            // If all vertices lie behind the eye, the triangle will be rejected anyway.
-            cross = -cross;
+        if (star->interpolate) {
+            sx = star->prevX + (star->x - star->prevX) * mInterpolationStep;
+            sy = star->prevY + (star->y - star->prevY) * mInterpolationStep;
         }
 
-        // If inverted culling is requested, negate the cross
-        if (ucode_handler_index == UcodeHandlers::ucode_f3dex2 &&
-            (mRsp->extra_geometry_mode & G_EX_INVERT_CULLING) == 1) {
-            cross = -cross;
-        }
+        for (int j = 0; j < 4; j++) {
+            struct LoadedVertex* d = &mRsp->loaded_vertices[j];
+            float ox = sx + corners[j][0];
+            float oy = sy + corners[j][1];
 
-        auto cull_type = mRsp->geometry_mode & cull_both;
+            float x = ox * mRsp->MP_matrix[0][0] + oy * mRsp->MP_matrix[1][0] + mRsp->MP_matrix[3][0];
+            float y = ox * mRsp->MP_matrix[0][1] + oy * mRsp->MP_matrix[1][1] + mRsp->MP_matrix[3][1];
+            float z = ox * mRsp->MP_matrix[0][2] + oy * mRsp->MP_matrix[1][2] + mRsp->MP_matrix[3][2];
+            float w = ox * mRsp->MP_matrix[0][3] + oy * mRsp->MP_matrix[1][3] + mRsp->MP_matrix[3][3];
 
-        if (cull_type == cull_front) {
-            if (cross <= 0) {
-                return;
+            x = AdjXForAspectRatio(x);
+
+            d->u = 0;
+            d->v = 0;
+            d->color = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+            d->clip_rej = 0;
+            if (x < -w) {
+                d->clip_rej |= 1; // CLIP_LEFT
             }
-        } else if (cull_type == cull_back) {
-            if (cross >= 0) {
-                return;
+            if (x > w) {
+                d->clip_rej |= 2; // CLIP_RIGHT
+            }
+            if (y < -w) {
+                d->clip_rej |= 4; // CLIP_BOTTOM
+            }
+            if (y > w) {
+                d->clip_rej |= 8; // CLIP_TOP
+            }
+            if (z > w) {
+                d->clip_rej |= 32; // CLIP_FAR
+            }
+
+            d->x = x;
+            d->y = y;
+            d->z = z;
+            d->w = w;
+
+            if (mRsp->geometry_mode & G_FOG) {
+                if (fabsf(w) < 0.001f) {
+                    w = 0.001f;
+                }
+
+                float winv = 1.0f / w;
+                if (winv < 0.0f) {
+                    winv = std::numeric_limits<int16_t>::max();
+                }
+
+                float fog_z = z * winv * mRsp->fog_mul + mRsp->fog_offset;
+                d->color.a = Ship::Math::clamp(fog_z, 0.0f, 255.0f);
             }
-        } else if (cull_type == cull_both) {
-            // Why is this even an option?
-            return;
         }
+
+        GfxDpSetPrimColor(0, 0, star->cn[0], star->cn[1], star->cn[2], star->cn[3]);
+        GfxSpTri1(0, 1, 2, false);
+        GfxSpTri1(1, 2, 3, false);
     }
+}
+
+// Derives the pipeline state used by GfxSpTri1 from the RDP/RSP state and applies it to the rendering API. Only
+// called after one of its inputs changed, triangles in between reuse mDerivedRenderState.
+void Interpreter::UpdateDerivedRenderState() {
+    DerivedRenderState& state = mDerivedRenderState;
 
     bool depth_test = (mRsp->geometry_mode & G_ZBUFFER) == G_ZBUFFER;
     bool depth_mask = (mRdp->other_mode_l & Z_UPD) == Z_UPD;
@@ -1488,21 +1714,6 @@ void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx
         mRenderingState.decal_mode = zmode_decal;
     }
 
-    if (mRdp->viewport_or_scissor_changed) {
-        if (memcmp(&mRdp->viewport, &mRenderingState.viewport, sizeof(mRdp->viewport)) != 0) {
-            Flush();
-            mRapi->SetViewport(mRdp->viewport.x, mRdp->viewport.y, mRdp->viewport.width, mRdp->viewport.height);
-            mRenderingState.viewport = mRdp->viewport;
-        }
-        if (memcmp(&mRdp->scissor, &mRenderingState.scissor, sizeof(mRdp->scissor)) != 0) {
-            Flush();
-            mRapi->SetScissor(mRdp->scissor.x, mRdp->scissor.y, mRdp->scissor.width, mRdp->scissor.height);
-            mRenderingState.scissor = mRdp->scissor;
-        }
-        mRdp->viewport_or_scissor_changed = false;
-    }
-
-    uint64_t cc_id = mRdp->combine_mode;
     uint64_t cc_options = 0;
     bool use_alpha = ((mRdp->other_mode_l & (3 << 20)) == (G_BL_CLR_MEM << 20) &&
                       (mRdp->other_mode_l & (3 << 16)) == (G_BL_1MA << 16)) ||
@@ -1577,9 +1788,13 @@ void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx
     }
 
     ColorCombiner* comb = LookupOrCreateColorCombiner(key);
+    bool linear_filter = (mRdp->other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT;
 
     uint32_t tm = 0;
-    uint32_t tex_width[2], tex_height[2], tex_width2[2], tex_height2[2];
+    uint32_t* tex_width = state.tex_width;
+    uint32_t* tex_height = state.tex_height;
+    uint32_t* tex_width2 = state.tex_width2;
+    uint32_t* tex_height2 = state.tex_height2;
 
     for (int i = 0; i < 2; i++) {
         uint32_t tile = mRdp->first_tile_index + i;
@@ -1642,7 +1857,6 @@ void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx
                 continue;
             }
 
-            bool linear_filter = (mRdp->other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT;
             if (linear_filter != mRenderingState.mTextures[i]->second.linear_filter ||
                 cms != mRenderingState.mTextures[i]->second.cms || cmt != mRenderingState.mTextures[i]->second.cmt) {
                 Flush();
@@ -1676,12 +1890,106 @@ void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx
         mRapi->SetUseAlpha(use_alpha);
         mRenderingState.alpha_blend = use_alpha;
     }
-    uint8_t numInputs;
-    bool usedTextures[2];
 
-    mRapi->ShaderGetInfo(prg, &numInputs, usedTextures);
+    mRapi->ShaderGetInfo(prg, &state.num_inputs, state.used_textures);
+
+    state.use_alpha = use_alpha;
+    state.use_fog = use_fog;
+    state.use_grayscale = use_grayscale;
+    state.linear_filter = linear_filter;
+    state.comb = comb;
+    state.tm = tm;
+    state.clip_parameters = mRapi->GetClipParameters();
+
+    mRdp->render_state_changed = false;
+    mRsp->geometry_mode_changed = false;
+}
+
+void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bool is_rect) {
+    struct LoadedVertex* v1 = &mRsp->loaded_vertices[vtx1_idx];
+    struct LoadedVertex* v2 = &mRsp->loaded_vertices[vtx2_idx];
+    struct LoadedVertex* v3 = &mRsp->loaded_vertices[vtx3_idx];
+    struct LoadedVertex* v_arr[3] = { v1, v2, v3 };
+
+    // if (rand()%2) return;
+
+    if (v1->clip_rej & v2->clip_rej & v3->clip_rej) {
+        // The whole triangle lies outside the visible area
+        return;
+    }
+
+    const uint32_t cull_both = get_attr(CULL_BOTH);
+    const uint32_t cull_front = get_attr(CULL_FRONT);
+    const uint32_t cull_back = get_attr(CULL_BACK);
+
+    if ((mRsp->geometry_mode & cull_both) != 0) {
+        float dx1 = v1->x / (v1->w) - v2->x / (v2->w);
+        float dy1 = v1->y / (v1->w) - v2->y / (v2->w);
+        float dx2 = v3->x / (v3->w) - v2->x / (v2->w);
+        float dy2 = v3->y / (v3->w) - v2->y / (v2->w);
+        float cross = dx1 * dy2 - dy1 * dx2;
+
+        if ((v1->w < 0) ^ (v2->w < 0) ^ (v3->w < 0)) {
+            // If one vertex lies behind the eye, negating cross will give the correct result.
+            // If all vertices lie behind the eye, the triangle will be rejected anyway.
+            cross = -cross;
+        }
+
+        // If inverted culling is requested, negate the cross
+        if (ucode_handler_index == UcodeHandlers::ucode_f3dex2 &&
+            (mRsp->extra_geometry_mode & G_EX_INVERT_CULLING) == 1) {
+            cross = -cross;
+        }
+
+        auto cull_type = mRsp->geometry_mode & cull_both;
+
+        if (cull_type == cull_front) {
+            if (cross <= 0) {
+                return;
+            }
+        } else if (cull_type == cull_back) {
+            if (cross >= 0) {
+                return;
+            }
+        } else if (cull_type == cull_both) {
+            // Why is this even an option?
+            return;
+        }
+    }
+
+    if (mRdp->viewport_or_scissor_changed) {
+        if (memcmp(&mRdp->viewport, &mRenderingState.viewport, sizeof(mRdp->viewport)) != 0) {
+            Flush();
+            mRapi->SetViewport(mRdp->viewport.x, mRdp->viewport.y, mRdp->viewport.width, mRdp->viewport.height);
+            mRenderingState.viewport = mRdp->viewport;
+        }
+        if (memcmp(&mRdp->scissor, &mRenderingState.scissor, sizeof(mRdp->scissor)) != 0) {
+            Flush();
+            mRapi->SetScissor(mRdp->scissor.x, mRdp->scissor.y, mRdp->scissor.width, mRdp->scissor.height);
+            mRenderingState.scissor = mRdp->scissor;
+        }
+        mRdp->viewport_or_scissor_changed = false;
+    }
 
-    struct GfxClipParameters clip_parameters = mRapi->GetClipParameters();
+    const DerivedRenderState& state = mDerivedRenderState;
+    if (mRdp->render_state_changed || mRsp->geometry_mode_changed ||
+        (mRdp->textures_changed[0] && state.comb->usedTextures[0]) ||
+        (mRdp->textures_changed[1] && state.comb->usedTextures[1])) {
+        UpdateDerivedRenderState();
+    }
+
+    const bool use_alpha = state.use_alpha;
+    const bool use_fog = state.use_fog;
+    const bool use_grayscale = state.use_grayscale;
+    const ColorCombiner* comb = state.comb;
+    const uint32_t tm = state.tm;
+    const uint32_t* tex_width = state.tex_width;
+    const uint32_t* tex_height = state.tex_height;
+    const uint32_t* tex_width2 = state.tex_width2;
+    const uint32_t* tex_height2 = state.tex_height2;
+    const uint8_t numInputs = state.num_inputs;
+    const bool* usedTextures = state.used_textures;
+    const GfxClipParameters& clip_parameters = state.clip_parameters;
 
     for (int i = 0; i < 3; i++) {
         float z = v_arr[i]->z, w = v_arr[i]->w;
@@ -1721,7 +2029,7 @@ void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx
             u -= mRdp->texture_tile[mRdp->first_tile_index + t].uls / 4.0f;
             v -= mRdp->texture_tile[mRdp->first_tile_index + t].ult / 4.0f;
 
-            if ((mRdp->other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT) {
+            if (state.linear_filter) {
                 // Linear filter adds 0.5f to the coordinates
                 if (!is_rect) {
                     u += 0.5f;
@@ -1846,6 +2154,7 @@ void Interpreter::GfxSpTri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx
 void Interpreter::GfxSpGeometryMode(uint32_t clear, uint32_t set) {
     mRsp->geometry_mode &= ~clear;
     mRsp->geometry_mode |= set;
+    mRsp->geometry_mode_changed = true;
 }
 
 void Interpreter::GfxSpExtraGeometryMode(uint32_t clear, uint32_t set) {
@@ -2138,6 +2447,8 @@ void Interpreter::GfxDpLoadBlock(uint8_t tile, uint32_t uls, uint32_t ult, uint3
         mRdp->loaded_texture[mRdp->texture_tile[tile].tmem_index].masked = false;
         mRdp->loaded_texture[mRdp->texture_tile[tile].tmem_index].blended = false;
     }
+    // Masked and blended textures select a different combiner
+    mRdp->render_state_changed = true;
 
     mRdp->textures_changed[mRdp->texture_tile[tile].tmem_index] = true;
 }
@@ -2208,6 +2519,8 @@ void Interpreter::GfxDpLoadTile(uint8_t tile, uint32_t uls, uint32_t ult, uint32
         mRdp->loaded_texture[mRdp->texture_tile[tile].tmem_index].masked = false;
         mRdp->loaded_texture[mRdp->texture_tile[tile].tmem_index].blended = false;
     }
+    // Masked and blended textures select a different combiner
+    mRdp->render_state_changed = true;
 
     mRdp->texture_tile[tile].uls = uls;
     mRdp->texture_tile[tile].ult = ult;
@@ -2251,6 +2564,7 @@ static void GfxDpSetCombineMode(uint32_t rgb, uint32_t alpha) {
 
 void Interpreter::GfxDpSetCombineMode(uint32_t rgb, uint32_t alpha, uint32_t rgb_cyc2, uint32_t alpha_cyc2) {
     mRdp->combine_mode = rgb | (alpha << 16) | ((uint64_t)rgb_cyc2 << 28) | ((uint64_t)alpha_cyc2 << 44);
+    mRdp->render_state_changed = true;
 }
 
 static inline uint32_t color_comb(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
@@ -2312,6 +2626,7 @@ void Interpreter::GfxDrawRectangle(int32_t ulx, int32_t uly, int32_t lrx, int32_
 
     if (cycle_type == G_CYC_COPY) {
         mRdp->other_mode_h = (mRdp->other_mode_h & ~(3U << G_MDSFT_TEXTFILT)) | G_TF_POINT;
+        mRdp->render_state_changed = true;
     }
 
     // U10.2 coordinates
@@ -2370,16 +2685,19 @@ void Interpreter::GfxDrawRectangle(int32_t ulx, int32_t uly, int32_t lrx, int32_
     mRdp->viewport = default_viewport;
     mRdp->viewport_or_scissor_changed = true;
     mRsp->geometry_mode = 0;
+    mRsp->geometry_mode_changed = true;
 
     GfxSpTri1(MAX_VERTICES + 0, MAX_VERTICES + 1, MAX_VERTICES + 3, true);
     GfxSpTri1(MAX_VERTICES + 1, MAX_VERTICES + 2, MAX_VERTICES + 3, true);
 
     mRsp->geometry_mode = geometry_mode_saved;
+    mRsp->geometry_mode_changed = true;
     mRdp->viewport = viewport_saved;
     mRdp->viewport_or_scissor_changed = true;
 
     if (cycle_type == G_CYC_COPY) {
         mRdp->other_mode_h = saved_other_mode_h;
+        mRdp->render_state_changed = true;
     }
 }
 
@@ -2447,6 +2765,7 @@ void Interpreter::GfxDpTextureRectangle(int32_t ulx, int32_t uly, int32_t lrx, i
     }
     mRdp->first_tile_index = saved_tile;
     mRdp->combine_mode = saved_combine_mode;
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::GfxDpImageRectangle(int32_t tile, int32_t w, int32_t h, int32_t ulx, int32_t uly, int16_t uls,
@@ -2481,6 +2800,8 @@ void Interpreter::GfxDpImageRectangle(int32_t tile, int32_t w, int32_t h, int32_
     auto& loadtex = mRdp->loaded_texture[mRdp->texture_tile[tile].tmem_index];
     loadtex.full_image_line_size_bytes = loadtex.line_size_bytes = mRdp->texture_tile[tile].line_size_bytes;
     loadtex.size_bytes = loadtex.orig_size_bytes = loadtex.line_size_bytes * h;
+    // The tile's size and clamp bits changed even when it already was the first tile
+    mRdp->render_state_changed = true;
 
     uint8_t saved_tile = mRdp->first_tile_index;
     if (saved_tile != tile) {
@@ -2495,6 +2816,8 @@ void Interpreter::GfxDpImageRectangle(int32_t tile, int32_t w, int32_t h, int32_
         mRdp->textures_changed[1] = true;
     }
     mRdp->first_tile_index = saved_tile;
+    // The next triangles draw with the tile as this left it
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::GfxDpFillRectangle(int32_t ulx, int32_t uly, int32_t lrx, int32_t lry) {
@@ -2531,6 +2854,7 @@ void Interpreter::GfxDpFillRectangle(int32_t ulx, int32_t uly, int32_t lrx, int3
 
     GfxDrawRectangle(ulx, uly, lrx, lry);
     mRdp->combine_mode = saved_combine_mode;
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::GfxDpSetZImage(void* zBufAddr) {
@@ -2547,11 +2871,13 @@ void Interpreter::GfxSpSetOtherMode(uint32_t shift, uint32_t num_bits, uint64_t
     om = (om & ~mask) | mode;
     mRdp->other_mode_l = (uint32_t)om;
     mRdp->other_mode_h = (uint32_t)(om >> 32);
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::GfxDpSetOtherMode(uint32_t h, uint32_t l) {
     mRdp->other_mode_h = h;
     mRdp->other_mode_l = l;
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::Gfxs2dexBgCopy(F3DuObjBg* bg) {
@@ -2971,7 +3297,7 @@ int16_t Interpreter::CreateShader(const std::string& path) {
     if (shader == nullptr || !shader->IsLoaded) {
         return -1;
     }
-    shader_ids.push_back(std::string(shader->Buffer->data()));
+    shader_ids.push_back(std::string(shader->GetData(), strnlen(shader->GetData(), shader->GetSize())));
     return shader_ids.size() - 1;
 }
 
@@ -2989,6 +3315,7 @@ bool gfx_set_shader_custom(F3DGfx** cmd0) {
     const auto path = std::string(file);
     const auto shaderId = gfx->CreateShader(path);
     gfx->mRdp->current_shader = { true, shaderId, (uint8_t)C0(16, 1) };
+    gfx->mRdp->render_state_changed = true;
     return false;
 }
 
@@ -3548,6 +3875,7 @@ bool gfx_reset_fb_handler_custom(F3DGfx** cmd0) {
     // Force viewport and scissor to reapply against the main framebuffer, in case a previous smaller
     // framebuffer truncated the values
     gfx->mRdp->viewport_or_scissor_changed = true;
+    gfx->mRdp->render_state_changed = true;
     gfx->mRenderingState.viewport = {};
     gfx->mRenderingState.scissor = {};
     return false;
@@ -3634,6 +3962,7 @@ bool gfx_set_timg_fb_handler_custom(F3DGfx** cmd0) {
     gfx->mRapi->SelectTextureFb((uint32_t)cmd->words.w1);
     gfx->mRdp->textures_changed[0] = false;
     gfx->mRdp->textures_changed[1] = false;
+    gfx->mRdp->render_state_changed = true;
     return false;
 }
 
@@ -3642,6 +3971,7 @@ bool gfx_set_grayscale_handler_custom(F3DGfx** cmd0) {
     F3DGfx* cmd = *cmd0;
 
     gfx->mRdp->grayscale = cmd->words.w1;
+    gfx->mRdp->render_state_changed = true;
     return false;
 }
 
@@ -3755,6 +4085,14 @@ bool gfx_set_fill_color_handler_rdp(F3DGfx** cmd0) {
     return false;
 }
 
+bool gfx_starfield_handler_custom(F3DGfx** cmd0) {
+    Interpreter* gfx = mInstance.lock().get();
+    F3DGfx* cmd = *cmd0;
+
+    gfx->GfxSpStarfield((const F3DStar*)cmd->words.w1, C0(0, 16));
+    return false;
+}
+
 bool gfx_set_intensity_handler_custom(F3DGfx** cmd0) {
     Interpreter* gfx = mInstance.lock().get();
     F3DGfx* cmd = *cmd0;
@@ -4036,6 +4374,7 @@ static constexpr UcodeHandler otrHandlers = {
     { OTR_G_SETINTENSITY, { "G_SETINTENSITY", gfx_set_intensity_handler_custom } }, // G_SETINTENSITY (0x40)
     { OTR_G_MOVEMEM_HASH, { "OTR_G_MOVEMEM_HASH", gfx_movemem_handler_otr } },      // OTR_G_MOVEMEM_HASH
     { OTR_G_LOAD_SHADER, { "G_LOAD_SHADER", gfx_set_shader_custom } },
+    { OTR_G_STARFIELD, { "G_STARFIELD", gfx_starfield_handler_custom } },
 };
 
 static constexpr UcodeHandler f3dex2Handlers = {
@@ -4360,7 +4699,7 @@ void Interpreter::StartFrame() {
 
 GfxExecStack g_exec_stack = {};
 
-void Interpreter::Run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_replacements) {
+void Interpreter::Run(Gfx* commands, const MtxReplacementMap& mtx_replacements) {
     SpReset();
 
     mGetPixelDepthPending.clear();
@@ -4368,12 +4707,18 @@ void Interpreter::Run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_r
 
     mCurMtxReplacements = &mtx_replacements;
 
+    mVertexBatchCursor = 0;
+    if (mInterpolationIndex == 0) {
+        mVertexBatchCount = 0;
+    }
+
     mRapi->UpdateFramebufferParameters(0, mGfxCurrentWindowDimensions.width, mGfxCurrentWindowDimensions.height, 1,
                                        false, true, true, !mRendersToFb);
     mRapi->StartFrame();
     mRapi->StartDrawToFramebuffer(mRendersToFb ? mGameFb : 0, (float)mCurDimensions.height / mNativeDimensions.height);
     mRapi->ClearFramebuffer(false, true);
     mRdp->viewport_or_scissor_changed = true;
+    mRdp->render_state_changed = true;
     mRenderingState.viewport = {};
     mRenderingState.scissor = {};
 
@@ -4463,6 +4808,7 @@ int Interpreter::CreateFrameBuffer(uint32_t width, uint32_t height, uint32_t nat
 void Interpreter::SetFrameBuffer(int fb, float noiseScale) {
     mRapi->StartDrawToFramebuffer(fb, noiseScale);
     mRapi->ClearFramebuffer(false, true);
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::CopyFrameBuffer(int fb_dst_id, int fb_src_id, bool copyOnce, bool* hasCopiedPtr) {
@@ -4509,6 +4855,7 @@ void Interpreter::CopyFrameBuffer(int fb_dst_id, int fb_src_id, bool copyOnce, b
 
 void Interpreter::ResetFrameBuffer() {
     mRapi->StartDrawToFramebuffer(0, (float)mCurDimensions.height / mNativeDimensions.height);
+    mRdp->render_state_changed = true;
 }
 
 void Interpreter::AdjustPixelDepthCoordinates(float& x, float& y) {
@@ -12,6 +12,8 @@
 #include <string>
 
 #include "graphic/Fast3D/lus_gbi.h"
+#include "graphic/Fast3D/MtxReplacementMap.h"
+#include "graphic/Fast3D/VertexTransform.h"
 #include "libultraship/libultra/types.h"
 #include "public/bridge/gfxbridge.h"
 #include "backends/gfx_rendering_api.h"
@@ -243,6 +245,7 @@ struct RSP {
     bool lights_changed;
 
     uint32_t geometry_mode;
+    bool geometry_mode_changed;
     int16_t fog_mul, fog_offset;
 
     uint32_t extra_geometry_mode;
@@ -295,6 +298,8 @@ struct RDP {
     uint64_t combine_mode;
     bool grayscale;
     ShaderMod current_shader;
+    // Other mode, combiner or texture state GfxSpTri1 derives its pipeline state from was changed
+    bool render_state_changed;
 
     uint8_t prim_lod_fraction;
     struct RGBA env_color, prim_color, fog_color, fill_color, grayscale_color;
@@ -341,6 +346,20 @@ struct RenderingState {
     TextureCacheNode* mTextures[SHADER_MAX_TEXTURES];
 };
 
+// Pipeline state derived from the RDP/RSP state, shared by every triangle until one of its inputs changes
+struct DerivedRenderState {
+    bool use_alpha;
+    bool use_fog;
+    bool use_grayscale;
+    bool linear_filter;
+    struct ColorCombiner* comb;
+    uint32_t tm; // Clamp S/T bits per texture
+    uint32_t tex_width[2], tex_height[2], tex_width2[2], tex_height2[2];
+    uint8_t num_inputs;
+    bool used_textures[2];
+    struct GfxClipParameters clip_parameters;
+};
+
 struct FBInfo {
     uint32_t orig_width, orig_height;       // Original shape
     uint32_t applied_width, applied_height; // Up-scaled for the viewport
@@ -353,6 +372,25 @@ struct MaskedTextureEntry {
     uint8_t* replacementData;
 };
 
+// Inputs and results of a single vertex load, recorded on the first interpolated sub-frame so later sub-frames can
+// skip the transform when none of the matrices or lights it depends on were replaced.
+struct VertexBatch {
+    const F3DVtx* vertices;
+    size_t numVertices;
+    size_t destIndex;
+    uint32_t geometryMode;
+    uint16_t textureScaleS, textureScaleT;
+    int16_t fogMul, fogOffset;
+    float aspectScale;
+    float mpMatrix[4][4];
+    float modelviewMatrix[4][4];
+    uint8_t numLights;
+    std::vector<F3DLight> lights;
+    float lightsCoeffs[MAX_LIGHTS][3];
+    float lookatCoeffs[2][3];
+    std::vector<LoadedVertex> result;
+};
+
 class Interpreter {
   public:
     Interpreter();
@@ -364,7 +402,7 @@ class Interpreter {
     void GetDimensions(uint32_t* width, uint32_t* height, int32_t* posX, int32_t* posY);
     GfxRenderingAPI* GetCurrentRenderingAPI();
     void StartFrame();
-    void Run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_replacements);
+    void Run(Gfx* commands, const MtxReplacementMap& mtx_replacements);
     void EndFrame();
     void HandleWindowEvents();
     bool IsFrameReady();
@@ -412,7 +450,13 @@ class Interpreter {
     void GfxSpMatrix(uint8_t params, const int32_t* addr);
     void GfxSpPopMatrix(uint32_t count);
     void GfxSpVertex(size_t numVertices, size_t destIndex, const F3DVtx* vertices);
+    bool GfxSpVertexSimd(size_t numVertices, size_t destIndex, const F3DVtx* vertices);
+    void CalculateTexGen(const F3DVtx_tn* vn, short* u, short* v);
+    void CaptureVertexBatch(VertexBatch& batch, size_t numVertices, size_t destIndex, const F3DVtx* vertices);
+    bool VertexBatchMatches(const VertexBatch& a, const VertexBatch& b) const;
     void GfxSpModifyVertex(uint16_t vtxIdx, uint8_t where, uint32_t val);
+    void GfxSpStarfield(const F3DStar* stars, size_t count);
+    void UpdateDerivedRenderState();
     void GfxSpTri1(uint8_t vtx1Idx, uint8_t vtx2Idx, uint8_t vtx3Idx, bool isRect);
     void GfxSpGeometryMode(uint32_t clear, uint32_t set);
     void GfxSpExtraGeometryMode(uint32_t clear, uint32_t set);
@@ -473,8 +517,11 @@ class Interpreter {
     RSP* mRsp;
     RDP* mRdp;
     RenderingState mRenderingState{};
+    DerivedRenderState mDerivedRenderState{};
 
     GfxTextureCache mTextureCache{};
+    // Textures imported because the cache did not have them, counted up for as long as the interpreter exists
+    size_t mTextureUploadCount{};
     std::map<ColorCombinerKey, ColorCombiner> mColorCombinerPool; // color_combiner_pool;
     std::map<ColorCombinerKey, ColorCombiner>::iterator mPrevCombiner = mColorCombinerPool.end();
     uint8_t* mTexUploadBuffer = nullptr;
@@ -511,11 +558,23 @@ class Interpreter {
     std::unordered_map<std::pair<float, float>, uint16_t, hash_pair_ff> mGetPixelDepthCached; // get_pixel_depth_cached;
     std::map<std::string, MaskedTextureEntry> mMaskedTextures;
 
-    const std::unordered_map<Mtx*, MtxF>* mCurMtxReplacements;
+    const MtxReplacementMap* mCurMtxReplacements;
     bool mMarkerOn; // This was originally a debug feature. Now it seems to control s2dex?
     std::vector<std::string> shader_ids;
     int mInterpolationIndex;
     int mInterpolationIndexTarget;
+    // Fraction between the previous and current game frame of the sub-frame being drawn
+    float mInterpolationStep = 1.0f;
+    // Set by the caller when the same display list is run for more than one interpolated sub-frame
+    bool mVertexBatchCacheEnabled{};
+    std::vector<VertexBatch> mVertexBatches;
+    size_t mVertexBatchCount{};
+    size_t mVertexBatchCursor{};
+    VertexBatch mVertexBatchScratch{};
+    // Transform vertex loads several at a time when the CPU supports it
+    bool mVertexSimdEnabled = true;
+    Fast::VertexTransformParams mVertexSimdParams{};
+    Fast::VertexSoA mVertexSimdStaging{};
 };
 
 void gfx_set_target_ucode(UcodeHandlers ucode);
@@ -70,6 +70,7 @@ constexpr int8_t OTR_G_MOVEMEM_HASH = OPCODE(0x42);
 constexpr int8_t OTR_G_LOAD_SHADER = OPCODE(0x43);
 constexpr int8_t RDP_G_SETTILESIZE_INTERP = OPCODE(0x44);
 constexpr int8_t RDP_G_SETTARGETINTERPINDEX = OPCODE(0x45);
+constexpr int8_t OTR_G_STARFIELD = OPCODE(0x46);
 
 /*
  * The following commands are the "generated" RDP commands; the user
@@ -867,6 +868,16 @@ typedef union F3DVtx {
     long long int force_structure_alignment;
 } F3DVtx;
 
+/*
+ * Starfield point, drawn as a 1x1 primitive colored quad
+ */
+typedef struct {
+    float x, y;          /* position */
+    float prevX, prevY;  /* position on the previous game frame */
+    unsigned char cn[4]; /* color & alpha */
+    int interpolate;     /* lerp from prevX, prevY on interpolated frames */
+} F3DStar;
+
 /*
  * Sprite structure
  */
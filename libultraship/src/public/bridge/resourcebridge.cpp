@@ -1,6 +1,7 @@
 #include "public/bridge/resourcebridge.h"
 #include "Context.h"
 #include <string>
+#include <vector>
 #include <algorithm>
 #include "utils/StrHash64.h"
 #include "window/Window.h"
@@ -20,6 +21,83 @@ std::shared_ptr<Ship::IResource> ResourceLoad(uint64_t crc) {
     return ResourceLoad(name);
 }
 
+namespace {
+// LOAD_ASSET is called with static path strings, so the pointer itself identifies the asset. Each thread keeps its own
+// table from path pointer to data pointer, which makes a hit a single probe without locks or allocations. Each entry
+// only hits in the cache generation it was loaded in. Names that are not static live in archive or resource data, and
+// those are only freed or replaced together with a generation change, so a reused buffer can not hit an old entry.
+constexpr size_t RESOURCE_DATA_CACHE_SIZE = 2048; // Power of two
+constexpr size_t RESOURCE_DATA_CACHE_MAX_LOAD = RESOURCE_DATA_CACHE_SIZE * 3 / 4;
+
+struct ResourceDataCacheEntry {
+    const char* Key = nullptr;
+    uint32_t Generation = 0;
+    void* Data = nullptr;
+};
+
+struct ResourceDataCache {
+    Ship::ResourceManager* Manager = nullptr;
+    size_t Count = 0;
+    std::vector<ResourceDataCacheEntry> Entries;
+};
+
+thread_local ResourceDataCache sResourceDataCache;
+
+size_t ResourceDataCacheSlot(const char* name) {
+    return (((uintptr_t)name >> 2) * 0x9E3779B97F4A7C15ull >> 32) & (RESOURCE_DATA_CACHE_SIZE - 1);
+}
+
+void ResourceDataCacheClear(ResourceDataCache& cache) {
+    for (auto& entry : cache.Entries) {
+        entry.Key = nullptr;
+    }
+    cache.Count = 0;
+}
+
+void* ResourceDataCacheFind(ResourceDataCache& cache, const char* name) {
+    if (cache.Manager == nullptr) {
+        return nullptr;
+    }
+
+    const uint32_t generation = cache.Manager->GetCacheGeneration();
+    for (size_t i = ResourceDataCacheSlot(name);; i = (i + 1) & (RESOURCE_DATA_CACHE_SIZE - 1)) {
+        const auto& entry = cache.Entries[i];
+        if (entry.Key == nullptr) {
+            return nullptr;
+        }
+        if (entry.Key == name) {
+            return entry.Generation == generation ? entry.Data : nullptr;
+        }
+    }
+}
+
+void ResourceDataCacheInsert(ResourceDataCache& cache, Ship::ResourceManager* manager, uint32_t generation,
+                             const char* name, void* data) {
+    if (cache.Entries.empty()) {
+        cache.Entries.resize(RESOURCE_DATA_CACHE_SIZE);
+    }
+    // Entries of older generations are overwritten when their name is loaded again, or dropped with the rest once
+    // the table fills up
+    if (cache.Manager != manager || cache.Count >= RESOURCE_DATA_CACHE_MAX_LOAD) {
+        ResourceDataCacheClear(cache);
+        cache.Manager = manager;
+    }
+
+    for (size_t i = ResourceDataCacheSlot(name);; i = (i + 1) & (RESOURCE_DATA_CACHE_SIZE - 1)) {
+        auto& entry = cache.Entries[i];
+        if (entry.Key == nullptr || entry.Key == name) {
+            if (entry.Key == nullptr) {
+                cache.Count++;
+            }
+            entry.Key = name;
+            entry.Generation = generation;
+            entry.Data = data;
+            return;
+        }
+    }
+}
+} // namespace
+
 extern "C" {
 
 uint64_t ResourceGetCrcByName(const char* name) {
@@ -61,13 +139,30 @@ uint8_t ResourceGetIsCustomByCrc(uint64_t crc) {
 }
 
 void* ResourceGetDataByName(const char* name) {
-    auto resource = ResourceLoad(name);
+    auto& cache = sResourceDataCache;
+
+    if (name != nullptr) {
+        void* data = ResourceDataCacheFind(cache, name);
+        if (data != nullptr) {
+            return data;
+        }
+    }
+
+    // Read the generation before loading so an invalidation racing with the load drops the entry again.
+    auto resourceManager = Ship::Context::GetInstance()->GetResourceManager();
+    const uint32_t generation = resourceManager->GetCacheGeneration();
+    auto resource = resourceManager->LoadResource(name);
 
     if (resource == nullptr) {
         return nullptr;
     }
 
-    return resource->GetRawPointer();
+    void* data = resource->GetRawPointer();
+    if (name != nullptr && data != nullptr) {
+        ResourceDataCacheInsert(cache, resourceManager.get(), generation, name, data);
+    }
+
+    return data;
 }
 
 void* ResourceGetDataByCrc(uint64_t crc) {
@@ -175,6 +270,7 @@ void ResourceDirtyByName(const char* name) {
 
     if (resource != nullptr) {
         resource->Dirty();
+        Ship::Context::GetInstance()->GetResourceManager()->InvalidateCacheGeneration();
     }
 }
 
@@ -183,6 +279,7 @@ void ResourceDirtyByCrc(uint64_t crc) {
 
     if (resource != nullptr) {
         resource->Dirty();
+        Ship::Context::GetInstance()->GetResourceManager()->InvalidateCacheGeneration();
     }
 }
 
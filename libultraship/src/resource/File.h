@@ -34,5 +34,23 @@ struct File {
     std::shared_ptr<std::vector<char>> Buffer;
     std::variant<std::shared_ptr<tinyxml2::XMLDocument>, std::shared_ptr<BinaryReader>> Reader;
     bool IsLoaded = false;
+    // Set instead of Buffer when the contents are read in place, out of a memory mapped archive or past the resource
+    // header of the file. DataOwner keeps that memory alive.
+    char* Data = nullptr;
+    size_t DataSize = 0;
+    std::shared_ptr<void> DataOwner;
+    // The data is part of memory shared with other files, like a mapped fast pack, and is read only. Resources copy
+    // what they hand out writable pointers to.
+    bool IsShared = false;
+
+    char* GetData() {
+        return DataOwner != nullptr ? Data : Buffer->data();
+    }
+    size_t GetSize() {
+        return DataOwner != nullptr ? DataSize : Buffer->size();
+    }
+    std::shared_ptr<void> GetOwner() {
+        return DataOwner != nullptr ? DataOwner : Buffer;
+    }
 };
 } // namespace Ship
@@ -20,4 +20,8 @@ void IResource::Dirty() {
 std::shared_ptr<ResourceInitData> IResource::GetInitData() {
     return mInitData;
 }
+
+size_t IResource::GetResidentSize() {
+    return GetPointerSize();
+}
 } // namespace Ship
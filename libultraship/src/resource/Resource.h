@@ -14,6 +14,9 @@ class IResource {
 
     virtual void* GetRawPointer() = 0;
     virtual size_t GetPointerSize() = 0;
+    // Bytes the resource keeps in memory, which is what the resource manager counts against its cache budget. Types
+    // that own more than GetPointerSize covers override it.
+    virtual size_t GetResidentSize();
 
     bool IsDirty();
     void Dirty();
@@ -85,10 +85,10 @@ std::shared_ptr<ResourceFactory> ResourceLoader::GetFactory(uint32_t format, std
 std::shared_ptr<ResourceInitData> ResourceLoader::ReadResourceInitDataLegacy(const std::string& filePath,
                                                                              std::shared_ptr<File> fileToLoad) {
     // Determine if file is binary or XML...
-    if (fileToLoad->Buffer->at(0) == '<') {
+    if (fileToLoad->GetSize() > 0 && fileToLoad->GetData()[0] == '<') {
         // File is XML
         // Read the xml document
-        auto stream = std::make_shared<MemoryStream>(fileToLoad->Buffer);
+        auto stream = CreateStream(fileToLoad);
         auto binaryReader = std::make_shared<BinaryReader>(stream);
 
         auto xmlReader = std::make_shared<tinyxml2::XMLDocument>();
@@ -100,31 +100,35 @@ std::shared_ptr<ResourceInitData> ResourceLoader::ReadResourceInitDataLegacy(con
         }
         return ReadResourceInitDataXml(filePath, xmlReader);
     } else {
-        auto headerBuffer = std::make_shared<std::vector<char>>(fileToLoad->Buffer->begin(),
-                                                                fileToLoad->Buffer->begin() + OTR_HEADER_SIZE);
-
-        if (headerBuffer->size() < OTR_HEADER_SIZE) {
+        if (fileToLoad->GetSize() < OTR_HEADER_SIZE) {
             SPDLOG_ERROR("Failed to parse ResourceInitData, buffer size too small. File: {}. Got {} bytes and "
                          "needed {} bytes.",
-                         filePath, headerBuffer->size(), OTR_HEADER_SIZE);
+                         filePath, fileToLoad->GetSize(), OTR_HEADER_SIZE);
             return nullptr;
         }
 
-        // Factories expect the buffer to not include the header,
-        // so we need to remove it from the buffer on the file
-        fileToLoad->Buffer = std::make_shared<std::vector<char>>(fileToLoad->Buffer->begin() + OTR_HEADER_SIZE,
-                                                                 fileToLoad->Buffer->end());
-
         // Create a reader for the header buffer
-        auto headerStream = std::make_shared<MemoryStream>(headerBuffer);
+        auto headerStream = std::make_shared<MemoryStream>(fileToLoad->GetData(), OTR_HEADER_SIZE,
+                                                           fileToLoad->GetOwner());
+
+        // Factories expect the file to not include the header, it is skipped in place instead of copying the rest
+        fileToLoad->DataOwner = fileToLoad->GetOwner();
+        fileToLoad->Data = fileToLoad->GetData() + OTR_HEADER_SIZE;
+        fileToLoad->DataSize = fileToLoad->GetSize() - OTR_HEADER_SIZE;
+        fileToLoad->Buffer = nullptr;
+
         auto headerReader = std::make_shared<BinaryReader>(headerStream);
         return ReadResourceInitDataBinary(filePath, headerReader);
     }
 }
 
+std::shared_ptr<MemoryStream> ResourceLoader::CreateStream(std::shared_ptr<File> fileToLoad) {
+    return std::make_shared<MemoryStream>(fileToLoad->GetData(), fileToLoad->GetSize(), fileToLoad->GetOwner());
+}
+
 std::shared_ptr<BinaryReader> ResourceLoader::CreateBinaryReader(std::shared_ptr<File> fileToLoad,
                                                                  std::shared_ptr<ResourceInitData> initData) {
-    auto stream = std::make_shared<MemoryStream>(fileToLoad->Buffer);
+    auto stream = CreateStream(fileToLoad);
     auto reader = std::make_shared<BinaryReader>(stream);
     reader->SetEndianness(initData->ByteOrder);
     return reader;
@@ -132,7 +136,7 @@ std::shared_ptr<BinaryReader> ResourceLoader::CreateBinaryReader(std::shared_ptr
 
 std::shared_ptr<tinyxml2::XMLDocument> ResourceLoader::CreateXMLReader(std::shared_ptr<File> fileToLoad,
                                                                        std::shared_ptr<ResourceInitData> initData) {
-    auto stream = std::make_shared<MemoryStream>(fileToLoad->Buffer);
+    auto stream = CreateStream(fileToLoad);
     auto binaryReader = std::make_shared<BinaryReader>(stream);
 
     auto xmlReader = std::make_shared<tinyxml2::XMLDocument>();
@@ -164,7 +168,7 @@ std::shared_ptr<ResourceInitData> ResourceLoader::ReadResourceInitData(const std
     // just using metaFileToLoad->Buffer->data() leads to garbage at the end
     // that causes nlohmann to fail parsing, following the pattern used for
     // xml resolves that issue
-    auto stream = std::make_shared<MemoryStream>(metaFileToLoad->Buffer);
+    auto stream = CreateStream(metaFileToLoad);
     auto binaryReader = std::make_shared<BinaryReader>(stream);
     auto parsed = nlohmann::json::parse(binaryReader->ReadCString());
 
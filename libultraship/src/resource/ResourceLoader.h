@@ -8,6 +8,7 @@
 
 namespace Ship {
 struct File;
+class MemoryStream;
 
 struct ResourceFactoryKey {
     uint32_t resourceFormat;
@@ -54,6 +55,7 @@ class ResourceLoader {
                                                                      std::shared_ptr<tinyxml2::XMLDocument> document);
     static std::shared_ptr<ResourceInitData> ReadResourceInitDataPng(const std::string& filePath,
                                                                      std::shared_ptr<BinaryReader> headerReader);
+    static std::shared_ptr<MemoryStream> CreateStream(std::shared_ptr<File> fileToLoad);
     std::shared_ptr<BinaryReader> CreateBinaryReader(std::shared_ptr<File> fileToLoad,
                                                      std::shared_ptr<ResourceInitData> initData);
     std::shared_ptr<tinyxml2::XMLDocument> CreateXMLReader(std::shared_ptr<File> fileToLoad,
@@ -2,7 +2,9 @@
 #include <spdlog/spdlog.h>
 #include "resource/File.h"
 #include "resource/archive/Archive.h"
+#include "resource/archive/ArchiveIndexCache.h"
 #include <algorithm>
+#include <chrono>
 #include <thread>
 #include "utils/StringHelper.h"
 #include "utils/Utils.h"
@@ -11,6 +13,21 @@
 
 namespace Ship {
 
+// Resource loads under way on this thread. Only the outermost one goes to the load observer, the ones nested in it are
+// a factory loading what the resource refers to, or a load running on a pool thread.
+static thread_local uint32_t sLoadDepth = 0;
+// Files this thread read and turned into resources, tells the observer whether the caller waited for a load
+static thread_local uint64_t sFilesLoaded = 0;
+
+struct LoadDepthGuard {
+    LoadDepthGuard() {
+        sLoadDepth++;
+    }
+    ~LoadDepthGuard() {
+        sLoadDepth--;
+    }
+};
+
 ResourceFilter::ResourceFilter(const std::list<std::string>& includeMasks, const std::list<std::string>& excludeMasks,
                                const uintptr_t owner, const std::shared_ptr<Archive> parent)
     : IncludeMasks(includeMasks), ExcludeMasks(excludeMasks), Owner(owner), Parent(parent) {
@@ -48,13 +65,19 @@ ResourceManager::ResourceManager() {
 void ResourceManager::Init(const std::vector<std::string>& archivePaths,
                            const std::unordered_set<uint32_t>& validHashes, int32_t reservedThreadCount) {
     mResourceLoader = std::make_shared<ResourceLoader>();
-    mArchiveManager = std::make_shared<ArchiveManager>();
-    GetArchiveManager()->Init(archivePaths, validHashes);
 
     // the extra `- 1` is because we reserve an extra thread for spdlog
     size_t threadCount = std::max(1, (int32_t)(std::thread::hardware_concurrency() - reservedThreadCount - 1));
     mThreadPool = std::make_shared<BS::thread_pool>(threadCount);
 
+    mArchiveManager = std::make_shared<ArchiveManager>();
+    // Without a context, as in the archive benchmarks, there is no app directory to keep the cache in
+    if (Context::GetInstance() != nullptr) {
+        GetArchiveManager()->SetIndexCache(
+            std::make_shared<ArchiveIndexCache>(Context::GetPathRelativeToAppDirectory("archive_index.cache")));
+    }
+    GetArchiveManager()->Init(archivePaths, validHashes, mThreadPool.get());
+
     if (!IsLoaded()) {
         // Nothing ever unpauses the thread pool since nothing will ever try to load the archive again.
         mThreadPool->pause();
@@ -95,17 +118,32 @@ std::shared_ptr<File> ResourceManager::LoadFileProcess(const ResourceIdentifier&
 
 std::shared_ptr<IResource> ResourceManager::LoadResourceProcess(const ResourceIdentifier& identifier, bool loadExact,
                                                                 std::shared_ptr<ResourceInitData> initData) {
+    if (!mLoadObserver || sLoadDepth > 0) {
+        return LoadResourceUnobserved(identifier, loadExact, initData);
+    }
+
+    const uint64_t filesLoaded = sFilesLoaded;
+    auto resource = LoadResourceUnobserved(identifier, loadExact, initData);
+    mLoadObserver(identifier.Path, sFilesLoaded != filesLoaded);
+    return resource;
+}
+
+std::shared_ptr<IResource> ResourceManager::LoadResourceUnobserved(const ResourceIdentifier& identifier, bool loadExact,
+                                                                   std::shared_ptr<ResourceInitData> initData) {
+    LoadDepthGuard depthGuard;
+
     // Check for and remove the OTR signature
     if (OtrSignatureCheck(identifier.Path.c_str())) {
         const auto newFilePath = identifier.Path.substr(7);
-        return LoadResourceProcess({ newFilePath, identifier.Owner, identifier.Parent }, false, initData);
+        return LoadResourceUnobserved({ newFilePath, identifier.Owner, identifier.Parent }, false, initData);
     }
 
     // Attempt to load the alternate version of the asset, if we fail then we continue trying to load the standard
     // asset.
     if (!loadExact && mAltAssetsEnabled && !identifier.Path.starts_with(IResource::gAltAssetPrefix)) {
         const auto altPath = IResource::gAltAssetPrefix + identifier.Path;
-        auto altResource = LoadResourceProcess({ altPath, identifier.Owner, identifier.Parent }, loadExact, initData);
+        auto altResource =
+            LoadResourceUnobserved({ altPath, identifier.Owner, identifier.Parent }, loadExact, initData);
 
         if (altResource != nullptr) {
             return altResource;
@@ -138,10 +176,13 @@ std::shared_ptr<IResource> ResourceManager::LoadResourceProcess(const ResourceId
     }
 
     // Get the file from the OTR
+    mCacheMisses++;
+    sFilesLoaded++;
     auto file = LoadFileProcess(identifier.Path);
     if (file == nullptr) {
         SPDLOG_TRACE("Failed to load resource file at path {}", identifier.Path);
-        mResourceCache[identifier] = ResourceLoadError::NotFound;
+        const std::lock_guard<std::mutex> lock(mMutex);
+        SetCacheEntry(identifier, ResourceLoadError::NotFound);
         return nullptr;
     }
 
@@ -163,9 +204,9 @@ std::shared_ptr<IResource> ResourceManager::LoadResourceProcess(const ResourceId
 
         // Set the cache to the loaded resource
         if (resource != nullptr) {
-            mResourceCache[identifier] = resource;
+            SetCacheEntry(identifier, resource);
         } else {
-            mResourceCache[identifier] = ResourceLoadError::NotFound;
+            SetCacheEntry(identifier, ResourceLoadError::NotFound);
         }
     }
 
@@ -202,7 +243,7 @@ ResourceManager::LoadResourceAsync(const ResourceIdentifier& identifier, bool lo
 
     return mThreadPool->submit_task(
         [this, identifier, loadExact, initData]() -> std::shared_ptr<IResource> {
-            return LoadResourceProcess(identifier, loadExact, initData);
+            return LoadResourceUnobserved(identifier, loadExact, initData);
         },
         priority);
 }
@@ -215,7 +256,11 @@ ResourceManager::LoadResourceAsync(const std::string& filePath, bool loadExact,
 
 std::shared_ptr<IResource> ResourceManager::LoadResource(const ResourceIdentifier& identifier, bool loadExact,
                                                          std::shared_ptr<ResourceInitData> initData) {
-    auto resource = LoadResourceAsync(identifier, loadExact, BS::pr::highest, initData).get();
+    auto future = LoadResourceAsync(identifier, loadExact, BS::pr::highest, initData);
+    if (mLoadObserver && sLoadDepth == 0) {
+        mLoadObserver(identifier.Path, future.wait_for(std::chrono::seconds(0)) != std::future_status::ready);
+    }
+    auto resource = future.get();
     if (resource == nullptr) {
         SPDLOG_TRACE("Failed to load resource file at path {}", identifier.Path);
     }
@@ -247,7 +292,24 @@ ResourceManager::CheckCache(const ResourceIdentifier& identifier, bool loadExact
         return ResourceLoadError::NotCached;
     }
 
-    return cacheFind->second;
+    if (std::holds_alternative<std::shared_ptr<IResource>>(cacheFind->second.Value)) {
+        cacheFind->second.LastUse = ++mUseClock;
+        mCacheHits++;
+    }
+    return cacheFind->second.Value;
+}
+
+void ResourceManager::SetCacheEntry(const ResourceIdentifier& identifier,
+                                    std::variant<ResourceLoadError, std::shared_ptr<IResource>> value) {
+    auto& entry = mResourceCache[identifier];
+    mCacheResidentBytes -= entry.Size;
+    entry.Size = 0;
+    if (std::holds_alternative<std::shared_ptr<IResource>>(value)) {
+        entry.Size = std::get<std::shared_ptr<IResource>>(value)->GetResidentSize();
+    }
+    mCacheResidentBytes += entry.Size;
+    entry.Value = std::move(value);
+    entry.LastUse = ++mUseClock;
 }
 
 std::variant<ResourceManager::ResourceLoadError, std::shared_ptr<IResource>>
@@ -339,6 +401,7 @@ void ResourceManager::DirtyResources(const ResourceFilter& filter) {
                 UnloadResource({ key, filter.Owner, filter.Parent });
             }
         }
+        InvalidateCacheGeneration();
     });
 }
 
@@ -387,7 +450,13 @@ size_t ResourceManager::UnloadResource(const ResourceIdentifier& identifier) {
     // We can only erase the resource if we have any resources for that owner.
     if (mResourceCache.contains(identifier)) {
         const std::lock_guard<std::mutex> lock(mMutex);
-        mResourceCache.erase(identifier);
+        auto cacheFind = mResourceCache.find(identifier);
+        if (cacheFind != mResourceCache.end()) {
+            mCacheResidentBytes -= cacheFind->second.Size;
+            value = std::move(cacheFind->second.Value);
+            mResourceCache.erase(cacheFind);
+        }
+        InvalidateCacheGeneration();
     }
 
     return ret;
@@ -406,8 +475,129 @@ bool ResourceManager::IsAltAssetsEnabled() {
     return mAltAssetsEnabled;
 }
 
-void ResourceManager::SetAltAssetsEnabled(bool isEnabled) {
-    mAltAssetsEnabled = isEnabled;
+std::vector<std::shared_ptr<IResource>> ResourceManager::SetAltAssetsEnabled(bool isEnabled) {
+    std::vector<std::shared_ptr<IResource>> replaced;
+    if (mAltAssetsEnabled == isEnabled) {
+        return replaced;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mAltAssetsEnabled = isEnabled;
+        for (const auto& [identifier, entry] : mResourceCache) {
+            const auto* resource = std::get_if<std::shared_ptr<IResource>>(&entry.Value);
+            if (resource == nullptr || *resource == nullptr) {
+                continue;
+            }
+
+            // Turning them on replaces the standard resources that have an alternate version, turning them off
+            // replaces every alternate one
+            const bool isAlt = identifier.Path.starts_with(IResource::gAltAssetPrefix);
+            if (isEnabled ? !isAlt && mArchiveManager->HasAltFile(identifier.Path) : isAlt) {
+                replaced.push_back(*resource);
+            }
+        }
+    }
+
+    // The bridge asks again for the data of every resource, and gets the other version of those that have one
+    InvalidateCacheGeneration();
+    SPDLOG_DEBUG("Alternate assets {}, {} cached resources replaced", isEnabled ? "enabled" : "disabled",
+                 replaced.size());
+    return replaced;
+}
+
+uint32_t ResourceManager::GetCacheGeneration() {
+    return mCacheGeneration.load(std::memory_order_acquire) + mArchiveManager->GetGeneration();
+}
+
+void ResourceManager::InvalidateCacheGeneration() {
+    mCacheGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void ResourceManager::SetLoadObserver(std::function<void(const std::string& path, bool waited)> observer) {
+    // The loads read it without a lock, replacing it could race with a load on another thread
+    if (mLoadObserver) {
+        SPDLOG_ERROR("The resource load observer can only be set once");
+        return;
+    }
+    mLoadObserver = observer;
+}
+
+void ResourceManager::SetCacheBudget(size_t bytes) {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    if (mCacheBudget != bytes) {
+        mCacheBudget = bytes;
+        mEvictionRetryBytes = 0;
+    }
+}
+
+void ResourceManager::SetEvictableResourceTypes(const std::unordered_set<uint32_t>& types) {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    mEvictableTypes = types;
+    mEvictionRetryBytes = 0;
+}
+
+void ResourceManager::BeginCacheEpoch() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    mEpochStart = mUseClock + 1;
+    mEvictionRetryBytes = 0;
+}
+
+std::vector<std::shared_ptr<IResource>> ResourceManager::EvictResources() {
+    std::vector<std::shared_ptr<IResource>> evicted;
+    const std::lock_guard<std::mutex> lock(mMutex);
+    if (!IsOverCacheBudgetLocked()) {
+        return evicted;
+    }
+
+    // Down to 7/8 of the budget, so a cache that is just over it does not evict a few resources every frame
+    const size_t target = mCacheBudget - mCacheBudget / 8;
+    std::vector<std::pair<uint64_t, decltype(mResourceCache)::iterator>> candidates;
+    for (auto it = mResourceCache.begin(); it != mResourceCache.end(); ++it) {
+        const auto* resource = std::get_if<std::shared_ptr<IResource>>(&it->second.Value);
+        if (resource == nullptr || *resource == nullptr || it->second.LastUse >= mEpochStart ||
+            resource->use_count() > 1 || (*resource)->GetInitData() == nullptr ||
+            !mEvictableTypes.contains((*resource)->GetInitData()->Type)) {
+            continue;
+        }
+        candidates.emplace_back(it->second.LastUse, it);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (auto& [lastUse, it] : candidates) {
+        if (mCacheResidentBytes <= target) {
+            break;
+        }
+        mCacheResidentBytes -= it->second.Size;
+        evicted.push_back(std::get<std::shared_ptr<IResource>>(it->second.Value));
+        mResourceCache.erase(it);
+    }
+
+    if (mCacheResidentBytes > mCacheBudget) {
+        // Everything else is pinned or in use, try again once the cache grew by another 1/16 of the budget
+        mEvictionRetryBytes = mCacheResidentBytes + mCacheBudget / 16;
+    }
+    if (!evicted.empty()) {
+        mCacheEvictions += evicted.size();
+        InvalidateCacheGeneration();
+        SPDLOG_DEBUG("Evicted {} resources, {} bytes of resources are cached", evicted.size(), mCacheResidentBytes);
+    }
+    return evicted;
+}
+
+bool ResourceManager::IsOverCacheBudget() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return IsOverCacheBudgetLocked();
+}
+
+bool ResourceManager::IsOverCacheBudgetLocked() {
+    return mCacheBudget != 0 && mCacheResidentBytes > std::max(mCacheBudget, mEvictionRetryBytes);
+}
+
+ResourceCacheStats ResourceManager::GetCacheStats() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return { mCacheHits, mCacheMisses, mCacheEvictions, mCacheResidentBytes, mCacheBudget };
 }
 
 } // namespace Ship
@@ -6,8 +6,10 @@
 #include <list>
 #include <vector>
 #include <mutex>
+#include <atomic>
 #include <queue>
 #include <variant>
+#include <functional>
 #include "resource/Resource.h"
 #include "resource/ResourceLoader.h"
 #include "resource/archive/Archive.h"
@@ -51,6 +53,17 @@ struct ResourceIdentifierHash {
     size_t operator()(const ResourceIdentifier& rcd) const;
 };
 
+struct ResourceCacheStats {
+    // Lookups that found the resource cached
+    uint64_t Hits;
+    // Resources that had to be loaded from the archives
+    uint64_t Misses;
+    uint64_t Evictions;
+    size_t ResidentBytes;
+    // 0 if there is none
+    size_t BudgetBytes;
+};
+
 class ResourceManager {
     friend class ResourceLoader;
     typedef enum class ResourceLoadError { None, NotCached, NotFound } ResourceLoadError;
@@ -101,7 +114,34 @@ class ResourceManager {
 
     bool OtrSignatureCheck(const char* fileName);
     bool IsAltAssetsEnabled();
-    void SetAltAssetsEnabled(bool isEnabled);
+    // Returns the cached resources the game no longer gets, those of the paths that have an alternate version. The
+    // caller drops whatever refers to them, like textures uploaded from their data. They stay cached for switching
+    // back, everything else is unaffected.
+    std::vector<std::shared_ptr<IResource>> SetAltAssetsEnabled(bool isEnabled);
+    // Changes whenever a previously returned resource may have been replaced or released, so callers holding on to
+    // raw data pointers know to look them up again.
+    uint32_t GetCacheGeneration();
+    void InvalidateCacheGeneration();
+    // Called by LoadResource and LoadResourceProcess with every path they are asked for, from whichever thread asked,
+    // and whether the caller had to wait for the resource to load. Loads nested in another load are not reported. Set
+    // it once, before any thread loads resources. It stays set for the lifetime of the manager, an observer that is
+    // done has to ignore the calls that follow.
+    void SetLoadObserver(std::function<void(const std::string& path, bool waited)> observer);
+    // Bytes of cached resources, as reported by IResource::GetResidentSize, that EvictResources brings the cache back
+    // under. 0 keeps everything, which is the default.
+    void SetCacheBudget(size_t bytes);
+    // Resource types EvictResources may drop. Resources of other types are counted against the budget but stay.
+    void SetEvictableResourceTypes(const std::unordered_set<uint32_t>& types);
+    // Pins every resource used from now on until the next call. The game calls it when a scene starts, so nothing
+    // the scene uses is evicted while it runs.
+    void BeginCacheEpoch();
+    // Drops the least recently used evictable resources until the cache is under its budget again. Pinned resources
+    // and those anything besides the cache holds on to are skipped. Returns the evicted resources, so the caller can
+    // drop whatever refers to them, like textures uploaded from their data, before they are freed.
+    std::vector<std::shared_ptr<IResource>> EvictResources();
+    // Whether EvictResources would evict anything
+    bool IsOverCacheBudget();
+    ResourceCacheStats GetCacheStats();
     std::shared_ptr<File> LoadFileProcess(const ResourceIdentifier& identifier);
     std::shared_ptr<File> LoadFileProcess(const std::string& filePath);
 
@@ -116,14 +156,41 @@ class ResourceManager {
     std::shared_ptr<IResource> GetCachedResource(std::variant<ResourceLoadError, std::shared_ptr<IResource>> cacheLine);
 
   private:
-    std::unordered_map<ResourceIdentifier, std::variant<ResourceLoadError, std::shared_ptr<IResource>>,
-                       ResourceIdentifierHash>
-        mResourceCache;
+    struct CacheEntry {
+        std::variant<ResourceLoadError, std::shared_ptr<IResource>> Value;
+        size_t Size = 0;
+        // mUseClock at the last lookup that found the resource
+        uint64_t LastUse = 0;
+    };
+
+    // LoadResourceProcess without telling the load observer
+    std::shared_ptr<IResource> LoadResourceUnobserved(const ResourceIdentifier& identifier, bool loadExact,
+                                                      std::shared_ptr<ResourceInitData> initData);
+    // Callers must hold mMutex
+    void SetCacheEntry(const ResourceIdentifier& identifier,
+                       std::variant<ResourceLoadError, std::shared_ptr<IResource>> value);
+    // Callers must hold mMutex
+    bool IsOverCacheBudgetLocked();
+
+    std::unordered_map<ResourceIdentifier, CacheEntry, ResourceIdentifierHash> mResourceCache;
     std::shared_ptr<ResourceLoader> mResourceLoader;
     std::shared_ptr<ArchiveManager> mArchiveManager;
     std::shared_ptr<BS::thread_pool> mThreadPool;
     std::mutex mMutex;
     bool mAltAssetsEnabled = false;
+    std::atomic<uint32_t> mCacheGeneration = 0;
+    std::function<void(const std::string& path, bool waited)> mLoadObserver;
+    // Everything below is guarded by mMutex, except for the counters
+    std::unordered_set<uint32_t> mEvictableTypes;
+    size_t mCacheBudget = 0;
+    size_t mCacheResidentBytes = 0;
+    uint64_t mUseClock = 0;
+    uint64_t mEpochStart = 0;
+    // After an eviction that could not get under the budget, the next one waits until the cache grew past this
+    size_t mEvictionRetryBytes = 0;
+    std::atomic<uint64_t> mCacheHits = 0;
+    std::atomic<uint64_t> mCacheMisses = 0;
+    std::atomic<uint64_t> mCacheEvictions = 0;
     // Private information for which owner and archive are default.
     uintptr_t mDefaultCacheOwner = 0;
     std::shared_ptr<Archive> mDefaultCacheArchive = nullptr;
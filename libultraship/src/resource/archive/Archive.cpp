@@ -4,6 +4,7 @@
 
 #include "Context.h"
 #include "resource/File.h"
+#include "resource/archive/ArchiveIndexCache.h"
 #include "resource/ResourceLoader.h"
 #include "resource/ResourceType.h"
 #include "utils/binarytools/MemoryStream.h"
@@ -31,29 +32,75 @@ void Archive::Load() {
     bool opened = Open();
 
     auto t = LoadFile("version");
-    bool isGameVersionValid = false;
     if (t != nullptr && t->IsLoaded) {
         mHasGameVersion = true;
-        auto stream = std::make_shared<MemoryStream>(t->Buffer->data(), t->Buffer->size());
+        auto stream = std::make_shared<MemoryStream>(t->GetData(), t->GetSize(), t->GetOwner());
         auto reader = std::make_shared<BinaryReader>(stream);
         Endianness endianness = (Endianness)reader->ReadUByte();
         reader->SetEndianness(endianness);
         SetGameVersion(reader->ReadUInt32());
-        isGameVersionValid =
-            Context::GetInstance()->GetResourceManager()->GetArchiveManager()->IsGameVersionValid(GetGameVersion());
+    }
+
+    SetLoaded(opened && IsGameVersionAllowed());
 
-        if (!isGameVersionValid) {
-            SPDLOG_WARN("Attempting to load Archive \"{}\" with invalid version {}", GetPath(), GetGameVersion());
-        }
+    if (!IsLoaded()) {
+        Unload();
     }
+}
 
-    SetLoaded(opened && (!mHasGameVersion || isGameVersionValid));
+void Archive::Load(const ArchiveIndex& index) {
+    if (!OpenFromIndex(index)) {
+        Load();
+        return;
+    }
+
+    mHasGameVersion = index.HasGameVersion;
+    if (mHasGameVersion) {
+        SetGameVersion(index.GameVersion);
+    }
+
+    SetLoaded(IsGameVersionAllowed());
 
     if (!IsLoaded()) {
         Unload();
     }
 }
 
+bool Archive::IsGameVersionAllowed() {
+    if (!mHasGameVersion) {
+        return true;
+    }
+
+    // Without a context, as in the archive benchmarks, there are no valid versions to check against
+    auto context = Context::GetInstance();
+    const bool isGameVersionValid =
+        context == nullptr || context->GetResourceManager()->GetArchiveManager()->IsGameVersionValid(GetGameVersion());
+
+    if (!isGameVersionValid) {
+        SPDLOG_WARN("Attempting to load Archive \"{}\" with invalid version {}", GetPath(), GetGameVersion());
+    }
+    return isGameVersionValid;
+}
+
+bool Archive::SaveIndex(ArchiveIndex& index) {
+    if (!SaveIndexData(index.Data)) {
+        return false;
+    }
+
+    index.HasGameVersion = mHasGameVersion;
+    index.GameVersion = mGameVersion;
+    index.Files.assign(mHashes->begin(), mHashes->end());
+    return true;
+}
+
+bool Archive::OpenFromIndex(const ArchiveIndex& index) {
+    return false;
+}
+
+bool Archive::SaveIndexData(std::vector<uint8_t>& data) {
+    return false;
+}
+
 void Archive::Unload() {
     Close();
     SetLoaded(false);
@@ -115,6 +162,10 @@ void Archive::IndexFile(const std::string& filePath) {
     (*mHashes)[CRC64(filePath.c_str())] = filePath;
 }
 
+void Archive::IndexFile(uint64_t hash, const std::string& filePath) {
+    (*mHashes)[hash] = filePath;
+}
+
 std::shared_ptr<File> Archive::LoadFile(uint64_t hash) {
     const std::string& filePath =
         *Context::GetInstance()->GetResourceManager()->GetArchiveManager()->HashToString(hash);
@@ -16,6 +16,7 @@ namespace Ship {
 
 struct File;
 struct ResourceInitData;
+struct ArchiveIndex;
 
 class Archive : public std::enable_shared_from_this<Archive> {
     friend class ArchiveManager;
@@ -27,7 +28,12 @@ class Archive : public std::enable_shared_from_this<Archive> {
     bool operator==(const Archive& rhs) const;
 
     void Load();
+    // Loads the archive from an index an earlier load saved with SaveIndex instead of reading it, or reads it after
+    // all if its type can not load that way
+    void Load(const ArchiveIndex& index);
     void Unload();
+    // Fills in what loading the archive found out about it. Returns false if its type can not be loaded from an index.
+    bool SaveIndex(ArchiveIndex& index);
 
     virtual std::shared_ptr<File> LoadFile(const std::string& filePath) = 0;
     virtual std::shared_ptr<File> LoadFile(uint64_t hash) = 0;
@@ -48,8 +54,16 @@ class Archive : public std::enable_shared_from_this<Archive> {
     void SetLoaded(bool isLoaded);
     void SetGameVersion(uint32_t gameVersion);
     void IndexFile(const std::string& filePath);
+    // For paths hashed before, by an earlier load
+    void IndexFile(uint64_t hash, const std::string& filePath);
+    // Opens the archive with the files in index and the data the type saved there with SaveIndexData. The default
+    // returns false, the archive is then opened with Open.
+    virtual bool OpenFromIndex(const ArchiveIndex& index);
+    virtual bool SaveIndexData(std::vector<uint8_t>& data);
 
   private:
+    bool IsGameVersionAllowed();
+
     bool mIsLoaded;
     bool mHasGameVersion;
     uint32_t mGameVersion;
@@ -0,0 +1,197 @@
+#include "ArchiveIndexCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+#include "spdlog/spdlog.h"
+
+namespace Ship {
+static constexpr char CACHE_MAGIC[8] = { 'S', 'H', 'I', 'P', 'I', 'D', 'X', 'C' };
+static constexpr uint32_t CACHE_VERSION = 1;
+
+static bool GetFileStamp(const std::string& path, uint64_t& size, int64_t& modifiedTime) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    modifiedTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    return !error;
+}
+
+template <typename T> static void Put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void PutString(std::string& out, const std::string& value) {
+    Put<uint32_t>(out, value.size());
+    out += value;
+}
+
+// Reads back what Put wrote, every read past the end fails the whole cache
+struct CacheReader {
+    const char* Pos;
+    const char* End;
+    bool Failed = false;
+
+    template <typename T> T Get() {
+        T value = {};
+        if (End - Pos < (ptrdiff_t)sizeof(T)) {
+            Failed = true;
+            return value;
+        }
+        memcpy(&value, Pos, sizeof(T));
+        Pos += sizeof(T);
+        return value;
+    }
+
+    std::string GetString() {
+        const uint32_t size = Get<uint32_t>();
+        if (Failed || (size_t)(End - Pos) < size) {
+            Failed = true;
+            return "";
+        }
+        std::string value(Pos, size);
+        Pos += size;
+        return value;
+    }
+};
+
+ArchiveIndexCache::ArchiveIndexCache(const std::string& cachePath) : mCachePath(cachePath) {
+    Read();
+}
+
+void ArchiveIndexCache::Read() {
+    std::ifstream stream(mCachePath, std::ios::binary);
+    if (!stream) {
+        return;
+    }
+    const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    CacheReader reader = { data.data(), data.data() + data.size() };
+    char magic[sizeof(CACHE_MAGIC)];
+    for (char& c : magic) {
+        c = reader.Get<char>();
+    }
+    if (memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || reader.Get<uint32_t>() != CACHE_VERSION) {
+        SPDLOG_INFO("Archive index cache \"{}\" is from another version, rebuilding it", mCachePath);
+        return;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<ArchiveIndex>> indices;
+    const uint32_t archiveCount = reader.Get<uint32_t>();
+    for (uint32_t i = 0; i < archiveCount && !reader.Failed; i++) {
+        const std::string archivePath = reader.GetString();
+        auto index = std::make_shared<ArchiveIndex>();
+        index->Size = reader.Get<uint64_t>();
+        index->ModifiedTime = reader.Get<int64_t>();
+        index->HasGameVersion = reader.Get<uint8_t>() != 0;
+        index->GameVersion = reader.Get<uint32_t>();
+
+        const uint32_t fileCount = reader.Get<uint32_t>();
+        if (reader.Failed || fileCount > (size_t)(reader.End - reader.Pos) / (sizeof(uint64_t) + sizeof(uint32_t))) {
+            reader.Failed = true;
+            break;
+        }
+        index->Files.reserve(fileCount);
+        for (uint32_t file = 0; file < fileCount && !reader.Failed; file++) {
+            const uint64_t hash = reader.Get<uint64_t>();
+            index->Files.emplace_back(hash, reader.GetString());
+        }
+
+        const std::string archiveData = reader.GetString();
+        index->Data.assign(archiveData.begin(), archiveData.end());
+        indices[archivePath] = index;
+    }
+
+    if (reader.Failed) {
+        SPDLOG_WARN("Archive index cache \"{}\" is damaged, rebuilding it", mCachePath);
+        return;
+    }
+    mIndices = std::move(indices);
+}
+
+std::shared_ptr<const ArchiveIndex> ArchiveIndexCache::Find(const std::string& archivePath) {
+    uint64_t size;
+    int64_t modifiedTime;
+    if (!GetFileStamp(archivePath, size, modifiedTime)) {
+        return nullptr;
+    }
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mIndices.find(archivePath);
+    if (it == mIndices.end() || it->second->Size != size || it->second->ModifiedTime != modifiedTime) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void ArchiveIndexCache::Store(const std::string& archivePath, std::shared_ptr<ArchiveIndex> index) {
+    if (!GetFileStamp(archivePath, index->Size, index->ModifiedTime)) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+    mIndices[archivePath] = index;
+    mDirty = true;
+}
+
+void ArchiveIndexCache::Retain(const std::vector<std::string>& archivePaths) {
+    const std::unordered_set<std::string> retained(archivePaths.begin(), archivePaths.end());
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+    for (auto it = mIndices.begin(); it != mIndices.end();) {
+        if (retained.contains(it->first)) {
+            ++it;
+        } else {
+            it = mIndices.erase(it);
+            mDirty = true;
+        }
+    }
+}
+
+bool ArchiveIndexCache::Save() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    if (!mDirty) {
+        return true;
+    }
+
+    std::string data(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    Put<uint32_t>(data, CACHE_VERSION);
+    Put<uint32_t>(data, mIndices.size());
+    for (const auto& [archivePath, index] : mIndices) {
+        PutString(data, archivePath);
+        Put<uint64_t>(data, index->Size);
+        Put<int64_t>(data, index->ModifiedTime);
+        Put<uint8_t>(data, index->HasGameVersion);
+        Put<uint32_t>(data, index->GameVersion);
+        Put<uint32_t>(data, index->Files.size());
+        for (const auto& [hash, path] : index->Files) {
+            Put<uint64_t>(data, hash);
+            PutString(data, path);
+        }
+        PutString(data, std::string(index->Data.begin(), index->Data.end()));
+    }
+
+    // Written next to it and moved over it once complete, a cache that exists is never half written
+    const std::string tempPath = mCachePath + ".tmp";
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    stream.write(data.data(), data.size());
+    stream.close();
+
+    std::error_code error;
+    if (stream) {
+        std::filesystem::rename(tempPath, mCachePath, error);
+    }
+    if (!stream || error) {
+        SPDLOG_ERROR("Failed to write archive index cache \"{}\"", mCachePath);
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    mDirty = false;
+    return true;
+}
+} // namespace Ship
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Ship {
+
+// What loading an archive found out about it, enough to load it again without reading it
+struct ArchiveIndex {
+    // Of the archive file when the index was made
+    uint64_t Size = 0;
+    int64_t ModifiedTime = 0;
+    bool HasGameVersion = false;
+    uint32_t GameVersion = 0;
+    // Path hash and path of every file, as Archive::ListFiles returns them
+    std::vector<std::pair<uint64_t, std::string>> Files;
+    // Whatever else the archive type needs to read its files, see Archive::SaveIndex
+    std::vector<uint8_t> Data;
+};
+
+// Archive indices kept in one file between starts, so unchanged archives are mounted without enumerating and
+// hashing their files. An index is only used while the archive has the size and modification time it was made at.
+class ArchiveIndexCache {
+  public:
+    ArchiveIndexCache(const std::string& cachePath);
+
+    // Returns the index stored for the archive, or nullptr if there is none or the archive changed since. Safe to
+    // call from several threads, like Store.
+    std::shared_ptr<const ArchiveIndex> Find(const std::string& archivePath);
+    // Stamps the index with the current size and modification time of the archive and keeps it
+    void Store(const std::string& archivePath, std::shared_ptr<ArchiveIndex> index);
+    // Drops the indices of archives that are not in the list
+    void Retain(const std::vector<std::string>& archivePaths);
+    // Writes the cache out if anything changed since it was read
+    bool Save();
+
+  private:
+    void Read();
+
+    std::string mCachePath;
+    std::mutex mMutex;
+    std::unordered_map<std::string, std::shared_ptr<ArchiveIndex>> mIndices;
+    bool mDirty = false;
+};
+} // namespace Ship
@@ -4,11 +4,14 @@
 #include "spdlog/spdlog.h"
 
 #include "resource/archive/Archive.h"
+#include "resource/archive/ArchiveIndexCache.h"
+#include "resource/Resource.h"
 #ifndef EXCLUDE_MPQ_SUPPORT
 #include "resource/archive/OtrArchive.h"
 #endif
 #include "resource/archive/O2rArchive.h"
 #include "resource/archive/FolderArchive.h"
+#include "resource/archive/FastPackArchive.h"
 #include "utils/StringHelper.h"
 #include "utils/glob.h"
 #include "utils/StrHash64.h"
@@ -23,11 +26,45 @@ void ArchiveManager::Init(const std::vector<std::string>& archivePaths) {
 
 void ArchiveManager::Init(const std::vector<std::string>& archivePaths,
                           const std::unordered_set<uint32_t>& validGameVersions) {
+    Init(archivePaths, validGameVersions, nullptr);
+}
+
+void ArchiveManager::Init(const std::vector<std::string>& archivePaths,
+                          const std::unordered_set<uint32_t>& validGameVersions, BS::thread_pool* threadPool) {
     mValidGameVersions = validGameVersions;
     auto archives = GetArchiveListInPaths(archivePaths);
-    for (const auto& archive : archives) {
+
+    std::vector<std::shared_ptr<Archive>> opened(archives.size());
+    if (threadPool != nullptr && archives.size() > 1) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(archives.size());
+        for (size_t i = 0; i < archives.size(); i++) {
+            futures.push_back(threadPool->submit_task([this, &archives, &opened, i]() -> void {
+                opened[i] = OpenArchive(archives[i]);
+            }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    } else {
+        for (size_t i = 0; i < archives.size(); i++) {
+            opened[i] = OpenArchive(archives[i]);
+        }
+    }
+
+    // Later archives override the files of earlier ones, the order has to be the one of the paths
+    for (const auto& archive : opened) {
         AddArchive(archive);
     }
+
+    if (mIndexCache != nullptr) {
+        mIndexCache->Retain(archives);
+        mIndexCache->Save();
+    }
+}
+
+void ArchiveManager::SetIndexCache(std::shared_ptr<ArchiveIndexCache> indexCache) {
+    mIndexCache = indexCache;
 }
 
 ArchiveManager::~ArchiveManager() {
@@ -64,6 +101,10 @@ bool ArchiveManager::HasFile(uint64_t hash) {
     return mFileToArchive.count(hash) > 0;
 }
 
+bool ArchiveManager::HasAltFile(const std::string& filePath) {
+    return mAltFiles.contains(CRC64(filePath.c_str()));
+}
+
 std::shared_ptr<Archive> ArchiveManager::GetArchiveFromFile(const std::string& filePath) {
     return mFileToArchive[CRC64(filePath.c_str())];
 }
@@ -143,6 +184,8 @@ void ArchiveManager::ResetVirtualFileSystem() {
     mGameVersions.clear();
     mHashes.clear();
     mFileToArchive.clear();
+    mAltFiles.clear();
+    mGeneration++;
     for (const auto& archive : archives) {
         archive->Unload();
         archive->Load();
@@ -157,6 +200,7 @@ bool ArchiveManager::WriteFile(std::shared_ptr<Archive> archive, const std::stri
             auto hash = CRC64(filePath.c_str());
             mHashes[hash] = filePath;
             mFileToArchive[hash] = archive;
+            mGeneration++;
             return true; // Successfully wrote file
         }
     }
@@ -225,6 +269,10 @@ std::vector<std::string> ArchiveManager::GetArchiveListInPaths(const std::vector
 }
 
 std::shared_ptr<Archive> ArchiveManager::AddArchive(const std::string& archivePath) {
+    return AddArchive(OpenArchive(archivePath));
+}
+
+std::shared_ptr<Archive> ArchiveManager::OpenArchive(const std::string& archivePath) {
     const std::filesystem::path path = archivePath;
     const std::string extension = path.extension().string();
     std::shared_ptr<Archive> archive = nullptr;
@@ -237,6 +285,8 @@ std::shared_ptr<Archive> ArchiveManager::AddArchive(const std::string& archivePa
     } else if (StringHelper::IEquals(extension, ".otr") || StringHelper::IEquals(extension, ".mpq")) {
         archive = dynamic_pointer_cast<Archive>(std::make_shared<OtrArchive>(archivePath));
 #endif
+    } else if (StringHelper::IEquals(extension, ".fpk")) {
+        archive = dynamic_pointer_cast<Archive>(std::make_shared<FastPackArchive>(archivePath));
     } else if (StringHelper::IEquals(extension, "")) {
         archive = dynamic_pointer_cast<Archive>(std::make_shared<FolderArchive>(archivePath));
     } else {
@@ -245,8 +295,23 @@ std::shared_ptr<Archive> ArchiveManager::AddArchive(const std::string& archivePa
         archive = std::make_shared<O2rArchive>(archivePath);
     }
 
+    if (mIndexCache == nullptr) {
+        archive->Load();
+        return archive;
+    }
+
+    auto index = mIndexCache->Find(archivePath);
+    if (index != nullptr) {
+        archive->Load(*index);
+        return archive;
+    }
+
     archive->Load();
-    return AddArchive(archive);
+    auto newIndex = std::make_shared<ArchiveIndex>();
+    if (archive->IsLoaded() && archive->SaveIndex(*newIndex)) {
+        mIndexCache->Store(archivePath, newIndex);
+    }
+    return archive;
 }
 
 std::shared_ptr<Archive> ArchiveManager::AddArchive(std::shared_ptr<Archive> archive) {
@@ -271,6 +336,9 @@ std::shared_ptr<Archive> ArchiveManager::AddArchive(std::shared_ptr<Archive> arc
     for (auto& [hash, filename] : *fileList.get()) {
         mHashes[hash] = filename;
         mFileToArchive[hash] = archive;
+        if (filename.starts_with(IResource::gAltAssetPrefix)) {
+            mAltFiles.insert(CRC64(filename.c_str() + IResource::gAltAssetPrefix.length()));
+        }
 
         size_t lastSlash = filename.find_last_of('/');
         if (lastSlash != std::string::npos) {
@@ -278,6 +346,7 @@ std::shared_ptr<Archive> ArchiveManager::AddArchive(std::shared_ptr<Archive> arc
             mDirectories.insert(dir);
         }
     }
+    mGeneration++;
     return archive;
 }
 
@@ -285,4 +354,8 @@ bool ArchiveManager::IsGameVersionValid(uint32_t gameVersion) {
     return mValidGameVersions.empty() || mValidGameVersions.contains(gameVersion);
 }
 
+uint32_t ArchiveManager::GetGeneration() {
+    return mGeneration.load(std::memory_order_acquire);
+}
+
 } // namespace Ship
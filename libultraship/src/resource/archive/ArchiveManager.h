@@ -6,20 +6,34 @@
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include <atomic>
 #include <stdint.h>
 #include "resource/File.h"
 
+#define BS_THREAD_POOL_ENABLE_PRIORITY
+#define BS_THREAD_POOL_ENABLE_PAUSE
+#include <BS_thread_pool.hpp>
+
 namespace Ship {
 struct File;
 class Archive;
+class ArchiveIndexCache;
 
 class ArchiveManager {
   public:
     ArchiveManager();
     void Init(const std::vector<std::string>& archivePaths);
     void Init(const std::vector<std::string>& archivePaths, const std::unordered_set<uint32_t>& validGameVersions);
+    // Opens the archives on the thread pool, all at once, then adds them in the order of the paths as if they were
+    // opened one after the other
+    void Init(const std::vector<std::string>& archivePaths, const std::unordered_set<uint32_t>& validGameVersions,
+              BS::thread_pool* threadPool);
     ~ArchiveManager();
 
+    // Archives opened by path after this are loaded from the cache when they did not change since they were last
+    // opened, and stored to it otherwise. Init saves the cache.
+    void SetIndexCache(std::shared_ptr<ArchiveIndexCache> indexCache);
+
     std::shared_ptr<Archive> AddArchive(const std::string& archivePath);
     std::shared_ptr<Archive> AddArchive(std::shared_ptr<Archive> archive);
     std::shared_ptr<std::vector<std::shared_ptr<Archive>>> GetArchives();
@@ -33,6 +47,8 @@ class ArchiveManager {
     bool WriteFile(std::shared_ptr<Archive> archive, const std::string& filename, const std::vector<uint8_t>& data);
     bool HasFile(const std::string& filePath);
     bool HasFile(uint64_t hash);
+    // Whether an archive has an alternate version of the file, under IResource::gAltAssetPrefix
+    bool HasAltFile(const std::string& filePath);
     std::shared_ptr<Archive>
     GetArchiveFromFile(const std::string& filePath); // Retrieves a ptr to the archive that the asset is inside of
     std::shared_ptr<std::vector<std::string>> ListFiles(const std::string& searchMask = "");
@@ -42,9 +58,13 @@ class ArchiveManager {
     std::vector<uint32_t> GetGameVersions();
     const std::string* HashToString(uint64_t hash) const;
     bool IsGameVersionValid(uint32_t gameVersion);
+    // Incremented every time the set of mounted archives or the files inside of them change.
+    uint32_t GetGeneration();
 
   protected:
     static std::vector<std::string> GetArchiveListInPaths(const std::vector<std::string>& archivePaths);
+    // Creates and loads the archive without adding it. Safe to call from several threads.
+    std::shared_ptr<Archive> OpenArchive(const std::string& archivePath);
     void AddGameVersion(uint32_t newGameVersion);
     void ResetVirtualFileSystem();
 
@@ -55,5 +75,9 @@ class ArchiveManager {
     std::unordered_map<uint64_t, std::string> mHashes;
     std::unordered_set<std::string> mDirectories;
     std::unordered_map<uint64_t, std::shared_ptr<Archive>> mFileToArchive;
+    // Hashes of the paths that have a file under IResource::gAltAssetPrefix, without the prefix
+    std::unordered_set<uint64_t> mAltFiles;
+    std::atomic<uint32_t> mGeneration = 0;
+    std::shared_ptr<ArchiveIndexCache> mIndexCache;
 };
 } // namespace Ship
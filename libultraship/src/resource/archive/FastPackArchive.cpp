@@ -0,0 +1,271 @@
+#include "FastPackArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "spdlog/spdlog.h"
+#include "resource/archive/ArchiveManager.h"
+#include "utils/StrHash64.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__SWITCH__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Ship {
+static constexpr char PACK_MAGIC[8] = { 'S', 'H', 'I', 'P', 'P', 'A', 'C', 'K' };
+static constexpr uint32_t PACK_VERSION = 1;
+static constexpr uint64_t PACK_PAGE_SIZE = 0x1000;
+static constexpr uint64_t PACK_ENTRY_ALIGNMENT = 16;
+
+// Files of a page or more start on a page, smaller ones only don't cross one so loading them touches a single page
+static uint64_t AlignEntry(uint64_t offset, uint64_t size) {
+    offset = (offset + PACK_ENTRY_ALIGNMENT - 1) & ~(PACK_ENTRY_ALIGNMENT - 1);
+    const uint64_t pageEnd = (offset | (PACK_PAGE_SIZE - 1)) + 1;
+    if (size >= PACK_PAGE_SIZE || offset + size > pageEnd) {
+        offset = (offset + PACK_PAGE_SIZE - 1) & ~(PACK_PAGE_SIZE - 1);
+    }
+    return offset;
+}
+
+// Mapped read only, shared by every file loaded from it. Resources the game writes to copy their data out of it, see
+// File::IsShared.
+static std::shared_ptr<char> MapFile(const std::string& path, size_t& size) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        return nullptr;
+    }
+    size = fileSize.QuadPart;
+    return std::shared_ptr<char>(static_cast<char*>(data), [](char* data) { UnmapViewOfFile(data); });
+#elif defined(__SWITCH__)
+    // No mmap, the pack is read whole instead. That still saves inflating and copying every file.
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file || file.tellg() <= 0) {
+        return nullptr;
+    }
+    size = file.tellg();
+    std::shared_ptr<char> data(new char[size], std::default_delete<char[]>());
+    file.seekg(0);
+    if (!file.read(data.get(), size)) {
+        return nullptr;
+    }
+    return data;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    size = fileStat.st_size;
+    const size_t mappedSize = size;
+    return std::shared_ptr<char>(static_cast<char*>(data),
+                                 [mappedSize](char* data) { munmap(data, mappedSize); });
+#endif
+}
+
+FastPackArchive::FastPackArchive(const std::string& archivePath) : Archive(archivePath) {
+}
+
+FastPackArchive::~FastPackArchive() {
+    SPDLOG_TRACE("destruct fastpackarchive: {}", GetPath());
+    Close();
+}
+
+std::shared_ptr<File> FastPackArchive::LoadFile(const std::string& filePath) {
+    return LoadFile(CRC64(filePath.c_str()));
+}
+
+std::shared_ptr<File> FastPackArchive::LoadFile(uint64_t hash) {
+    if (mData == nullptr) {
+        SPDLOG_TRACE("Failed to open file {:016X} from fast pack {}. Archive not open.", hash, GetPath());
+        return nullptr;
+    }
+
+    const Entry* end = mEntries + mEntryCount;
+    const Entry* entry =
+        std::lower_bound(mEntries, end, hash, [](const Entry& entry, uint64_t hash) { return entry.Hash < hash; });
+    if (entry == end || entry->Hash != hash) {
+        SPDLOG_TRACE("Failed to find file {:016X} in fast pack {}.", hash, GetPath());
+        return nullptr;
+    }
+
+    auto fileToLoad = std::make_shared<File>();
+    fileToLoad->Data = mData.get() + entry->Offset;
+    fileToLoad->DataSize = entry->Size;
+    fileToLoad->DataOwner = mData;
+    fileToLoad->IsShared = true;
+    fileToLoad->IsLoaded = true;
+
+    return fileToLoad;
+}
+
+bool FastPackArchive::Open() {
+    mData = MapFile(GetPath(), mDataSize);
+    if (mData == nullptr) {
+        SPDLOG_ERROR("Failed to map fast pack \"{}\"", GetPath());
+        return false;
+    }
+
+    Header header;
+    if (mDataSize < sizeof(header)) {
+        SPDLOG_ERROR("Fast pack \"{}\" is too small", GetPath());
+        Close();
+        return false;
+    }
+    memcpy(&header, mData.get(), sizeof(header));
+    if (memcmp(header.Magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.Version != PACK_VERSION ||
+        header.EntriesOffset + (uint64_t)header.EntryCount * sizeof(Entry) > mDataSize ||
+        header.NamesOffset + header.NamesSize > mDataSize) {
+        SPDLOG_ERROR("Fast pack \"{}\" is invalid or from another version", GetPath());
+        Close();
+        return false;
+    }
+
+    mEntries = reinterpret_cast<const Entry*>(mData.get() + header.EntriesOffset);
+    mEntryCount = header.EntryCount;
+    const char* names = mData.get() + header.NamesOffset;
+    for (uint32_t i = 0; i < mEntryCount; i++) {
+        const Entry& entry = mEntries[i];
+        if (entry.Offset + entry.Size > mDataSize || (uint64_t)entry.NameOffset + entry.NameSize > header.NamesSize) {
+            SPDLOG_ERROR("Fast pack \"{}\" has an entry outside of the file", GetPath());
+            Close();
+            return false;
+        }
+        IndexFile(std::string(names + entry.NameOffset, entry.NameSize));
+    }
+
+    return true;
+}
+
+bool FastPackArchive::Close() {
+    // Files and resources that still point into the mapping keep it alive
+    mData = nullptr;
+    mDataSize = 0;
+    mEntries = nullptr;
+    mEntryCount = 0;
+    return true;
+}
+
+bool FastPackArchive::WriteFile(const std::string& filename, const std::vector<uint8_t>& data) {
+    SPDLOG_ERROR("Cannot write \"{}\" to fast pack \"{}\": Fast packs are read only.", filename, GetPath());
+    return false;
+}
+
+bool FastPackArchive::Write(const std::string& packPath, ArchiveManager& archives, uint64_t sourceId) {
+    static const char padding[PACK_PAGE_SIZE] = {};
+
+    auto paths = archives.ListFiles();
+    std::sort(paths->begin(), paths->end());
+
+    // Written next to it and moved over it once complete, a pack that exists is never half written
+    const std::string tempPath = packPath + ".tmp";
+    std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        SPDLOG_ERROR("Failed to create fast pack \"{}\"", tempPath);
+        return false;
+    }
+
+    std::vector<Entry> entries;
+    std::string names;
+    // The header gets the first page to itself
+    uint64_t offset = PACK_PAGE_SIZE;
+    stream.write(padding, offset);
+    for (const auto& path : *paths) {
+        auto file = archives.LoadFile(path);
+        if (file == nullptr || !file->IsLoaded) {
+            continue;
+        }
+
+        const uint64_t size = file->GetSize();
+        const uint64_t entryOffset = AlignEntry(offset, size);
+        stream.write(padding, entryOffset - offset);
+        stream.write(file->GetData(), size);
+        entries.push_back({ CRC64(path.c_str()), entryOffset, size, (uint32_t)names.size(), (uint32_t)path.size() });
+        names += path;
+        offset = entryOffset + size;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.Hash < b.Hash; });
+
+    Header header = {};
+    memcpy(header.Magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.Version = PACK_VERSION;
+    header.EntryCount = entries.size();
+    header.SourceId = sourceId;
+    header.EntriesOffset = AlignEntry(offset, 0);
+    header.NamesOffset = header.EntriesOffset + entries.size() * sizeof(Entry);
+    header.NamesSize = names.size();
+
+    stream.write(padding, header.EntriesOffset - offset);
+    stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+    stream.write(names.data(), names.size());
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.close();
+
+    std::error_code error;
+    if (stream) {
+        std::filesystem::rename(tempPath, packPath, error);
+    }
+    if (!stream || error) {
+        SPDLOG_ERROR("Failed to write fast pack \"{}\"", packPath);
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    SPDLOG_INFO("Wrote fast pack \"{}\" with {} files, {} bytes", packPath, entries.size(),
+                header.NamesOffset + header.NamesSize);
+    return true;
+}
+
+uint64_t FastPackArchive::GetSourceId(const std::vector<std::string>& archivePaths) {
+    std::string state;
+    for (const auto& path : archivePaths) {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        const auto time = std::filesystem::last_write_time(path, error);
+        state += path + '|' + std::to_string(size) + '|' + std::to_string(time.time_since_epoch().count()) + '\n';
+    }
+    return CRC64(state.c_str());
+}
+
+bool FastPackArchive::IsCurrent(const std::string& packPath, uint64_t sourceId) {
+    Header header;
+    std::ifstream stream(packPath, std::ios::binary);
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    return memcmp(header.Magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 && header.Version == PACK_VERSION &&
+           header.SourceId == sourceId;
+}
+} // namespace Ship
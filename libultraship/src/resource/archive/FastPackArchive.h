@@ -0,0 +1,67 @@
+#pragma once
+
+#undef _DLL
+
+#include <string>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "resource/File.h"
+#include "resource/Resource.h"
+#include "resource/archive/Archive.h"
+
+namespace Ship {
+struct File;
+class ArchiveManager;
+
+// Every file of a set of archives stored uncompressed in one file that is memory mapped instead of read. Loads
+// hand out files that point into the mapping, so nothing is inflated or copied until a factory needs to.
+// Packs are written by Write from whatever the archive manager has mounted and are read only after that.
+class FastPackArchive final : virtual public Archive {
+  public:
+    FastPackArchive(const std::string& archivePath);
+    ~FastPackArchive();
+
+    bool Open();
+    bool Close();
+    bool WriteFile(const std::string& filename, const std::vector<uint8_t>& data);
+
+    std::shared_ptr<File> LoadFile(const std::string& filePath);
+    std::shared_ptr<File> LoadFile(uint64_t hash);
+
+    // Writes every file the archive manager can load, resolved the same way it resolves loads, to a pack at
+    // packPath. sourceId ends up in the header, see IsCurrent.
+    static bool Write(const std::string& packPath, ArchiveManager& archives, uint64_t sourceId);
+    // Identifies the state of the archives a pack is written from, changes whenever one is added, removed or
+    // modified
+    static uint64_t GetSourceId(const std::vector<std::string>& archivePaths);
+    // Returns true if there is a pack at packPath and it was written from archives with the given id
+    static bool IsCurrent(const std::string& packPath, uint64_t sourceId);
+
+  private:
+    struct Header {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t EntryCount;
+        uint64_t SourceId;
+        uint64_t EntriesOffset;
+        uint64_t NamesOffset;
+        uint64_t NamesSize;
+    };
+
+    // Sorted by hash
+    struct Entry {
+        uint64_t Hash;
+        uint64_t Offset;
+        uint64_t Size;
+        uint32_t NameOffset;
+        uint32_t NameSize;
+    };
+
+    std::shared_ptr<char> mData;
+    size_t mDataSize = 0;
+    const Entry* mEntries = nullptr;
+    uint32_t mEntryCount = 0;
+};
+} // namespace Ship
@@ -1,64 +1,137 @@
 #include "O2rArchive.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "Context.h"
+#include "resource/archive/ArchiveIndexCache.h"
 #include "window/Window.h"
 #include "spdlog/spdlog.h"
+#include "utils/StrHash64.h"
 
 namespace Ship {
+// Archives that have not been destroyed yet, an exiting thread only releases its readers in these
+static std::mutex sLiveArchivesMutex;
+static std::unordered_set<O2rArchive*> sLiveArchives;
+
+// One per thread that read from an O2R archive, releases the thread's readers when it exits
+struct O2rArchive::ReaderGuard {
+    std::vector<O2rArchive*> Archives;
+
+    ~ReaderGuard() {
+        const std::lock_guard<std::mutex> lock(sLiveArchivesMutex);
+        for (auto archive : Archives) {
+            if (sLiveArchives.contains(archive)) {
+                archive->ReleaseReader(std::this_thread::get_id());
+            }
+        }
+    }
+};
+
 O2rArchive::O2rArchive(const std::string& archivePath) : Archive(archivePath) {
+    const std::lock_guard<std::mutex> lock(sLiveArchivesMutex);
+    sLiveArchives.insert(this);
 }
 
 O2rArchive::~O2rArchive() {
     SPDLOG_TRACE("destruct o2rarchive: {}", GetPath());
+    {
+        const std::lock_guard<std::mutex> lock(sLiveArchivesMutex);
+        sLiveArchives.erase(this);
+    }
     Close();
 }
 
-std::shared_ptr<File> O2rArchive::LoadFile(uint64_t hash) {
-    const std::string& filePath =
-        *Context::GetInstance()->GetResourceManager()->GetArchiveManager()->HashToString(hash);
-    return LoadFile(filePath);
+std::shared_ptr<File> O2rArchive::LoadFile(const std::string& filePath) {
+    return LoadFile(CRC64(filePath.c_str()));
 }
 
-std::shared_ptr<File> O2rArchive::LoadFile(const std::string& filePath) {
-    if (mZipArchive == nullptr) {
-        SPDLOG_TRACE("Failed to open file {} from zip archive {}. Archive not open.", filePath, GetPath());
-        return nullptr;
+zip_t* O2rArchive::GetReader() {
+    const std::lock_guard<std::mutex> lock(mReadersMutex);
+    const auto threadId = std::this_thread::get_id();
+    auto reader = mReaders.find(threadId);
+    if (reader != mReaders.end()) {
+        return reader->second;
+    }
+
+    zip_t* zipArchive = zip_open(GetPath().c_str(), ZIP_RDONLY, nullptr);
+    if (zipArchive != nullptr) {
+        mReaders[threadId] = zipArchive;
+        ReleaseReaderOnThreadExit();
+    }
+    return zipArchive;
+}
+
+void O2rArchive::CloseReaders() {
+    const std::lock_guard<std::mutex> lock(mReadersMutex);
+    for (auto& [threadId, zipArchive] : mReaders) {
+        if (zipArchive != mZipArchive) {
+            zip_discard(zipArchive);
+        }
     }
+    mReaders.clear();
+}
+
+void O2rArchive::ReleaseReader(std::thread::id threadId) {
+    const std::lock_guard<std::mutex> lock(mReadersMutex);
+    auto reader = mReaders.find(threadId);
+    if (reader == mReaders.end()) {
+        return;
+    }
+    // mZipArchive stays open for WriteFile, it's closed with the archive
+    if (reader->second != mZipArchive) {
+        zip_discard(reader->second);
+    }
+    mReaders.erase(reader);
+}
 
-    auto zipEntryIndex = zip_name_locate(mZipArchive, filePath.c_str(), 0);
-    if (zipEntryIndex < 0) {
-        SPDLOG_TRACE("Failed to find file {} in zip archive  {}.", filePath, GetPath());
+void O2rArchive::ReleaseReaderOnThreadExit() {
+    thread_local ReaderGuard guard;
+    if (std::find(guard.Archives.begin(), guard.Archives.end(), this) == guard.Archives.end()) {
+        guard.Archives.push_back(this);
+    }
+}
+
+std::shared_ptr<File> O2rArchive::LoadFile(uint64_t hash) {
+    const std::shared_lock<std::shared_mutex> handlesLock(mHandlesMutex);
+    if (!mOpen) {
+        SPDLOG_TRACE("Failed to open file {:016X} from zip archive {}. Archive not open.", hash, GetPath());
         return nullptr;
     }
 
-    struct zip_stat zipEntryStat;
-    zip_stat_init(&zipEntryStat);
-    if (zip_stat_index(mZipArchive, zipEntryIndex, 0, &zipEntryStat) != 0) {
-        SPDLOG_TRACE("Failed to get entry information for file {} in zip archive  {}.", filePath, GetPath());
+    auto entry = mEntries.find(hash);
+    if (entry == mEntries.end()) {
+        SPDLOG_TRACE("Failed to find file {:016X} in zip archive  {}.", hash, GetPath());
         return nullptr;
     }
 
     // Filesize 0, no logging needed
-    if (zipEntryStat.size == 0) {
-        SPDLOG_TRACE("Failed to load file {}; filesize 0", filePath, GetPath());
+    if (entry->second.Size == 0) {
+        SPDLOG_TRACE("Failed to load file {:016X}; filesize 0", hash, GetPath());
         return nullptr;
     }
 
-    struct zip_file* zipEntryFile = zip_fopen_index(mZipArchive, zipEntryIndex, 0);
+    zip_t* zipArchive = GetReader();
+    if (zipArchive == nullptr) {
+        SPDLOG_TRACE("Failed to open file {:016X} from zip archive {}. Could not open a reader.", hash, GetPath());
+        return nullptr;
+    }
+
+    struct zip_file* zipEntryFile = zip_fopen_index(zipArchive, entry->second.Index, 0);
     if (!zipEntryFile) {
-        SPDLOG_TRACE("Failed to open file {} in zip archive  {}.", filePath, GetPath());
+        SPDLOG_TRACE("Failed to open file {:016X} in zip archive  {}.", hash, GetPath());
         return nullptr;
     }
 
     auto fileToLoad = std::make_shared<File>();
-    fileToLoad->Buffer = std::make_shared<std::vector<char>>(zipEntryStat.size);
+    fileToLoad->Buffer = std::make_shared<std::vector<char>>(entry->second.Size);
 
-    if (zip_fread(zipEntryFile, fileToLoad->Buffer->data(), zipEntryStat.size) < 0) {
-        SPDLOG_TRACE("Error reading file {} in zip archive  {}.", filePath, GetPath());
+    if (zip_fread(zipEntryFile, fileToLoad->Buffer->data(), entry->second.Size) < 0) {
+        SPDLOG_TRACE("Error reading file {:016X} in zip archive  {}.", hash, GetPath());
     }
 
     if (zip_fclose(zipEntryFile) != 0) {
-        SPDLOG_TRACE("Error closing file {} in zip archive  {}.", filePath, GetPath());
+        SPDLOG_TRACE("Error closing file {:016X} in zip archive  {}.", hash, GetPath());
     }
 
     fileToLoad->IsLoaded = true;
@@ -66,16 +139,18 @@ std::shared_ptr<File> O2rArchive::LoadFile(const std::string& filePath) {
     return fileToLoad;
 }
 
-bool O2rArchive::Open() {
-    mZipArchive = zip_open(GetPath().c_str(), ZIP_CREATE, nullptr);
-    if (mZipArchive == nullptr) {
-        SPDLOG_ERROR("Failed to load zip file \"{}\"", GetPath());
-        return false;
-    }
+void O2rArchive::IndexEntries() {
+    mEntries.clear();
 
     auto zipNumEntries = zip_get_num_entries(mZipArchive, 0);
     for (auto i = 0; i < zipNumEntries; i++) {
-        auto zipEntryName = zip_get_name(mZipArchive, i, 0);
+        struct zip_stat zipEntryStat;
+        zip_stat_init(&zipEntryStat);
+        if (zip_stat_index(mZipArchive, i, 0, &zipEntryStat) != 0) {
+            SPDLOG_TRACE("Failed to get entry information for entry {} in zip archive  {}.", i, GetPath());
+            continue;
+        }
+        auto zipEntryName = zipEntryStat.name;
 
         // It is possible for directories to have entries in a zip
         // file, we don't want those indexed as files in the archive
@@ -83,31 +158,116 @@ bool O2rArchive::Open() {
             continue;
         }
 
+        mEntries[CRC64(zipEntryName)] = {
+            zipEntryStat.index, zipEntryStat.size, zipEntryStat.comp_size, zipEntryStat.comp_method
+        };
         IndexFile(zipEntryName);
     }
+}
+
+bool O2rArchive::Open() {
+    const std::unique_lock<std::shared_mutex> handlesLock(mHandlesMutex);
+    mZipArchive = zip_open(GetPath().c_str(), ZIP_CREATE, nullptr);
+    if (mZipArchive == nullptr) {
+        SPDLOG_ERROR("Failed to load zip file \"{}\"", GetPath());
+        return false;
+    }
+    {
+        const std::lock_guard<std::mutex> lock(mReadersMutex);
+        mReaders[std::this_thread::get_id()] = mZipArchive;
+    }
+    ReleaseReaderOnThreadExit();
+    mOpen = true;
+
+    IndexEntries();
 
     return true;
 }
 
+// The entries as IndexEntries found them: hash, index, size, compressed size and compression method of each
+struct IndexedZipEntry {
+    uint64_t Hash;
+    uint64_t Index;
+    uint64_t Size;
+    uint64_t CompressedSize;
+    // Widened so the struct has no padding
+    uint64_t CompressionMethod;
+};
+
+bool O2rArchive::OpenFromIndex(const ArchiveIndex& index) {
+    if (index.Data.size() != index.Files.size() * sizeof(IndexedZipEntry)) {
+        return false;
+    }
+
+    const std::unique_lock<std::shared_mutex> handlesLock(mHandlesMutex);
+    mEntries.clear();
+    mEntries.reserve(index.Files.size());
+    for (size_t i = 0; i < index.Files.size(); i++) {
+        IndexedZipEntry entry;
+        memcpy(&entry, index.Data.data() + i * sizeof(IndexedZipEntry), sizeof(IndexedZipEntry));
+        mEntries[entry.Hash] = { entry.Index, entry.Size, entry.CompressedSize, (uint16_t)entry.CompressionMethod };
+    }
+    for (const auto& [hash, filePath] : index.Files) {
+        IndexFile(hash, filePath);
+    }
+
+    // The central directory is not read again, the zip is opened by the first thread that reads from it
+    mOpen = true;
+    return true;
+}
+
+bool O2rArchive::SaveIndexData(std::vector<uint8_t>& data) {
+    const std::shared_lock<std::shared_mutex> handlesLock(mHandlesMutex);
+    data.resize(mEntries.size() * sizeof(IndexedZipEntry));
+    size_t offset = 0;
+    for (const auto& [hash, zipEntry] : mEntries) {
+        const IndexedZipEntry entry = { hash, zipEntry.Index, zipEntry.Size, zipEntry.CompressedSize,
+                                        zipEntry.CompressionMethod };
+        memcpy(data.data() + offset, &entry, sizeof(IndexedZipEntry));
+        offset += sizeof(IndexedZipEntry);
+    }
+    return true;
+}
+
 bool O2rArchive::Close() {
-    if (mZipArchive == nullptr) {
+    const std::unique_lock<std::shared_mutex> handlesLock(mHandlesMutex);
+    if (!mOpen) {
         SPDLOG_ERROR("Cannot close zip file. Zip file not loaded. \"{}\"", GetPath());
         return false;
     }
 
+    CloseReaders();
+    mOpen = false;
+    mEntries.clear();
+    if (mZipArchive == nullptr) {
+        return true;
+    }
+
     if (zip_close(mZipArchive) == -1) {
         SPDLOG_ERROR("Failed to close zip file \"{}\"", GetPath());
+        zip_discard(mZipArchive);
+        mZipArchive = nullptr;
         return false;
     }
 
+    mZipArchive = nullptr;
     return true;
 }
 
 bool O2rArchive::WriteFile(const std::string& filePath, const std::vector<uint8_t>& data) {
-    if (!mZipArchive) {
+    const std::unique_lock<std::shared_mutex> handlesLock(mHandlesMutex);
+    if (!mOpen) {
         SPDLOG_ERROR("Cannot write to zip: Archive is not open.");
         return false;
     }
+    if (mZipArchive == nullptr) {
+        // Opened from an index
+        mZipArchive = zip_open(GetPath().c_str(), ZIP_CREATE, nullptr);
+        if (mZipArchive == nullptr) {
+            SPDLOG_ERROR("Cannot write to zip: Failed to open \"{}\".", GetPath());
+            return false;
+        }
+    }
 
     // Create a new zip source from the data buffer
     zip_source_t* source = zip_source_buffer(mZipArchive, data.data(), data.size(), 0);
@@ -123,12 +283,17 @@ bool O2rArchive::WriteFile(const std::string& filePath, const std::vector<uint8_
         return false;
     }
 
+    // The readers still see the archive as it was before the write
+    CloseReaders();
+
     // Save changes to disk
     if (zip_close(mZipArchive) < 0) {
         zip_error_t* error = zip_get_error(mZipArchive);
         SPDLOG_ERROR("Failed to save changes to zip archive: {} ({})", zip_error_strerror(error),
                      zip_error_code_zip(error));
         zip_discard(mZipArchive); // Close zip and discard changes
+        mZipArchive = nullptr;
+        mOpen = false;
         return false;
     }
 
@@ -138,10 +303,17 @@ bool O2rArchive::WriteFile(const std::string& filePath, const std::vector<uint8_
     mZipArchive = zip_open(GetPath().c_str(), ZIP_CREATE, nullptr);
     if (mZipArchive == nullptr) {
         SPDLOG_ERROR("Failed to reopen zip file after writing.");
+        mOpen = false;
         return false;
     }
+    {
+        const std::lock_guard<std::mutex> lock(mReadersMutex);
+        mReaders[std::this_thread::get_id()] = mZipArchive;
+    }
+    ReleaseReaderOnThreadExit();
 
-    IndexFile(filePath);
+    // Written entries can land at a different index than before
+    IndexEntries();
 
     // Success
     return true;
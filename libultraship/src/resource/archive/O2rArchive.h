@@ -4,7 +4,10 @@
 
 #include <string>
 #include <stdint.h>
-#include <string>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "zip.h"
 
@@ -27,7 +30,40 @@ class O2rArchive final : virtual public Archive {
     std::shared_ptr<File> LoadFile(const std::string& filePath);
     std::shared_ptr<File> LoadFile(uint64_t hash);
 
+  protected:
+    bool OpenFromIndex(const ArchiveIndex& index);
+    bool SaveIndexData(std::vector<uint8_t>& data);
+
   private:
-    zip_t* mZipArchive;
+    // Everything LoadFile needs to know about an entry, taken from the central directory once at Open
+    struct ZipEntry {
+        zip_uint64_t Index;
+        zip_uint64_t Size;
+        zip_uint64_t CompressedSize;
+        uint16_t CompressionMethod;
+    };
+
+    void IndexEntries();
+
+    // A zip_t can not be used from several threads at once, so every thread reads through its own handle. The
+    // thread that opened the archive reads through mZipArchive.
+    zip_t* GetReader();
+    void CloseReaders();
+    // Drops the handle of a thread that exited, thread pool workers come and go over a session
+    void ReleaseReader(std::thread::id threadId);
+    // Makes the calling thread release its handle in this archive when it exits
+    void ReleaseReaderOnThreadExit();
+    struct ReaderGuard;
+
+    // Stays null when the archive was opened from an index until WriteFile needs it, reads then only go through
+    // mReaders
+    zip_t* mZipArchive = nullptr;
+    bool mOpen = false;
+    // Held shared while reading, WriteFile and Close hold it exclusively while they replace the handles
+    std::shared_mutex mHandlesMutex;
+    std::mutex mReadersMutex;
+    std::unordered_map<std::thread::id, zip_t*> mReaders;
+    // Keyed by the hash of the entry name. Entry indices are the same in every reader, they all open the same file.
+    std::unordered_map<uint64_t, ZipEntry> mEntries;
 };
 } // namespace Ship
@@ -4,6 +4,23 @@
 
 namespace Fast {
 
+static void ReadImageData(std::shared_ptr<Texture> texture, std::shared_ptr<Ship::File> file,
+                          std::shared_ptr<Ship::BinaryReader> reader) {
+    // Points into the loaded file when it belongs to the texture alone, saves copying every texture a second time. The
+    // game writes to some textures, those writes must go away with the texture instead of ending up in shared data.
+    if (!file->IsShared) {
+        auto imageData = reader->ReadInPlace(texture->ImageDataSize);
+        if (imageData != nullptr) {
+            texture->ImageData = reinterpret_cast<uint8_t*>(imageData.get());
+            texture->ImageDataOwner = imageData;
+            return;
+        }
+    }
+
+    texture->ImageData = new uint8_t[texture->ImageDataSize];
+    reader->Read((char*)texture->ImageData, texture->ImageDataSize);
+}
+
 std::shared_ptr<Ship::IResource>
 ResourceFactoryBinaryTextureV0::ReadResource(std::shared_ptr<Ship::File> file,
                                              std::shared_ptr<Ship::ResourceInitData> initData) {
@@ -18,9 +35,7 @@ ResourceFactoryBinaryTextureV0::ReadResource(std::shared_ptr<Ship::File> file,
     texture->Width = reader->ReadUInt32();
     texture->Height = reader->ReadUInt32();
     texture->ImageDataSize = reader->ReadUInt32();
-    texture->ImageData = new uint8_t[texture->ImageDataSize];
-
-    reader->Read((char*)texture->ImageData, texture->ImageDataSize);
+    ReadImageData(texture, file, reader);
 
     return texture;
 }
@@ -42,9 +57,7 @@ ResourceFactoryBinaryTextureV1::ReadResource(std::shared_ptr<Ship::File> file,
     texture->HByteScale = reader->ReadFloat();
     texture->VPixelScale = reader->ReadFloat();
     texture->ImageDataSize = reader->ReadUInt32();
-    texture->ImageData = new uint8_t[texture->ImageDataSize];
-
-    reader->Read((char*)texture->ImageData, texture->ImageDataSize);
+    ReadImageData(texture, file, reader);
 
     return texture;
 }
@@ -1,4 +1,5 @@
 #include "resource/type/DisplayList.h"
+#include <cstring>
 #include <memory>
 
 namespace Fast {
@@ -18,4 +19,12 @@ Gfx* DisplayList::GetPointer() {
 size_t DisplayList::GetPointerSize() {
     return Instructions.size() * sizeof(Gfx);
 }
+
+size_t DisplayList::GetResidentSize() {
+    size_t size = sizeof(DisplayList) + Instructions.capacity() * sizeof(Gfx) + Strings.capacity() * sizeof(char*);
+    for (const char* string : Strings) {
+        size += strlen(string) + 1;
+    }
+    return size;
+}
 } // namespace Fast
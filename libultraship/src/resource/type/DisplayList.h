@@ -15,6 +15,7 @@ class DisplayList : public Ship::Resource<Gfx> {
 
     Gfx* GetPointer() override;
     size_t GetPointerSize() override;
+    size_t GetResidentSize() override;
 
     UcodeHandlers UCode;
     std::vector<Gfx> Instructions;
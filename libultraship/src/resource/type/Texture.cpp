@@ -12,8 +12,12 @@ size_t Texture::GetPointerSize() {
     return ImageDataSize;
 }
 
+size_t Texture::GetResidentSize() {
+    return sizeof(Texture) + ImageDataSize;
+}
+
 Texture::~Texture() {
-    if (ImageData != nullptr) {
+    if (ImageData != nullptr && ImageDataOwner == nullptr) {
         delete[] ImageData;
     }
 }
@@ -27,6 +27,7 @@ class Texture : public Ship::Resource<uint8_t> {
 
     uint8_t* GetPointer() override;
     size_t GetPointerSize() override;
+    size_t GetResidentSize() override;
 
     TextureType Type;
     uint16_t Width, Height;
@@ -35,6 +36,8 @@ class Texture : public Ship::Resource<uint8_t> {
     float VPixelScale = 1.0;
     uint32_t ImageDataSize;
     uint8_t* ImageData = nullptr;
+    // Set when ImageData points into the file the texture was loaded from instead of its own allocation
+    std::shared_ptr<void> ImageDataOwner;
 
     ~Texture();
 };
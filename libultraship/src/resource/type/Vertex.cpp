@@ -12,4 +12,8 @@ Vtx* Vertex::GetPointer() {
 size_t Vertex::GetPointerSize() {
     return VertexList.size() * sizeof(Vtx);
 }
+
+size_t Vertex::GetResidentSize() {
+    return sizeof(Vertex) + VertexList.capacity() * sizeof(Vtx);
+}
 } // namespace Fast
@@ -14,6 +14,7 @@ class Vertex : public Ship::Resource<Vtx> {
 
     Vtx* GetPointer() override;
     size_t GetPointerSize() override;
+    size_t GetResidentSize() override;
 
     std::vector<Vtx> VertexList;
 };
@@ -43,6 +43,10 @@ void Ship::BinaryReader::Read(char* buffer, int32_t length) {
     mStream->Read(buffer, length);
 }
 
+std::shared_ptr<char> Ship::BinaryReader::ReadInPlace(size_t length) {
+    return mStream->ReadInPlace(length);
+}
+
 char Ship::BinaryReader::ReadChar() {
     return (char)mStream->ReadByte();
 }
@@ -26,6 +26,7 @@ class BinaryReader {
 
     void Read(int32_t length);
     void Read(char* buffer, int32_t length);
+    std::shared_ptr<char> ReadInPlace(size_t length);
     char ReadChar();
     int8_t ReadInt8();
     int16_t ReadInt16();
@@ -1,5 +1,6 @@
 #include "MemoryStream.h"
 #include <cstring>
+#include <stdexcept>
 
 #ifndef _MSC_VER
 #define memcpy_s(dest, destSize, source, sourceSize) memcpy(dest, source, destSize)
@@ -24,11 +25,37 @@ Ship::MemoryStream::MemoryStream(std::shared_ptr<std::vector<char>> buffer) : Me
     mBaseAddress = 0;
 }
 
+Ship::MemoryStream::MemoryStream(char* data, size_t dataSize, std::shared_ptr<void> owner) : MemoryStream() {
+    mView = data;
+    mViewOwner = owner;
+    mBufferSize = dataSize;
+    mBaseAddress = 0;
+}
+
 Ship::MemoryStream::~MemoryStream() {
 }
 
+char* Ship::MemoryStream::At(size_t offset) {
+    if (mView == nullptr) {
+        return &mBuffer->at(offset);
+    }
+    if (offset >= mBufferSize) {
+        throw std::out_of_range("MemoryStream read past the end of its view");
+    }
+    return mView + offset;
+}
+
+void Ship::MemoryStream::Detach() {
+    if (mView == nullptr) {
+        return;
+    }
+    mBuffer = std::make_shared<std::vector<char>>(mView, mView + mBufferSize);
+    mView = nullptr;
+    mViewOwner = nullptr;
+}
+
 uint64_t Ship::MemoryStream::GetLength() {
-    return mBuffer->size();
+    return mView != nullptr ? mBufferSize : mBuffer->size();
 }
 
 void Ship::MemoryStream::Seek(int32_t offset, SeekOffsetType seekType) {
@@ -44,22 +71,39 @@ void Ship::MemoryStream::Seek(int32_t offset, SeekOffsetType seekType) {
 std::unique_ptr<char[]> Ship::MemoryStream::Read(size_t length) {
     std::unique_ptr<char[]> result = std::make_unique<char[]>(length);
 
-    memcpy_s(result.get(), length, &mBuffer->at(mBaseAddress), length);
+    memcpy_s(result.get(), length, At(mBaseAddress), length);
     mBaseAddress += length;
 
     return result;
 }
 
 void Ship::MemoryStream::Read(const char* dest, size_t length) {
-    memcpy_s((void*)dest, length, &mBuffer->at(mBaseAddress), length);
+    memcpy_s((void*)dest, length, At(mBaseAddress), length);
     mBaseAddress += length;
 }
 
 int8_t Ship::MemoryStream::ReadByte() {
-    return mBuffer->at(mBaseAddress++);
+    return *At(mBaseAddress++);
+}
+
+std::shared_ptr<char> Ship::MemoryStream::ReadInPlace(size_t length) {
+    if (mBaseAddress + length > GetLength()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<char> result;
+    if (mView != nullptr) {
+        result = std::shared_ptr<char>(mViewOwner, mView + mBaseAddress);
+    } else {
+        result = std::shared_ptr<char>(mBuffer, mBuffer->data() + mBaseAddress);
+    }
+    mBaseAddress += length;
+
+    return result;
 }
 
 void Ship::MemoryStream::Write(char* srcBuffer, size_t length) {
+    Detach();
     if (mBaseAddress + length >= mBuffer->size()) {
         mBuffer->resize(mBaseAddress + length);
         mBufferSize += length;
@@ -70,6 +114,7 @@ void Ship::MemoryStream::Write(char* srcBuffer, size_t length) {
 }
 
 void Ship::MemoryStream::WriteByte(int8_t value) {
+    Detach();
     if (mBaseAddress >= mBuffer->size()) {
         mBuffer->resize(mBaseAddress + 1);
         mBufferSize = mBaseAddress;
@@ -79,6 +124,9 @@ void Ship::MemoryStream::WriteByte(int8_t value) {
 }
 
 std::vector<char> Ship::MemoryStream::ToVector() {
+    if (mView != nullptr) {
+        return std::vector<char>(mView, mView + mBufferSize);
+    }
     return *mBuffer;
 }
 
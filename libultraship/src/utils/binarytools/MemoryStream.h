@@ -10,6 +10,8 @@ class MemoryStream : public Stream {
     MemoryStream();
     MemoryStream(char* nBuffer, size_t nBufferSize);
     MemoryStream(std::shared_ptr<std::vector<char>> buffer);
+    // Reads memory owned by someone else without copying it, owner keeps it alive. Writing copies it first.
+    MemoryStream(char* data, size_t dataSize, std::shared_ptr<void> owner);
     ~MemoryStream();
 
     uint64_t GetLength() override;
@@ -19,6 +21,7 @@ class MemoryStream : public Stream {
     std::unique_ptr<char[]> Read(size_t length) override;
     void Read(const char* dest, size_t length) override;
     int8_t ReadByte() override;
+    std::shared_ptr<char> ReadInPlace(size_t length) override;
 
     void Write(char* srcBuffer, size_t length) override;
     void WriteByte(int8_t value) override;
@@ -29,7 +32,13 @@ class MemoryStream : public Stream {
     void Close() override;
 
   protected:
+    char* At(size_t offset);
+    void Detach();
+
     std::shared_ptr<std::vector<char>> mBuffer;
     std::size_t mBufferSize;
+    // Set instead of mBuffer while reading someone else's memory
+    char* mView = nullptr;
+    std::shared_ptr<void> mViewOwner;
 };
 } // namespace Ship
@@ -3,3 +3,7 @@
 uint64_t Ship::Stream::GetBaseAddress() {
     return mBaseAddress;
 }
+
+std::shared_ptr<char> Ship::Stream::ReadInPlace(size_t length) {
+    return nullptr;
+}
@@ -18,6 +18,9 @@ class Stream {
     virtual std::unique_ptr<char[]> Read(size_t length) = 0;
     virtual void Read(const char* dest, size_t length) = 0;
     virtual int8_t ReadByte() = 0;
+    // Points at the next length bytes instead of copying them and skips past them, the pointer keeps the memory
+    // alive. Returns nullptr if the stream can not be read in place.
+    virtual std::shared_ptr<char> ReadInPlace(size_t length);
 
     virtual void Write(char* destBuffer, size_t length) = 0;
     virtual void WriteByte(int8_t value) = 0;
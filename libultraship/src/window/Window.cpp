@@ -94,8 +94,11 @@ void Window::SetForceCursorVisibility(bool visible) {
     CVarSave();
 }
 
-void Window::SetWindowBackend(WindowBackend backend) {
+void Window::SetWindowBackend(WindowBackend backend, bool save) {
     mWindowBackend = backend;
+    if (!save) {
+        return;
+    }
     Context::GetInstance()->GetConfig()->SetWindowBackend(GetWindowBackend());
     Context::GetInstance()->GetConfig()->Save();
 }
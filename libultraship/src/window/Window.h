@@ -10,7 +10,7 @@
 #include "controller/controldevice/controller/mapping/keyboard/KeyboardScancodes.h"
 
 namespace Ship {
-enum class WindowBackend { FAST3D_DXGI_DX11, FAST3D_SDL_OPENGL, FAST3D_SDL_METAL, WINDOW_BACKEND_COUNT };
+enum class WindowBackend { FAST3D_DXGI_DX11, FAST3D_SDL_OPENGL, FAST3D_SDL_METAL, FAST3D_NULL, WINDOW_BACKEND_COUNT };
 
 struct Coords {
     int32_t x;
@@ -76,7 +76,8 @@ class Window {
     void SetForceCursorVisibility(bool visible);
 
   protected:
-    void SetWindowBackend(WindowBackend backend);
+    // Backends forced for a single run (e.g. headless) pass save = false to leave the configured one untouched
+    void SetWindowBackend(WindowBackend backend, bool save = true);
     void AddAvailableWindowBackend(WindowBackend backend);
 
   private:
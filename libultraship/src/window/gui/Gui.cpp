@@ -242,6 +242,10 @@ void Gui::ImGuiBackendInit() {
                                 static_cast<ID3D11DeviceContext*>(mImpl.Dx11.DeviceContext));
             break;
 #endif
+        case WindowBackend::FAST3D_NULL:
+            // Nothing uploads the font atlas, but ImGui refuses to start a frame until it is built
+            mImGuiIo->Fonts->Build();
+            break;
         default:
             break;
     }
@@ -376,6 +380,12 @@ void Gui::ImGuiWMNewFrame() {
             ImGui_ImplWin32_NewFrame();
             break;
 #endif
+        case WindowBackend::FAST3D_NULL: {
+            std::shared_ptr<Window> window = Context::GetInstance()->GetWindow();
+            mImGuiIo->DisplaySize = ImVec2(window->GetWidth(), window->GetHeight());
+            mImGuiIo->DeltaTime = 1.0f / 60.0f;
+            break;
+        }
         default:
             break;
     }
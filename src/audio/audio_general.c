@@ -4,6 +4,7 @@
 #include "audiothread_cmd.h"
 #include "audioseq_cmd.h"
 #include "port/Engine.h"
+#include "port/audio/AudioQueue.h"
 
 void Audio_SetModulationAndPlaySfx(f32* sfxSource, u32 sfxId, f32 freqMod);
 s32 Audio_GetCurrentVoice(void);
@@ -441,8 +442,9 @@ s8 Audio_GetSfxReverb(u8 bankId, u8 entryIndex, u8 channelId) {
             distReverb = 40;
         }
     }
-    if (IS_SEQUENCE_CHANNEL_VALID(gSeqPlayers[SEQ_PLAYER_SFX].channels[channelId])) {
-        scriptReverb = gSeqPlayers[SEQ_PLAYER_SFX].channels[channelId]->seqScriptIO[6];
+    // @port: the audio thread may be updating the players, read what it copied out after its last update
+    if (AudioQueue_GetSnapshot()->sfxChannelValid[channelId]) {
+        scriptReverb = AudioQueue_GetSnapshot()->sfxChannelReverb[channelId];
     }
     if (scriptReverb == -1) {
         scriptReverb = 0;
@@ -932,7 +934,7 @@ void Audio_ProcessSeqCmds(void) {
 }
 
 u16 Audio_GetActiveSeqId(u8 seqPlayId) {
-    if (!gSeqPlayers[seqPlayId].enabled) {
+    if (!AudioQueue_GetSnapshot()->playerEnabled[seqPlayId]) {
         return 0xFFFF;
     }
     return sActiveSequences[seqPlayId].seqId;
@@ -1048,8 +1050,8 @@ void Audio_UpdateActiveSequences(void) {
             if (temp2 == 0) {
                 tempoTimer = temp2 + 1;
             }
-            if (gSeqPlayers[seqPlayId].enabled) {
-                prevTempo = gSeqPlayers[seqPlayId].tempo / 48;
+            if (AudioQueue_GetSnapshot()->playerEnabled[seqPlayId]) {
+                prevTempo = AudioQueue_GetSnapshot()->playerTempo[seqPlayId] / 48;
                 tempoOp = ((cmd & 0xF000) >> 0xC);
 
                 switch (tempoOp) {
@@ -1079,7 +1081,7 @@ void Audio_UpdateActiveSequences(void) {
                     sActiveSequences[seqPlayId].tempoOriginal = prevTempo;
                 }
                 sActiveSequences[seqPlayId].tempo.target = tempoTarget;
-                sActiveSequences[seqPlayId].tempo.value = (s32) gSeqPlayers[seqPlayId].tempo / 48;
+                sActiveSequences[seqPlayId].tempo.value = (s32) AudioQueue_GetSnapshot()->playerTempo[seqPlayId] / 48;
 
                 sActiveSequences[seqPlayId].tempo.step =
                     (sActiveSequences[seqPlayId].tempo.value - sActiveSequences[seqPlayId].tempo.target) / tempoTimer;
@@ -1139,7 +1141,7 @@ void Audio_UpdateActiveSequences(void) {
         }
         if (sActiveSequences[seqPlayId].setupCmdTimer != 0) {
             sActiveSequences[seqPlayId].setupCmdTimer--;
-        } else if (!gSeqPlayers[seqPlayId].enabled) {
+        } else if (!AudioQueue_GetSnapshot()->playerEnabled[seqPlayId]) {
             for (i = 0; i < sActiveSequences[seqPlayId].setupCmdNum; i++) {
                 setupOp = (sActiveSequences[seqPlayId].setupCmd[i] & 0xF00000) >> 20;
 
@@ -1587,7 +1589,6 @@ void Audio_PlayActiveSfx(u8 bankId) {
 
         if (entryIndex != 0xFF) {
             SfxBankEntry* entry = &sSfxBanks[bankId][entryIndex];
-            SequenceChannel* channel = gSeqPlayers[SEQ_PLAYER_SFX].channels[sCurSfxPlayerChannelIndex];
             s32 pad;
 
             if (entry->state == 2) {
@@ -1600,7 +1601,7 @@ void Audio_PlayActiveSfx(u8 bankId) {
                 AUDIOCMD_CHANNEL_SET_IO(SEQ_PLAYER_SFX, sCurSfxPlayerChannelIndex, 0, 1);
                 AUDIOCMD_CHANNEL_SET_IO(SEQ_PLAYER_SFX, sCurSfxPlayerChannelIndex, 4, SFX_INDEX(entry->sfxId) & 0xFF);
                 entry->state = 4;
-            } else if ((u8) channel->seqScriptIO[7] == 0x80) {
+            } else if ((u8) AudioQueue_GetSnapshot()->sfxChannelState[sCurSfxPlayerChannelIndex] == 0x80) {
                 AUDIOCMD_CHANNEL_SET_IO(SEQ_PLAYER_SFX, sCurSfxPlayerChannelIndex, 7, 0);
                 Audio_RemoveSfxBankEntry(bankId, entryIndex);
             } else if (entry->state == 3) {
@@ -1805,7 +1806,7 @@ void Audio_UpdateSfxVolumeMod(u8 bankId) {
 void Audio_PlayAllSfx(void) {
     u8 bankId;
 
-    if (IS_SEQUENCE_CHANNEL_VALID(gSeqPlayers[SEQ_PLAYER_SFX].channels[0])) {
+    if (AudioQueue_GetSnapshot()->sfxChannelValid[0]) {
         sCurSfxPlayerChannelIndex = 0;
         for (bankId = 0; bankId < ARRAY_COUNT(sSfxBanks); bankId++) {
             Audio_ChooseActiveSfx(bankId);
@@ -1891,10 +1892,10 @@ s32 Audio_GetCurrentVoice(void) {
     // LAudioTODO: Stub for now
     // return 0;
 
-    if (!IS_SEQUENCE_CHANNEL_VALID(gSeqPlayers[SEQ_PLAYER_VOICE].channels[15])) {
+    if (!AudioQueue_GetSnapshot()->voiceChannelValid) {
         return 0;
     }
-    if (gSeqPlayers[SEQ_PLAYER_VOICE].channels[15]->seqScriptIO[1] == 1) {
+    if (AudioQueue_GetSnapshot()->voiceChannelPlaying == 1) {
         if (sCurrentVoiceId < 4) {
             return 0;
         } else {
@@ -1908,20 +1909,8 @@ s32 Audio_GetCurrentVoiceStatus(void) {
     // LAudioTODO: Stub for now
     // return 1;
 
-    SequenceChannel* channel = gSeqPlayers[SEQ_PLAYER_VOICE].channels[15];
-    SequenceLayer* layer = channel->layers[0];
-
-    if (!IS_SEQUENCE_CHANNEL_VALID(channel) || (layer == NULL) || (channel->seqScriptIO[1] != 1)) {
-        return 0;
-    }
-    if (layer->note != NULL) {
-        if (layer != layer->note->playbackState.parentLayer) {
-            return 2;
-        } else {
-            return 1;
-        }
-    }
-    return 0;
+    // @port: worked out by the audio thread, the layer and its note belong to the synthesis
+    return AudioQueue_GetSnapshot()->voiceStatus;
 }
 
 void Audio_SetUnkVoiceParam(u8 unkVoiceParam) {
@@ -73,73 +73,6 @@ void AudioLoad_DecreaseSampleDmaTtls(void) {
 
 static const char devstr00[] = "CAUTION:WAVE CACHE FULL %d";
 
-void* AudioLoad_DmaSampleData(uintptr_t devAddr, u32 size, u32 arg2, u8* dmaIndexRef, s32 medium) {
-    u32 i;
-    SampleDma* dma;
-    bool hasDma = false;
-    s32 bufferPos;
-    uintptr_t dmaDevAddr;
-    s32 sp38;
-
-    if ((arg2 != 0) || (*dmaIndexRef >= gSampleDmaListSize1)) {
-        for (i = gSampleDmaListSize1; i < gSampleDmaCount; i++) {
-            dma = &gSampleDmas[i];
-            bufferPos = devAddr - dma->devAddr;
-            if ((0 <= bufferPos) && (bufferPos <= (dma->size - size))) {
-                if ((dma->ttl == 0) && (gSampleDmaReuseQueue2RdPos != gSampleDmaReuseQueue2WrPos)) {
-                    if (dma->reuseIndex != gSampleDmaReuseQueue2RdPos) {
-                        gSampleDmaReuseQueue2[dma->reuseIndex] = gSampleDmaReuseQueue2[gSampleDmaReuseQueue2RdPos];
-                        gSampleDmas[gSampleDmaReuseQueue2[gSampleDmaReuseQueue2RdPos]].reuseIndex = dma->reuseIndex;
-                    }
-                    gSampleDmaReuseQueue2RdPos++;
-                }
-                dma->ttl = 60;
-                *dmaIndexRef = i;
-                return &dma->ramAddr[devAddr - dma->devAddr];
-            }
-        }
-
-        if ((gSampleDmaReuseQueue2RdPos != gSampleDmaReuseQueue2WrPos) && (arg2 != 0)) {
-            sp38 = gSampleDmaReuseQueue2[gSampleDmaReuseQueue2RdPos];
-            gSampleDmaReuseQueue2RdPos++;
-            dma = &gSampleDmas[sp38];
-            hasDma = true;
-        }
-    } else {
-        dma = &gSampleDmas[*dmaIndexRef];
-        for (i = 0; i < gSampleDmaListSize1; i++) {
-            bufferPos = devAddr - dma->devAddr;
-            if ((0 <= bufferPos) && (bufferPos <= (dma->size - size))) {
-                if (dma->ttl == 0) {
-                    if (dma->reuseIndex != gSampleDmaReuseQueue1RdPos) {
-                        gSampleDmaReuseQueue1[dma->reuseIndex] = gSampleDmaReuseQueue1[gSampleDmaReuseQueue1RdPos];
-                        gSampleDmas[gSampleDmaReuseQueue1[gSampleDmaReuseQueue1RdPos]].reuseIndex = dma->reuseIndex;
-                    }
-                    if (1) {}
-                    gSampleDmaReuseQueue1RdPos++;
-                }
-                dma->ttl = 2;
-                return &dma->ramAddr[devAddr - dma->devAddr];
-            }
-            dma = &gSampleDmas[i];
-        }
-    }
-
-    if (hasDma == 0) {
-        sp38 = gSampleDmaReuseQueue1[gSampleDmaReuseQueue1RdPos];
-        gSampleDmaReuseQueue1RdPos++;
-        dma = &gSampleDmas[sp38];
-    }
-    dmaDevAddr = devAddr & ~0xF;
-    dma->ttl = 2;
-    dma->devAddr = dmaDevAddr;
-    dma->sizeUnused = dma->size;
-    AudioLoad_Dma(&gCurAudioFrameDmaIoMsgBuf[gCurAudioFrameDmaCount++], OS_MESG_PRI_NORMAL, OS_READ, dmaDevAddr,
-                  dma->ramAddr, dma->size, &gCurAudioFrameDmaQueue, medium, "SUPERDMA");
-    *dmaIndexRef = sp38;
-    return devAddr - dmaDevAddr + dma->ramAddr;
-}
-
 static const char devstr02[] = "Bank Change... top %d lba %d\n";
 static const char devstr03[] = "BankCount %d\n";
 static const char devstr04[] = "BANK LOAD MISS! FOR %d\n";
@@ -3,6 +3,9 @@
 #include "audio/mixer.h"
 #include "endianness.h"
 #include "port/Engine.h"
+#include "port/audio/SampleStream.h"
+#include "port/audio/AdpcmCache.h"
+#include "port/audio/SynthPool.h"
 
 #define DMEM_WET_SCRATCH 0x470
 #define DMEM_COMPRESSED_ADPCM_DATA 0xD50
@@ -30,6 +33,19 @@ typedef enum {
     /* 2 */ HAAS_EFFECT_DELAY_RIGHT // Delay right channel so that left channel is heard first
 } HaasEffectDelaySide;
 
+// @port: notes of one update split across the synthesis workers
+typedef struct {
+    u8* noteIndices;
+    u8 parts[0x3C];
+    u32 usedParts;
+    s32 count;
+    s16* aiBuf;
+    s32 aiBufLen;
+    Acmd* aList;
+    Acmd* aListOut;
+    s32 updateIndex;
+} SynthNoteJob;
+
 s32 D_80145D40; // unused
 
 // all of these are part of the DFT-related function
@@ -61,6 +77,7 @@ void AudioSynth_SyncSampleStates(s32 updateIndex);
 Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisState* synthState, s16* aiBuf,
                              s32 aiBufLen, Acmd* aList, s32 updateIndex);
 Acmd* AudioSynth_DoOneAudioUpdate(s16* aiBuf, s32 aiBufLen, Acmd* aList, s32 updateIndex);
+Acmd* AudioSynth_ProcessNotes(Acmd* aList, u8* noteIndices, s32 count, s16* aiBuf, s32 aiBufLen, s32 updateIndex);
 Acmd* AudioSynth_LoadRingBufferPart(Acmd* aList, u16 dmem, u16 startPos, s32 size, s32 reverbIndex);
 Acmd* AudioSynth_SaveRingBufferPart(Acmd* aList, u16 dmem, u16 startPos, s32 size, s32 reverbIndex);
 Acmd* AudioSynth_LoadReverbSamples(Acmd* aList, s32 aiBufLen, s16 reverbIndex, s16 updateIndex);
@@ -546,66 +563,60 @@ void func_80009504(s16* arg0, UnkStruct_800097A8* arg1) {
     }
 }
 
-s32 func_8000967C(s32 length, s16* ramAddr, UnkStruct_800097A8* arg2) {
-    s32 pad;
-    s32 temp_t0;
-    s32 i;
-    s32 var_s1;
-    s16* temp_t7 = (s16*) arg2->unk_14->ramAddr;
-
-    for (i = 0; i < arg2->unk_4; i++) {
-        ramAddr[i] = temp_t7[i];
+// @port: zeroes past the decoded samples, the synthesis loads up to a DMA buffer beyond where it reads
+#define DECODED_SAMPLE_PAD (0x2D0 / 2 + SAMPLES_PER_FRAME)
+
+// @port: decodes the whole sample once, block by block as func_80009504 would while the note plays. The first block
+// is the transform of what the previous decode left behind, start from silence so it does not depend on that.
+static const s16* AudioSynth_DecodeInMemorySample(Sample* sample, u32* numSamples) {
+    UnkStruct_800097A8 state = { 0 };
+    s16* streamEnd = (s16*) (sample->sampleAddr + sample->size);
+    s16* stream = (s16*) sample->sampleAddr;
+    const s16* decoded;
+    s16* pcm;
+    u32 numBlocks;
+    u32 i;
+
+    decoded = SampleStream_GetDecoded(sample, numSamples);
+    if (decoded != NULL) {
+        return decoded;
     }
 
-    var_s1 = arg2->unk_4;
-    temp_t0 = (length - arg2->unk_4 + 0xFF) / 256;
-    arg2->unk_4 = (temp_t0 * 256) + arg2->unk_4 - length;
-
-    for (i = 0; i < temp_t0; i++) {
-        func_80009504(&ramAddr[var_s1], arg2);
-        var_s1 += 0x100;
+    for (numBlocks = 0; stream < streamEnd; numBlocks++) {
+        func_80009124(&stream);
     }
 
-    for (i = 0; i < arg2->unk_4; i++) {
-        temp_t7[i] = ramAddr[length + i];
+    // func_80009504 hands out each block one call after it reads it, so there is one more output than blocks and the
+    // last call reads the last block
+    *numSamples = (numBlocks + 1) * 256;
+    pcm = SampleStream_AllocDecoded(sample, *numSamples, DECODED_SAMPLE_PAD);
+    for (i = 0; i < ARRAY_COUNTU(D_80145D48); i++) {
+        D_80145D48[i] = 0.0f;
+    }
+    state.unk_0 = (s16*) sample->sampleAddr;
+    for (i = 0; i <= numBlocks; i++) {
+        func_80009504(&pcm[i * 256], &state);
     }
-    return temp_t0;
+
+    return pcm;
 }
 
 u8* func_800097A8(Sample* sample, s32 length, u32 flags, UnkStruct_800097A8* arg3) {
-    // @port: We don't need to do a dma call
-    // return sample->sampleAddr;
-    s32 pad1;
-    SampleDma* pad2;
-    SampleDma* sp1C = NULL;
+    // @port: point into the decoded sample instead of decoding into a DMA buffer on every update. unk_0 holds the
+    // decoded samples, unk_4 how many there are and unk_8 how far the note has read.
+    u32 numSamples;
+    s32 pos;
 
     if (flags == A_INIT) {
-        arg3->unk_0 = (s16*) sample->sampleAddr;
-        arg3->unk_4 = 0;
+        arg3->unk_0 = (s16*) AudioSynth_DecodeInMemorySample(sample, &numSamples);
+        arg3->unk_4 = numSamples;
         arg3->unk_8 = 0;
-        arg3->unk18 = 0;
-
-        if (gSampleDmaReuseQueue1RdPos != gSampleDmaReuseQueue1WrPos) {
-            arg3->unk_14 = &gSampleDmas[gSampleDmaReuseQueue1[gSampleDmaReuseQueue1RdPos++]];
-            arg3->unk_14->devAddr = -1;
-            arg3->unk_14->sizeUnused = 0;
-        }
-    }
-
-    if (gSampleDmaReuseQueue1RdPos != gSampleDmaReuseQueue1WrPos) {
-        sp1C = &gSampleDmas[gSampleDmaReuseQueue1[gSampleDmaReuseQueue1RdPos++]];
     }
 
-    if (1) {} //! FAKE
-
-    sp1C->ttl = 2;
-    // @port: (uintptr_t)
-    sp1C->devAddr = (uintptr_t) sample->sampleAddr;
-    sp1C->sizeUnused = length * 2;
-    pad2 = arg3->unk_14;
-    pad2->ttl = 2;
-    arg3->unk_8 += func_8000967C(length, (s16*) sp1C->ramAddr, arg3);
-    return sp1C->ramAddr;
+    // Past the end it reads the zeroes after the decoded samples
+    pos = MIN(arg3->unk_8, arg3->unk_4);
+    arg3->unk_8 += length;
+    return (u8*) &arg3->unk_0[pos];
 }
 
 Acmd* AudioSynth_LoadRingBufferPart(Acmd* aList, u16 dmem, u16 startPos, s32 size, s32 reverbIndex) {
@@ -662,6 +673,9 @@ Acmd* AudioSynth_Update(Acmd* aList, s32* cmdCount, s16* aiBufStart, s32 aiBufLe
     s32 i;
     s32 j;
 
+    // @port: nothing is synthesizing yet, so the cache can drop samples
+    AdpcmCache_Update();
+
     aCmdPtr = aList;
     for (i = gAudioBufferParams.ticksPerUpdate; i > 0; i--) {
         AudioSeq_ProcessSequences(i - 1);
@@ -783,6 +797,7 @@ Acmd* AudioSynth_DoOneAudioUpdate(s16* aiBuf, s32 aiBufLen, Acmd* aList, s32 upd
     s16 count;
     s16 i = 0;
     s32 j = 0;
+    s32 start;
 
     count = 0;
     if (gNumSynthReverbs == 0) {
@@ -816,24 +831,20 @@ Acmd* AudioSynth_DoOneAudioUpdate(s16* aiBuf, s32 aiBufLen, Acmd* aList, s32 upd
         if (D_8014C1B2) {
             aList = AudioSynth_LoadReverbSamples(aList, aiBufLen, i, updateIndex);
         }
+        start = j;
         while (j < count) {
             if (i != gNoteSubsEu[updateIndex * gNumNotes + sp84[j]].bitField1.reverbIndex) {
                 break;
             }
-            aList = AudioSynth_ProcessNote(sp84[j], &gNoteSubsEu[updateIndex * gNumNotes + sp84[j]],
-                                           &gNotes[sp84[j]].synthesisState, aiBuf, aiBufLen, aList, updateIndex);
             j++;
         }
+        aList = AudioSynth_ProcessNotes(aList, &sp84[start], j - start, aiBuf, aiBufLen, updateIndex);
         if (gSynthReverbs[i].useReverb) {
             aList = AudioSynth_SaveReverbSamples(aList, i, updateIndex);
         }
     }
 
-    while (j < count) {
-        aList = AudioSynth_ProcessNote(sp84[j], &gNoteSubsEu[updateIndex * gNumNotes + sp84[j]],
-                                       &gNotes[sp84[j]].synthesisState, aiBuf, aiBufLen, aList, updateIndex);
-        j++;
-    }
+    aList = AudioSynth_ProcessNotes(aList, &sp84[j], count - j, aiBuf, aiBufLen, updateIndex);
 
     int num_audio_channels = GetNumAudioChannels();
     j = aiBufLen * num_audio_channels * sizeof(s16);
@@ -847,6 +858,80 @@ Acmd* AudioSynth_DoOneAudioUpdate(s16* aiBuf, s32 aiBufLen, Acmd* aList, s32 upd
     return aList;
 }
 
+// @port: func_800097A8 decodes through the global transform buffers, those notes stay on the calling thread
+static bool AudioSynth_NoteUsesSharedState(NoteSubEu* noteSub) {
+    return !noteSub->bitField1.isSyntheticWave && ((*noteSub->waveSampleAddr)->codec == CODEC_S16_INMEMORY);
+}
+
+static void AudioSynth_ProcessNotesPart(void* arg, s32 part, s32 numParts) {
+    SynthNoteJob* job = arg;
+    Acmd* aList = job->aList;
+    s32 i;
+
+    if (job->usedParts & (1 << part)) {
+        if (part != 0) {
+            // Workers mix from silence, the caller adds their output to its own afterwards
+            aClearBuffer(aList++, DMEM_LEFT_CH, DMEM_6CH_SIZE + DMEM_2CH_SIZE);
+        }
+        for (i = 0; i < job->count; i++) {
+            if (job->parts[i] == part) {
+                aList = AudioSynth_ProcessNote(job->noteIndices[i],
+                                               &gNoteSubsEu[job->updateIndex * gNumNotes + job->noteIndices[i]],
+                                               &gNotes[job->noteIndices[i]].synthesisState, job->aiBuf, job->aiBufLen,
+                                               aList, job->updateIndex);
+            }
+        }
+    }
+    if (part == 0) {
+        job->aListOut = aList;
+    }
+}
+
+// @port: spreads the notes over the synthesis workers when there are any
+Acmd* AudioSynth_ProcessNotes(Acmd* aList, u8* noteIndices, s32 count, s16* aiBuf, s32 aiBufLen, s32 updateIndex) {
+    SynthNoteJob job;
+    s32 numParts = SynthPool_GetNumParts();
+    s32 nextPart = 0;
+    s32 i;
+
+    if ((numParts <= 1) || (count <= 1)) {
+        for (i = 0; i < count; i++) {
+            aList = AudioSynth_ProcessNote(noteIndices[i], &gNoteSubsEu[updateIndex * gNumNotes + noteIndices[i]],
+                                           &gNotes[noteIndices[i]].synthesisState, aiBuf, aiBufLen, aList,
+                                           updateIndex);
+        }
+        return aList;
+    }
+
+    // Fixed round robin, so the mix and where it saturates does not depend on the thread timing
+    job.usedParts = 0;
+    for (i = 0; i < count; i++) {
+        if (AudioSynth_NoteUsesSharedState(&gNoteSubsEu[updateIndex * gNumNotes + noteIndices[i]])) {
+            job.parts[i] = 0;
+        } else {
+            job.parts[i] = nextPart;
+            nextPart = (nextPart + 1) % numParts;
+        }
+        job.usedParts |= 1 << job.parts[i];
+    }
+    job.noteIndices = noteIndices;
+    job.count = count;
+    job.aiBuf = aiBuf;
+    job.aiBufLen = aiBufLen;
+    job.aList = aList;
+    job.updateIndex = updateIndex;
+
+    SynthPool_Run(AudioSynth_ProcessNotesPart, &job);
+
+    // Dry and wet channels are next to each other
+    for (i = 1; i < numParts; i++) {
+        if (job.usedParts & (1 << i)) {
+            aMixerContextAccumulate(SynthPool_GetContext(i), DMEM_LEFT_CH, DMEM_6CH_SIZE + DMEM_2CH_SIZE);
+        }
+    }
+    return job.aListOut;
+}
+
 Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisState* synthState, s16* aiBuf,
                              s32 aiBufLen, Acmd* aList, s32 updateIndex) {
     s32 pad11C[3];
@@ -901,6 +986,9 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
     s32 samplesRemaining;
     s32 numSamplesToDecode;
     uintptr_t buffAddr;
+    const s16* cachedPcm;
+    const s16* cachedFramePcm;
+    u32 cachedFrames;
 
     currentBook = NULL;
     note = &gNotes[noteIndex];
@@ -915,6 +1003,7 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
         synthState->curVolRight = 0;
         synthState->curVolCenter = 0;
         synthState->curVolLfe = 0;
+        synthState->lfeFilterState = 0.0f;
         synthState->curVolRLeft = 0;
         synthState->curVolRRight = 0;
         synthState->numParts = synthState->prevHaasEffectRightDelaySize = synthState->prevHaasEffectLeftDelaySize = 0;
@@ -983,6 +1072,12 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
                 aLoadADPCM(aList++, nEntries, OS_K0_TO_PHYSICAL(currentBook));
             }
 
+            // @port: samples decoded ahead of time are copied instead, only with their own book
+            cachedPcm = NULL;
+            if ((bookSample->codec == CODEC_ADPCM) && (currentBook == bookSample->book->book)) {
+                cachedPcm = AdpcmCache_Get(bookSample, &cachedFrames);
+            }
+
             while (numSamplesProcessed != numSamplesToLoadAdj) {
                 sampleFinished = false;
                 loopToPoint = false;
@@ -1060,8 +1155,11 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
                             bytesToRead = bookSample->size - (synthState->samplePosInt * 2);
                         }
                         // 2S2H [Port] [Custom audio] Handle decoding OPUS data
-                        aLoadBuffer(cmd++, sampleAddr + (synthState->samplePosInt * 2), DMEM_UNCOMPRESSED_NOTE,
-                                    bytesToRead);
+                        // @port: streamed custom samples are decoded as they are read
+                        aLoadBuffer(cmd++,
+                                    SampleStream_Fetch(bookSample, synthState, (u8*) sampleAddr,
+                                                       synthState->samplePosInt * 2, bytesToRead),
+                                    DMEM_UNCOMPRESSED_NOTE, bytesToRead);
 
                         goto skip;
                 }
@@ -1079,12 +1177,20 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
                 if (nFramesToDecode != 0) {
                     if (1) {}
                     frameIndex = (synthState->samplePosInt + skipInitialSamples - nFirstFrameSamplesToIgnore) / 16;
-                    sampleDataOffset = frameIndex * frameSize;
-                    samplesToLoadAddr = (u8*) (sampleDmaStart + sampleDataOffset + sampleAddr);
-                    sampleDataChunkAlignPad = ((uintptr_t) samplesToLoadAddr) % SAMPLES_PER_FRAME;
+                    if ((cachedPcm != NULL) && ((u32) (frameIndex + nFramesToDecode) <= cachedFrames)) {
+                        cachedFramePcm = &cachedPcm[frameIndex * SAMPLES_PER_FRAME];
+                        sampleDataChunkAlignPad = 0;
+                    } else {
+                        cachedFramePcm = NULL;
+                        sampleDataOffset = frameIndex * frameSize;
+                        samplesToLoadAddr = (u8*) (sampleDmaStart + sampleDataOffset + sampleAddr);
+                        sampleDataChunkAlignPad = ((uintptr_t) samplesToLoadAddr) % SAMPLES_PER_FRAME;
 
-                    aLoadBuffer(aList++, OS_K0_TO_PHYSICAL(samplesToLoadAddr - sampleDataChunkAlignPad), addr, aligned);
+                        aLoadBuffer(aList++, OS_K0_TO_PHYSICAL(samplesToLoadAddr - sampleDataChunkAlignPad), addr,
+                                    aligned);
+                    }
                 } else {
+                    cachedFramePcm = NULL;
                     numSamplesToDecode = 0;
                     sampleDataChunkAlignPad = 0;
                 }
@@ -1102,7 +1208,12 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
                         case 0:
                             aSetBuffer(aList++, 0, addr + sampleDataChunkAlignPad, DMEM_UNCOMPRESSED_NOTE,
                                        numSamplesToDecode * SAMPLE_SIZE);
-                            aADPCMdec(aList++, flags, OS_K0_TO_PHYSICAL(synthState->synthesisBuffers));
+                            if (cachedFramePcm != NULL) {
+                                aADPCMcopy(aList++, flags, OS_K0_TO_PHYSICAL(synthState->synthesisBuffers),
+                                           cachedFramePcm);
+                            } else {
+                                aADPCMdec(aList++, flags, OS_K0_TO_PHYSICAL(synthState->synthesisBuffers));
+                            }
                             break;
 
                         case 1:
@@ -1119,7 +1230,12 @@ Acmd* AudioSynth_ProcessNote(s32 noteIndex, NoteSubEu* noteSub, NoteSynthesisSta
                         case 0:
                             aSetBuffer(aList++, 0, addr + sampleDataChunkAlignPad, DMEM_UNCOMPRESSED_NOTE + aligned,
                                        numSamplesToDecode * SAMPLE_SIZE);
-                            aADPCMdec(aList++, flags, OS_K0_TO_PHYSICAL(synthState->synthesisBuffers));
+                            if (cachedFramePcm != NULL) {
+                                aADPCMcopy(aList++, flags, OS_K0_TO_PHYSICAL(synthState->synthesisBuffers),
+                                           cachedFramePcm);
+                            } else {
+                                aADPCMdec(aList++, flags, OS_K0_TO_PHYSICAL(synthState->synthesisBuffers));
+                            }
                             break;
 
                         case 1:
@@ -1355,6 +1471,7 @@ Acmd* AudioSynth_ProcessEnvelope(Acmd* aList, NoteSubEu* noteSub, NoteSynthesisS
     synthState->curVolRLeft = curVolRLeft + (rampRLeft * aiBufLenSmall);
     synthState->curVolRRight = curVolRRight + (rampRRight * aiBufLenSmall);
     uint32_t cutoffFreqLfe = CVarGetInteger("gSubwooferThreshold", 80);
+    aSetLfeState(aList++, &synthState->lfeFilterState);
 
     if (noteSub->bitField0.usesHeadsetPanEffects) {
         int32_t num_audio_channels = 2;
@@ -1,27 +1,20 @@
 #include "sys.h"
 #include "sf64audio_provisional.h"
 #include "audiothread_cmd.h"
+#include "port/audio/AudioQueue.h"
 
 void AudioThread_ProcessCmds(u32 msg);
+void AudioThread_UpdateSnapshot(void);
 void AudioThread_SetFadeOutTimer(s32 seqPlayId, s32 fadeTime);
 void AudioThread_SetFadeInTimer(s32 seqPlayId, s32 fadeTime);
 
 OSMesgQueue sAudioTaskStartQueue;
-OSMesgQueue sThreadCmdProcQueue;
-OSMesgQueue sAudioSpecQueue;
-OSMesgQueue sAudioResetQueue;
 AudioCmd gThreadCmdBuffer[256];
 OSMesg sAudioTaskStartMsg[1];
-OSMesg sThreadCmdProcMsg[4];
-OSMesg sAudioSpecMsg[1];
-OSMesg sAudioResetMsg[1];
 
 u8 gThreadCmdWritePos = 0;
 u8 gThreadCmdReadPos = 0;
 OSMesgQueue* gAudioTaskStartQueue = &sAudioTaskStartQueue;
-OSMesgQueue* gThreadCmdProcQueue = &sThreadCmdProcQueue;
-OSMesgQueue* gAudioSpecQueue = &sAudioSpecQueue;
-OSMesgQueue* gAudioResetQueue = &sAudioResetQueue;
 
 static const char devstr0[] = "DAC:Lost 1 Frame.\n";
 static const char devstr1[] = "DMA: Request queue over.( %d )\n";
@@ -39,12 +32,45 @@ static const char devstr12[] = "Undefined Port Command %d\n";
 static const char devstr13[] = "specchg conjunction error (Msg:%d Cur:%d)\n";
 static const char devstr14[] = "Error : Queue is not empty ( %x ) \n";
 
+// @port: copies what the game thread reads of the sequence players, see AudioSnapshot
+void AudioThread_UpdateSnapshot(void) {
+    AudioSnapshot* snapshot = AudioQueue_GetSnapshotForWrite();
+    SequenceChannel* channel;
+    SequenceLayer* layer;
+    s32 i;
+
+    for (i = 0; i < AUDIO_SNAPSHOT_PLAYERS; i++) {
+        snapshot->playerEnabled[i] = gSeqPlayers[i].enabled;
+        snapshot->playerTempo[i] = gSeqPlayers[i].tempo;
+    }
+
+    for (i = 0; i < AUDIO_SNAPSHOT_CHANNELS; i++) {
+        channel = gSeqPlayers[SEQ_PLAYER_SFX].channels[i];
+        snapshot->sfxChannelValid[i] = IS_SEQUENCE_CHANNEL_VALID(channel);
+        snapshot->sfxChannelReverb[i] = snapshot->sfxChannelValid[i] ? channel->seqScriptIO[6] : 0;
+        snapshot->sfxChannelState[i] = snapshot->sfxChannelValid[i] ? channel->seqScriptIO[7] : 0;
+    }
+
+    channel = gSeqPlayers[SEQ_PLAYER_VOICE].channels[15];
+    snapshot->voiceChannelValid = IS_SEQUENCE_CHANNEL_VALID(channel);
+    snapshot->voiceChannelPlaying = snapshot->voiceChannelValid ? channel->seqScriptIO[1] : 0;
+    snapshot->voiceStatus = 0;
+    if (snapshot->voiceChannelValid && (snapshot->voiceChannelPlaying == 1)) {
+        layer = channel->layers[0];
+        if ((layer != NULL) && (layer->note != NULL)) {
+            snapshot->voiceStatus = (layer != layer->note->playbackState.parentLayer) ? 2 : 1;
+        }
+    }
+
+    AudioQueue_PublishSnapshot();
+}
+
 void AudioThread_CreateNextAudioBuffer(s16* samples, u32 num_samples) {
     static s32 gMaxAbiCmdCnt = 128;
     static SPTask* gWaitingAudioTask = NULL;
     s32 abiCmdCount;
-    OSMesg specId;
-    OSMesg msg;
+    u8 specId;
+    u32 msg;
 
     gCurAiBuffIndex++;
     gCurAiBuffIndex %= 3;
@@ -53,18 +79,21 @@ void AudioThread_CreateNextAudioBuffer(s16* samples, u32 num_samples) {
     AudioLoad_DecreaseSampleDmaTtls();
     AudioLoad_ProcessLoads(gAudioResetStep);
 
-    if (osRecvMesg(gAudioSpecQueue, &specId, 0) != -1) {
+    // @port: the game thread may be running at the same time, take the spec and the commands from the lock-free
+    // queues instead of the message queues
+    if (AudioQueue_Receive(AUDIO_MAILBOX_SPEC, &specId)) {
         if (gAudioResetStep == 0) {
             gAudioResetStep = 5;
         }
-        gAudioSpecId = specId.data8;
+        gAudioSpecId = specId;
     }
 
     if ((gAudioResetStep != 0) && (AudioHeap_ResetStep() == 0)) {
         if (gAudioResetStep == 0) {
-            osSendMesg8(gAudioResetQueue, gAudioSpecId, OS_MESG_NOBLOCK);
+            AudioQueue_Send(AUDIO_MAILBOX_RESET, gAudioSpecId);
         }
         gWaitingAudioTask = NULL;
+        AudioThread_UpdateSnapshot();
         return;
     }
 
@@ -75,11 +104,12 @@ void AudioThread_CreateNextAudioBuffer(s16* samples, u32 num_samples) {
         gAudioResetTimer++;
     }
 
-    while (MQ_GET_MESG(gThreadCmdProcQueue, &msg)) {
-        AudioThread_ProcessCmds(msg.data32);
+    while (AudioQueue_ReceiveCmds(&msg)) {
+        AudioThread_ProcessCmds(msg);
     }
 
     AudioSynth_Update(gCurAbiCmdBuffer, &abiCmdCount, samples, num_samples);
+    AudioThread_UpdateSnapshot();
 
     // Spectrum Analyzer fix
     memcpy(gAiBuffers[gCurAiBuffIndex], samples, GetNumAudioChannels() * num_samples * sizeof(s16));
@@ -98,7 +128,7 @@ SPTask* AudioThread_CreateTask() {
     OSTask_t* task;
     u16* aiBuffer;
     s32 pad3C;
-    u32 specId;
+    u8 specId;
     u32 msg;
     s32 pad30;
 
@@ -124,7 +154,7 @@ SPTask* AudioThread_CreateTask() {
     AudioLoad_DecreaseSampleDmaTtls();
     AudioLoad_ProcessLoads(gAudioResetStep);
 
-    if (MQ_GET_MESG(gAudioSpecQueue, &specId)) {
+    if (AudioQueue_Receive(AUDIO_MAILBOX_SPEC, &specId)) {
         if (gAudioResetStep == 0) {
             gAudioResetStep = 5;
         }
@@ -133,7 +163,7 @@ SPTask* AudioThread_CreateTask() {
 
     if ((gAudioResetStep != 0) && (AudioHeap_ResetStep() == 0)) {
         if (gAudioResetStep == 0) {
-            osSendMesg(gAudioResetQueue, OS_MESG_32((s32) gAudioSpecId), OS_MESG_NOBLOCK);
+            AudioQueue_Send(AUDIO_MAILBOX_RESET, gAudioSpecId);
         }
         gWaitingAudioTask = NULL;
         return NULL;
@@ -158,7 +188,7 @@ SPTask* AudioThread_CreateTask() {
     if (gAiBuffLengths[aiBuffIndex] > gAudioBufferParams.maxAiBufferLength) {
         gAiBuffLengths[aiBuffIndex] = gAudioBufferParams.maxAiBufferLength;
     }
-    while (MQ_GET_MESG(gThreadCmdProcQueue, &msg)) {
+    while (AudioQueue_ReceiveCmds(&msg)) {
         AudioThread_ProcessCmds(msg);
     }
     gCurAbiCmdBuffer = AudioSynth_Update(gCurAbiCmdBuffer, &abiCmdCount, aiBuffer, gAiBuffLengths[aiBuffIndex]);
@@ -298,9 +328,7 @@ void AudioThread_InitQueues(void) {
     gThreadCmdWritePos = 0;
     gThreadCmdReadPos = 0;
     osCreateMesgQueue(gAudioTaskStartQueue, sAudioTaskStartMsg, 1);
-    osCreateMesgQueue(gThreadCmdProcQueue, sThreadCmdProcMsg, 4);
-    osCreateMesgQueue(gAudioSpecQueue, sAudioSpecMsg, 1);
-    osCreateMesgQueue(gAudioResetQueue, sAudioResetMsg, 1);
+    AudioQueue_Reset();
 }
 
 void AudioThread_QueueCmd(AudioCmd cmd) {
@@ -309,7 +337,8 @@ void AudioThread_QueueCmd(AudioCmd cmd) {
     *audioCmd = cmd;
 
     gThreadCmdWritePos++;
-    if (gThreadCmdWritePos == gThreadCmdReadPos) {
+    // @port: full once the next slot is one the audio thread has not processed yet
+    if (gThreadCmdWritePos == AudioQueue_GetCmdReadPos()) {
         gThreadCmdWritePos--;
     }
 }
@@ -339,18 +368,17 @@ void AudioThread_QueueCmdS8(u32 opArgs, s8 val) {
 
 void AudioThread_ScheduleProcessCmds(void) {
     static s32 D_800C7C70 = 0;
-    s32 msg;
 
     if (D_800C7C70 < (u8) (gThreadCmdWritePos - gThreadCmdReadPos + 0x100)) {
         D_800C7C70 = (u8) (gThreadCmdWritePos - gThreadCmdReadPos + 0x100);
     }
-    msg = (((gThreadCmdReadPos & 0xFF) << 8) | (gThreadCmdWritePos & 0xFF));
-    osSendMesg(gThreadCmdProcQueue, OS_MESG_32(msg), OS_MESG_NOBLOCK);
+    AudioQueue_PublishCmds(gThreadCmdWritePos);
     gThreadCmdReadPos = gThreadCmdWritePos;
 }
 
 void AudioThread_ResetCmdQueue(void) {
-    gThreadCmdReadPos = gThreadCmdWritePos;
+    // @port: drop the commands that were not scheduled yet by rewinding, published ranges have to stay contiguous
+    gThreadCmdWritePos = gThreadCmdReadPos;
 }
 
 void AudioThread_ProcessCmds(u32 msg) {
@@ -457,6 +485,7 @@ void AudioThread_ProcessCmds(u32 msg) {
         }
         cmd->op = 0;
     }
+    AudioQueue_ConsumeCmds(gCurCmdReadPos);
 }
 
 u32 AudioThread_GetAsyncLoadStatus(u32* outData) {
@@ -471,24 +500,22 @@ u8* AudioThread_GetFontsForSequence(s32 seqId, u32* outNumFonts) {
 
 bool AudioThread_ResetComplete(void) {
     s32 pad;
-    OSMesg sp18;
+    u8 sp18;
 
-    if (!MQ_GET_MESG(gAudioResetQueue, &sp18)) {
+    if (!AudioQueue_Receive(AUDIO_MAILBOX_RESET, &sp18)) {
         return false;
     }
-    if (sp18.data8 != gAudioSpecId) {
+    if (sp18 != gAudioSpecId) {
         return false;
     }
     return true;
 }
 
 void AudioThread_ResetAudioHeap(s32 specId) {
-    OSMesg msg;
-    msg.data8 = specId & 0xFF;
-    MQ_CLEAR_QUEUE(gAudioResetQueue);
+    AudioQueue_Clear(AUDIO_MAILBOX_RESET);
 
     AudioThread_ResetCmdQueue();
-    osSendMesg8(gAudioSpecQueue, msg.data8, OS_MESG_NOBLOCK);
+    AudioQueue_Send(AUDIO_MAILBOX_SPEC, specId & 0xFF);
 }
 
 void AudioThread_PreNMIReset(void) {
@@ -1,12 +1,13 @@
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 
 #include <macros.h>
 
-#include "mixer.h"
+#include "mixer_internal.h"
 
 #ifndef __clang__
 #pragma GCC optimize("unroll-loops")
@@ -24,6 +25,11 @@
 #include "sse2neon.h"
 #endif
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
 #ifdef SSE2_AVAILABLE
 typedef struct {
     __m128i lo, hi;
@@ -64,39 +70,38 @@ static m256i m256i_srai(m256i a, int b) {
 static __m128i m256i_clamp_to_m128i(m256i a) {
     return _mm_packs_epi32(a.lo, a.hi);
 }
+
+// (int16_t) (a * b >> 16) for a signed and b unsigned. _mm_mulhi_epi16 reads b as b - 0x10000 when its top bit is
+// set, which takes a off the result.
+static __m128i mulhi_epi16_epu16(__m128i a, __m128i b) {
+    __m128i hi = _mm_mulhi_epi16(a, b);
+    return _mm_add_epi16(hi, _mm_and_si128(a, _mm_srai_epi16(b, 15)));
+}
 #endif
 
-#define ROUND_UP_64(v) (((v) + 63) & ~63)
-#define ROUND_UP_32(v) (((v) + 31) & ~31)
-#define ROUND_UP_16(v) (((v) + 15) & ~15)
-#define ROUND_UP_8(v) (((v) + 7) & ~7)
-#define ROUND_DOWN_16(v) ((v) & ~0xf)
+// The scalar kernels are the reference for the SIMD ones. With SSE2 or NEON they are still built, named
+// <kernel>Scalar, for aMixerCheckKernel. Nothing else calls them, so the game build drops them.
+#ifdef SSE2_AVAILABLE
+#define SCALAR_KERNEL(impl) static inline void impl##Scalar
+#else
+#define SCALAR_KERNEL(impl) void impl
+#endif
 
-#define DMEM_BUF_SIZE (0x1B90) // 7056 B
-#define BUF_U8(a) (rspa.buf + ((a) -0x450))
+#define BUF_U8(a) CTX_BUF_U8(rspa, a)
 #define BUF_S16(a) (int16_t*) BUF_U8(a)
 
-#define SAMPLE_RATE 32000 // Adjusted to match the actual sample rate of 32 kHz
-
-static struct {
-    uint16_t in;
-    uint16_t out;
-    uint16_t nbytes;
-
-    uint16_t vol[6];
-    uint16_t rate[6];
-    uint16_t vol_wet;
-    uint16_t rate_wet;
-
-    ADPCM_STATE* adpcm_loop_state;
-
-    int16_t adpcm_table[8][2][8];
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
 
-    uint16_t filter_count;
-    int16_t filter[8];
+// Commands run against the calling thread's context, every thread starts out on the shared one
+static AudioMixerContext sDefaultContext;
+static THREAD_LOCAL AudioMixerContext* rspa = &sDefaultContext;
 
-    uint8_t buf[DMEM_BUF_SIZE];
-} rspa;
+// Set by aMixerInit when the CPU runs AVX2, the kernels that have an AVX2 version hand their work to it
+static const MixerAvx2Kernels* sAvx2Kernels;
 
 static int16_t resample_table[64][4] = {
     { 0x0c39, 0x66ad, 0x0d46, 0xffdf }, { 0x0b39, 0x6696, 0x0e5f, 0xffd8 }, { 0x0a44, 0x6669, 0x0f83, 0xffd0 },
@@ -163,26 +168,26 @@ void aSaveBufferImpl(uint16_t source_addr, int16_t* dest_addr, uint16_t nbytes)
 }
 
 void aLoadADPCMImpl(int num_entries_times_16, const int16_t* book_source_addr) {
-    memcpy(rspa.adpcm_table, book_source_addr, num_entries_times_16);
+    memcpy(rspa->adpcm_table, book_source_addr, num_entries_times_16);
 }
 
 void aSetBufferImpl(uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes) {
-    rspa.in = in;
-    rspa.out = out;
-    rspa.nbytes = nbytes;
+    rspa->in = in;
+    rspa->out = out;
+    rspa->nbytes = nbytes;
 }
 
-void aInterleaveImpl(uint16_t left, uint16_t right, uint16_t center, uint16_t lfe, uint16_t surround_left,
-                     uint16_t surround_right, uint16_t num_channels) {
-    if (rspa.nbytes == 0) {
+SCALAR_KERNEL(aInterleaveImpl)(uint16_t left, uint16_t right, uint16_t center, uint16_t lfe,
+                               uint16_t surround_left, uint16_t surround_right, uint16_t num_channels) {
+    if (rspa->nbytes == 0) {
         return;
     }
 
-    int count = rspa.nbytes / (num_channels * sizeof(int16_t));
+    int count = rspa->nbytes / (num_channels * sizeof(int16_t));
 
     int16_t* l = BUF_S16(left);
     int16_t* r = BUF_S16(right);
-    int16_t* d = BUF_S16(rspa.out);
+    int16_t* d = BUF_S16(rspa->out);
 
     if (num_channels == 2) {
         for (int i = 0; i < count; i++) {
@@ -206,25 +211,114 @@ void aInterleaveImpl(uint16_t left, uint16_t right, uint16_t center, uint16_t lf
     }
 }
 
+#ifdef SSE2_AVAILABLE
+
+void aInterleaveImpl(uint16_t left, uint16_t right, uint16_t center, uint16_t lfe, uint16_t surround_left,
+                     uint16_t surround_right, uint16_t num_channels) {
+    if (rspa->nbytes == 0) {
+        return;
+    }
+
+    int count = rspa->nbytes / (num_channels * sizeof(int16_t));
+    int i = 0;
+
+    int16_t* l = BUF_S16(left);
+    int16_t* r = BUF_S16(right);
+    int16_t* d = BUF_S16(rspa->out);
+
+    if (num_channels == 2) {
+        for (; i + 8 <= count; i += 8) {
+            __m128i lVec = _mm_loadu_si128((__m128i*) l);
+            __m128i rVec = _mm_loadu_si128((__m128i*) r);
+            _mm_storeu_si128((__m128i*) d, _mm_unpacklo_epi16(lVec, rVec));
+            _mm_storeu_si128((__m128i*) (d + 8), _mm_unpackhi_epi16(lVec, rVec));
+            l += 8;
+            r += 8;
+            d += 16;
+        }
+        for (; i < count; i++) {
+            *d++ = *l++;
+            *d++ = *r++;
+        }
+    } else {
+        int16_t* c = BUF_S16(center);
+        int16_t* lf = BUF_S16(lfe);
+        int16_t* sl = BUF_S16(surround_left);
+        int16_t* sr = BUF_S16(surround_right);
+
+        for (; i + 8 <= count; i += 8) {
+            __m128i lVec = _mm_loadu_si128((__m128i*) l);
+            __m128i rVec = _mm_loadu_si128((__m128i*) r);
+            __m128i cVec = _mm_loadu_si128((__m128i*) c);
+            __m128i lfVec = _mm_loadu_si128((__m128i*) lf);
+            __m128i slVec = _mm_loadu_si128((__m128i*) sl);
+            __m128i srVec = _mm_loadu_si128((__m128i*) sr);
+            // Pair up the channels, each 32 bit lane then holds one sample of a pair: a = l r, b = c lfe, c = sl sr
+            __m128i pairs[2][3] = {
+                { _mm_unpacklo_epi16(lVec, rVec), _mm_unpacklo_epi16(cVec, lfVec), _mm_unpacklo_epi16(slVec, srVec) },
+                { _mm_unpackhi_epi16(lVec, rVec), _mm_unpackhi_epi16(cVec, lfVec), _mm_unpackhi_epi16(slVec, srVec) },
+            };
+
+            for (int h = 0; h < 2; h++) {
+                __m128 a = _mm_castsi128_ps(pairs[h][0]);
+                __m128 b = _mm_castsi128_ps(pairs[h][1]);
+                __m128 cc = _mm_castsi128_ps(pairs[h][2]);
+                __m128 abLo = _mm_unpacklo_ps(a, b);  // a0 b0 a1 b1
+                __m128 abHi = _mm_unpackhi_ps(a, b);  // a2 b2 a3 b3
+                __m128 bcLo = _mm_unpacklo_ps(b, cc); // b0 c0 b1 c1
+                __m128 bcHi = _mm_unpackhi_ps(b, cc); // b2 c2 b3 c3
+                __m128 caLo = _mm_unpacklo_ps(cc, a); // c0 a0 c1 a1
+                __m128 caHi = _mm_unpackhi_ps(cc, a); // c2 a2 c3 a3
+
+                // a0 b0 c0 a1 | b1 c1 a2 b2 | c2 a3 b3 c3
+                _mm_storeu_si128((__m128i*) d, _mm_castps_si128(_mm_shuffle_ps(abLo, caLo, _MM_SHUFFLE(3, 0, 1, 0))));
+                _mm_storeu_si128((__m128i*) (d + 8),
+                                 _mm_castps_si128(_mm_shuffle_ps(bcLo, abHi, _MM_SHUFFLE(1, 0, 3, 2))));
+                _mm_storeu_si128((__m128i*) (d + 16),
+                                 _mm_castps_si128(_mm_shuffle_ps(caHi, bcHi, _MM_SHUFFLE(3, 2, 3, 0))));
+                d += 24;
+            }
+            l += 8;
+            r += 8;
+            c += 8;
+            lf += 8;
+            sl += 8;
+            sr += 8;
+        }
+        for (; i < count; i++) {
+            *d++ = *l++;
+            *d++ = *r++;
+            *d++ = *c++;
+            *d++ = *lf++;
+            *d++ = *sl++;
+            *d++ = *sr++;
+        }
+    }
+}
+
+#endif
+
 void aDMEMMoveImpl(uint16_t in_addr, uint16_t out_addr, int nbytes) {
     nbytes = ROUND_UP_16(nbytes);
     memmove(BUF_U8(out_addr), BUF_U8(in_addr), nbytes);
 }
 
 void aSetLoopImpl(ADPCM_STATE* adpcm_loop_state) {
-    rspa.adpcm_loop_state = adpcm_loop_state;
+    rspa->adpcm_loop_state = adpcm_loop_state;
 }
 
-#ifndef SSE2_AVAILABLE
+void aSetLfeStateImpl(float* lfe_state) {
+    rspa->lfe_state = lfe_state;
+}
 
-void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
-    uint8_t* in = BUF_U8(rspa.in);
-    int16_t* out = BUF_S16(rspa.out);
-    int nbytes = ROUND_UP_32(rspa.nbytes);
+SCALAR_KERNEL(aADPCMdecImpl)(uint8_t flags, ADPCM_STATE state) {
+    uint8_t* in = BUF_U8(rspa->in);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_32(rspa->nbytes);
     if (flags & A_INIT) {
         memset(out, 0, 16 * sizeof(int16_t));
     } else if (flags & A_LOOP) {
-        memcpy(out, rspa.adpcm_loop_state, 16 * sizeof(int16_t));
+        memcpy(out, rspa->adpcm_loop_state, 16 * sizeof(int16_t));
     } else {
         memcpy(out, state, 16 * sizeof(int16_t));
     }
@@ -233,7 +327,7 @@ void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
     while (nbytes > 0) {
         int shift = *in >> 4;          // should be in 0..12 or 0..14
         int table_index = *in++ & 0xf; // should be in 0..7
-        int16_t(*tbl)[8] = rspa.adpcm_table[table_index];
+        int16_t(*tbl)[8] = rspa->adpcm_table[table_index];
         int i;
 
         for (i = 0; i < 2; i++) {
@@ -268,7 +362,7 @@ void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
     memcpy(state, out - 16, 16 * sizeof(int16_t));
 }
 
-#else
+#ifdef SSE2_AVAILABLE
 
 static uint16_t lower_4bit[] = {
     0xf,
@@ -277,19 +371,22 @@ static uint16_t lower_4bit[] = {
     0xf,
 };
 
+// Loaded 8 bytes at a time like lower_4bit, only the first two lanes are used
 static uint16_t lower_2bit[] = {
     0x3,
     0x3,
+    0x3,
+    0x3,
 };
 
 void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
-    uint8_t* in = BUF_U8(rspa.in);
-    int16_t* out = BUF_S16(rspa.out);
-    int nbytes = ROUND_UP_32(rspa.nbytes);
+    uint8_t* in = BUF_U8(rspa->in);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_32(rspa->nbytes);
     if (flags & A_INIT) {
         memset(out, 0, 16 * sizeof(int16_t));
     } else if (flags & A_LOOP) {
-        memcpy(out, rspa.adpcm_loop_state, 16 * sizeof(int16_t));
+        memcpy(out, rspa->adpcm_loop_state, 16 * sizeof(int16_t));
     } else {
         memcpy(out, state, 16 * sizeof(int16_t));
     }
@@ -302,7 +399,7 @@ void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
         int shift = *in >> 4; // should be in 0..12 or 0..14
         __m128i shift_vec = _mm_set1_epi16(shift);
         int table_index = *in++ & 0xf; // should be in 0..7
-        int16_t(*tbl)[8] = rspa.adpcm_table[table_index];
+        int16_t(*tbl)[8] = rspa->adpcm_table[table_index];
 
         for (int i = 0; i < 2; i++) {
             int16_t ins[8];
@@ -319,10 +416,9 @@ void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
                 __m128i in_vec_uplower2bit = _mm_and_si128(_mm_srli_epi16(ins_vec, 4), mask_2bit);
                 __m128i in_vec_lowerup2bit = _mm_and_si128(_mm_srli_epi16(ins_vec, 2), mask_2bit);
                 __m128i in_vec_lower2bit = _mm_and_si128(ins_vec, mask_2bit);
+                // Four samples per byte, highest bits first
                 __m128i in_vec_up = _mm_unpacklo_epi16(in_vec_up2bit, in_vec_uplower2bit);
-                in_vec_up = _mm_shuffle_epi32(in_vec_up, _MM_SHUFFLE(3, 1, 2, 0));
-                __m128i in_vec_low = _mm_unpacklo_epi16(in_vec_lower2bit, in_vec_lowerup2bit);
-                in_vec_low = _mm_shuffle_epi32(in_vec_low, _MM_SHUFFLE(3, 1, 2, 0));
+                __m128i in_vec_low = _mm_unpacklo_epi16(in_vec_lowerup2bit, in_vec_lower2bit);
                 ins_vec = _mm_unpacklo_epi32(in_vec_up, in_vec_low);
                 ins_vec = _mm_slli_epi16(ins_vec, 14);
                 ins_vec = _mm_srai_epi16(ins_vec, 14);
@@ -393,14 +489,30 @@ void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
 
 #endif
 
-#ifndef SSE2_AVAILABLE
+// Same output as aADPCMdec for samples already decoded to pcm, starting at the frame aADPCMdec would decode first
+void aADPCMcopyImpl(uint8_t flags, ADPCM_STATE state, const int16_t* pcm) {
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_32(rspa->nbytes);
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(int16_t));
+    } else if (flags & A_LOOP) {
+        memcpy(out, rspa->adpcm_loop_state, 16 * sizeof(int16_t));
+    } else {
+        memcpy(out, state, 16 * sizeof(int16_t));
+    }
+    out += 16;
+
+    memcpy(out, pcm, nbytes);
+    out += nbytes / sizeof(int16_t);
+    memcpy(state, out - 16, 16 * sizeof(int16_t));
+}
 
-void aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
+SCALAR_KERNEL(aResampleImpl)(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
     int16_t tmp[16];
-    int16_t* in_initial = BUF_S16(rspa.in);
+    int16_t* in_initial = BUF_S16(rspa->in);
     int16_t* in = in_initial;
-    int16_t* out = BUF_S16(rspa.out);
-    int nbytes = ROUND_UP_16(rspa.nbytes);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_16(rspa->nbytes);
     uint32_t pitch_accumulator;
     int i;
     int16_t* tbl;
@@ -444,7 +556,7 @@ void aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
     memcpy(state + 8, in, 8 * sizeof(int16_t));
 }
 
-#else
+#ifdef SSE2_AVAILABLE
 
 static const ALIGN_ASSET(16) int32_t x4000[4] = {
     0x4000,
@@ -485,10 +597,10 @@ static __m128i move_two_4x16(int16_t* a, int16_t* b) {
 
 void aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
     int16_t tmp[32];
-    int16_t* in_initial = BUF_S16(rspa.in);
+    int16_t* in_initial = BUF_S16(rspa->in);
     int16_t* in = in_initial;
-    int16_t* out = BUF_S16(rspa.out);
-    int nbytes = ROUND_UP_16(rspa.nbytes);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_16(rspa->nbytes);
     uint32_t pitch_accumulator;
     int i;
 
@@ -611,28 +723,29 @@ void aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
 
 void aEnvSetup1Impl(uint8_t initial_vol_wet, uint16_t rate_wet, uint16_t rate_left, uint16_t rate_right,
                     uint16_t rate_center, uint16_t rate_lfe, uint16_t rate_rear_left, uint16_t rate_rear_right) {
-    rspa.vol_wet = (uint16_t) (initial_vol_wet << 8);
-    rspa.rate_wet = rate_wet;
-    rspa.rate[0] = rate_left;
-    rspa.rate[1] = rate_right;
-    rspa.rate[2] = rate_center;
-    rspa.rate[3] = rate_lfe;
-    rspa.rate[4] = rate_rear_left;
-    rspa.rate[5] = rate_rear_right;
+    rspa->vol_wet = (uint16_t) (initial_vol_wet << 8);
+    rspa->rate_wet = rate_wet;
+    rspa->rate[0] = rate_left;
+    rspa->rate[1] = rate_right;
+    rspa->rate[2] = rate_center;
+    rspa->rate[3] = rate_lfe;
+    rspa->rate[4] = rate_rear_left;
+    rspa->rate[5] = rate_rear_right;
 }
 
 void aEnvSetup2Impl(uint16_t initial_vol_left, uint16_t initial_vol_right, int16_t initial_vol_center,
                     int16_t initial_vol_lfe, int16_t initial_vol_rear_left, int16_t initial_vol_rear_right) {
-    rspa.vol[0] = initial_vol_left;
-    rspa.vol[1] = initial_vol_right;
-    rspa.vol[2] = initial_vol_center;
-    rspa.vol[3] = initial_vol_lfe;
-    rspa.vol[4] = initial_vol_rear_left;
-    rspa.vol[5] = initial_vol_rear_right;
+    rspa->vol[0] = initial_vol_left;
+    rspa->vol[1] = initial_vol_right;
+    rspa->vol[2] = initial_vol_center;
+    rspa->vol[3] = initial_vol_lfe;
+    rspa->vol[4] = initial_vol_rear_left;
+    rspa->vol[5] = initial_vol_rear_right;
 }
 
-void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool neg_left, bool neg_right,
-                   uint32_t wet_dry_addr, uint32_t haas_temp_addr, uint32_t num_channels, uint32_t cutoff_freq_lfe) {
+SCALAR_KERNEL(aEnvMixerImpl)(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool neg_left,
+                             bool neg_right, uint32_t wet_dry_addr, uint32_t haas_temp_addr, uint32_t num_channels,
+                             uint32_t cutoff_freq_lfe) {
     // Note: max number of samples is 192 (192 * 2 = 384 bytes = 0x180)
     int max_num_samples = 192;
 
@@ -642,8 +755,8 @@ void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool
         printf("Warning: n_samples is too large: %d\n", n_samples);
     }
 
-    uint16_t rate_wet = rspa.rate_wet;
-    uint16_t vol_wet = rspa.vol_wet;
+    uint16_t rate_wet = rspa->rate_wet;
+    uint16_t vol_wet = rspa->vol_wet;
 
     // All speakers
     int dry_addr_start = wet_dry_addr & 0xFFFF;
@@ -656,7 +769,7 @@ void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool
         wet[i] = BUF_S16(wet_addr_start + max_num_samples * i * sizeof(int16_t));
     }
 
-    uint16_t vols[6] = { rspa.vol[0], rspa.vol[1], rspa.vol[2], rspa.vol[3], rspa.vol[4], rspa.vol[5] };
+    uint16_t vols[6] = { rspa->vol[0], rspa->vol[1], rspa->vol[2], rspa->vol[3], rspa->vol[4], rspa->vol[5] };
     int swapped[2] = { swap_reverb ? 1 : 0, swap_reverb ? 0 : 1 };
 
     if (num_channels == 6) {
@@ -666,7 +779,8 @@ void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool
         float alpha = dt / (RC + dt);
 
         // Low-pass filter state for the subwoofer channel
-        static float prev_lfe_sample = 0.0f;
+        float* lfe_state = rspa->lfe_state != NULL ? rspa->lfe_state : &rspa->lfe_state_default;
+        float prev_lfe_sample = *lfe_state;
 
         for (int i = 0; i < n / 8; i++) {
             for (int k = 0; k < 8; k++) {
@@ -706,10 +820,11 @@ void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool
             }
 
             for (int j = 0; j < 6; j++) {
-                vols[j] += rspa.rate[j];
+                vols[j] += rspa->rate[j];
             }
             vol_wet += rate_wet;
         }
+        *lfe_state = prev_lfe_sample;
     } else {
         // Account for haas effect
         int haas_addr_left = haas_temp_addr >> 16;
@@ -748,16 +863,157 @@ void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool
             }
 
             for (int j = 0; j < 2; j++) {
-                vols[j] += rspa.rate[j];
+                vols[j] += rspa->rate[j];
             }
             vol_wet += rate_wet;
         }
     }
 }
 
-#ifndef SSE2_AVAILABLE
+#ifdef SSE2_AVAILABLE
 
-void aMixImpl(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr) {
+static void aEnvMixerImplSse2(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool neg_left, bool neg_right,
+                              uint32_t wet_dry_addr, uint32_t haas_temp_addr, uint32_t num_channels,
+                              uint32_t cutoff_freq_lfe) {
+    // Note: max number of samples is 192 (192 * 2 = 384 bytes = 0x180)
+    int max_num_samples = 192;
+
+    int16_t* in = BUF_S16(in_addr);
+    int n = ROUND_UP_16(n_samples);
+    if (n > max_num_samples) {
+        printf("Warning: n_samples is too large: %d\n", n_samples);
+    }
+
+    uint16_t rate_wet = rspa->rate_wet;
+    uint16_t vol_wet = rspa->vol_wet;
+
+    // All speakers
+    int dry_addr_start = wet_dry_addr & 0xFFFF;
+    int wet_addr_start = wet_dry_addr >> 16;
+
+    int16_t* dry[6];
+    int16_t* wet[6];
+    for (int i = 0; i < 6; i++) {
+        dry[i] = BUF_S16(dry_addr_start + max_num_samples * i * sizeof(int16_t));
+        wet[i] = BUF_S16(wet_addr_start + max_num_samples * i * sizeof(int16_t));
+    }
+
+    uint16_t vols[6] = { rspa->vol[0], rspa->vol[1], rspa->vol[2], rspa->vol[3], rspa->vol[4], rspa->vol[5] };
+    int swapped[2] = { swap_reverb ? 1 : 0, swap_reverb ? 0 : 1 };
+    __m128i samples[6];
+
+    // The volumes only ramp every 8 samples, so each block of 8 is one vector per speaker
+    if (num_channels == 6) {
+        // Calculate the filter coefficient
+        float RC = 1.f / (2 * M_PI * cutoff_freq_lfe);
+        float dt = 1.f / SAMPLE_RATE;
+        float alpha = dt / (RC + dt);
+
+        // Low-pass filter state for the subwoofer channel
+        float* lfe_state = rspa->lfe_state != NULL ? rspa->lfe_state : &rspa->lfe_state_default;
+        float prev_lfe_sample = *lfe_state;
+
+        for (int i = 0; i < n / 8; i++) {
+            __m128i inVec = _mm_loadu_si128((__m128i*) in);
+            in += 8;
+
+            // Apply volume
+            for (int j = 0; j < 6; j++) {
+                samples[j] = mulhi_epi16_epu16(inVec, _mm_set1_epi16(vols[j]));
+            }
+
+            // Apply low-pass filter to the LFE channel (index 3), it depends on the previous sample
+            int16_t lfe[8];
+            _mm_storeu_si128((__m128i*) lfe, samples[3]);
+            for (int k = 0; k < 8; k++) {
+                float lfe_sample = lfe[k];
+                lfe_sample = alpha * lfe_sample + (1.0f - alpha) * prev_lfe_sample;
+                prev_lfe_sample = lfe_sample;
+                lfe[k] = (int16_t) lfe_sample;
+            }
+            samples[3] = _mm_loadu_si128((__m128i*) lfe);
+
+            // Mix dry and wet signals
+            __m128i volWetVec = _mm_set1_epi16(vol_wet);
+            for (int j = 0; j < 6; j++) {
+                __m128i dryVec = _mm_loadu_si128((__m128i*) dry[j]);
+                _mm_storeu_si128((__m128i*) dry[j], _mm_adds_epi16(dryVec, samples[j]));
+                dry[j] += 8;
+
+                if (j < 2) {
+                    // Apply reverb only to the front stereo channels wet
+                    // They will be mixed with the rear channels later
+                    __m128i wetVec = _mm_loadu_si128((__m128i*) wet[j]);
+                    __m128i reverb = mulhi_epi16_epu16(samples[swapped[j]], volWetVec);
+                    _mm_storeu_si128((__m128i*) wet[j], _mm_adds_epi16(wetVec, reverb));
+                    wet[j] += 8;
+                }
+            }
+
+            for (int j = 0; j < 6; j++) {
+                vols[j] += rspa->rate[j];
+            }
+            vol_wet += rate_wet;
+        }
+        *lfe_state = prev_lfe_sample;
+    } else {
+        // Account for haas effect
+        int haas_addr_left = haas_temp_addr >> 16;
+        int haas_addr_right = haas_temp_addr & 0xFFFF;
+
+        if (haas_addr_left) {
+            dry[0] = BUF_S16(haas_addr_left);
+        } else if (haas_addr_right) {
+            dry[1] = BUF_S16(haas_addr_right);
+        }
+
+        __m128i negs[2] = { _mm_set1_epi16(neg_left ? 0 : 0xFFFF), _mm_set1_epi16(neg_right ? 0 : 0xFFFF) };
+
+        for (int i = 0; i < n / 8; i++) {
+            __m128i inVec = _mm_loadu_si128((__m128i*) in);
+            in += 8;
+
+            // Apply volume
+            for (int j = 0; j < 2; j++) {
+                samples[j] = _mm_and_si128(mulhi_epi16_epu16(inVec, _mm_set1_epi16(vols[j])), negs[j]);
+            }
+
+            // Mix dry and wet signals
+            __m128i volWetVec = _mm_set1_epi16(vol_wet);
+            for (int j = 0; j < 2; j++) {
+                __m128i dryVec = _mm_loadu_si128((__m128i*) dry[j]);
+                _mm_storeu_si128((__m128i*) dry[j], _mm_adds_epi16(dryVec, samples[j]));
+                dry[j] += 8;
+
+                // Apply reverb
+                __m128i wetVec = _mm_loadu_si128((__m128i*) wet[j]);
+                __m128i reverb = mulhi_epi16_epu16(samples[swapped[j]], volWetVec);
+                _mm_storeu_si128((__m128i*) wet[j], _mm_adds_epi16(wetVec, reverb));
+                wet[j] += 8;
+            }
+
+            for (int j = 0; j < 2; j++) {
+                vols[j] += rspa->rate[j];
+            }
+            vol_wet += rate_wet;
+        }
+    }
+}
+
+void aEnvMixerImpl(uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool neg_left, bool neg_right,
+                   uint32_t wet_dry_addr, uint32_t haas_temp_addr, uint32_t num_channels, uint32_t cutoff_freq_lfe) {
+    if (sAvx2Kernels != NULL) {
+        sAvx2Kernels->env_mixer(rspa, in_addr, n_samples, swap_reverb, neg_left, neg_right, wet_dry_addr,
+                                haas_temp_addr, num_channels, cutoff_freq_lfe);
+        return;
+    }
+    aEnvMixerImplSse2(in_addr, n_samples, swap_reverb, neg_left, neg_right, wet_dry_addr, haas_temp_addr,
+                      num_channels, cutoff_freq_lfe);
+}
+
+#endif
+
+SCALAR_KERNEL(aMixImpl)(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr) {
     int nbytes = ROUND_UP_32(ROUND_DOWN_16(count << 4));
     int16_t* in = BUF_S16(in_addr);
     int16_t* out = BUF_S16(out_addr);
@@ -784,13 +1040,13 @@ void aMixImpl(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr)
     }
 }
 
-#else
+#ifdef SSE2_AVAILABLE
 
 static const ALIGN_ASSET(16) int16_t x7fff[8] = {
     0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF, 0x7FFF,
 };
 
-void aMixImpl(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr) {
+static void aMixImplSse2(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr) {
     int nbytes = ROUND_UP_32(ROUND_DOWN_16(count << 4));
     int16_t* in = BUF_S16(in_addr);
     int16_t* out = BUF_S16(out_addr);
@@ -847,16 +1103,24 @@ void aMixImpl(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr)
     }
 }
 
+void aMixImpl(uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr) {
+    if (sAvx2Kernels != NULL) {
+        sAvx2Kernels->mix(rspa, count, gain, in_addr, out_addr);
+        return;
+    }
+    aMixImplSse2(count, gain, in_addr, out_addr);
+}
+
 #endif
 
-void aS8DecImpl(uint8_t flags, ADPCM_STATE state) {
-    uint8_t* in = BUF_U8(rspa.in);
-    int16_t* out = BUF_S16(rspa.out);
-    int nbytes = ROUND_UP_32(rspa.nbytes);
+SCALAR_KERNEL(aS8DecImpl)(uint8_t flags, ADPCM_STATE state) {
+    uint8_t* in = BUF_U8(rspa->in);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_32(rspa->nbytes);
     if (flags & A_INIT) {
         memset(out, 0, 16 * sizeof(int16_t));
     } else if (flags & A_LOOP) {
-        memcpy(out, rspa.adpcm_loop_state, 16 * sizeof(int16_t));
+        memcpy(out, rspa->adpcm_loop_state, 16 * sizeof(int16_t));
     } else {
         memcpy(out, state, 16 * sizeof(int16_t));
     }
@@ -886,7 +1150,40 @@ void aS8DecImpl(uint8_t flags, ADPCM_STATE state) {
     memcpy(state, out - 16, 16 * sizeof(int16_t));
 }
 
-void aAddMixerImpl(uint16_t count, uint16_t in_addr, uint16_t out_addr) {
+#ifdef SSE2_AVAILABLE
+
+void aS8DecImpl(uint8_t flags, ADPCM_STATE state) {
+    uint8_t* in = BUF_U8(rspa->in);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_32(rspa->nbytes);
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(int16_t));
+    } else if (flags & A_LOOP) {
+        memcpy(out, rspa->adpcm_loop_state, 16 * sizeof(int16_t));
+    } else {
+        memcpy(out, state, 16 * sizeof(int16_t));
+    }
+    out += 16;
+
+    __m128i zero = _mm_setzero_si128();
+
+    while (nbytes > 0) {
+        // Interleaving zeroes below each byte is the same as shifting it into the top half of a sample
+        __m128i inVec = _mm_loadu_si128((__m128i*) in);
+        _mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi8(zero, inVec));
+        _mm_storeu_si128((__m128i*) (out + 8), _mm_unpackhi_epi8(zero, inVec));
+        in += 16;
+        out += 16;
+
+        nbytes -= 16 * sizeof(int16_t);
+    }
+
+    memcpy(state, out - 16, 16 * sizeof(int16_t));
+}
+
+#endif
+
+SCALAR_KERNEL(aAddMixerImpl)(uint16_t count, uint16_t in_addr, uint16_t out_addr) {
     int16_t* in = BUF_S16(in_addr);
     int16_t* out = BUF_S16(out_addr);
     int nbytes = ROUND_UP_64(ROUND_DOWN_16(count));
@@ -929,6 +1226,36 @@ void aAddMixerImpl(uint16_t count, uint16_t in_addr, uint16_t out_addr) {
     } while (nbytes > 0);
 }
 
+#ifdef SSE2_AVAILABLE
+
+static void aAddMixerImplSse2(uint16_t count, uint16_t in_addr, uint16_t out_addr) {
+    int16_t* in = BUF_S16(in_addr);
+    int16_t* out = BUF_S16(out_addr);
+    int nbytes = ROUND_UP_64(ROUND_DOWN_16(count));
+
+    do {
+        for (int i = 0; i < 2; i++) {
+            __m128i outVec = _mm_loadu_si128((__m128i*) out);
+            __m128i inVec = _mm_loadu_si128((__m128i*) in);
+            _mm_storeu_si128((__m128i*) out, _mm_adds_epi16(outVec, inVec));
+            in += 8;
+            out += 8;
+        }
+
+        nbytes -= 16 * sizeof(int16_t);
+    } while (nbytes > 0);
+}
+
+void aAddMixerImpl(uint16_t count, uint16_t in_addr, uint16_t out_addr) {
+    if (sAvx2Kernels != NULL) {
+        sAvx2Kernels->add_mixer(rspa, count, in_addr, out_addr);
+        return;
+    }
+    aAddMixerImplSse2(count, in_addr, out_addr);
+}
+
+#endif
+
 void aDuplicateImpl(uint16_t count, uint16_t in_addr, uint16_t out_addr) {
     uint8_t* in = BUF_U8(in_addr);
     uint8_t* out = BUF_U8(out_addr);
@@ -954,9 +1281,9 @@ void aDMEMMove2Impl(uint8_t t, uint16_t in_addr, uint16_t out_addr, uint16_t cou
 }
 
 void aResampleZohImpl(uint16_t pitch, uint16_t start_fract) {
-    int16_t* in = BUF_S16(rspa.in);
-    int16_t* out = BUF_S16(rspa.out);
-    int nbytes = ROUND_UP_8(rspa.nbytes);
+    int16_t* in = BUF_S16(rspa->in);
+    int16_t* out = BUF_S16(rspa->out);
+    int nbytes = ROUND_UP_8(rspa->nbytes);
     uint32_t pos = start_fract;
     uint32_t pitch_add = pitch << 2;
 
@@ -1001,13 +1328,13 @@ void aInterlImpl(uint16_t in_addr, uint16_t out_addr, uint16_t n_samples) {
     } while (n > 0);
 }
 
-void aFilterImpl(uint8_t flags, uint16_t count_or_buf, int16_t* state_or_filter) {
+SCALAR_KERNEL(aFilterImpl)(uint8_t flags, uint16_t count_or_buf, int16_t* state_or_filter) {
     if (flags > A_INIT) {
-        rspa.filter_count = ROUND_UP_16(count_or_buf);
-        memcpy(rspa.filter, state_or_filter, sizeof(rspa.filter));
+        rspa->filter_count = ROUND_UP_16(count_or_buf);
+        memcpy(rspa->filter, state_or_filter, sizeof(rspa->filter));
     } else {
         int16_t tmp[16], tmp2[8];
-        int count = rspa.filter_count;
+        int count = rspa->filter_count;
         int16_t* buf = BUF_S16(count_or_buf);
 
         if (flags == A_INIT) {
@@ -1026,7 +1353,7 @@ void aFilterImpl(uint8_t flags, uint16_t count_or_buf, int16_t* state_or_filter)
         }
 
         for (int i = 0; i < 8; i++) {
-            rspa.filter[i] = (tmp2[i] + rspa.filter[i]) / 2;
+            rspa->filter[i] = (tmp2[i] + rspa->filter[i]) / 2;
         }
 
         do {
@@ -1034,7 +1361,7 @@ void aFilterImpl(uint8_t flags, uint16_t count_or_buf, int16_t* state_or_filter)
             for (int i = 0; i < 8; i++) {
                 int64_t sample = 0x4000; // round term
                 for (int j = 0; j < 8; j++) {
-                    sample += tmp[i + j] * rspa.filter[7 - j];
+                    sample += tmp[i + j] * rspa->filter[7 - j];
                 }
                 buf[i] = clamp16((int32_t) (sample >> 15));
             }
@@ -1045,11 +1372,76 @@ void aFilterImpl(uint8_t flags, uint16_t count_or_buf, int16_t* state_or_filter)
         } while (count > 0);
 
         memcpy(state_or_filter, tmp, 8 * sizeof(int16_t));
-        memcpy(state_or_filter + 8, rspa.filter, 8 * sizeof(int16_t));
+        memcpy(state_or_filter + 8, rspa->filter, 8 * sizeof(int16_t));
     }
 }
 
-void aHiLoGainImpl(uint8_t g, uint16_t count, uint16_t addr) {
+#ifdef SSE2_AVAILABLE
+
+void aFilterImpl(uint8_t flags, uint16_t count_or_buf, int16_t* state_or_filter) {
+    if (flags > A_INIT) {
+        rspa->filter_count = ROUND_UP_16(count_or_buf);
+        memcpy(rspa->filter, state_or_filter, sizeof(rspa->filter));
+    } else {
+        int16_t tmp[16], tmp2[8];
+        int count = rspa->filter_count;
+        int16_t* buf = BUF_S16(count_or_buf);
+
+        if (flags == A_INIT) {
+#ifndef __clang__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmemset-elt-size"
+#endif
+            memset(tmp, 0, 8 * sizeof(int16_t));
+#ifndef __clang__
+#pragma GCC diagnostic pop
+#endif
+            memset(tmp2, 0, 8 * sizeof(int16_t));
+        } else {
+            memcpy(tmp, state_or_filter, 8 * sizeof(int16_t));
+            memcpy(tmp2, state_or_filter + 8, 8 * sizeof(int16_t));
+        }
+
+        for (int i = 0; i < 8; i++) {
+            rspa->filter[i] = (tmp2[i] + rspa->filter[i]) / 2;
+        }
+
+        __m128i taps[8];
+        for (int j = 0; j < 8; j++) {
+            taps[j] = _mm_set1_epi16(rspa->filter[7 - j]);
+        }
+        __m128i x4000Vec = _mm_load_si128((__m128i*) x4000);
+        __m128i x7fffVec = _mm_set1_epi32(0x7FFF);
+
+        do {
+            memcpy(tmp + 8, buf, 8 * sizeof(int16_t));
+
+            // Eight taps can overflow 32 bits. Splitting every product at bit 15 and summing the two parts on their
+            // own keeps both in range and gives the same result as the 64 bit sum shifted by 15.
+            m256i sumHi = { _mm_setzero_si128(), _mm_setzero_si128() };
+            m256i sumLo = { x4000Vec, x4000Vec }; // round term
+            for (int j = 0; j < 8; j++) {
+                m256i product = m256i_mul_epi16(_mm_loadu_si128((__m128i*) (tmp + j)), taps[j]);
+                sumHi = m256i_add_m256i_epi32(sumHi, m256i_srai(product, 15));
+                sumLo.lo = _mm_add_epi32(sumLo.lo, _mm_and_si128(product.lo, x7fffVec));
+                sumLo.hi = _mm_add_epi32(sumLo.hi, _mm_and_si128(product.hi, x7fffVec));
+            }
+            m256i sample = m256i_add_m256i_epi32(sumHi, m256i_srai(sumLo, 15));
+            _mm_storeu_si128((__m128i*) buf, m256i_clamp_to_m128i(sample));
+            memcpy(tmp, tmp + 8, 8 * sizeof(int16_t));
+
+            buf += 8;
+            count -= 8 * sizeof(int16_t);
+        } while (count > 0);
+
+        memcpy(state_or_filter, tmp, 8 * sizeof(int16_t));
+        memcpy(state_or_filter + 8, rspa->filter, 8 * sizeof(int16_t));
+    }
+}
+
+#endif
+
+SCALAR_KERNEL(aHiLoGainImpl)(uint8_t g, uint16_t count, uint16_t addr) {
     int16_t* samples = BUF_S16(addr);
     int nbytes = ROUND_UP_32(count);
 
@@ -1075,6 +1467,33 @@ void aHiLoGainImpl(uint8_t g, uint16_t count, uint16_t addr) {
     } while (nbytes > 0);
 }
 
+#ifdef SSE2_AVAILABLE
+
+static void aHiLoGainImplSse2(uint8_t g, uint16_t count, uint16_t addr) {
+    int16_t* samples = BUF_S16(addr);
+    int nbytes = ROUND_UP_32(count);
+    __m128i gainVec = _mm_set1_epi16(g);
+
+    do {
+        __m128i samplesVec = _mm_loadu_si128((__m128i*) samples);
+        m256i product = m256i_mul_epi16(samplesVec, gainVec);
+        _mm_storeu_si128((__m128i*) samples, m256i_clamp_to_m128i(m256i_srai(product, 4)));
+        samples += 8;
+
+        nbytes -= 8;
+    } while (nbytes > 0);
+}
+
+void aHiLoGainImpl(uint8_t g, uint16_t count, uint16_t addr) {
+    if (sAvx2Kernels != NULL) {
+        sAvx2Kernels->hilo_gain(rspa, g, count, addr);
+        return;
+    }
+    aHiLoGainImplSse2(g, count, addr);
+}
+
+#endif
+
 void aUnkCmd3Impl(uint16_t a, uint16_t b, uint16_t c) {
 }
 
@@ -1093,3 +1512,314 @@ void aUnkCmd19Impl(uint8_t f, uint16_t count, uint16_t out_addr, uint16_t in_add
         nbytes -= 32 * sizeof(int16_t);
     } while (nbytes > 0);
 }
+
+static bool cpu_supports_avx2(void) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // The OS has to save the YMM registers as well
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// The AVX2 kernels if both the build and the running CPU have them
+static const MixerAvx2Kernels* get_avx2_kernels(void) {
+#ifdef SSE2_AVAILABLE
+    if (cpu_supports_avx2()) {
+        return aMixerGetAvx2Kernels();
+    }
+#endif
+    return NULL;
+}
+
+void aMixerInit(void) {
+    sAvx2Kernels = get_avx2_kernels();
+}
+
+AudioMixerContext* aMixerContextCreate(void) {
+    return calloc(1, sizeof(AudioMixerContext));
+}
+
+void aMixerContextDestroy(AudioMixerContext* ctx) {
+    free(ctx);
+}
+
+void aMixerContextSet(AudioMixerContext* ctx) {
+    rspa = ctx != NULL ? ctx : &sDefaultContext;
+}
+
+void aMixerContextAccumulate(const AudioMixerContext* ctx, uint16_t addr, int nbytes) {
+    const int16_t* in = (const int16_t*) CTX_BUF_U8(ctx, addr);
+    int16_t* out = BUF_S16(addr);
+
+    for (int i = 0; i < nbytes / (int) sizeof(int16_t); i++) {
+        out[i] = clamp16(out[i] + in[i]);
+    }
+}
+
+#ifdef MIXER_KERNEL_CHECK
+
+#ifdef SSE2_AVAILABLE
+
+// Everything a kernel reads besides the context, drawn at random for each round of aMixerCheckKernel
+typedef struct {
+    uint32_t args[8];
+    ADPCM_STATE state;
+    ADPCM_STATE loop_state;
+    float lfe_state;
+} KernelCheckCase;
+
+// Runs the scalar kernel, the AVX2 one from avx2 or else the SSE2 one
+typedef void (*KernelCheckRun)(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar);
+
+// Regions of DMEM the kernels are pointed at, far enough apart that none of them overlap
+#define CHECK_DMEM_START 0x450
+#define CHECK_IN_ADDR 0x600
+#define CHECK_OUT_ADDR 0x1000
+
+static uint32_t check_random(uint32_t* rng) {
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 17;
+    *rng ^= *rng << 5;
+    return *rng;
+}
+
+static void check_random_bytes(uint32_t* rng, void* dest, size_t size) {
+    uint8_t* bytes = dest;
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = check_random(rng);
+    }
+}
+
+static void check_interleave(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    // Not a multiple of 8 samples half the time, for the tail after the vectors
+    uint16_t num_channels = c->args[0] & 1 ? 6 : 2;
+    uint16_t count = c->args[1] % 193;
+    uint16_t ch[6];
+    for (int i = 0; i < 6; i++) {
+        ch[i] = CHECK_DMEM_START + i * 192 * sizeof(int16_t);
+    }
+    rspa->out = CHECK_DMEM_START + 6 * 192 * sizeof(int16_t);
+    rspa->nbytes = count * num_channels * sizeof(int16_t);
+    (scalar ? aInterleaveImplScalar : aInterleaveImpl)(ch[0], ch[1], ch[2], ch[3], ch[4], ch[5], num_channels);
+}
+
+static void check_adpcm_dec(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    uint8_t flags = (c->args[0] % 3) | (c->args[1] & 4);
+    int frame_size = flags & 4 ? 5 : 9;
+    rspa->in = CHECK_IN_ADDR;
+    rspa->out = CHECK_OUT_ADDR;
+    rspa->nbytes = (c->args[2] % 12 + 1) * 32;
+    // Frame headers as in the game's samples, a shift of at most 12 and one of the 8 codebooks
+    for (int i = 0; i < rspa->nbytes / 32; i++) {
+        uint8_t* header = BUF_U8(CHECK_IN_ADDR + i * frame_size);
+        *header = ((*header >> 4) % 13) << 4 | (*header & 7);
+    }
+    (scalar ? aADPCMdecImplScalar : aADPCMdecImpl)(flags, c->state);
+}
+
+static void check_resample(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    static const int16_t offsets[] = { 0, -10, -12, -14 };
+    uint8_t flags = c->args[0] % 3;
+    // Only offsets the kernel itself leaves in the state that keep the input aligned
+    c->state[5] = offsets[c->args[1] % 4];
+    rspa->in = CHECK_IN_ADDR;
+    rspa->out = CHECK_OUT_ADDR;
+    rspa->nbytes = (c->args[2] % 24 + 1) * 16;
+    (scalar ? aResampleImplScalar : aResampleImpl)(flags, c->args[3], c->state);
+}
+
+static void check_env_mixer(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    // Six dry and six wet channels of 192 samples after the input, the haas buffer after those
+    uint32_t dry = CHECK_IN_ADDR + 192 * sizeof(int16_t);
+    uint32_t wet = dry + 6 * 192 * sizeof(int16_t);
+    uint32_t haas = wet + 6 * 192 * sizeof(int16_t);
+    uint32_t haas_temp_addr = (c->args[1] % 3 == 1) ? haas << 16 : (c->args[1] % 3 == 2) ? haas : 0;
+    uint32_t num_channels = c->args[0] & 1 ? 6 : 2;
+    uint16_t n_samples = c->args[2] % 193;
+    uint32_t cutoff_freq_lfe = 20 + c->args[3] % 200;
+    rspa->lfe_state = c->args[4] & 1 ? &c->lfe_state : NULL;
+    if (!scalar && avx2 != NULL) {
+        avx2->env_mixer(rspa, CHECK_IN_ADDR, n_samples, c->args[5] & 1, c->args[5] & 2, c->args[5] & 4,
+                        wet << 16 | dry, haas_temp_addr, num_channels, cutoff_freq_lfe);
+        return;
+    }
+    (scalar ? aEnvMixerImplScalar : aEnvMixerImplSse2)(CHECK_IN_ADDR, n_samples, c->args[5] & 1, c->args[5] & 2,
+                                                       c->args[5] & 4, wet << 16 | dry, haas_temp_addr, num_channels,
+                                                       cutoff_freq_lfe);
+}
+
+static void check_mix(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    uint16_t count = c->args[0] % 24 + 1;
+    int16_t gain = c->args[1] & 3 ? (int16_t) c->args[2] : -0x8000;
+    if (!scalar && avx2 != NULL) {
+        avx2->mix(rspa, count, gain, CHECK_IN_ADDR, CHECK_OUT_ADDR);
+        return;
+    }
+    (scalar ? aMixImplScalar : aMixImplSse2)(count, gain, CHECK_IN_ADDR, CHECK_OUT_ADDR);
+}
+
+static void check_s8_dec(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    rspa->in = CHECK_IN_ADDR;
+    rspa->out = CHECK_OUT_ADDR;
+    rspa->nbytes = (c->args[0] % 12 + 1) * 32;
+    (scalar ? aS8DecImplScalar : aS8DecImpl)(c->args[1] % 3, c->state);
+}
+
+static void check_add_mixer(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    if (!scalar && avx2 != NULL) {
+        avx2->add_mixer(rspa, c->args[0] % 0x301, CHECK_IN_ADDR, CHECK_OUT_ADDR);
+        return;
+    }
+    (scalar ? aAddMixerImplScalar : aAddMixerImplSse2)(c->args[0] % 0x301, CHECK_IN_ADDR, CHECK_OUT_ADDR);
+}
+
+static void check_filter(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    int16_t filter[8];
+    memcpy(filter, c->args, sizeof(filter));
+    void (*filter_impl)(uint8_t, uint16_t, int16_t*) = scalar ? aFilterImplScalar : aFilterImpl;
+    filter_impl(2, (c->args[4] % 24 + 1) * 16, filter);
+    filter_impl(c->args[5] & 1 ? A_INIT : 0, CHECK_OUT_ADDR, c->state);
+}
+
+static void check_hilo_gain(KernelCheckCase* c, const MixerAvx2Kernels* avx2, bool scalar) {
+    if (!scalar && avx2 != NULL) {
+        avx2->hilo_gain(rspa, c->args[0], c->args[1] % 0x181, CHECK_OUT_ADDR);
+        return;
+    }
+    (scalar ? aHiLoGainImplScalar : aHiLoGainImplSse2)(c->args[0], c->args[1] % 0x181, CHECK_OUT_ADDR);
+}
+
+int32_t aMixerCheckKernel(MixerKernel kernel, MixerIsa isa, uint32_t rounds, uint32_t seed, uint64_t* simd_ns,
+                          uint64_t* scalar_ns) {
+    const MixerAvx2Kernels* avx2 = NULL;
+    KernelCheckRun run;
+    switch (kernel) {
+        case MIXER_KERNEL_INTERLEAVE:
+            run = check_interleave;
+            break;
+        case MIXER_KERNEL_ADPCM_DEC:
+            run = check_adpcm_dec;
+            break;
+        case MIXER_KERNEL_RESAMPLE:
+            run = check_resample;
+            break;
+        case MIXER_KERNEL_ENV_MIXER:
+            run = check_env_mixer;
+            break;
+        case MIXER_KERNEL_MIX:
+            run = check_mix;
+            break;
+        case MIXER_KERNEL_S8_DEC:
+            run = check_s8_dec;
+            break;
+        case MIXER_KERNEL_ADD_MIXER:
+            run = check_add_mixer;
+            break;
+        case MIXER_KERNEL_FILTER:
+            run = check_filter;
+            break;
+        case MIXER_KERNEL_HILO_GAIN:
+            run = check_hilo_gain;
+            break;
+        default:
+            return -1;
+    }
+
+    if (isa == MIXER_ISA_AVX2) {
+        switch (kernel) {
+            case MIXER_KERNEL_ENV_MIXER:
+            case MIXER_KERNEL_MIX:
+            case MIXER_KERNEL_ADD_MIXER:
+            case MIXER_KERNEL_HILO_GAIN:
+                avx2 = get_avx2_kernels();
+                break;
+            default:
+                break;
+        }
+        if (avx2 == NULL) {
+            return -1;
+        }
+    } else if (isa != MIXER_ISA_SSE2) {
+        return -1;
+    }
+
+    AudioMixerContext* contexts[2] = { aMixerContextCreate(), aMixerContextCreate() };
+    AudioMixerContext* prev = rspa;
+    uint32_t rng = seed != 0 ? seed : 1;
+    int32_t failed = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        KernelCheckCase cases[2];
+        check_random_bytes(&rng, &cases[0], sizeof(cases[0]));
+        cases[0].lfe_state = (int16_t) check_random(&rng);
+        check_random_bytes(&rng, contexts[0], sizeof(AudioMixerContext));
+        contexts[0]->lfe_state_default = (int16_t) check_random(&rng);
+        // Codebooks the size of the game's, larger ones overflow the 32 bit sums of the decoder
+        for (int i = 0; i < 8 * 2 * 8; i++) {
+            (&contexts[0]->adpcm_table[0][0][0])[i] >>= 3;
+        }
+        memcpy(contexts[1], contexts[0], sizeof(AudioMixerContext));
+        cases[1] = cases[0];
+
+        for (int i = 0; i < 2; i++) {
+            rspa = contexts[i];
+            rspa->adpcm_loop_state = &cases[i].loop_state;
+            rspa->lfe_state = NULL;
+            uint64_t start = MixerProfile_Begin();
+            run(&cases[i], avx2, i == 1);
+            *(i == 1 ? scalar_ns : simd_ns) += MixerProfile_Begin() - start;
+        }
+
+        // Both pointed into their own case
+        contexts[1]->adpcm_loop_state = contexts[0]->adpcm_loop_state;
+        contexts[1]->lfe_state = contexts[0]->lfe_state;
+        if (memcmp(contexts[0], contexts[1], sizeof(AudioMixerContext)) != 0 ||
+            memcmp(&cases[0], &cases[1], sizeof(KernelCheckCase)) != 0) {
+            if (failed == 0) {
+                int offset = 0;
+                while (offset < DMEM_BUF_SIZE && contexts[0]->buf[offset] == contexts[1]->buf[offset]) {
+                    offset++;
+                }
+                if (offset < DMEM_BUF_SIZE) {
+                    printf("%s: round %u differs from the scalar kernel first at DMEM 0x%X\n",
+                           MixerProfile_GetName(kernel), round, CHECK_DMEM_START + offset);
+                } else {
+                    printf("%s: round %u differs from the scalar kernel in its state\n", MixerProfile_GetName(kernel),
+                           round);
+                }
+            }
+            failed++;
+        }
+    }
+
+    rspa = prev;
+    aMixerContextDestroy(contexts[0]);
+    aMixerContextDestroy(contexts[1]);
+    return failed;
+}
+
+#else
+
+int32_t aMixerCheckKernel(MixerKernel kernel, MixerIsa isa, uint32_t rounds, uint32_t seed, uint64_t* simd_ns,
+                          uint64_t* scalar_ns) {
+    return -1;
+}
+
+#endif
+
+#endif
@@ -3,6 +3,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "libultraship/libultra/abi.h"
+#include "port/audio/MixerProfile.h"
 
 #undef aSegment
 #undef aClearBuffer
@@ -32,6 +33,19 @@
 #undef aUnkCmd3
 #undef aUnkCmd19
 
+// Picks the widest kernels the CPU runs. Call it before any thread mixes, until then they all use SSE2 (or NEON).
+void aMixerInit(void);
+
+// Each thread runs the commands against its own DMEM and state, set with aMixerContextSet
+typedef struct AudioMixerContext AudioMixerContext;
+
+AudioMixerContext* aMixerContextCreate(void);
+void aMixerContextDestroy(AudioMixerContext* ctx);
+// NULL goes back to the default context
+void aMixerContextSet(AudioMixerContext* ctx);
+// Saturating add of nbytes at addr in ctx into the same range of the current context
+void aMixerContextAccumulate(const AudioMixerContext* ctx, uint16_t addr, int nbytes);
+
 void aClearBufferImpl(uint16_t addr, int nbytes);
 void aLoadBufferImpl(const void* source_addr, uint16_t dest_addr, uint16_t nbytes);
 void aSaveBufferImpl(uint16_t source_addr, int16_t* dest_addr, uint16_t nbytes);
@@ -40,7 +54,10 @@ void aSetBufferImpl(uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes);
 void aInterleaveImpl(uint16_t left, uint16_t right, uint16_t center, uint16_t lfe, uint16_t surround_left, uint16_t surround_right, uint16_t num_audio_channels);
 void aDMEMMoveImpl(uint16_t in_addr, uint16_t out_addr, int nbytes);
 void aSetLoopImpl(ADPCM_STATE* adpcm_loop_state);
+// Filter state the 6 channel env mixer carries from one call to the next, NULL uses the context's own
+void aSetLfeStateImpl(float* lfe_state);
 void aADPCMdecImpl(uint8_t flags, ADPCM_STATE state);
+void aADPCMcopyImpl(uint8_t flags, ADPCM_STATE state, const int16_t* pcm);
 void aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state);
 void aEnvSetup1Impl(uint8_t initial_vol_wet, uint16_t rate_wet, uint16_t rate_left, uint16_t rate_right,
     uint16_t rate_center, uint16_t rate_lfe, uint16_t rate_rear_left, uint16_t rate_rear_right);
@@ -60,33 +77,57 @@ void aHiLoGainImpl(uint8_t g, uint16_t count, uint16_t addr);
 void aUnkCmd3Impl(uint16_t a, uint16_t b, uint16_t c);
 void aUnkCmd19Impl(uint8_t f, uint16_t count, uint16_t out_addr, uint16_t in_addr);
 
+#ifdef MIXER_KERNEL_CHECK
+
+// Only built into the self-check tool, see src/port/selfcheck
+
+// Instruction sets the SIMD kernels are written for. The SSE2 ones run on NEON through sse2neon.
+typedef enum MixerIsa {
+    MIXER_ISA_SSE2,
+    MIXER_ISA_AVX2,
+    MIXER_ISA_MAX,
+} MixerIsa;
+
+// Runs the isa version of a kernel and its scalar reference rounds times on the same random DMEM, state and
+// arguments, and compares everything they wrote bit for bit. Returns the number of rounds that differed, -1 if the
+// kernel has no version for isa or the CPU can not run it. The time spent in each version is added to simd_ns and
+// scalar_ns.
+int32_t aMixerCheckKernel(MixerKernel kernel, MixerIsa isa, uint32_t rounds, uint32_t seed, uint64_t* simd_ns,
+                          uint64_t* scalar_ns);
+
+#endif
+
 #define aSegment(pkt, s, b) \
     do {                    \
     } while (0)
-#define aClearBuffer(pkt, d, c) aClearBufferImpl(d, c)
-#define aLoadBuffer(pkt, s, d, c) aLoadBufferImpl(s, d, c)
-#define aSaveBuffer(pkt, s, d, c) aSaveBufferImpl(s, d, c)
-#define aLoadADPCM(pkt, c, d) aLoadADPCMImpl(c, d)
+#define aClearBuffer(pkt, d, c) MIXER_PROFILE(MIXER_KERNEL_CLEAR_BUFFER, aClearBufferImpl(d, c))
+#define aLoadBuffer(pkt, s, d, c) MIXER_PROFILE(MIXER_KERNEL_LOAD_BUFFER, aLoadBufferImpl(s, d, c))
+#define aSaveBuffer(pkt, s, d, c) MIXER_PROFILE(MIXER_KERNEL_SAVE_BUFFER, aSaveBufferImpl(s, d, c))
+#define aLoadADPCM(pkt, c, d) MIXER_PROFILE(MIXER_KERNEL_LOAD_ADPCM, aLoadADPCMImpl(c, d))
 #define aSetBuffer(pkt, f, i, o, c) aSetBufferImpl(f, i, o, c)
-#define aInterleave(pkt, l, r, c, lfe, sl, sr, num_channels) aInterleaveImpl(l, r, c, lfe, sl, sr, num_channels)
-#define aDMEMMove(pkt, i, o, c) aDMEMMoveImpl(i, o, c)
+#define aInterleave(pkt, l, r, c, lfe, sl, sr, num_channels) \
+    MIXER_PROFILE(MIXER_KERNEL_INTERLEAVE, aInterleaveImpl(l, r, c, lfe, sl, sr, num_channels))
+#define aDMEMMove(pkt, i, o, c) MIXER_PROFILE(MIXER_KERNEL_DMEM_MOVE, aDMEMMoveImpl(i, o, c))
 #define aSetLoop(pkt, a) aSetLoopImpl(a)
-#define aADPCMdec(pkt, f, s) aADPCMdecImpl(f, s)
-#define aResample(pkt, f, p, s) aResampleImpl(f, p, s)
+#define aSetLfeState(pkt, s) aSetLfeStateImpl(s)
+#define aADPCMdec(pkt, f, s) MIXER_PROFILE(MIXER_KERNEL_ADPCM_DEC, aADPCMdecImpl(f, s))
+#define aADPCMcopy(pkt, f, s, p) MIXER_PROFILE(MIXER_KERNEL_ADPCM_COPY, aADPCMcopyImpl(f, s, p))
+#define aResample(pkt, f, p, s) MIXER_PROFILE(MIXER_KERNEL_RESAMPLE, aResampleImpl(f, p, s))
 #define aEnvSetup1(pkt, initialVolReverb, rampReverb, rampLeft, rampRight, rampCenter, rampLfe, rampRLeft, rampRRight) \
     aEnvSetup1Impl(initialVolReverb, rampReverb, rampLeft, rampRight, rampCenter, rampLfe, rampRLeft, rampRRight)
 #define aEnvSetup2(pkt, initialVolLeft, initialVolRight, initialVolCenter, initialVolLfe, initialVolRLeft, initialVolRRight) \
     aEnvSetup2Impl(initialVolLeft, initialVolRight, initialVolCenter, initialVolLfe, initialVolRLeft, initialVolRRight)
 #define aEnvMixer(pkt, inAddr, nSamples, swapReverb, negLeft, negRight, wetDryAddr, haasTempAddr, numChannels, cutoffFreqLfe) \
-    aEnvMixerImpl(inAddr, nSamples, swapReverb, negLeft, negRight, wetDryAddr, haasTempAddr, numChannels, cutoffFreqLfe)
-#define aMix(pkt, c, g, i, o) aMixImpl(c, g, i, o)
-#define aS8Dec(pkt, f, s) aS8DecImpl(f, s)
-#define aAddMixer(pkt, s, d, c) aAddMixerImpl(s, d, c)
-#define aDuplicate(pkt, s, d, c) aDuplicateImpl(s, d, c)
+    MIXER_PROFILE(MIXER_KERNEL_ENV_MIXER, aEnvMixerImpl(inAddr, nSamples, swapReverb, negLeft, negRight, wetDryAddr, \
+                                                        haasTempAddr, numChannels, cutoffFreqLfe))
+#define aMix(pkt, c, g, i, o) MIXER_PROFILE(MIXER_KERNEL_MIX, aMixImpl(c, g, i, o))
+#define aS8Dec(pkt, f, s) MIXER_PROFILE(MIXER_KERNEL_S8_DEC, aS8DecImpl(f, s))
+#define aAddMixer(pkt, s, d, c) MIXER_PROFILE(MIXER_KERNEL_ADD_MIXER, aAddMixerImpl(s, d, c))
+#define aDuplicate(pkt, s, d, c) MIXER_PROFILE(MIXER_KERNEL_DUPLICATE, aDuplicateImpl(s, d, c))
 #define aDMEMMove2(pkt, t, i, o, c) aDMEMMove2Impl(t, i, o, c)
-#define aResampleZoh(pkt, pitch, startFract) aResampleZohImpl(pitch, startFract)
-#define aInterl(pkt, dmemi, dmemo, count) aInterlImpl(dmemi, dmemo, count)
-#define aFilter(pkt, f, countOrBuf, addr) aFilterImpl(f, countOrBuf, addr)
-#define aHiLoGain(pkt, g, buflen, i, a4) aHiLoGainImpl(g, buflen, i)
+#define aResampleZoh(pkt, pitch, startFract) MIXER_PROFILE(MIXER_KERNEL_RESAMPLE_ZOH, aResampleZohImpl(pitch, startFract))
+#define aInterl(pkt, dmemi, dmemo, count) MIXER_PROFILE(MIXER_KERNEL_INTERL, aInterlImpl(dmemi, dmemo, count))
+#define aFilter(pkt, f, countOrBuf, addr) MIXER_PROFILE(MIXER_KERNEL_FILTER, aFilterImpl(f, countOrBuf, addr))
+#define aHiLoGain(pkt, g, buflen, i, a4) MIXER_PROFILE(MIXER_KERNEL_HILO_GAIN, aHiLoGainImpl(g, buflen, i))
 #define aUnkCmd3(pkt, a1, a2, a3) aUnkCmd3Impl(a1, a2, a3)
-#define aUnkCmd19(pkt, a1, a2, a3, a4) aUnkCmd19Impl(a1, a2, a3, a4)
\ No newline at end of file
+#define aUnkCmd19(pkt, a1, a2, a3, a4) MIXER_PROFILE(MIXER_KERNEL_UNK_CMD19, aUnkCmd19Impl(a1, a2, a3, a4))
\ No newline at end of file
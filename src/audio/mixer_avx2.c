@@ -0,0 +1,257 @@
+// Built with AVX2 enabled (see CMakeLists.txt) and only called after aMixerInit checked the CPU, nothing outside of
+// this file may be compiled with these flags.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <macros.h>
+
+#include "mixer_internal.h"
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+// Only the kernels that work on whole vectors of samples. The resampler and the ADPCM decoder spend their time on
+// per-sample table lookups and state, twice the lanes do not help them.
+
+// (int16_t) (a * b >> 16) for a signed and b unsigned, see the SSE2 version in mixer.c
+static __m256i mulhi_epi16_epu16(__m256i a, __m256i b) {
+    __m256i hi = _mm256_mulhi_epi16(a, b);
+    return _mm256_add_epi16(hi, _mm256_and_si256(a, _mm256_srai_epi16(b, 15)));
+}
+
+// first in the low 8 lanes, second in the high 8
+static __m256i set_halves_epi16(uint16_t first, uint16_t second) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi16(first)), _mm_set1_epi16(second), 1);
+}
+
+static void aEnvMixerImplAvx2(AudioMixerContext* ctx, uint16_t in_addr, uint16_t n_samples, bool swap_reverb,
+                              bool neg_left, bool neg_right, uint32_t wet_dry_addr, uint32_t haas_temp_addr,
+                              uint32_t num_channels, uint32_t cutoff_freq_lfe) {
+    // Note: max number of samples is 192 (192 * 2 = 384 bytes = 0x180)
+    int max_num_samples = 192;
+
+    int16_t* in = CTX_BUF_S16(ctx, in_addr);
+    int n = ROUND_UP_16(n_samples);
+    if (n > max_num_samples) {
+        printf("Warning: n_samples is too large: %d\n", n_samples);
+    }
+
+    uint16_t rate_wet = ctx->rate_wet;
+    uint16_t vol_wet = ctx->vol_wet;
+
+    // All speakers
+    int dry_addr_start = wet_dry_addr & 0xFFFF;
+    int wet_addr_start = wet_dry_addr >> 16;
+
+    int16_t* dry[6];
+    int16_t* wet[6];
+    for (int i = 0; i < 6; i++) {
+        dry[i] = CTX_BUF_S16(ctx, dry_addr_start + max_num_samples * i * sizeof(int16_t));
+        wet[i] = CTX_BUF_S16(ctx, wet_addr_start + max_num_samples * i * sizeof(int16_t));
+    }
+
+    uint16_t vols[6] = { ctx->vol[0], ctx->vol[1], ctx->vol[2], ctx->vol[3], ctx->vol[4], ctx->vol[5] };
+    int swapped[2] = { swap_reverb ? 1 : 0, swap_reverb ? 0 : 1 };
+    __m256i samples[6];
+
+    // The volumes ramp every 8 samples and n is a multiple of 16, so each block of 16 is one vector per speaker with
+    // two volumes in it
+    if (num_channels == 6) {
+        // Calculate the filter coefficient
+        float RC = 1.f / (2 * M_PI * cutoff_freq_lfe);
+        float dt = 1.f / SAMPLE_RATE;
+        float alpha = dt / (RC + dt);
+
+        // Low-pass filter state for the subwoofer channel
+        float* lfe_state = ctx->lfe_state != NULL ? ctx->lfe_state : &ctx->lfe_state_default;
+        float prev_lfe_sample = *lfe_state;
+
+        for (int i = 0; i < n / 16; i++) {
+            __m256i inVec = _mm256_loadu_si256((__m256i*) in);
+            in += 16;
+
+            // Apply volume
+            for (int j = 0; j < 6; j++) {
+                samples[j] = mulhi_epi16_epu16(inVec, set_halves_epi16(vols[j], vols[j] + ctx->rate[j]));
+            }
+
+            // Apply low-pass filter to the LFE channel (index 3), it depends on the previous sample
+            int16_t lfe[16];
+            _mm256_storeu_si256((__m256i*) lfe, samples[3]);
+            for (int k = 0; k < 16; k++) {
+                float lfe_sample = lfe[k];
+                lfe_sample = alpha * lfe_sample + (1.0f - alpha) * prev_lfe_sample;
+                prev_lfe_sample = lfe_sample;
+                lfe[k] = (int16_t) lfe_sample;
+            }
+            samples[3] = _mm256_loadu_si256((__m256i*) lfe);
+
+            // Mix dry and wet signals
+            __m256i volWetVec = set_halves_epi16(vol_wet, vol_wet + rate_wet);
+            for (int j = 0; j < 6; j++) {
+                __m256i dryVec = _mm256_loadu_si256((__m256i*) dry[j]);
+                _mm256_storeu_si256((__m256i*) dry[j], _mm256_adds_epi16(dryVec, samples[j]));
+                dry[j] += 16;
+
+                if (j < 2) {
+                    // Apply reverb only to the front stereo channels wet
+                    // They will be mixed with the rear channels later
+                    __m256i wetVec = _mm256_loadu_si256((__m256i*) wet[j]);
+                    __m256i reverb = mulhi_epi16_epu16(samples[swapped[j]], volWetVec);
+                    _mm256_storeu_si256((__m256i*) wet[j], _mm256_adds_epi16(wetVec, reverb));
+                    wet[j] += 16;
+                }
+            }
+
+            for (int j = 0; j < 6; j++) {
+                vols[j] += 2 * ctx->rate[j];
+            }
+            vol_wet += 2 * rate_wet;
+        }
+        *lfe_state = prev_lfe_sample;
+    } else {
+        // Account for haas effect
+        int haas_addr_left = haas_temp_addr >> 16;
+        int haas_addr_right = haas_temp_addr & 0xFFFF;
+
+        if (haas_addr_left) {
+            dry[0] = CTX_BUF_S16(ctx, haas_addr_left);
+        } else if (haas_addr_right) {
+            dry[1] = CTX_BUF_S16(ctx, haas_addr_right);
+        }
+
+        __m256i negs[2] = { _mm256_set1_epi16(neg_left ? 0 : 0xFFFF), _mm256_set1_epi16(neg_right ? 0 : 0xFFFF) };
+
+        for (int i = 0; i < n / 16; i++) {
+            __m256i inVec = _mm256_loadu_si256((__m256i*) in);
+            in += 16;
+
+            // Apply volume
+            for (int j = 0; j < 2; j++) {
+                __m256i volVec = set_halves_epi16(vols[j], vols[j] + ctx->rate[j]);
+                samples[j] = _mm256_and_si256(mulhi_epi16_epu16(inVec, volVec), negs[j]);
+            }
+
+            // Mix dry and wet signals
+            __m256i volWetVec = set_halves_epi16(vol_wet, vol_wet + rate_wet);
+            for (int j = 0; j < 2; j++) {
+                __m256i dryVec = _mm256_loadu_si256((__m256i*) dry[j]);
+                _mm256_storeu_si256((__m256i*) dry[j], _mm256_adds_epi16(dryVec, samples[j]));
+                dry[j] += 16;
+
+                // Apply reverb
+                __m256i wetVec = _mm256_loadu_si256((__m256i*) wet[j]);
+                __m256i reverb = mulhi_epi16_epu16(samples[swapped[j]], volWetVec);
+                _mm256_storeu_si256((__m256i*) wet[j], _mm256_adds_epi16(wetVec, reverb));
+                wet[j] += 16;
+            }
+
+            for (int j = 0; j < 2; j++) {
+                vols[j] += 2 * ctx->rate[j];
+            }
+            vol_wet += 2 * rate_wet;
+        }
+    }
+}
+
+static void aMixImplAvx2(AudioMixerContext* ctx, uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr) {
+    int nbytes = ROUND_UP_32(ROUND_DOWN_16(count << 4));
+    int16_t* in = CTX_BUF_S16(ctx, in_addr);
+    int16_t* out = CTX_BUF_S16(ctx, out_addr);
+
+    if (gain == -0x8000) {
+        while (nbytes > 0) {
+            __m256i outVec = _mm256_loadu_si256((__m256i*) out);
+            __m256i inVec = _mm256_loadu_si256((__m256i*) in);
+            _mm256_storeu_si256((__m256i*) out, _mm256_subs_epi16(outVec, inVec));
+            in += 16;
+            out += 16;
+            nbytes -= 16 * sizeof(int16_t);
+        }
+        return;
+    }
+
+    // out * 0x7fff + in * gain of each pair of samples in one multiply-add, it stays below 2^31 even with 0x4000 added
+    __m256i factors = _mm256_set1_epi32((int32_t) (0x7FFF | ((uint32_t) (uint16_t) gain << 16)));
+    __m256i x4000Vec = _mm256_set1_epi32(0x4000);
+
+    while (nbytes > 0) {
+        __m256i outVec = _mm256_loadu_si256((__m256i*) out);
+        __m256i inVec = _mm256_loadu_si256((__m256i*) in);
+        // Unpacking and packing both work within each 128 bit half, so the samples come back out in order
+        __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(outVec, inVec), factors);
+        __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(outVec, inVec), factors);
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, x4000Vec), 15);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, x4000Vec), 15);
+        _mm256_storeu_si256((__m256i*) out, _mm256_packs_epi32(lo, hi));
+        in += 16;
+        out += 16;
+
+        nbytes -= 16 * sizeof(int16_t);
+    }
+}
+
+static void aAddMixerImplAvx2(AudioMixerContext* ctx, uint16_t count, uint16_t in_addr, uint16_t out_addr) {
+    int16_t* in = CTX_BUF_S16(ctx, in_addr);
+    int16_t* out = CTX_BUF_S16(ctx, out_addr);
+    int nbytes = ROUND_UP_64(ROUND_DOWN_16(count));
+
+    do {
+        __m256i outVec = _mm256_loadu_si256((__m256i*) out);
+        __m256i inVec = _mm256_loadu_si256((__m256i*) in);
+        _mm256_storeu_si256((__m256i*) out, _mm256_adds_epi16(outVec, inVec));
+        in += 16;
+        out += 16;
+
+        nbytes -= 16 * sizeof(int16_t);
+    } while (nbytes > 0);
+}
+
+static void aHiLoGainImplAvx2(AudioMixerContext* ctx, uint8_t g, uint16_t count, uint16_t addr) {
+    int16_t* samples = CTX_BUF_S16(ctx, addr);
+    int nbytes = ROUND_UP_32(count);
+    __m256i gainVec = _mm256_set1_epi16(g);
+
+    // 8 samples for every 8 bytes, and at least one block of 8, as in the other versions
+    if (nbytes == 0) {
+        nbytes = 8;
+    }
+
+    for (; nbytes >= 16; nbytes -= 16) {
+        __m256i samplesVec = _mm256_loadu_si256((__m256i*) samples);
+        __m256i productLo = _mm256_mullo_epi16(samplesVec, gainVec);
+        __m256i productHi = _mm256_mulhi_epi16(samplesVec, gainVec);
+        __m256i lo = _mm256_srai_epi32(_mm256_unpacklo_epi16(productLo, productHi), 4);
+        __m256i hi = _mm256_srai_epi32(_mm256_unpackhi_epi16(productLo, productHi), 4);
+        _mm256_storeu_si256((__m256i*) samples, _mm256_packs_epi32(lo, hi));
+        samples += 16;
+    }
+    if (nbytes > 0) {
+        __m128i samplesVec = _mm_loadu_si128((__m128i*) samples);
+        __m128i productLo = _mm_mullo_epi16(samplesVec, _mm256_castsi256_si128(gainVec));
+        __m128i productHi = _mm_mulhi_epi16(samplesVec, _mm256_castsi256_si128(gainVec));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(productLo, productHi), 4);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(productLo, productHi), 4);
+        _mm_storeu_si128((__m128i*) samples, _mm_packs_epi32(lo, hi));
+    }
+}
+
+static const MixerAvx2Kernels sKernels = {
+    aEnvMixerImplAvx2,
+    aMixImplAvx2,
+    aAddMixerImplAvx2,
+    aHiLoGainImplAvx2,
+};
+
+#endif
+
+const MixerAvx2Kernels* aMixerGetAvx2Kernels(void) {
+#ifdef __AVX2__
+    return &sKernels;
+#else
+    return NULL;
+#endif
+}
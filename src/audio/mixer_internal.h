@@ -0,0 +1,54 @@
+#pragma once
+
+// Shared by mixer.c and the kernels built for other instruction sets, nothing else should include it
+
+#include "mixer.h"
+
+#define ROUND_UP_64(v) (((v) + 63) & ~63)
+#define ROUND_UP_32(v) (((v) + 31) & ~31)
+#define ROUND_UP_16(v) (((v) + 15) & ~15)
+#define ROUND_UP_8(v) (((v) + 7) & ~7)
+#define ROUND_DOWN_16(v) ((v) & ~0xf)
+
+#define DMEM_BUF_SIZE (0x1B90) // 7056 B
+#define CTX_BUF_U8(ctx, a) ((ctx)->buf + ((a) -0x450))
+#define CTX_BUF_S16(ctx, a) (int16_t*) CTX_BUF_U8(ctx, a)
+
+#define SAMPLE_RATE 32000 // Adjusted to match the actual sample rate of 32 kHz
+
+struct AudioMixerContext {
+    uint16_t in;
+    uint16_t out;
+    uint16_t nbytes;
+
+    uint16_t vol[6];
+    uint16_t rate[6];
+    uint16_t vol_wet;
+    uint16_t rate_wet;
+
+    ADPCM_STATE* adpcm_loop_state;
+
+    // Low-pass state of the subwoofer channel, owned by the note being mixed
+    float* lfe_state;
+    float lfe_state_default;
+
+    int16_t adpcm_table[8][2][8];
+
+    uint16_t filter_count;
+    int16_t filter[8];
+
+    uint8_t buf[DMEM_BUF_SIZE];
+};
+
+// The AVX2 kernels, each one does what the kernel of the same name does on the context it is given
+typedef struct {
+    void (*env_mixer)(AudioMixerContext* ctx, uint16_t in_addr, uint16_t n_samples, bool swap_reverb, bool neg_left,
+                      bool neg_right, uint32_t wet_dry_addr, uint32_t haas_temp_addr, uint32_t num_channels,
+                      uint32_t cutoff_freq_lfe);
+    void (*mix)(AudioMixerContext* ctx, uint16_t count, int16_t gain, uint16_t in_addr, uint16_t out_addr);
+    void (*add_mixer)(AudioMixerContext* ctx, uint16_t count, uint16_t in_addr, uint16_t out_addr);
+    void (*hilo_gain)(AudioMixerContext* ctx, uint8_t g, uint16_t count, uint16_t addr);
+} MixerAvx2Kernels;
+
+// NULL when mixer_avx2.c was built without AVX2. Only call them after checking the CPU, see aMixerInit.
+const MixerAvx2Kernels* aMixerGetAvx2Kernels(void);
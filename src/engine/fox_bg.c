@@ -158,13 +158,6 @@ static Vtx starVerts[4] = {
     VTX(1, 1, 0, 0, 0, 255, 255, 255, 255), // Top-right
 };
 
-// Display list to render the two triangles forming the star quad
-static Gfx starDL[] = {
-    gsSPVertex(starVerts, ARRAY_COUNT(starVerts), 0),
-    gsSP2Triangles(0, 1, 2, 0, 1, 2, 3, 0),
-    gsSPEndDisplayList(),
-};
-
 // Display list to render the two triangles forming the partial star quad
 static Gfx starDLPartial[] = {
     gsSPVertex(starVerts, ARRAY_COUNT(starVerts), 0),
@@ -187,6 +180,10 @@ static Gfx starSetupDL[] = {
 // New global variables for storing the previoous positions
 f32 gStarPrevX[3000];
 f32 gStarPrevY[3000];
+static bool sStarWasVisible[3000];
+
+// Double buffered like the gfx pools, the renderer reads these after the display list is built
+static Gstar sStarfieldPoints[2][3000];
 
 // @port: Starfield drawn with triangles, re-engineered by @Tharo & @TheBoy181
 void Background_DrawStarfield(void) {
@@ -207,6 +204,8 @@ void Background_DrawStarfield(void) {
     float starfieldHeight;
     float vx;
     float vy;
+    Gstar* stars;
+    s32 visibleCount;
     const float STAR_MARGIN = 40.0f; // Margin to hide seam stars
 
     // Set projection to orthographic before drawing stars
@@ -262,6 +261,15 @@ void Background_DrawStarfield(void) {
         float marginX = (currentScreenWidth - renderMaskWidth) / 2;
         float renderMaskHeight = currentScreenHeight / 3;
 
+        if (starCount > ARRAY_COUNT(gStarPrevX)) {
+            starCount = ARRAY_COUNT(gStarPrevX);
+        }
+
+        // @port All visible stars are packed into one array and drawn with a single command, interpolation happens
+        // on the array itself instead of through a matrix and interpolation node per star.
+        stars = sStarfieldPoints[gSysFrameCount % 2];
+        visibleCount = 0;
+
         for (i = 0; i < starCount; i++, yStar++, xStar++, color++) {
             // Adjust star positions with field offsets
             bx = *xStar + xField;
@@ -295,6 +303,7 @@ void Background_DrawStarfield(void) {
             if (vx >= (marginX - STAR_MARGIN) && vx <= (marginX + renderMaskWidth + STAR_MARGIN) &&
                 vy >= (renderMaskHeight - STAR_MARGIN) && vy <= ((renderMaskHeight * 2) + STAR_MARGIN)) {
                 bool skipInterpolation;
+                Gstar* star = &stars[visibleCount++];
 
                 skipInterpolation = (fabsf(vx - gStarPrevX[i]) > (marginX + renderMaskWidth) / 2.0f) ||
                                     (fabsf(vy - gStarPrevY[i]) > ((renderMaskHeight * 2)) / 2.0f);
@@ -303,19 +312,13 @@ void Background_DrawStarfield(void) {
                     skipInterpolation = true;
                 }
 #endif
-                if (skipInterpolation) {
-                    // @port Skip interpolation
-                    FrameInterpolation_ShouldInterpolateFrame(false);
-                } else {
-                    FrameInterpolation_RecordOpenChild("Starfield", i);
-                    FrameInterpolation_RecordMarker(__FILE__, __LINE__);
-                }
 
                 // Translate to (vx, vy) in ortho coordinates
-                Matrix_Push(&gGfxMatrix);
-                Matrix_Translate(gGfxMatrix, vx - (currentScreenWidth / 2.0f), -(vy - (currentScreenHeight / 2.0f)),
-                                 0.0f, MTXF_NEW);
-                Matrix_SetGfxMtx(&gMasterDisp);
+                star->x = vx - (currentScreenWidth / 2.0f);
+                star->y = -(vy - (currentScreenHeight / 2.0f));
+                star->prevX = gStarPrevX[i] - (currentScreenWidth / 2.0f);
+                star->prevY = -(gStarPrevY[i] - (currentScreenHeight / 2.0f));
+                star->interpolate = !skipInterpolation && sStarWasVisible[i] && FrameInterpolation_IsRecording();
 
                 // Convert color from fill color (assuming RGB5A1) to RGBA8
                 u8 r = ((*color >> 11) & 0x1F);
@@ -324,26 +327,26 @@ void Background_DrawStarfield(void) {
                 g = (g << 3) | (g >> 2); // Convert 5-bit to 8-bit
                 u8 b = ((*color >> 1) & 0x1F);
                 b = (b << 3) | (b >> 2); // Convert 5-bit to 8-bit
-                u8 a = 255;              // Fully opaque
-
-                gDPSetPrimColor(gMasterDisp++, 0, 0, r, g, b, a);
 
-                // Draw the star using the predefined display list
-                gSPDisplayList(gMasterDisp++, starDL);
-                Matrix_Pop(&gGfxMatrix);
-
-                if (skipInterpolation) {
-                    // @port Re-enable Interpolation if it was skipped
-                    FrameInterpolation_ShouldInterpolateFrame(true);
-                } else {
-                    FrameInterpolation_RecordCloseChild();
-                }
+                star->cn[0] = r;
+                star->cn[1] = g;
+                star->cn[2] = b;
+                star->cn[3] = 255; // Fully opaque
 
                 gStarPrevX[i] = vx;
                 gStarPrevY[i] = vy;
+                sStarWasVisible[i] = true;
+            } else {
+                sStarWasVisible[i] = false;
             }
         }
 
+        if (visibleCount != 0) {
+            // Stars are positioned by the command itself, only the ortho projection is left in the matrix
+            Matrix_SetGfxMtx(&gMasterDisp);
+            gSPStarfield(gMasterDisp++, stars, visibleCount);
+        }
+
         if (CVarGetInteger("gDisableStarsInterpolation", 0) == 1) {
             FrameInterpolation_ShouldInterpolateFrame(true);
         }
@@ -1,4 +1,5 @@
 #include "global.h"
+#include "port/collision/ColPolyBvh.h"
 
 f32 __dx1;
 f32 __dx2;
@@ -485,29 +486,114 @@ bool func_col1_80098980(Vec3f* pos, Vec3s** tri, Vec3f* normal) {
     return var_v1;
 }
 
-bool func_80099254(Vec3f* objPos, Vec3f* colliderPos, Vec3f* objVel, CollisionHeader* colHeader, Vec3f* hitPosOut,
-                   f32* hitAnglesOut) {
+// @port: the poly tests of func_80099254, split out so gCollisionBvh 2 can run them over every poly as well. Visits
+// the candidate polys in order, or every poly if candidates is NULL. Returns the index of the poly hit, or -1.
+static s32 func_80099254_TestPolys(CollisionPoly* polys, Vec3s* mesh, const u16* candidates, s32 candidateCount,
+                                   s32* objMin, s32* objMax, Vec3f* objRel, Vec3f* objVel, Vec3f* colliderPos,
+                                   Vec3f* hitPosOut, f32* hitAnglesOut) {
     Vec3s* polyVtxPos[3];
-    Vec3f objRel;
-    s32 pad11C;
-    s32 pad118;
     PlaneF polyPlane;
     f32 tempf;
-    s32 didHit = false;
-    s32 swapBuff;
+    f32 speed = VEC3F_MAG(objVel);
     CollisionPoly* colPoly;
-    Vec3s* mesh;
-    s32 polyCount;
-    f32 speed;
-    s32 i;
     Vec3f hitPosRel;
-    s32 padD8;
     s32 polyMinX;
     s32 polyMaxX;
     s32 polyMinY;
     s32 polyMaxY;
     s32 polyMinZ;
     s32 polyMaxZ;
+    s32 i;
+    s32 j;
+
+    for (j = 0; j < candidateCount; j++) {
+        i = (candidates != NULL) ? candidates[j] : j;
+        colPoly = &polys[i];
+        polyVtxPos[0] = &mesh[colPoly->tri.vtx[0]];
+        polyVtxPos[1] = &mesh[colPoly->tri.vtx[1]];
+        polyVtxPos[2] = &mesh[colPoly->tri.vtx[2]];
+        Math_MinMax(&polyMinX, &polyMaxX, polyVtxPos[0]->x, polyVtxPos[1]->x, polyVtxPos[2]->x);
+        Math_MinMax(&polyMinY, &polyMaxY, polyVtxPos[0]->y, polyVtxPos[1]->y, polyVtxPos[2]->y);
+        Math_MinMax(&polyMinZ, &polyMaxZ, polyVtxPos[0]->z, polyVtxPos[1]->z, polyVtxPos[2]->z);
+
+        // check if bounding boxes of the object's movement and the collision polygon overlap
+        if ((objMin[0] < polyMaxX) && (objMax[0] > polyMinX) && (objMin[1] < polyMaxY) && (objMax[1] > polyMinY) &&
+            (objMin[2] < polyMaxZ) && (objMax[2] > polyMinZ)) {
+            polyPlane.normal.x = colPoly->plane.normal.x;
+            polyPlane.normal.y = colPoly->plane.normal.y;
+            polyPlane.normal.z = colPoly->plane.normal.z;
+            polyPlane.dist = colPoly->plane.dist;
+
+            // check if object is on the "back" side of the polygon
+            if ((DOT_XYZ(&polyPlane.normal, objRel) + polyPlane.dist) <= 0.0f) {
+
+                // calculate the normal component of velocity
+                tempf = DOT_XYZ(&polyPlane.normal, objVel);
+
+                // check if the angle between the normal and velocity is > 90. That is, the object was moving toward the
+                // front of the polygon
+                if (Math_FAcosF(tempf / (VEC3F_MAG(&polyPlane.normal) * speed)) > DEG_TO_RAD(90.0f)) {
+                    // Calculate the time since the plane was crossed. Reusing the temp is required to match
+                    tempf = (DOT_XYZ(&polyPlane.normal, objRel) + polyPlane.dist) / tempf;
+
+                    // find the point where the object crossed the plane of the polygon
+                    hitPosRel.x = objRel->x - (objVel->x * tempf);
+                    hitPosRel.y = objRel->y - (objVel->y * tempf);
+                    hitPosRel.z = objRel->z - (objVel->z * tempf);
+
+                    // check if that point is within the polygon
+                    if (func_col1_80098980(&hitPosRel, polyVtxPos, &polyPlane.normal) == true) {
+                        hitPosOut->x = colliderPos->x + hitPosRel.x;
+                        hitPosOut->y = colliderPos->y + hitPosRel.y;
+                        hitPosOut->z = colliderPos->z + hitPosRel.z;
+                        if (polyPlane.normal.x != 0.0) {
+                            polyPlane.normal.x = -polyPlane.dist / polyPlane.normal.x;
+                        }
+                        if (polyPlane.normal.y != 0.0f) {
+                            polyPlane.normal.y = -polyPlane.dist / polyPlane.normal.y;
+                        }
+                        if (polyPlane.normal.z != 0.0f) {
+                            polyPlane.normal.z = -polyPlane.dist / polyPlane.normal.z;
+                        }
+                        hitAnglesOut[0] = Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.z);
+                        if (polyPlane.normal.z != 0.0f) {
+                            hitAnglesOut[1] = -Math_Atan2F_XY(
+                                __sinf(Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.z)) * polyPlane.normal.z,
+                                polyPlane.normal.x);
+                        } else if (hitAnglesOut[0] >= M_PI) {
+                            hitAnglesOut[1] = Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.x);
+                        } else {
+                            hitAnglesOut[1] = -Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.x);
+                        }
+                        return i;
+                    }
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+// @port: whether two results of func_80099254_TestPolys hit at the same spot, on a poly facing the same way
+static bool func_80099254_SameHit(CollisionPoly* polys, s32 hitPoly, Vec3f* hitPos, f32* hitAngles, s32 otherHitPoly,
+                                  Vec3f* otherHitPos, f32* otherHitAngles) {
+    if ((hitPoly < 0) || (otherHitPoly < 0)) {
+        return hitPoly == otherHitPoly;
+    }
+    return (hitPos->x == otherHitPos->x) && (hitPos->y == otherHitPos->y) && (hitPos->z == otherHitPos->z) &&
+           (hitAngles[0] == otherHitAngles[0]) && (hitAngles[1] == otherHitAngles[1]) &&
+           (polys[hitPoly].plane.normal.x == polys[otherHitPoly].plane.normal.x) &&
+           (polys[hitPoly].plane.normal.y == polys[otherHitPoly].plane.normal.y) &&
+           (polys[hitPoly].plane.normal.z == polys[otherHitPoly].plane.normal.z) &&
+           (polys[hitPoly].plane.dist == polys[otherHitPoly].plane.dist);
+}
+
+bool func_80099254(Vec3f* objPos, Vec3f* colliderPos, Vec3f* objVel, CollisionHeader* colHeader, Vec3f* hitPosOut,
+                   f32* hitAnglesOut) {
+    Vec3f objRel;
+    s32 swapBuff;
+    Vec3s* mesh;
+    s32 polyCount;
     s32 objMinX;
     s32 objMaxX;
     s32 objMinY;
@@ -516,6 +602,15 @@ bool func_80099254(Vec3f* objPos, Vec3f* colliderPos, Vec3f* objVel, CollisionHe
     s32 objMaxZ;
     Vec3f min;
     Vec3f max;
+    CollisionPoly* polys;
+    const u16* candidates;
+    s32 candidateCount;
+    s32 objMin[3];
+    s32 objMax[3];
+    s32 hitPoly;
+    s32 linearHitPoly;
+    Vec3f linearHitPos;
+    f32 linearHitAngles[2];
 
     hitPosOut->x = hitPosOut->y = hitPosOut->z = hitAnglesOut[0] = hitAnglesOut[1] = 0.0f;
     objRel.x = objPos->x - colliderPos->x;
@@ -562,77 +657,41 @@ bool func_80099254(Vec3f* objPos, Vec3f* colliderPos, Vec3f* objVel, CollisionHe
         objMinZ = swapBuff;
     }
 
-    colPoly = LOAD_ASSET(colHeader->polys);
+    polys = LOAD_ASSET(colHeader->polys);
     mesh = LOAD_ASSET(colHeader->mesh);
     polyCount = colHeader->polyCount;
-    speed = VEC3F_MAG(objVel);
-
-    for (i = 0; i < polyCount; i++, colPoly++) {
-        polyVtxPos[0] = &mesh[colPoly->tri.vtx[0]];
-        polyVtxPos[1] = &mesh[colPoly->tri.vtx[1]];
-        polyVtxPos[2] = &mesh[colPoly->tri.vtx[2]];
-        Math_MinMax(&polyMinX, &polyMaxX, polyVtxPos[0]->x, polyVtxPos[1]->x, polyVtxPos[2]->x);
-        Math_MinMax(&polyMinY, &polyMaxY, polyVtxPos[0]->y, polyVtxPos[1]->y, polyVtxPos[2]->y);
-        Math_MinMax(&polyMinZ, &polyMaxZ, polyVtxPos[0]->z, polyVtxPos[1]->z, polyVtxPos[2]->z);
-
-        // check if bounding boxes of the object's movement and the collision polygon overlap
-        if ((objMinX < polyMaxX) && (objMaxX > polyMinX) && (objMinY < polyMaxY) && (objMaxY > polyMinY) &&
-            (objMinZ < polyMaxZ) && (objMaxZ > polyMinZ)) {
-            polyPlane.normal.x = colPoly->plane.normal.x;
-            polyPlane.normal.y = colPoly->plane.normal.y;
-            polyPlane.normal.z = colPoly->plane.normal.z;
-            polyPlane.dist = colPoly->plane.dist;
-
-            // check if object is on the "back" side of the polygon
-            if ((DOT_XYZ(&polyPlane.normal, &objRel) + polyPlane.dist) <= 0.0f) {
-
-                // calculate the normal component of velocity
-                tempf = DOT_XYZ(&polyPlane.normal, objVel);
-
-                // check if the angle between the normal and velocity is > 90. That is, the object was moving toward the
-                // front of the polygon
-                if (Math_FAcosF(tempf / (VEC3F_MAG(&polyPlane.normal) * speed)) > DEG_TO_RAD(90.0f)) {
-                    // Calculate the time since the plane was crossed. Reusing the temp is required to match
-                    tempf = (DOT_XYZ(&polyPlane.normal, &objRel) + polyPlane.dist) / tempf;
-
-                    // find the point where the object crossed the plane of the polygon
-                    hitPosRel.x = objRel.x - (objVel->x * tempf);
-                    hitPosRel.y = objRel.y - (objVel->y * tempf);
-                    hitPosRel.z = objRel.z - (objVel->z * tempf);
 
-                    // check if that point is within the polygon
-                    if (func_col1_80098980(&hitPosRel, polyVtxPos, &polyPlane.normal) == true) {
-                        hitPosOut->x = colliderPos->x + hitPosRel.x;
-                        hitPosOut->y = colliderPos->y + hitPosRel.y;
-                        hitPosOut->z = colliderPos->z + hitPosRel.z;
-                        if (polyPlane.normal.x != 0.0) {
-                            polyPlane.normal.x = -polyPlane.dist / polyPlane.normal.x;
-                        }
-                        if (polyPlane.normal.y != 0.0f) {
-                            polyPlane.normal.y = -polyPlane.dist / polyPlane.normal.y;
-                        }
-                        if (polyPlane.normal.z != 0.0f) {
-                            polyPlane.normal.z = -polyPlane.dist / polyPlane.normal.z;
-                        }
-                        hitAnglesOut[0] = Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.z);
-                        if (polyPlane.normal.z != 0.0f) {
-                            hitAnglesOut[1] = -Math_Atan2F_XY(
-                                __sinf(Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.z)) * polyPlane.normal.z,
-                                polyPlane.normal.x);
-                        } else if (hitAnglesOut[0] >= M_PI) {
-                            hitAnglesOut[1] = Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.x);
-                        } else {
-                            hitAnglesOut[1] = -Math_Atan2F_XY(polyPlane.normal.y, polyPlane.normal.x);
-                        }
+    // Only visit the polys whose bounding boxes can overlap the object's movement, in the same order as before
+    objMin[0] = objMinX;
+    objMin[1] = objMinY;
+    objMin[2] = objMinZ;
+    objMax[0] = objMaxX;
+    objMax[1] = objMaxY;
+    objMax[2] = objMaxZ;
+    candidates = ColPolyBvh_Query(polys, mesh, polyCount, objMin, objMax, &candidateCount);
+    if (candidates == NULL) {
+        candidateCount = polyCount;
+    }
 
-                        didHit = true;
-                        break;
-                    }
-                }
-            }
+    hitPoly = func_80099254_TestPolys(polys, mesh, candidates, candidateCount, objMin, objMax, &objRel, objVel,
+                                      colliderPos, hitPosOut, hitAnglesOut);
+
+    // @port: gCollisionBvh 2 also runs the tests over every poly, which has to hit the same spot
+    if ((candidates != NULL) && ColPolyBvh_IsChecking()) {
+        linearHitPos.x = linearHitPos.y = linearHitPos.z = linearHitAngles[0] = linearHitAngles[1] = 0.0f;
+        linearHitPoly = func_80099254_TestPolys(polys, mesh, NULL, polyCount, objMin, objMax, &objRel, objVel,
+                                                colliderPos, &linearHitPos, linearHitAngles);
+        if (!func_80099254_SameHit(polys, hitPoly, hitPosOut, hitAnglesOut, linearHitPoly, &linearHitPos,
+                                   linearHitAngles)) {
+            ColPolyBvh_ReportMismatch(polyCount, hitPoly, linearHitPoly);
+            *hitPosOut = linearHitPos;
+            hitAnglesOut[0] = linearHitAngles[0];
+            hitAnglesOut[1] = linearHitAngles[1];
+            hitPoly = linearHitPoly;
         }
     }
-    return didHit;
+
+    return hitPoly >= 0;
 }
 
 bool func_col1_800998FC(Vec3f* objPos, Vec3f* colliderPos, Vec3f* objVel, s32 colId, Vec3f* hitPosOut,
@@ -840,6 +840,130 @@ bool Object_CheckPolyCollision(Vec3f* pos, Vec3f* vel, ObjectId objId, Object* o
     return false;
 }
 
+// Uniform XZ grid over scenery and sprites so that collision queries only look at objects near the query point.
+// It is rebuilt by Object_Update once scenery and sprites have moved for the frame and is only used until the end of
+// it. Cells are larger than the farthest distance a hit can happen at by COLGRID_MARGIN, so objects that move a bit
+// after the rebuild are still found. Candidates are visited in array order and go through the same checks as before.
+#define COLGRID_BUCKETS 256
+#define COLGRID_MARGIN 500.0f
+#define COLGRID_POS_LIMIT 1.0e8f
+#define COLGRID_MAX_OBJECTS 200
+#define COLGRID_WORDS ((COLGRID_MAX_OBJECTS + 31) / 32)
+
+typedef struct {
+    f32 cellSize;
+    s32 count;
+    s16 head[COLGRID_BUCKETS + 1]; // The last bucket holds free slots and objects too far out to be placed in a cell
+    s16 next[COLGRID_MAX_OBJECTS];
+} ObjectColGrid;
+
+static bool sColGridValid = false;
+static ObjectColGrid sColGridScenery360;
+static ObjectColGrid sColGridScenery;
+static ObjectColGrid sColGridSprites;
+static u32 sColGridCandidates[COLGRID_WORDS];
+
+static s32 ObjectColGrid_Bucket(s32 cellX, s32 cellZ) {
+    return (((u32) cellX * 73856093u) ^ ((u32) cellZ * 19349663u)) % COLGRID_BUCKETS;
+}
+
+static void ObjectColGrid_Init(ObjectColGrid* grid, f32 cellSize, s32 count) {
+    s32 i;
+
+    grid->cellSize = cellSize;
+    grid->count = count;
+    for (i = 0; i < COLGRID_BUCKETS + 1; i++) {
+        grid->head[i] = -1;
+    }
+}
+
+static void ObjectColGrid_Insert(ObjectColGrid* grid, s32 index, Object* obj) {
+    s32 bucket = COLGRID_BUCKETS;
+
+    // Free slots can be filled by objects spawned later in the frame, so they are always visited
+    if ((obj->status != OBJ_FREE) && (fabsf(obj->pos.x) < COLGRID_POS_LIMIT) &&
+        (fabsf(obj->pos.z) < COLGRID_POS_LIMIT)) {
+        bucket = ObjectColGrid_Bucket((s32) floorf(obj->pos.x / grid->cellSize),
+                                      (s32) floorf(obj->pos.z / grid->cellSize));
+    }
+    grid->next[index] = grid->head[bucket];
+    grid->head[bucket] = index;
+}
+
+static void ObjectColGrid_MarkBucket(ObjectColGrid* grid, s32 bucket) {
+    s32 i;
+
+    for (i = grid->head[bucket]; i >= 0; i = grid->next[i]) {
+        sColGridCandidates[i / 32] |= 1u << (i % 32);
+    }
+}
+
+// Fills sColGridCandidates with every object of the grid that may be close enough to pos to collide with it, or with
+// every object when the grid isn't built.
+static void ObjectColGrid_Query(ObjectColGrid* grid, Vec3f* pos) {
+    s32 i;
+    s32 cellX;
+    s32 cellZ;
+
+    if (!sColGridValid || !(fabsf(pos->x) < COLGRID_POS_LIMIT) || !(fabsf(pos->z) < COLGRID_POS_LIMIT)) {
+        for (i = 0; i < COLGRID_WORDS; i++) {
+            sColGridCandidates[i] = 0xFFFFFFFF;
+        }
+        return;
+    }
+
+    for (i = 0; i < COLGRID_WORDS; i++) {
+        sColGridCandidates[i] = 0;
+    }
+    cellX = (s32) floorf(pos->x / grid->cellSize);
+    cellZ = (s32) floorf(pos->z / grid->cellSize);
+    for (i = 0; i < 9; i++) {
+        ObjectColGrid_MarkBucket(grid, ObjectColGrid_Bucket(cellX + (i % 3) - 1, cellZ + (i / 3) - 1));
+    }
+    ObjectColGrid_MarkBucket(grid, COLGRID_BUCKETS);
+}
+
+// Returns the first candidate after index, or count if there is none.
+static s32 ObjectColGrid_Next(s32 index, s32 count) {
+    u32 word;
+
+    for (index++; index < count; index = (index | 31) + 1) {
+        word = sColGridCandidates[index / 32] >> (index % 32);
+        if (word != 0) {
+            while (!(word & 1)) {
+                word >>= 1;
+                index++;
+            }
+            return MIN(index, count);
+        }
+    }
+    return count;
+}
+
+void Object_UpdateCollisionGrid(void) {
+    s32 i;
+
+    sColGridValid = CVarGetInteger("gCollisionGrid", 1);
+    if (!sColGridValid) {
+        return;
+    }
+
+    ObjectColGrid_Init(&sColGridScenery360, 2000.0f + COLGRID_MARGIN, 200);
+    ObjectColGrid_Init(&sColGridScenery, 2000.0f + COLGRID_MARGIN, ARRAY_COUNT(gScenery));
+    ObjectColGrid_Init(&sColGridSprites, 500.0f + COLGRID_MARGIN, ARRAY_COUNT(gSprites));
+
+    // Inserted back to front so the lists end up in ascending order
+    for (i = 200 - 1; i >= 0; i--) {
+        ObjectColGrid_Insert(&sColGridScenery360, i, &gScenery360[i].obj);
+    }
+    for (i = ARRAY_COUNT(gScenery) - 1; i >= 0; i--) {
+        ObjectColGrid_Insert(&sColGridScenery, i, &gScenery[i].obj);
+    }
+    for (i = ARRAY_COUNT(gSprites) - 1; i >= 0; i--) {
+        ObjectColGrid_Insert(&sColGridSprites, i, &gSprites[i].obj);
+    }
+}
+
 s32 Object_CheckCollision(s32 index, Vec3f* pos, Vec3f* vel, s32 mode) {
     Scenery360* scenery360;
     Scenery* scenery;
@@ -850,8 +974,9 @@ s32 Object_CheckCollision(s32 index, Vec3f* pos, Vec3f* vel, s32 mode) {
     s32 i;
 
     if ((gLevelMode == LEVELMODE_ALL_RANGE) && (gCurrentLevel != LEVEL_KATINA)) {
-        scenery360 = gScenery360;
-        for (i = 0; i < 200; i++, scenery360++) {
+        ObjectColGrid_Query(&sColGridScenery360, pos);
+        for (i = ObjectColGrid_Next(-1, 200); i < 200; i = ObjectColGrid_Next(i, 200)) {
+            scenery360 = &gScenery360[i];
             if (scenery360->obj.status == OBJ_ACTIVE) {
                 if ((scenery360->obj.id == OBJ_SCENERY_CO_BUMP_1) || (scenery360->obj.id == OBJ_SCENERY_CO_BUMP_3) ||
                     (scenery360->obj.id == OBJ_SCENERY_AQ_CORAL_REEF_1) ||
@@ -873,8 +998,11 @@ s32 Object_CheckCollision(s32 index, Vec3f* pos, Vec3f* vel, s32 mode) {
         }
     }
 
-    scenery = &gScenery[0];
-    for (i = 0; (i < ARRAY_COUNT(gScenery)) && (gLevelMode == LEVELMODE_ON_RAILS); i++, scenery++) {
+    ObjectColGrid_Query(&sColGridScenery, pos);
+    for (i = ObjectColGrid_Next(-1, ARRAY_COUNT(gScenery));
+         (i < ARRAY_COUNT(gScenery)) && (gLevelMode == LEVELMODE_ON_RAILS);
+         i = ObjectColGrid_Next(i, ARRAY_COUNT(gScenery))) {
+        scenery = &gScenery[i];
         if (scenery->obj.status == OBJ_ACTIVE) {
             if ((scenery->obj.id == OBJ_SCENERY_CO_BUMP_1) || (scenery->obj.id == OBJ_SCENERY_CO_BUMP_4) ||
                 (scenery->obj.id == OBJ_SCENERY_CO_BUMP_5) || (scenery->obj.id == OBJ_SCENERY_CO_BUMP_2) ||
@@ -891,8 +1019,10 @@ s32 Object_CheckCollision(s32 index, Vec3f* pos, Vec3f* vel, s32 mode) {
         }
     }
 
-    sprite = &gSprites[0];
-    for (i = 0; i < ARRAY_COUNT(gSprites); i++, sprite++) {
+    ObjectColGrid_Query(&sColGridSprites, pos);
+    for (i = ObjectColGrid_Next(-1, ARRAY_COUNT(gSprites)); i < ARRAY_COUNT(gSprites);
+         i = ObjectColGrid_Next(i, ARRAY_COUNT(gSprites))) {
+        sprite = &gSprites[i];
         if ((sprite->obj.status == OBJ_ACTIVE) && (fabsf(pos->x - sprite->obj.pos.x) < 500.0f) &&
             (fabsf(pos->z - sprite->obj.pos.z) < 500.0f) &&
             Object_CheckSingleHitbox(pos, sprite->info.hitbox, &sprite->obj.pos)) {
@@ -3146,6 +3276,8 @@ void Object_Update(void) {
         }
     }
 
+    Object_UpdateCollisionGrid();
+
     for (i = 0, boss = &gBosses[0]; i < ARRAY_COUNT(gBosses); i++, boss++) {
         if (boss->obj.status != OBJ_FREE) {
             boss->index = i;
@@ -3176,6 +3308,8 @@ void Object_Update(void) {
 
     TexturedLine_UpdateAll();
 
+    sColGridValid = false;
+
     for (i = 0; i < ARRAY_COUNT(D_enmy_Timer_80161670); i++) {
         if (D_enmy_Timer_80161670[i] != 0) {
             D_enmy_Timer_80161670[i]--;
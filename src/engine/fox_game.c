@@ -6,6 +6,8 @@
 #include "port/interpolation/FrameInterpolation.h"
 #include "port/hooks/list/EngineEvent.h"
 #include "port/mods/PortEnhancements.h"
+#include "port/benchmark/Benchmark.h"
+#include "port/resource/ScenePrefetch.h"
 
 f32 gNextVsViewScale;
 f32 gVsViewScale;
@@ -58,18 +60,22 @@ void Game_Initialize(void) {
     Rand_Init();
     Rand_SetSeed(1, 29000, 9876);
     gGameState = GSTATE_BOOT;
-#ifdef MODS_BOOT_STATE
-    gNextGameState = GSTATE_INIT;
-    if (Save_Read() != 0) {
+#ifndef MODS_BOOT_STATE
+    // @port: Recordings and their replays skip the logo, like MODS_BOOT_STATE does
+    if (Benchmark_IsActive())
+#endif
+    {
+        gNextGameState = GSTATE_INIT;
+        if (Save_Read() != 0) {
 #ifdef AVOID_UB
-        gSaveFile.save = gDefaultSave;
-        gSaveFile.backup = gDefaultSave;
+            gSaveFile.save = gDefaultSave;
+            gSaveFile.backup = gDefaultSave;
 #else
-        gSaveFile = *((SaveFile*) &gDefaultSave);
+            gSaveFile = *((SaveFile*) &gDefaultSave);
 #endif
-        Save_Write();
+            Save_Write();
+        }
     }
-#endif
     gNextGameStateTimer = 0;
     gBgColor = 0;
     gBlurAlpha = 255;
@@ -154,6 +160,8 @@ bool Game_ChangeScene(void) {
         sHoldTimer--;
         return true;
     }
+    // @port: Gameplay starts, everything on the scene's prefetch list has to be loaded by now
+    ScenePrefetch_Wait();
     return false;
 }
 
@@ -431,6 +439,11 @@ void Game_Update(void) {
 #ifdef MODS_BOOT_STATE
                 gNextGameState = MODS_BOOT_STATE;
 #endif
+                // @port: Recordings and their replays start right in the level
+                if (Benchmark_IsActive()) {
+                    gNextGameState = GSTATE_PLAY;
+                    gNextLevel = Benchmark_GetLevel();
+                }
                 CVarSetFloat("gMainMusicVolume", gSaveFile.save.data.musicVolume / 100.0f);
                 CVarSetFloat("gVoiceVolume", gSaveFile.save.data.voiceVolume / 100.0f);
                 CVarSetFloat("gSFXMusicVolume", gSaveFile.save.data.sfxVolume / 100.0f);
@@ -516,6 +529,7 @@ void Game_Update(void) {
                 break;
         }
 
+        Benchmark_StageBegin(BENCHMARK_STAGE_DRAW);
         Game_Draw(0);
 
         if (gCamCount == 2) {
@@ -608,6 +622,7 @@ void Game_Update(void) {
                                    OTRGetRectDimensionFromRightEdge(SCREEN_WIDTH), SCREEN_HEIGHT, gFillScreenRed,
                                    gFillScreenGreen, gFillScreenBlue, gFillScreenAlpha);
         }
+        Benchmark_StageEnd(BENCHMARK_STAGE_DRAW);
         Audio_dummy_80016A50();
 
         // @port: @event: Call GamePostUpdateEvent
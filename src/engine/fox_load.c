@@ -1,5 +1,6 @@
 #include "global.h"
 #include "sf64dma.h"
+#include "port/resource/ScenePrefetch.h"
 
 u8 sFillTimer = 3;
 
@@ -90,6 +91,9 @@ u8 Load_SceneFiles(Scene* scene) {
 u8 Load_SceneSetup(u8 sceneId, u8 sceneSetup) {
     u8 changeScene;
 
+    // @port: Start loading the resources the scene used on earlier runs
+    ScenePrefetch_SetScene(sceneId, sceneSetup);
+
     switch (sceneId) {
         case SCENE_TITLE:
             changeScene = Load_SceneFiles(&sOvlmenu_Title[sceneSetup]);
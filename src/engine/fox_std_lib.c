@@ -35,12 +35,15 @@ void Lib_Texture_Scroll(u16* texture, s32 width, s32 height, u8 mode) {
     GameEngine_GetTextureInfo(texture, &newWidth, &newHeight, &scale, &custom);
 
     if (custom) {
-        u32* pixel = SEGMENTED_TO_VIRTUAL(texture);
+        u32* texData = SEGMENTED_TO_VIRTUAL(texture);
+        u32* pixel;
         u32 tempPxl;
         s32 u;
         s32 v;
         width = newWidth;
         height = newHeight;
+        // @port: The render thread may be reading the texture, write to the copy that replaces it between frames
+        pixel = GameEngine_BeginTextureWrite(texData, width * height * sizeof(u32));
 
         scale = 1; // TODO: a higher scale causes performance issues for large textures ?
 
@@ -84,10 +87,12 @@ void Lib_Texture_Scroll(u16* texture, s32 width, s32 height, u8 mode) {
                     break;
             }
 
-            gSPInvalidateTexCache(gMasterDisp++, pixel);
+            gSPInvalidateTexCache(gMasterDisp++, texData);
         }
     } else {
-        u16* pixel = SEGMENTED_TO_VIRTUAL(texture);
+        u16* texData = SEGMENTED_TO_VIRTUAL(texture);
+        // @port: See above
+        u16* pixel = GameEngine_BeginTextureWrite(texData, width * height * sizeof(u16));
         u16 tempPxl;
         s32 u;
         s32 v;
@@ -131,7 +136,7 @@ void Lib_Texture_Scroll(u16* texture, s32 width, s32 height, u8 mode) {
                 break;
         }
 
-        gSPInvalidateTexCache(gMasterDisp++, pixel);
+        gSPInvalidateTexCache(gMasterDisp++, texData);
     }
 }
 
@@ -142,9 +147,16 @@ void Lib_Texture_Mottle(u16* dst, u16* src, u8 mode) {
     u8* dst8;
     u8* src8;
     s32 offset;
+    u16* texData;
+    // @port: Bytes of dst the mode writes
+    static const s32 sMottleSizes[] = { 32 * 32 * 2, 16 * 16 * 2, 32 * 32 * 2, 32 * 64 * 2, 0, 64 * 64 };
 
-    dst = LOAD_ASSET(dst);
+    texData = LOAD_ASSET(dst);
     src = LOAD_ASSET(src);
+    // @port: The render thread may be reading the textures, write to the copy that replaces dst between frames and
+    // read the copy of src if it was written this frame
+    dst = GameEngine_BeginTextureWrite(texData, mode < ARRAY_COUNT(sMottleSizes) ? sMottleSizes[mode] : 0);
+    src = (u16*) GameEngine_GetTextureForRead(src);
 
     switch (mode) {
         case 2:
@@ -195,7 +207,7 @@ void Lib_Texture_Mottle(u16* dst, u16* src, u8 mode) {
             break;
     }
 
-    gSPInvalidateTexCache(gMasterDisp++, dst);
+    gSPInvalidateTexCache(gMasterDisp++, texData);
 }
 
 s32 Animation_GetLimbIndex(Limb* limb, Limb** skeleton) {
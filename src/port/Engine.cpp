@@ -11,6 +11,7 @@
 
 #include "extractor/GameExtractor.h"
 #include "libultraship/src/Context.h"
+#include "libultraship/src/resource/archive/FastPackArchive.h"
 #include "libultraship/src/controller/controldevice/controller/mapping/ControllerDefaultMappings.h"
 #include "resource/type/ResourceType.h"
 #include "resource/importers/AnimFactory.h"
@@ -45,8 +46,15 @@
 #include <BlobFactory.h>
 #include <VertexFactory.h>
 #include "audio/GameAudio.h"
+#include "audio/AudioRing.h"
+#include "audio/AudioRateControl.h"
+#include "audio/SynthPool.h"
+#include "audio/AdpcmCache.h"
+#include "GameRender.h"
 #include "port/patches/DisplayListPatch.h"
 #include "port/mods/PortEnhancements.h"
+#include "port/benchmark/Benchmark.h"
+#include "port/resource/ScenePrefetch.h"
 
 #include <Fast3D/interpreter.h>
 #include <filesystem>
@@ -63,6 +71,7 @@ bool gEnableGammaBoost = true;
 #include <sf64thread.h>
 #include <macros.h>
 #include "sf64audio_provisional.h"
+#include "audio/mixer.h"
 void AudioThread_CreateNextAudioBuffer(int16_t* samples, uint32_t num_samples);
 }
 
@@ -113,6 +122,20 @@ void waitForSetupFromNative() {
 #endif
 
 
+// Mounted over the O2R files so every load is served from the pack, which is written again whenever one of them
+// changes. The O2R files stay mounted for their game versions.
+static void MountFastPack(const std::vector<std::string>& archiveFiles) {
+    auto archiveManager = Ship::Context::GetInstance()->GetResourceManager()->GetArchiveManager();
+    const std::string packPath = Ship::Context::GetPathRelativeToAppDirectory("starship.fpk");
+    const uint64_t sourceId = Ship::FastPackArchive::GetSourceId(archiveFiles);
+
+    if (!Ship::FastPackArchive::IsCurrent(packPath, sourceId) &&
+        !Ship::FastPackArchive::Write(packPath, *archiveManager, sourceId)) {
+        return;
+    }
+    archiveManager->AddArchive(packPath);
+}
+
 GameEngine::GameEngine() {
 #ifdef __ANDROID__
     const char* sdlInternal = SDL_AndroidGetInternalStoragePath();
@@ -227,9 +250,14 @@ GameEngine::GameEngine() {
     auto controlDeck = std::make_shared<LUS::ControlDeck>(std::vector<CONTROLLERBUTTONS_T>(), defaultMappings);
 
     this->context->InitResourceManager(archiveFiles, {}, 3); // without this line InitWindow fails in Gui::Init()
+    if (CVarGetInteger("gFastPack", 0)) {
+        MountFastPack(archiveFiles);
+    }
     this->context->InitConsole(); // without this line the GuiWindow constructor fails in ConsoleWindow::InitElement()
 
-    auto window = std::make_shared<Fast::Fast3dWindow>(std::vector<std::shared_ptr<Ship::GuiWindow>>({}));
+    auto window = std::make_shared<Fast::Fast3dWindow>(
+        std::vector<std::shared_ptr<Ship::GuiWindow>>({ std::make_shared<GameStatsWindow>("gStatsEnabled", "Stats") }));
+    window->SetHeadless(SF64::Benchmark::IsHeadless());
 
     auto audioChannelsSetting = Ship::Context::GetInstance()->GetConfig()->GetCurrentAudioChannelsSetting();
     this->context->Init(archiveFiles, {}, 3, { 32000, 1024, 1680, audioChannelsSetting }, window, controlDeck);
@@ -327,6 +355,10 @@ GameEngine::GameEngine() {
     prevAltAssets = CVarGetInteger("gEnhancements.Mods.AlternateAssets", 0);
     gEnableGammaBoost = CVarGetInteger("gGraphics.GammaMode", 0) == 0;
     context->GetResourceManager()->SetAltAssetsEnabled(prevAltAssets);
+    // The game keeps raw pointers to most other resources, and the audio ones have to stay for the ADPCM cache and
+    // sample streams. Textures are looked up by the renderer every frame, and they are what HD packs make large.
+    context->GetResourceManager()->SetEvictableResourceTypes({ static_cast<uint32_t>(Fast::ResourceType::Texture) });
+    ScenePrefetch_Init();
 }
 
 bool GameEngine::GenAssetFile(bool exitOnFail) {
@@ -370,6 +402,7 @@ void GameEngine::Create() {
 
 void GameEngine::Destroy() {
     PortEnhancements_Exit();
+    ScenePrefetch_Shutdown();
     AudioExit();
     for (auto ptr : MemoryPool) {
         free(ptr);
@@ -380,10 +413,96 @@ void GameEngine::Destroy() {
 #endif
 }
 
+// Blocks until the render thread finished the frames handed to it. The interpreter is then only used by the caller.
+static void WaitForRenderIdle() {
+    if (!render.running) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> Lock(render.mutex);
+    while ((render.pending || render.rendering) && render.running) {
+        render.cv_from_render.wait(Lock);
+    }
+}
+
+// Textures the game thread changed this frame, by the address of the texture. Only used with the render pipeline,
+// only touched by the game thread.
+static std::unordered_map<void*, std::vector<uint8_t>> sStagedTextures;
+
+extern "C" void* GameEngine_BeginTextureWrite(void* texture, size_t size) {
+    if (!render.running || texture == nullptr || size == 0) {
+        return texture;
+    }
+
+    auto& staged = sStagedTextures[texture];
+    if (staged.size() < size) {
+        // The first write this frame, or a larger one, starts from what the texture holds
+        const uint8_t* data = (const uint8_t*) texture;
+        staged.insert(staged.end(), data + staged.size(), data + size);
+    }
+    return staged.data();
+}
+
+extern "C" const void* GameEngine_GetTextureForRead(const void* texture) {
+    if (sStagedTextures.empty()) {
+        return texture;
+    }
+
+    auto staged = sStagedTextures.find(const_cast<void*>(texture));
+    return staged != sStagedTextures.end() ? staged->second.data() : texture;
+}
+
+// Called by the game thread while the render thread is idle
+static void FlushStagedTextures() {
+    for (auto& [texture, staged] : sStagedTextures) {
+        memcpy(texture, staged.data(), staged.size());
+    }
+    sStagedTextures.clear();
+}
+
+// Called by the main thread before it waits for a frame
+static void PollRenderPipelineInput() {
+    OSContPad pads[MAXCONTROLLERS];
+    osContGetReadData(pads);
+    auto window = Ship::Context::GetInstance()->GetWindow();
+    const int32_t scancode = window->GetLastScancode();
+    window->SetLastScancode(-1);
+
+    std::unique_lock<std::mutex> Lock(render.mutex);
+    memcpy(render.pads, pads, sizeof(pads));
+    // Kept until the game thread read it, it may not have started a frame since the last poll
+    if (scancode != -1) {
+        render.scancode = scancode;
+    }
+}
+
+extern "C" void GameEngine_ContGetReadData(OSContPad* pads) {
+    if (!render.running) {
+        osContGetReadData(pads);
+        return;
+    }
+
+    std::unique_lock<std::mutex> Lock(render.mutex);
+    memcpy(pads, render.pads, sizeof(OSContPad) * __osMaxControllers);
+}
+
+static int32_t TakeLastScancode() {
+    if (!render.running) {
+        auto window = Ship::Context::GetInstance()->GetWindow();
+        const int32_t scancode = window->GetLastScancode();
+        window->SetLastScancode(-1);
+        return scancode;
+    }
+
+    std::unique_lock<std::mutex> Lock(render.mutex);
+    const int32_t scancode = render.scancode;
+    render.scancode = -1;
+    return scancode;
+}
+
 void GameEngine::StartFrame() const {
     using Ship::KbScancode;
-    const int32_t dwScancode = this->context->GetWindow()->GetLastScancode();
-    this->context->GetWindow()->SetLastScancode(-1);
+    const int32_t dwScancode = TakeLastScancode();
 
     switch (dwScancode) {
         case KbScancode::LUS_KB_TAB: {
@@ -408,6 +527,7 @@ void GameEngine::StartFrame() const {
 // Values for 32000 hz
 #define SAMPLES_HIGH 560
 #define SAMPLES_LOW 528
+#define AUDIO_SAMPLE_RATE 32000
 
 #endif
 
@@ -420,13 +540,30 @@ extern "C" volatile s32 gAudioTaskCountQ;
 int frames = 0;
 extern "C" int countermin = 0;
 
-extern "C" unsigned short samples_high = SAMPLES_HIGH;
-extern "C" unsigned short samples_low = SAMPLES_LOW;
+#define AUDIO_UPDATES_PER_SECOND 60
+#define AUDIO_MIN_LATENCY_MS 20
+#define AUDIO_MAX_LATENCY_MS 200
+
+static SF64::AudioRing sAudioRing;
+static SF64::AudioRateControl sAudioRateControl;
+
+// Samples per channel to keep queued, gAudioLatency in ms or the player's default when it's 0 (Auto)
+static int32_t GetAudioTargetBuffered() {
+    const int32_t latencyMs = CVarGetInteger("gAudioLatency", 0);
+    if (latencyMs <= 0) {
+        return AudioPlayerGetDesiredBuffered();
+    }
+    return std::clamp(latencyMs, AUDIO_MIN_LATENCY_MS, AUDIO_MAX_LATENCY_MS) * AUDIO_SAMPLE_RATE / 1000;
+}
 
 void GameEngine::HandleAudioThread() {
 #ifdef PIPE_DEBUG
     std::ofstream outfile("audio.bin", std::ios::binary | std::ios::app);
 #endif
+    u32 owed = 0;
+    bool started = false;
+    sAudioRateControl.Reset();
+
     while (audio.running) {
         {
             std::unique_lock<std::mutex> Lock(audio.mutex);
@@ -444,8 +581,6 @@ void GameEngine::HandleAudioThread() {
 #define MAX_AUDIO_FRAMES_PER_UPDATE 5 // Compile-time constant with max value of gVIsPerFrame
 
         std::unique_lock<std::mutex> Lock(audio.mutex);
-        int samples_left = AudioPlayerBuffered();
-        u32 num_audio_samples = samples_left < AudioPlayerGetDesiredBuffered() ? (((samples_high))) : (((samples_low)));
 
         frames++;
 
@@ -456,18 +591,47 @@ void GameEngine::HandleAudioThread() {
         const int32_t num_audio_channels = GetNumAudioChannels();
 
         s16 audio_buffer[SAMPLES_HIGH * MAX_NUM_AUDIO_CHANNELS * MAX_AUDIO_FRAMES_PER_UPDATE] = { 0 };
+        u32 num_audio_samples = 0;
+        Benchmark_StageBegin(BENCHMARK_STAGE_AUDIO);
         for (int i = 0; i < AUDIO_FRAMES_PER_UPDATE; i++) {
-            AudioThread_CreateNextAudioBuffer(audio_buffer + i * (num_audio_samples * num_audio_channels),
-                                              num_audio_samples);
+            // Multiples of 16 samples per VI that average out to the sample rate, which keeps the music's tempo
+            // steady. The rate control takes up the difference to the device's clock.
+            owed += AUDIO_SAMPLE_RATE;
+            const u32 vi_samples = (owed / AUDIO_UPDATES_PER_SECOND) & ~15;
+            owed -= vi_samples * AUDIO_UPDATES_PER_SECOND;
+
+            AudioThread_CreateNextAudioBuffer(audio_buffer + num_audio_samples * num_audio_channels, vi_samples);
+            num_audio_samples += vi_samples;
         }
+        Benchmark_StageEnd(BENCHMARK_STAGE_AUDIO);
 #ifdef PIPE_DEBUG
         if (outfile.is_open()) {
             outfile.write(reinterpret_cast<char*>(audio_buffer),
-                          num_audio_samples * (sizeof(int16_t) * num_audio_channels * AUDIO_FRAMES_PER_UPDATE));
+                          num_audio_samples * (sizeof(int16_t) * num_audio_channels));
         }
 #endif
-        AudioPlayerPlayFrame((u8*) audio_buffer,
-                             num_audio_samples * (sizeof(int16_t) * num_audio_channels * AUDIO_FRAMES_PER_UPDATE));
+        // Headless runs go as fast as they can, queueing their audio would only pile it up
+        if (!SF64::Benchmark::IsHeadless()) {
+            const int32_t target = GetAudioTargetBuffered();
+            int32_t buffered = AudioPlayerBuffered();
+            if (buffered == 0) {
+                if (started) {
+                    SF64::AudioRateControl::ReportUnderrun();
+                }
+                // Starting out or starved, fill up to the target at once instead of slowly stretching up to it
+                std::vector<s16> silence(target * num_audio_channels);
+                AudioPlayerPlayFrame((u8*) silence.data(), silence.size() * sizeof(int16_t));
+                buffered = target;
+            }
+            started = true;
+
+            s16 resampled[(SAMPLES_HIGH * MAX_AUDIO_FRAMES_PER_UPDATE + 16) * MAX_NUM_AUDIO_CHANNELS];
+            sAudioRateControl.Update(buffered, target, num_audio_samples);
+            const size_t resampled_frames =
+                sAudioRateControl.Process(audio_buffer, num_audio_samples, num_audio_channels, resampled,
+                                          SAMPLES_HIGH * MAX_AUDIO_FRAMES_PER_UPDATE + 16);
+            AudioPlayerPlayFrame((u8*) resampled, resampled_frames * num_audio_channels * sizeof(int16_t));
+        }
         
         audio.processing = false;
         audio.cv_from_thread.notify_one();
@@ -477,15 +641,89 @@ void GameEngine::HandleAudioThread() {
 #endif
 }
 
+void GameEngine::HandleAudioSynthThread() {
+    {
+        // The audio heap is only set up once the game runs its first frame
+        std::unique_lock<std::mutex> Lock(audio.mutex);
+        while (!audio.processing && audio.running) {
+            audio.cv_to_thread.wait(Lock);
+        }
+        if (!audio.running) {
+            return;
+        }
+    }
+
+    const int32_t max_target =
+        std::max(AudioPlayerGetDesiredBuffered(), AUDIO_MAX_LATENCY_MS * AUDIO_SAMPLE_RATE / 1000);
+    sAudioRing.Init((max_target + SAMPLES_HIGH) * MAX_NUM_AUDIO_CHANNELS);
+    audio.output = std::thread(HandleAudioOutputThread);
+
+    s16 audio_buffer[SAMPLES_HIGH * MAX_NUM_AUDIO_CHANNELS];
+    u32 owed = 0;
+
+    while (audio.running) {
+        const int32_t num_audio_channels = GetNumAudioChannels();
+
+        // Render ahead until the ring holds the target latency. Rendering on demand follows the device's clock, so
+        // there is no drift to correct here.
+        if (sAudioRing.Available() >= GetAudioTargetBuffered() * num_audio_channels) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // One update per VI on the audio's own clock. Updates have to be a multiple of 16 samples, carrying the
+        // remainder over makes them average out to the sample rate (528, 528, 544 at 32 kHz).
+        owed += AUDIO_SAMPLE_RATE;
+        u32 num_audio_samples = (owed / AUDIO_UPDATES_PER_SECOND) & ~15;
+        owed -= num_audio_samples * AUDIO_UPDATES_PER_SECOND;
+
+        AudioThread_CreateNextAudioBuffer(audio_buffer, num_audio_samples);
+        sAudioRing.Write(audio_buffer, num_audio_samples * num_audio_channels);
+    }
+}
+
+void GameEngine::HandleAudioOutputThread() {
+    s16 audio_buffer[SAMPLES_HIGH * MAX_NUM_AUDIO_CHANNELS];
+    bool started = false;
+
+    while (audio.running) {
+        const size_t num_audio_channels = GetNumAudioChannels();
+
+        const int32_t buffered = AudioPlayerBuffered();
+        if (buffered == 0 && started) {
+            SF64::AudioRateControl::ReportUnderrun();
+        }
+        SF64::AudioRateControl::ReportFill(buffered + sAudioRing.Available() / num_audio_channels,
+                                           GetAudioTargetBuffered(), 0);
+
+        // The players only take pushed data, keep the device a couple of updates deep and leave the rest of the
+        // latency in the ring where a late frame can not starve it
+        while (AudioPlayerBuffered() < SAMPLES_HIGH * 2 && sAudioRing.Available() >= num_audio_channels) {
+            size_t count = std::min(sAudioRing.Available(), SAMPLES_HIGH * num_audio_channels);
+            count = sAudioRing.Read(audio_buffer, count - count % num_audio_channels);
+            AudioPlayerPlayFrame((u8*) audio_buffer, count * sizeof(int16_t));
+            started = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
 void GameEngine::StartAudioFrame() {
     {
         std::unique_lock<std::mutex> Lock(audio.mutex);
+        // Decoupled, this only lets the audio thread start on the first frame
+        if (audio.decoupled && audio.processing) {
+            return;
+        }
         audio.processing = true;
     }
     audio.cv_to_thread.notify_one();
 }
 
 void GameEngine::EndAudioFrame() {
+    if (audio.decoupled) {
+        return;
+    }
     {
         std::unique_lock<std::mutex> Lock(audio.mutex);
         while (audio.processing) {
@@ -497,7 +735,14 @@ void GameEngine::EndAudioFrame() {
 void GameEngine::AudioInit() {
     if (!audio.running) {
         audio.running = true;
-        audio.thread = std::thread(HandleAudioThread);
+        // Benchmarks keep the lockstep audio, anything the game reads back from it has to happen on the same frame
+        // on every run
+        audio.decoupled = CVarGetInteger("gAudioDecoupled", 0) && !SF64::Benchmark::IsHeadless() &&
+                          !Benchmark_IsActive();
+        aMixerInit();
+        SynthPool_Init(CVarGetInteger("gAudioSynthThreads", 0));
+        AdpcmCache_Init();
+        audio.thread = std::thread(audio.decoupled ? HandleAudioSynthThread : HandleAudioThread);
     }
 }
 
@@ -509,9 +754,15 @@ void GameEngine::AudioExit() {
     audio.cv_to_thread.notify_all();
     // Wait until the audio thread quit
     audio.thread.join();
+    if (audio.output.joinable()) {
+        audio.output.join();
+    }
+    SynthPool_Shutdown();
+    AdpcmCache_Shutdown();
 }
 
-void GameEngine::RunCommands(Gfx* Commands, const std::vector<std::unordered_map<Mtx*, MtxF>>& mtx_replacements) {
+void GameEngine::RunCommands(Gfx* Commands, const std::vector<Fast::MtxReplacementMap>& mtx_replacements,
+                             const std::vector<float>& interpolation_steps) {
     auto wnd = std::dynamic_pointer_cast<Fast::Fast3dWindow>(Ship::Context::GetInstance()->GetWindow());
 
     if (wnd == nullptr) {
@@ -524,21 +775,59 @@ void GameEngine::RunCommands(Gfx* Commands, const std::vector<std::unordered_map
     wnd->HandleEvents();
 
     interpreter->mInterpolationIndex = 0;
-
-    for (const auto& m : mtx_replacements) {
-        wnd->DrawAndRunGraphicsCommands(Commands, m);
+    interpreter->mVertexBatchCacheEnabled = interpolation_steps.size() > 1;
+    // Debug switch to compare the vectorized vertex transform against the scalar one
+    interpreter->mVertexSimdEnabled = CVarGetInteger("gVertexSimd", 1);
+
+    // The replacement tables are reused between frames, only the first interpolation_steps.size() are valid
+    for (size_t i = 0; i < interpolation_steps.size(); i++) {
+        interpreter->mInterpolationStep = interpolation_steps[i];
+        wnd->DrawAndRunGraphicsCommands(Commands, mtx_replacements[i]);
         interpreter->mInterpolationIndex++;
     }
 
-    bool curAltAssets = CVarGetInteger("gEnhancements.Mods.AlternateAssets", 0);
+    SF64::Benchmark::RecordTextureUploads(interpreter->mTextureUploadCount);
+}
+
+void GameEngine::UpdateResourceCache() {
+    auto resourceManager = Ship::Context::GetInstance()->GetResourceManager();
+    resourceManager->SetCacheBudget((size_t) std::max(CVarGetInteger("gResourceCacheBudget", 0), 0) << 20);
+
+    const bool curAltAssets = CVarGetInteger("gEnhancements.Mods.AlternateAssets", 0);
+    if (prevAltAssets == curAltAssets && !resourceManager->IsOverCacheBudget()) {
+        return;
+    }
+
+    // The game thread is between frames, but with the render pipeline the previous frame may still be drawn from
+    // resources about to be replaced or freed
+    WaitForRenderIdle();
+    auto interpreter = GameEngine_GetInterpreter();
+
     if (prevAltAssets != curAltAssets) {
         prevAltAssets = curAltAssets;
-        Ship::Context::GetInstance()->GetResourceManager()->SetAltAssetsEnabled(curAltAssets);
-        gfx_texture_cache_clear();
+        // Only the textures that have another version are uploaded again, the others stay in the texture cache
+        uint32_t replacedTextures = 0;
+        for (const auto& resource : resourceManager->SetAltAssetsEnabled(curAltAssets)) {
+            if (auto texture = std::dynamic_pointer_cast<Fast::Texture>(resource)) {
+                interpreter->TextureCacheDelete(texture->ImageData);
+                replacedTextures++;
+            }
+        }
+        SF64::Benchmark::RecordAltAssetsToggle(replacedTextures);
+    }
+
+    // Over the asset budget, textures no longer used since the scene started are dropped. Their uploads go as well,
+    // a texture loaded later could get the same address.
+    for (const auto& resource : resourceManager->EvictResources()) {
+        if (auto texture = std::dynamic_pointer_cast<Fast::Texture>(resource)) {
+            interpreter->TextureCacheDelete(texture->ImageData);
+        }
     }
 }
 
-void GameEngine::ProcessGfxCommands(Gfx* commands) {
+
+void GameEngine::SubmitGfxCommands(Gfx* commands, const std::vector<Fast::MtxReplacementMap>& mtx_replacements,
+                                   const std::vector<float>& interpolation_steps, int fps) {
     auto wnd = std::dynamic_pointer_cast<Fast::Fast3dWindow>(Ship::Context::GetInstance()->GetWindow());
 
     if (wnd == nullptr) {
@@ -549,8 +838,23 @@ void GameEngine::ProcessGfxCommands(Gfx* commands) {
         wnd->EnableSRGBMode();
     }
     wnd->SetRendererUCode(UcodeHandlers::ucode_f3dex);
+    wnd->SetTargetFps(fps);
+    wnd->SetMaximumFrameLatency(CVarGetInteger("gRenderParallelization", 1) ? 2 : 1);
+
+    Benchmark_StageBegin(BENCHMARK_STAGE_RENDER);
+    RunCommands(commands, mtx_replacements, interpolation_steps);
+    Benchmark_StageEnd(BENCHMARK_STAGE_RENDER);
+}
 
-    std::vector<std::unordered_map<Mtx*, MtxF>> mtx_replacements;
+void GameEngine::ProcessGfxCommands(Gfx* commands) {
+    auto wnd = std::dynamic_pointer_cast<Fast::Fast3dWindow>(Ship::Context::GetInstance()->GetWindow());
+
+    if (wnd == nullptr) {
+        return;
+    }
+
+    static std::vector<Fast::MtxReplacementMap> mtx_replacements;
+    static std::vector<float> interpolation_steps;
     int target_fps = GameEngine::Instance->GetInterpolationFPS();
     static int last_fps;
     static int last_update_rate;
@@ -569,32 +873,130 @@ void GameEngine::ProcessGfxCommands(Gfx* commands) {
     // time_base = fps * original_fps (one second)
     int next_original_frame = fps;
 
+    interpolation_steps.clear();
+
     while (time + original_fps <= next_original_frame) {
         time += original_fps;
+        if (mtx_replacements.size() <= interpolation_steps.size()) {
+            mtx_replacements.emplace_back();
+        }
+        auto& replacements = mtx_replacements[interpolation_steps.size()];
+        replacements.clear();
         if (time != next_original_frame) {
-            mtx_replacements.push_back(FrameInterpolation_Interpolate((float) time / next_original_frame));
+            FrameInterpolation_Interpolate((float) time / next_original_frame, replacements);
+            interpolation_steps.push_back((float) time / next_original_frame);
         } else {
-            mtx_replacements.emplace_back();
+            interpolation_steps.push_back(1.0f);
         }
     }
 
     time -= fps;
 
-    if (wnd != nullptr) {
-        wnd->SetTargetFps(fps);
-        wnd->SetMaximumFrameLatency(CVarGetInteger("gRenderParallelization", 1) ? 2 : 1);
-    }
-
     // When the gfx debugger is active, only run with the final mtx
     if (GfxDebuggerIsDebugging()) {
-        mtx_replacements.clear();
-        mtx_replacements.emplace_back();
+        if (mtx_replacements.empty()) {
+            mtx_replacements.emplace_back();
+        }
+        mtx_replacements[0].clear();
+        interpolation_steps.clear();
+        interpolation_steps.push_back(1.0f);
     }
 
-    RunCommands(commands, mtx_replacements);
-
     last_fps = fps;
     last_update_rate = gVIsPerFrame;
+
+    if (!render.running) {
+        SubmitGfxCommands(commands, mtx_replacements, interpolation_steps, fps);
+        return;
+    }
+
+    // The interpolated matrices are resolved here on the game thread, so the render thread never touches the
+    // FrameInterpolation recording. Waiting for the previous frame to finish rendering guarantees the GfxPool
+    // the game is about to rebuild is no longer in use.
+    std::unique_lock<std::mutex> Lock(render.mutex);
+    while ((render.pending || render.rendering) && render.running) {
+        render.cv_from_render.wait(Lock);
+    }
+    if (!render.running) {
+        return;
+    }
+    // The render thread is idle, the textures the game changed this frame can replace the ones it drew from
+    FlushStagedTextures();
+    render.commands = commands;
+    render.fps = fps;
+    // Swap rather than move so the tables the render thread handed back keep their storage for the next frame
+    std::swap(render.mtx_replacements, mtx_replacements);
+    std::swap(render.interpolation_steps, interpolation_steps);
+    render.pending = true;
+    Lock.unlock();
+    render.cv_to_render.notify_one();
+}
+
+void GameEngine::RenderPipelineInit(void (*update)()) {
+    if (render.running) {
+        return;
+    }
+
+    render.scancode = -1;
+    PollRenderPipelineInput();
+    render.running = true;
+    render.pending = false;
+    render.rendering = false;
+    render.thread = std::thread([update]() {
+        while (render.running) {
+            update();
+        }
+    });
+}
+
+bool GameEngine::RenderPipelineFrame() {
+    Gfx* commands;
+    int fps;
+    static std::vector<Fast::MtxReplacementMap> mtx_replacements;
+    static std::vector<float> interpolation_steps;
+
+    PollRenderPipelineInput();
+
+    {
+        std::unique_lock<std::mutex> Lock(render.mutex);
+        while (!render.pending && render.running) {
+            render.cv_to_render.wait(Lock);
+        }
+        if (!render.running) {
+            return false;
+        }
+        commands = render.commands;
+        fps = render.fps;
+        std::swap(mtx_replacements, render.mtx_replacements);
+        std::swap(interpolation_steps, render.interpolation_steps);
+        render.pending = false;
+        render.rendering = true;
+    }
+
+    SubmitGfxCommands(commands, mtx_replacements, interpolation_steps, fps);
+
+    {
+        std::unique_lock<std::mutex> Lock(render.mutex);
+        render.rendering = false;
+    }
+    render.cv_from_render.notify_one();
+    return true;
+}
+
+void GameEngine::RenderPipelineExit() {
+    if (!render.running) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> Lock(render.mutex);
+        render.running = false;
+    }
+    render.cv_to_render.notify_all();
+    render.cv_from_render.notify_all();
+    // Wait until the game thread finished its current frame
+    render.thread.join();
+    FlushStagedTextures();
 }
 
 uint32_t GameEngine::GetInterpolationFPS() {
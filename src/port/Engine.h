@@ -33,15 +33,26 @@ class GameEngine {
     static bool GenAssetFile(bool exitOnFail = true);
     static void Create();
     static void HandleAudioThread();
+    static void HandleAudioSynthThread();
+    static void HandleAudioOutputThread();
     static void StartAudioFrame();
     static void EndAudioFrame();
     static void AudioInit();
     static void AudioExit();
-    static void RunCommands(Gfx* Commands, const std::vector<std::unordered_map<Mtx*, MtxF>>& mtx_replacements);
+    static void RunCommands(Gfx* Commands, const std::vector<Fast::MtxReplacementMap>& mtx_replacements,
+                            const std::vector<float>& interpolation_steps);
     static void Destroy();
 	static uint32_t GetInterpolationFPS();
 	static uint32_t GetInterpolationFrameCount();
     static void ProcessGfxCommands(Gfx* commands);
+    static void SubmitGfxCommands(Gfx* commands, const std::vector<Fast::MtxReplacementMap>& mtx_replacements,
+                                  const std::vector<float>& interpolation_steps, int fps);
+    static void RenderPipelineInit(void (*update)());
+    static bool RenderPipelineFrame();
+    static void RenderPipelineExit();
+    // Applies alternate asset toggles and evicts resources over the cache budget. Called by the game thread before it
+    // starts a frame, once the renderer is done with every frame that could refer to what gets replaced.
+    static void UpdateResourceCache();
 
     static int ShowYesNoBox(const char* title, const char* box);
     static void ShowMessage(const char* title, const char* message, SDL_MessageBoxFlags type = SDL_MESSAGEBOX_ERROR);
@@ -83,6 +94,14 @@ uint32_t OTRGetGameRenderWidth();
 uint32_t OTRGetGameRenderHeight();
 void* GameEngine_Malloc(size_t size);
 void GameEngine_GetTextureInfo(const char* path, int32_t* width, int32_t* height, float* scale, bool* custom);
+// Returns where the game writes size bytes of a texture it changes at runtime. With the render pipeline that is a
+// copy, the texture itself may be read by the render thread, which replaces the texture when the frame is handed
+// over. Otherwise it is the texture.
+void* GameEngine_BeginTextureWrite(void* texture, size_t size);
+// The texture as the game thread last wrote it, for textures read from after GameEngine_BeginTextureWrite
+const void* GameEngine_GetTextureForRead(const void* texture);
+// osContGetReadData, or the pads the main thread polled last when the game runs on its own thread
+void GameEngine_ContGetReadData(OSContPad* pads);
 void gDPSetTileSizeInterp(Gfx* pkt, int t, float uls, float ult, float lrs, float lrt);
 uint32_t GameEngine_GetInterpolationFrameCount();
 
@@ -2,6 +2,7 @@
 
 #include <Fast3D/interpreter.h>
 #include "Engine.h"
+#include "benchmark/Benchmark.h"
 
 extern "C" {
 #include <sf64mesg.h>
@@ -21,12 +22,14 @@ void Graphics_PushFrame(Gfx* data) {
 extern "C" void Timer_Update();
 
 void push_frame() {
+    GameEngine::UpdateResourceCache();
     Graphics_ThreadUpdate();
     GameEngine::StartAudioFrame();
     GameEngine::Instance->StartFrame();
     Timer_Update();
     // thread5_iteration();
     GameEngine::EndAudioFrame();
+    SF64::Benchmark::EndFrame();
 }
 
 #ifdef _WIN32
@@ -37,14 +40,35 @@ extern "C"
 #endif
 int main(int argc, char *argv[]) {
 #endif
+    if (!SF64::Benchmark::ParseArgs(argc, argv)) {
+        return 1;
+    }
     GameEngine::Create();
+    if (SF64::Benchmark::IsAudioRender()) {
+        const int result = SF64::Benchmark::RunAudioRender(SF64::Benchmark::GetAudioRenderOptions());
+        GameEngine::Instance->Destroy();
+        return result;
+    }
     Main_SetVIMode();
     Lib_FillScreen(1);
     Main_Initialize();
     Main_ThreadEntry(NULL);
-    while (WindowIsRunning()) {
-        push_frame();
+    // Experimental and off by default. Textures, input and resource cache changes are handed over between frames, but
+    // the game thread still reads CVars without a lock while the menus on the main thread write them.
+    if (CVarGetInteger("gRenderPipelined", 0)) {
+        // Game logic and display list building move to their own thread, the interpreter keeps the main thread
+        // (and with it the window and graphics context) and runs one frame behind.
+        GameEngine::RenderPipelineInit(push_frame);
+        while (WindowIsRunning()) {
+            GameEngine::RenderPipelineFrame();
+        }
+        GameEngine::RenderPipelineExit();
+    } else {
+        while (WindowIsRunning()) {
+            push_frame();
+        }
     }
+    const int result = SF64::Benchmark::Exit();
     GameEngine::Instance->Destroy();
-    return 0;
+    return result;
 }
\ No newline at end of file
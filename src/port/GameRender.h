@@ -0,0 +1,25 @@
+#pragma once
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <Fast3D/interpreter.h>
+
+// Handoff slot between the game thread (building frame N+1) and the render thread (interpreting frame N).
+// Only one frame may be pending or rendering at a time, which keeps the game from reusing the GfxPool
+// that is still being read by the interpreter.
+static struct {
+    std::thread thread;
+    std::condition_variable cv_to_render, cv_from_render;
+    std::mutex mutex;
+    std::atomic<bool> running;
+    bool pending;
+    bool rendering;
+    Gfx* commands;
+    int fps;
+    std::vector<Fast::MtxReplacementMap> mtx_replacements;
+    std::vector<float> interpolation_steps;
+    // Input is polled on the main thread, which owns the window and its events, and read from here by the game
+    OSContPad pads[MAXCONTROLLERS];
+    int32_t scancode;
+} render;
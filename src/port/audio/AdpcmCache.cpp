@@ -0,0 +1,289 @@
+#include "AdpcmCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <libultraship.h>
+
+extern "C" {
+#include "sf64audio_provisional.h"
+#include "audio/mixer.h"
+}
+
+static constexpr uint32_t ADPCM_FRAME_SIZE = 9;
+static constexpr uint32_t ADPCM_FRAME_SAMPLES = 16;
+// Frames decoded per pass, the in and out buffers have to fit into the DMEM of the decoding context
+static constexpr uint32_t DECODE_CHUNK_FRAMES = 64;
+static constexpr uint32_t DECODE_CHUNK_SIZE = (DECODE_CHUNK_FRAMES * ADPCM_FRAME_SIZE + 15) & ~15;
+static constexpr uint16_t DECODE_IN = 0x450;
+static constexpr uint16_t DECODE_OUT = 0x850;
+static constexpr uint32_t ADPCM_TABLE_SIZE = 8 * 2 * 8 * sizeof(int16_t);
+
+// Immutable once published, the synthesis reads it without a lock
+struct CacheEntry {
+    // Empty while the sample is queued, or if it can't be cached
+    std::vector<int16_t> pcm;
+    uint32_t numFrames = 0;
+    // sUpdateCount when it last played, the least recently played samples are dropped first
+    mutable std::atomic<uint32_t> lastPlayed = 0;
+    // Set once the sample is dropped. The snapshot may still hold the entry until the next AdpcmCache_Update, a new
+    // sample at the same address must not get its PCM.
+    std::atomic<bool> released = false;
+};
+
+using Snapshot = std::unordered_map<const Sample*, const CacheEntry*>;
+
+static std::mutex sMutex;
+static std::condition_variable sQueueReady;
+static std::condition_variable sDecodeDone;
+static std::thread sThread;
+static bool sRunning = false;
+static std::atomic<bool> sEnabled = false;
+static std::atomic<uint32_t> sUpdateCount = 0;
+static size_t sBudget = 0;
+static size_t sCachedBytes = 0;
+static std::deque<const Sample*> sQueue;
+// Being decoded, outside the lock
+static const Sample* sDecoding = nullptr;
+// Every sample queued, decoded or not cacheable, so nothing is decoded twice. Guarded by sMutex.
+static std::unordered_map<const Sample*, std::unique_ptr<CacheEntry>> sEntries;
+// What AdpcmCache_Get looks up, a copy of sEntries. Copying it for every change costs O(n) per queued sample, so
+// changes only mark it stale and AdpcmCache_Update publishes a new one at most once per update.
+static std::atomic<const Snapshot*> sSnapshot = nullptr;
+// Guarded by sMutex
+static bool sSnapshotStale = false;
+// Replaced snapshots and dropped entries, the synthesis may read them until the next AdpcmCache_Update
+static std::vector<std::unique_ptr<const Snapshot>> sRetiredSnapshots;
+static std::vector<std::unique_ptr<CacheEntry>> sRetiredEntries;
+
+// Callers must hold sMutex
+static void Publish() {
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->reserve(sEntries.size());
+    for (const auto& [sample, entry] : sEntries) {
+        snapshot->emplace(sample, entry.get());
+    }
+    const Snapshot* previous = sSnapshot.exchange(snapshot.release(), std::memory_order_acq_rel);
+    if (previous != nullptr) {
+        sRetiredSnapshots.emplace_back(previous);
+    }
+    sSnapshotStale = false;
+}
+
+// Callers must hold sMutex. Decoded again the next time it plays.
+static void Retire(std::unordered_map<const Sample*, std::unique_ptr<CacheEntry>>::iterator it) {
+    it->second->released.store(true, std::memory_order_release);
+    sSnapshotStale = true;
+    sCachedBytes -= it->second->pcm.size() * sizeof(int16_t);
+    sRetiredEntries.push_back(std::move(it->second));
+    sEntries.erase(it);
+}
+
+// Runs the mixer's own decoder so the cached PCM matches what the synthesis would decode bit for bit
+static bool Decode(const Sample* sample, std::vector<int16_t>& pcm, uint32_t& numFrames) {
+    const AdpcmBook* book = sample->book;
+    if (book == nullptr || book->book == nullptr || sample->sampleAddr == nullptr) {
+        return false;
+    }
+    const uint32_t bookSize = ADPCM_FRAME_SAMPLES * book->order * book->numPredictors;
+    if (book->order != 2 || bookSize > ADPCM_TABLE_SIZE) {
+        return false;
+    }
+
+    numFrames = sample->size / ADPCM_FRAME_SIZE;
+    pcm.resize((size_t) numFrames * ADPCM_FRAME_SAMPLES);
+
+    uint8_t in[DECODE_CHUNK_SIZE];
+    ADPCM_STATE state;
+    aLoadADPCMImpl(bookSize, book->book);
+    for (uint32_t frame = 0; frame < numFrames; frame += DECODE_CHUNK_FRAMES) {
+        const uint32_t count = std::min(DECODE_CHUNK_FRAMES, numFrames - frame);
+        memset(in, 0, sizeof(in));
+        memcpy(in, sample->sampleAddr + frame * ADPCM_FRAME_SIZE, count * ADPCM_FRAME_SIZE);
+
+        aLoadBufferImpl(in, DECODE_IN, (count * ADPCM_FRAME_SIZE + 15) & ~15);
+        aSetBufferImpl(0, DECODE_IN, DECODE_OUT, count * ADPCM_FRAME_SAMPLES * sizeof(int16_t));
+        aADPCMdecImpl(frame == 0 ? A_INIT : A_CONTINUE, state);
+        aSaveBufferImpl(DECODE_OUT + ADPCM_FRAME_SAMPLES * sizeof(int16_t), &pcm[frame * ADPCM_FRAME_SAMPLES],
+                        count * ADPCM_FRAME_SAMPLES * sizeof(int16_t));
+    }
+
+    // After looping the synthesis continues from the loop state instead of what was decoded before the loop start.
+    // Both give the same samples only if the state is that frame, anything else is left to the decoder.
+    const AdpcmLoop* loop = sample->loop;
+    if (loop != nullptr && loop->count != 0) {
+        const uint32_t loopFrame = loop->start / ADPCM_FRAME_SAMPLES;
+        if (loopFrame >= numFrames || memcmp(&pcm[loopFrame * ADPCM_FRAME_SAMPLES], loop->predictorState,
+                                             sizeof(loop->predictorState)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void DecodeThread() {
+    AudioMixerContext* context = aMixerContextCreate();
+    aMixerContextSet(context);
+
+    std::unique_lock<std::mutex> lock(sMutex);
+    while (true) {
+        sQueueReady.wait(lock, [] { return !sRunning || !sQueue.empty(); });
+        if (!sRunning) {
+            break;
+        }
+        const Sample* sample = sQueue.front();
+        sQueue.pop_front();
+        sDecoding = sample;
+
+        lock.unlock();
+        auto decoded = std::make_unique<CacheEntry>();
+        const bool isDecoded = Decode(sample, decoded->pcm, decoded->numFrames);
+        lock.lock();
+        sDecoding = nullptr;
+        sDecodeDone.notify_all();
+
+        // Stays known when it can't be cached, so it isn't queued again on every note. Dropped while decoding if it
+        // was released or the cache was disabled.
+        const size_t bytes = decoded->pcm.size() * sizeof(int16_t);
+        auto it = sEntries.find(sample);
+        if (!isDecoded || bytes > sBudget || it == sEntries.end()) {
+            continue;
+        }
+        decoded->lastPlayed = sUpdateCount.load(std::memory_order_relaxed);
+        sRetiredEntries.push_back(std::move(it->second));
+        it->second = std::move(decoded);
+        sCachedBytes += bytes;
+        sSnapshotStale = true;
+    }
+
+    lock.unlock();
+    aMixerContextSet(nullptr);
+    aMixerContextDestroy(context);
+}
+
+extern "C" void AdpcmCache_Init(void) {
+    AdpcmCache_Update();
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    if (!sRunning) {
+        sRunning = true;
+        sThread = std::thread(DecodeThread);
+    }
+}
+
+extern "C" void AdpcmCache_Shutdown(void) {
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (!sRunning) {
+            return;
+        }
+        sRunning = false;
+    }
+    sQueueReady.notify_all();
+    sThread.join();
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    sQueue.clear();
+    sEntries.clear();
+    delete sSnapshot.exchange(nullptr);
+    sRetiredSnapshots.clear();
+    sRetiredEntries.clear();
+    sCachedBytes = 0;
+}
+
+extern "C" void AdpcmCache_Queue(const void* sample) {
+    const Sample* adpcmSample = static_cast<const Sample*>(sample);
+    if (!sEnabled || adpcmSample == nullptr || adpcmSample->codec != CODEC_ADPCM) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (!sEntries.try_emplace(adpcmSample, std::make_unique<CacheEntry>()).second) {
+            return;
+        }
+        sQueue.push_back(adpcmSample);
+        sSnapshotStale = true;
+    }
+    sQueueReady.notify_one();
+}
+
+extern "C" void AdpcmCache_Release(const void* sample) {
+    const Sample* adpcmSample = static_cast<const Sample*>(sample);
+
+    std::unique_lock<std::mutex> lock(sMutex);
+    // The decoder reads the sample data without the lock
+    sDecodeDone.wait(lock, [adpcmSample] { return sDecoding != adpcmSample; });
+    sQueue.erase(std::remove(sQueue.begin(), sQueue.end(), adpcmSample), sQueue.end());
+    auto it = sEntries.find(adpcmSample);
+    if (it != sEntries.end()) {
+        Retire(it);
+    }
+}
+
+extern "C" void AdpcmCache_Update(void) {
+    const bool enabled = CVarGetInteger("gAudioAdpcmCache", 0);
+    const size_t budget = (size_t) std::max(CVarGetInteger("gAudioAdpcmCacheSize", 64), 1) << 20;
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    sUpdateCount.fetch_add(1, std::memory_order_relaxed);
+    sEnabled = enabled;
+    sBudget = enabled ? budget : 0;
+    if (!enabled) {
+        sQueue.clear();
+        while (!sEntries.empty()) {
+            Retire(sEntries.begin());
+        }
+    }
+    if (sCachedBytes > sBudget) {
+        std::vector<std::pair<uint32_t, const Sample*>> decoded;
+        for (const auto& [sample, entry] : sEntries) {
+            if (!entry->pcm.empty()) {
+                decoded.emplace_back(entry->lastPlayed.load(std::memory_order_relaxed), sample);
+            }
+        }
+        std::sort(decoded.begin(), decoded.end());
+        for (size_t i = 0; i < decoded.size() && sCachedBytes > sBudget; i++) {
+            Retire(sEntries.find(decoded[i].second));
+        }
+    }
+    if (sSnapshotStale) {
+        Publish();
+    }
+
+    // Nothing synthesizes, so nothing can still read what the snapshots before this one held
+    sRetiredSnapshots.clear();
+    sRetiredEntries.clear();
+}
+
+extern "C" const int16_t* AdpcmCache_Get(const void* sample, uint32_t* numFrames) {
+    if (!sEnabled) {
+        return nullptr;
+    }
+
+    const CacheEntry* entry = nullptr;
+    const Snapshot* snapshot = sSnapshot.load(std::memory_order_acquire);
+    if (snapshot != nullptr) {
+        const auto it = snapshot->find(static_cast<const Sample*>(sample));
+        entry = (it != snapshot->end()) ? it->second : nullptr;
+    }
+    // Until the next update the snapshot can miss samples queued since, or hold ones that were released
+    if (entry == nullptr || entry->released.load(std::memory_order_acquire)) {
+        AdpcmCache_Queue(sample);
+        return nullptr;
+    }
+    if (entry->pcm.empty()) {
+        return nullptr;
+    }
+
+    entry->lastPlayed.store(sUpdateCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    *numFrames = entry->numFrames;
+    return entry->pcm.data();
+}
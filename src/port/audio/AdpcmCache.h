@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// ADPCM samples decoded once to PCM on a background thread, so the synthesis can copy them instead of decoding
+// every update. Enabled with gAudioAdpcmCache and bounded by gAudioAdpcmCacheSize (in MB), the least recently
+// played samples are dropped first. Lookups read a snapshot published by AdpcmCache_Update and take no lock, unless
+// they miss on a sample queued since.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void AdpcmCache_Init(void);
+void AdpcmCache_Shutdown(void);
+// Queues an ADPCM sample for decoding, anything else is ignored
+void AdpcmCache_Queue(const void* sample);
+// Drops the sample, called when the resource holding it is destroyed so a new sample at its address is not mistaken
+// for it. Waits if it is being decoded. Its PCM is freed by the next AdpcmCache_Update.
+void AdpcmCache_Release(const void* sample);
+// Applies the settings, drops samples over the budget and publishes what was queued, decoded or released since the
+// last call. Frees decoded PCM, only call it while no synthesis runs.
+void AdpcmCache_Update(void);
+// Returns the sample decoded from its start, 16 samples per frame and numFrames frames, or NULL if it is not
+// decoded yet. Queues it on a miss. Stays valid until the next AdpcmCache_Update.
+const int16_t* AdpcmCache_Get(const void* sample, uint32_t* numFrames);
+
+#ifdef __cplusplus
+}
+#endif
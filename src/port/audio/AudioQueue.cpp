@@ -0,0 +1,106 @@
+#include "AudioQueue.h"
+
+#include <atomic>
+
+static std::atomic<uint8_t> sCmdWritePos = 0;
+static std::atomic<uint8_t> sCmdReadPos = 0;
+static std::atomic<int32_t> sMailboxes[AUDIO_MAILBOX_MAX] = { -1, -1 };
+
+// Write position of every publish the audio thread has not received yet, so it still processes them one range at a
+// time like the message queue did. A stop command only holds back the rest of its own range.
+static uint8_t sCmdRanges[256];
+static std::atomic<uint8_t> sCmdRangeHead = 0;
+static std::atomic<uint8_t> sCmdRangeTail = 0;
+
+// Triple buffer, the audio thread fills one slot, the game thread reads another and the third is passed between them
+static constexpr uint8_t SNAPSHOT_FRESH = 0x80;
+static AudioSnapshot sSnapshots[3];
+static std::atomic<uint8_t> sSnapshotShared = 1;
+static uint8_t sSnapshotWrite = 0;
+static uint8_t sSnapshotRead = 2;
+
+extern "C" void AudioQueue_Reset(void) {
+    sCmdWritePos.store(0, std::memory_order_relaxed);
+    sCmdReadPos.store(0, std::memory_order_relaxed);
+    sCmdRangeHead.store(0, std::memory_order_relaxed);
+    sCmdRangeTail.store(0, std::memory_order_relaxed);
+    for (auto& mailbox : sMailboxes) {
+        mailbox.store(-1, std::memory_order_relaxed);
+    }
+    for (auto& snapshot : sSnapshots) {
+        snapshot = {};
+    }
+    sSnapshotShared.store(1, std::memory_order_relaxed);
+    sSnapshotWrite = 0;
+    sSnapshotRead = 2;
+}
+
+extern "C" void AudioQueue_PublishCmds(uint8_t writePos) {
+    // Release, so the commands are in memory before the audio thread sees the new position
+    sCmdWritePos.store(writePos, std::memory_order_release);
+
+    // With every range slot taken the position only moves on, the last range the audio thread receives grows to it
+    const uint8_t head = sCmdRangeHead.load(std::memory_order_relaxed);
+    if ((uint8_t) (head + 1) != sCmdRangeTail.load(std::memory_order_acquire)) {
+        sCmdRanges[head] = writePos;
+        sCmdRangeHead.store(head + 1, std::memory_order_release);
+    }
+}
+
+extern "C" uint8_t AudioQueue_GetCmdReadPos(void) {
+    return sCmdReadPos.load(std::memory_order_acquire);
+}
+
+extern "C" bool AudioQueue_ReceiveCmds(uint32_t* msg) {
+    const uint8_t tail = sCmdRangeTail.load(std::memory_order_relaxed);
+    const uint8_t head = sCmdRangeHead.load(std::memory_order_acquire);
+
+    if (tail == head) {
+        return false;
+    }
+    uint8_t writePos = sCmdRanges[tail];
+    if ((uint8_t) (tail + 1) == head) {
+        writePos = sCmdWritePos.load(std::memory_order_acquire);
+    }
+    sCmdRangeTail.store(tail + 1, std::memory_order_release);
+
+    *msg = (sCmdReadPos.load(std::memory_order_relaxed) << 8) | writePos;
+    return true;
+}
+
+extern "C" void AudioQueue_ConsumeCmds(uint8_t readPos) {
+    sCmdReadPos.store(readPos, std::memory_order_release);
+}
+
+extern "C" void AudioQueue_Send(AudioMailbox box, uint8_t value) {
+    sMailboxes[box].store(value, std::memory_order_release);
+}
+
+extern "C" bool AudioQueue_Receive(AudioMailbox box, uint8_t* value) {
+    const int32_t received = sMailboxes[box].exchange(-1, std::memory_order_acquire);
+
+    if (received < 0) {
+        return false;
+    }
+    *value = received;
+    return true;
+}
+
+extern "C" void AudioQueue_Clear(AudioMailbox box) {
+    sMailboxes[box].store(-1, std::memory_order_relaxed);
+}
+
+extern "C" AudioSnapshot* AudioQueue_GetSnapshotForWrite(void) {
+    return &sSnapshots[sSnapshotWrite];
+}
+
+extern "C" void AudioQueue_PublishSnapshot(void) {
+    sSnapshotWrite = sSnapshotShared.exchange(sSnapshotWrite | SNAPSHOT_FRESH, std::memory_order_acq_rel) & 3;
+}
+
+extern "C" const AudioSnapshot* AudioQueue_GetSnapshot(void) {
+    if (sSnapshotShared.load(std::memory_order_relaxed) & SNAPSHOT_FRESH) {
+        sSnapshotRead = sSnapshotShared.exchange(sSnapshotRead, std::memory_order_acq_rel) & 3;
+    }
+    return &sSnapshots[sSnapshotRead];
+}
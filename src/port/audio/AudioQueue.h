@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Lock-free single producer, single consumer handoff between the game thread and the audio thread. Replaces the
+// libultra message queues, which are not safe once both threads run at the same time.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum AudioMailbox {
+    AUDIO_MAILBOX_SPEC,  // Game -> audio: audio spec to reset the heap to
+    AUDIO_MAILBOX_RESET, // Audio -> game: spec the heap finished resetting to
+    AUDIO_MAILBOX_MAX,
+} AudioMailbox;
+
+#define AUDIO_SNAPSHOT_PLAYERS 4
+#define AUDIO_SNAPSHOT_CHANNELS 16
+
+// The sequence player state the game thread reads, copied out by the audio thread after every update so the game
+// never reads the players while the synthesis changes them
+typedef struct AudioSnapshot {
+    bool playerEnabled[AUDIO_SNAPSHOT_PLAYERS];
+    uint16_t playerTempo[AUDIO_SNAPSHOT_PLAYERS];
+    // Channels of the sfx player, io is only set for valid ones
+    bool sfxChannelValid[AUDIO_SNAPSHOT_CHANNELS];
+    int8_t sfxChannelReverb[AUDIO_SNAPSHOT_CHANNELS]; // seqScriptIO[6]
+    int8_t sfxChannelState[AUDIO_SNAPSHOT_CHANNELS];  // seqScriptIO[7]
+    // Channel 15 of the voice player
+    bool voiceChannelValid;
+    int8_t voiceChannelPlaying; // seqScriptIO[1]
+    // What Audio_GetCurrentVoiceStatus returns
+    uint8_t voiceStatus;
+} AudioSnapshot;
+
+void AudioQueue_Reset(void);
+
+// Game thread: makes every command before writePos visible to the audio thread
+void AudioQueue_PublishCmds(uint8_t writePos);
+// Game thread: first command the audio thread has not processed yet, its slot must not be written
+uint8_t AudioQueue_GetCmdReadPos(void);
+// Audio thread: returns the next published range as (readPos << 8) | writePos, false if there is none. Call it until
+// it returns false, every publish comes as its own range.
+bool AudioQueue_ReceiveCmds(uint32_t* msg);
+// Audio thread: marks every command before readPos as processed
+void AudioQueue_ConsumeCmds(uint8_t readPos);
+
+// Single value mailboxes, a newer value replaces one that was not received yet
+void AudioQueue_Send(AudioMailbox box, uint8_t value);
+bool AudioQueue_Receive(AudioMailbox box, uint8_t* value);
+void AudioQueue_Clear(AudioMailbox box);
+
+// Audio thread: the snapshot to fill, then AudioQueue_PublishSnapshot hands it to the game thread
+AudioSnapshot* AudioQueue_GetSnapshotForWrite(void);
+void AudioQueue_PublishSnapshot(void);
+// Game thread: the latest published snapshot, stays valid until the next call
+const AudioSnapshot* AudioQueue_GetSnapshot(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,99 @@
+#include "AudioRateControl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace SF64 {
+
+static constexpr double SAMPLE_RATE = 32000.0;
+// At most 1% off, about a sixth of a semitone, a step that big only happens far off the target
+static constexpr double MAX_RATIO_DEVIATION = 0.01;
+// Ratio change per fill error, the error being relative to the target
+static constexpr double KP = 0.02;
+// Ratio change per second of fill error
+static constexpr double KI = 0.001;
+static constexpr double INTEGRAL_LIMIT = MAX_RATIO_DEVIATION / KI;
+// The player drains in device periods, smoothing the fill keeps that jitter out of the ratio
+static constexpr double FILL_SMOOTHING = 0.1;
+
+static std::atomic<int32_t> sBuffered = 0;
+static std::atomic<int32_t> sTarget = 0;
+static std::atomic<int32_t> sDriftPpm = 0;
+static std::atomic<uint32_t> sUnderruns = 0;
+
+void AudioRateControl::Reset() {
+    mRatio = 1.0;
+    mIntegral = 0.0;
+    mFill = -1.0;
+    mPos = 0.0;
+    memset(mLast, 0, sizeof(mLast));
+}
+
+double AudioRateControl::Update(int32_t buffered, int32_t target, uint32_t blockFrames) {
+    if (mFill < 0.0) {
+        mFill = buffered;
+    } else {
+        mFill += (buffered - mFill) * FILL_SMOOTHING;
+    }
+
+    const double error = (target - mFill) / std::max(target, 1);
+    const double integral =
+        std::clamp(mIntegral + error * (blockFrames / SAMPLE_RATE), -INTEGRAL_LIMIT, INTEGRAL_LIMIT);
+    const double ratio = 1.0 + KP * error + KI * integral;
+    // No integrating while the ratio is pinned at its limit, that would only overshoot once the fill recovers
+    if (std::abs(ratio - 1.0) < MAX_RATIO_DEVIATION) {
+        mIntegral = integral;
+    }
+    mRatio = std::clamp(ratio, 1.0 - MAX_RATIO_DEVIATION, 1.0 + MAX_RATIO_DEVIATION);
+
+    ReportFill(buffered, target, (int32_t) std::lround((mRatio - 1.0) * 1000000.0));
+    return mRatio;
+}
+
+size_t AudioRateControl::Process(const int16_t* in, size_t frames, uint32_t channels, int16_t* out,
+                                 size_t maxFrames) {
+    const double step = 1.0 / mRatio;
+    size_t written = 0;
+
+    while (written < maxFrames && (size_t) mPos < frames) {
+        const size_t index = (size_t) mPos;
+        const float frac = (float) (mPos - index);
+        const int16_t* a = index == 0 ? mLast : in + (index - 1) * channels;
+        const int16_t* b = in + index * channels;
+
+        for (uint32_t c = 0; c < channels; c++) {
+            out[written * channels + c] = (int16_t) std::lrint(a[c] + (b[c] - a[c]) * frac);
+        }
+        written++;
+        mPos += step;
+    }
+
+    if (frames > 0) {
+        memcpy(mLast, in + (frames - 1) * channels, channels * sizeof(int16_t));
+        mPos = std::max(mPos - frames, 0.0);
+    }
+    return written;
+}
+
+AudioLatencyStats AudioRateControl::GetStats() {
+    return {
+        sBuffered.load(std::memory_order_relaxed),
+        sTarget.load(std::memory_order_relaxed),
+        sDriftPpm.load(std::memory_order_relaxed),
+        sUnderruns.load(std::memory_order_relaxed),
+    };
+}
+
+void AudioRateControl::ReportFill(int32_t buffered, int32_t target, int32_t driftPpm) {
+    sBuffered.store(buffered, std::memory_order_relaxed);
+    sTarget.store(target, std::memory_order_relaxed);
+    sDriftPpm.store(driftPpm, std::memory_order_relaxed);
+}
+
+void AudioRateControl::ReportUnderrun() {
+    sUnderruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace SF64
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SF64 {
+
+struct AudioLatencyStats {
+    // Samples per channel waiting to be played, and what the controller aims for
+    int32_t buffered;
+    int32_t target;
+    // How much faster the output runs than the synthesis, in parts per million
+    int32_t driftPpm;
+    uint32_t underruns;
+};
+
+// Holds the audio player's fill at a target by stretching the final mix by a fraction of a percent, instead of
+// switching the update size and with it the tempo of the music. A PI controller on the fill sets the ratio, the
+// integral term takes up a steady drift between the game's clock and the audio device's.
+class AudioRateControl {
+  public:
+    void Reset();
+    // Call once per block with the player's fill before the block is queued, returns the new ratio
+    double Update(int32_t buffered, int32_t target, uint32_t blockFrames);
+    // Linear resampling of interleaved frames at the current ratio, carries the phase over to the next block.
+    // Returns the frames written to out.
+    size_t Process(const int16_t* in, size_t frames, uint32_t channels, int16_t* out, size_t maxFrames);
+
+    // Telemetry for the stats window, written by whichever thread feeds the player
+    static AudioLatencyStats GetStats();
+    static void ReportFill(int32_t buffered, int32_t target, int32_t driftPpm);
+    static void ReportUnderrun();
+
+  private:
+    double mRatio = 1.0;
+    double mIntegral = 0.0;
+    double mFill = -1.0;
+    // Position in the input, 0 being mLast
+    double mPos = 0.0;
+    int16_t mLast[8] = {};
+};
+
+} // namespace SF64
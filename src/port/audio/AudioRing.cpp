@@ -0,0 +1,59 @@
+#include "AudioRing.h"
+
+#include <algorithm>
+
+namespace SF64 {
+
+void AudioRing::Init(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mBuffer.assign(size, 0);
+    mMask = size - 1;
+    Clear();
+}
+
+void AudioRing::Clear() {
+    mHead.store(0, std::memory_order_relaxed);
+    mTail.store(0, std::memory_order_relaxed);
+}
+
+size_t AudioRing::Write(const int16_t* samples, size_t count) {
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    const size_t tail = mTail.load(std::memory_order_acquire);
+
+    count = std::min(count, mBuffer.size() - (head - tail));
+    // Copy in up to two pieces, the second one after wrapping around
+    const size_t start = head & mMask;
+    const size_t first = std::min(count, mBuffer.size() - start);
+    std::copy_n(samples, first, mBuffer.data() + start);
+    std::copy_n(samples + first, count - first, mBuffer.data());
+
+    mHead.store(head + count, std::memory_order_release);
+    return count;
+}
+
+size_t AudioRing::Read(int16_t* samples, size_t count) {
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    const size_t head = mHead.load(std::memory_order_acquire);
+
+    count = std::min(count, head - tail);
+    const size_t start = tail & mMask;
+    const size_t first = std::min(count, mBuffer.size() - start);
+    std::copy_n(mBuffer.data() + start, first, samples);
+    std::copy_n(mBuffer.data(), count - first, samples + first);
+
+    mTail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+size_t AudioRing::Available() const {
+    return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+}
+
+size_t AudioRing::Free() const {
+    return mBuffer.size() - Available();
+}
+
+} // namespace SF64
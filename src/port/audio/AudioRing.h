@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SF64 {
+
+// Lock-free single producer, single consumer ring of interleaved samples, the synthesis thread writes into it
+// and the output thread drains it into the audio player.
+class AudioRing {
+  public:
+    // Rounds the capacity up to a power of two, must not be called while either side is running
+    void Init(size_t capacity);
+    void Clear();
+    // Both return the number of samples actually copied
+    size_t Write(const int16_t* samples, size_t count);
+    size_t Read(int16_t* samples, size_t count);
+    size_t Available() const;
+    size_t Free() const;
+
+  private:
+    std::vector<int16_t> mBuffer;
+    size_t mMask = 0;
+    // Free running positions, only the writer moves mHead and only the reader moves mTail
+    std::atomic<size_t> mHead = 0;
+    std::atomic<size_t> mTail = 0;
+};
+
+} // namespace SF64
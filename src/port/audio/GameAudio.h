@@ -1,10 +1,15 @@
 #pragma once
 #include <thread>
 #include <condition_variable>
+#include <atomic>
 static struct {
     std::thread thread;
     std::condition_variable cv_to_thread, cv_from_thread;
     std::mutex mutex;
-    bool running;
+    std::atomic<bool> running;
     bool processing;
-} audio;
\ No newline at end of file
+    // Decoupled mode: the audio thread renders ahead into a ring on its own clock and a second thread feeds the
+    // ring to the audio player, the game thread never waits on either of them.
+    bool decoupled;
+    std::thread output;
+} audio;
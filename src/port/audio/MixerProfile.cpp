@@ -0,0 +1,51 @@
+#include "MixerProfile.h"
+
+#include <atomic>
+#include <chrono>
+
+static const char* sKernelNames[MIXER_KERNEL_MAX] = {
+    "aClearBuffer", "aLoadBuffer",  "aSaveBuffer", "aLoadADPCM", "aADPCMdec",  "aADPCMcopy", "aS8Dec",
+    "aResample",    "aResampleZoh", "aEnvMixer",   "aMix",       "aAddMixer",  "aDuplicate", "aDMEMMove",
+    "aInterleave",  "aInterl",      "aFilter",     "aHiLoGain",  "aUnkCmd19",
+};
+
+static std::atomic<bool> sActive = false;
+static std::atomic<uint64_t> sKernelNs[MIXER_KERNEL_MAX];
+static std::atomic<uint64_t> sKernelCalls[MIXER_KERNEL_MAX];
+
+extern "C" void MixerProfile_SetActive(bool active) {
+    if (active) {
+        for (int i = 0; i < MIXER_KERNEL_MAX; i++) {
+            sKernelNs[i].store(0, std::memory_order_relaxed);
+            sKernelCalls[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    sActive.store(active, std::memory_order_relaxed);
+}
+
+extern "C" bool MixerProfile_IsActive(void) {
+    return sActive.load(std::memory_order_relaxed);
+}
+
+extern "C" uint64_t MixerProfile_Begin(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+extern "C" void MixerProfile_End(MixerKernel kernel, uint64_t start) {
+    sKernelNs[kernel].fetch_add(MixerProfile_Begin() - start, std::memory_order_relaxed);
+    sKernelCalls[kernel].fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" const char* MixerProfile_GetName(MixerKernel kernel) {
+    return sKernelNames[kernel];
+}
+
+extern "C" uint64_t MixerProfile_GetNs(MixerKernel kernel) {
+    return sKernelNs[kernel].load(std::memory_order_relaxed);
+}
+
+extern "C" uint64_t MixerProfile_GetCalls(MixerKernel kernel) {
+    return sKernelCalls[kernel].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Time spent in each mixer kernel, only measured while active. Kernels on the synthesis workers add up with the
+// ones on the audio thread.
+
+typedef enum MixerKernel {
+    MIXER_KERNEL_CLEAR_BUFFER,
+    MIXER_KERNEL_LOAD_BUFFER,
+    MIXER_KERNEL_SAVE_BUFFER,
+    MIXER_KERNEL_LOAD_ADPCM,
+    MIXER_KERNEL_ADPCM_DEC,
+    MIXER_KERNEL_ADPCM_COPY,
+    MIXER_KERNEL_S8_DEC,
+    MIXER_KERNEL_RESAMPLE,
+    MIXER_KERNEL_RESAMPLE_ZOH,
+    MIXER_KERNEL_ENV_MIXER,
+    MIXER_KERNEL_MIX,
+    MIXER_KERNEL_ADD_MIXER,
+    MIXER_KERNEL_DUPLICATE,
+    MIXER_KERNEL_DMEM_MOVE,
+    MIXER_KERNEL_INTERLEAVE,
+    MIXER_KERNEL_INTERL,
+    MIXER_KERNEL_FILTER,
+    MIXER_KERNEL_HILO_GAIN,
+    MIXER_KERNEL_UNK_CMD19,
+    MIXER_KERNEL_MAX,
+} MixerKernel;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MixerProfile_SetActive(bool active);
+bool MixerProfile_IsActive(void);
+uint64_t MixerProfile_Begin(void);
+void MixerProfile_End(MixerKernel kernel, uint64_t start);
+const char* MixerProfile_GetName(MixerKernel kernel);
+uint64_t MixerProfile_GetNs(MixerKernel kernel);
+uint64_t MixerProfile_GetCalls(MixerKernel kernel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define MIXER_PROFILE(kernel, call)                            \
+    do {                                                       \
+        if (MixerProfile_IsActive()) {                         \
+            uint64_t mixerProfileStart = MixerProfile_Begin(); \
+            call;                                              \
+            MixerProfile_End((kernel), mixerProfileStart);     \
+        } else {                                               \
+            call;                                              \
+        }                                                      \
+    } while (0)
@@ -0,0 +1,383 @@
+#include "SampleStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <dr_mp3.h>
+
+#include "vorbis/vorbisfile.h"
+
+namespace SF64 {
+
+// Decoded per refill, in frames
+static constexpr size_t DECODE_CHUNK_FRAMES = 1024;
+// Reads further ahead than this seek instead of decoding everything in between
+static constexpr uint64_t SEEK_DISTANCE = 0x10000;
+static constexpr drmp3_uint32 MP3_SEEK_POINTS = 256;
+// Voices reading a stream at once before they share cursors, each one holds a decoder
+static constexpr size_t MAX_CURSORS = 8;
+
+// Guards the streams against being destroyed while the synthesis reads from them
+static std::mutex sStreamsMutex;
+static std::unordered_map<const void*, SampleStream*> sStreams;
+struct DecodedSample {
+    // The samples followed by zero padding
+    std::vector<int16_t> pcm;
+    uint32_t numSamples;
+};
+
+// In-memory samples decoded once by the synthesis, by sample
+static std::unordered_map<const void*, DecodedSample> sDecoded;
+
+struct OggFileData {
+    void* data;
+    size_t pos;
+    size_t size;
+};
+
+static size_t VorbisReadCallback(void* out, size_t size, size_t elems, void* src) {
+    OggFileData* data = static_cast<OggFileData*>(src);
+    size_t toRead = size * elems;
+
+    if (toRead > data->size - data->pos) {
+        toRead = data->size - data->pos;
+    }
+
+    memcpy(out, static_cast<uint8_t*>(data->data) + data->pos, toRead);
+    data->pos += toRead;
+
+    return toRead / size;
+}
+
+static int VorbisSeekCallback(void* src, ogg_int64_t pos, int whence) {
+    OggFileData* data = static_cast<OggFileData*>(src);
+    size_t newPos;
+
+    switch (whence) {
+        case SEEK_SET:
+            newPos = pos;
+            break;
+        case SEEK_CUR:
+            newPos = data->pos + pos;
+            break;
+        case SEEK_END:
+            newPos = data->size + pos;
+            break;
+        default:
+            return -1;
+    }
+    if (newPos > data->size) {
+        return -1;
+    }
+    data->pos = newPos;
+    return 0;
+}
+
+static int VorbisCloseCallback([[maybe_unused]] void* src) {
+    return 0;
+}
+
+static long VorbisTellCallback(void* src) {
+    OggFileData* data = static_cast<OggFileData*>(src);
+    return data->pos;
+}
+
+static const ov_callbacks vorbisCallbacks = {
+    VorbisReadCallback,
+    VorbisSeekCallback,
+    VorbisCloseCallback,
+    VorbisTellCallback,
+};
+
+struct SampleStream::SeekTable {
+    std::vector<drmp3_seek_point> points;
+};
+
+// Both decoders keep pointers into themselves and the file data, so this never moves
+struct SampleStream::Decoder {
+    Format format;
+    bool opened = false;
+    OggFileData oggData;
+    OggVorbis_File vorbis;
+    drmp3 mp3;
+
+    ~Decoder() {
+        if (!opened) {
+            return;
+        }
+        if (format == Format::Ogg) {
+            ov_clear(&vorbis);
+        } else {
+            drmp3_uninit(&mp3);
+        }
+    }
+};
+
+struct SampleStream::Cursor {
+    // Held while decoding, another voice can take the cursor over in the meantime
+    std::mutex mutex;
+    const void* voice = nullptr;
+    uint64_t lastFetch = 0;
+    std::unique_ptr<Decoder> decoder;
+    uint32_t frameSize = 0;
+    // Decoded bytes [windowStart, windowStart + window.size()), the decoder continues at the end of it
+    std::vector<uint8_t> window;
+    uint64_t windowStart = 0;
+    bool ended = false;
+
+    bool Seek(uint64_t frame);
+    size_t Decode(uint8_t* out, size_t size);
+    const uint8_t* Fetch(uint64_t offset, uint32_t size);
+};
+
+std::unique_ptr<SampleStream::Decoder> SampleStream::OpenDecoder() const {
+    auto decoder = std::make_unique<Decoder>();
+    decoder->format = mFormat;
+
+    if (mFormat == Format::Ogg) {
+        decoder->oggData = { mData->data(), 0, mData->size() };
+        if (ov_open_callbacks(&decoder->oggData, &decoder->vorbis, nullptr, 0, vorbisCallbacks) != 0) {
+            return nullptr;
+        }
+    } else {
+        if (!drmp3_init_memory(&decoder->mp3, mData->data(), mData->size(), nullptr)) {
+            return nullptr;
+        }
+        if (mSeekTable != nullptr) {
+            drmp3_bind_seek_table(&decoder->mp3, mSeekTable->points.size(), mSeekTable->points.data());
+        }
+    }
+    decoder->opened = true;
+    return decoder;
+}
+
+std::unique_ptr<SampleStream> SampleStream::Open(Format format, std::shared_ptr<std::vector<char>> data,
+                                                 const void* sample) {
+    std::unique_ptr<SampleStream> stream(new SampleStream());
+    stream->mFormat = format;
+    stream->mData = std::move(data);
+    stream->mSample = sample;
+
+    auto decoder = stream->OpenDecoder();
+    if (decoder == nullptr) {
+        return nullptr;
+    }
+
+    if (format == Format::Ogg) {
+        vorbis_info* vi = ov_info(&decoder->vorbis, -1);
+        const ogg_int64_t frameCount = ov_pcm_total(&decoder->vorbis, -1);
+        if (vi == nullptr || frameCount < 0) {
+            return nullptr;
+        }
+        stream->mChannels = vi->channels;
+        stream->mSampleRate = vi->rate;
+        stream->mFrameCount = frameCount;
+    } else {
+        stream->mChannels = decoder->mp3.channels;
+        stream->mSampleRate = decoder->mp3.sampleRate;
+        stream->mFrameCount = drmp3_get_pcm_frame_count(&decoder->mp3);
+
+        // Without a seek table every seek decodes from the start of the file
+        auto seekTable = std::make_unique<SeekTable>();
+        drmp3_uint32 seekPointCount = MP3_SEEK_POINTS;
+        seekTable->points.resize(seekPointCount);
+        if (drmp3_calculate_seek_points(&decoder->mp3, &seekPointCount, seekTable->points.data())) {
+            seekTable->points.resize(seekPointCount);
+            drmp3_bind_seek_table(&decoder->mp3, seekPointCount, seekTable->points.data());
+            stream->mSeekTable = std::move(seekTable);
+        }
+    }
+    stream->mFrameSize = stream->mChannels * sizeof(int16_t);
+
+    // The decoder that read the header is the first voice's
+    auto cursor = std::make_unique<Cursor>();
+    cursor->decoder = std::move(decoder);
+    cursor->frameSize = stream->mFrameSize;
+    stream->mCursors.push_back(std::move(cursor));
+
+    std::lock_guard<std::mutex> lock(sStreamsMutex);
+    sStreams[sample] = stream.get();
+    return stream;
+}
+
+SampleStream::~SampleStream() {
+    {
+        std::lock_guard<std::mutex> lock(sStreamsMutex);
+        auto it = sStreams.find(mSample);
+        if (it != sStreams.end() && it->second == this) {
+            sStreams.erase(it);
+        }
+    }
+    // Fetches that found the stream before it was erased finish first
+    std::unique_lock<std::shared_mutex> lock(mInUse);
+}
+
+void SampleStream::ReleaseDecoded(const void* sample) {
+    std::lock_guard<std::mutex> lock(sStreamsMutex);
+    sDecoded.erase(sample);
+}
+
+uint32_t SampleStream::GetChannels() const {
+    return mChannels;
+}
+
+uint32_t SampleStream::GetSampleRate() const {
+    return mSampleRate;
+}
+
+uint64_t SampleStream::GetFrameCount() const {
+    return mFrameCount;
+}
+
+bool SampleStream::Cursor::Seek(uint64_t frame) {
+    bool sought;
+
+    if (decoder->format == Format::Ogg) {
+        sought = ov_pcm_seek(&decoder->vorbis, frame) == 0;
+    } else {
+        sought = drmp3_seek_to_pcm_frame(&decoder->mp3, frame);
+    }
+
+    window.clear();
+    windowStart = frame * frameSize;
+    // If the decoder is lost there is nothing left to play
+    ended = !sought;
+    return sought;
+}
+
+size_t SampleStream::Cursor::Decode(uint8_t* out, size_t size) {
+    if (decoder->format == Format::Mp3) {
+        const drmp3_uint64 frames = drmp3_read_pcm_frames_s16(&decoder->mp3, size / frameSize, (int16_t*) out);
+        return frames * frameSize;
+    }
+
+    size_t decoded = 0;
+    while (decoded < size) {
+        int bitStream = 0;
+        const long read = ov_read(&decoder->vorbis, (char*) out + decoded, size - decoded, 0, 2, 1, &bitStream);
+        if (read == OV_HOLE) {
+            continue;
+        }
+        if (read <= 0) {
+            break;
+        }
+        decoded += read;
+    }
+    return decoded;
+}
+
+const uint8_t* SampleStream::Cursor::Fetch(uint64_t offset, uint32_t size) {
+    if (offset < windowStart || offset > windowStart + window.size() + SEEK_DISTANCE) {
+        Seek(offset / frameSize);
+    }
+
+    // Drop what was read already, in whole frames so the window stays aligned to them
+    const uint64_t consumed = (offset - windowStart) / frameSize * frameSize;
+    const uint64_t dropped = std::min<uint64_t>(consumed, window.size());
+    window.erase(window.begin(), window.begin() + dropped);
+    windowStart += dropped;
+
+    const size_t chunkSize = DECODE_CHUNK_FRAMES * frameSize;
+    while (windowStart + window.size() < offset + size) {
+        if (ended) {
+            // Past the end there is only silence, the decoder does not move anymore so it can go into the window
+            window.resize(offset + size - windowStart, 0);
+            break;
+        }
+        const size_t pos = window.size();
+        window.resize(pos + chunkSize);
+        const size_t decoded = Decode(window.data() + pos, chunkSize);
+        window.resize(pos + decoded);
+        ended = decoded == 0;
+    }
+
+    return window.data() + (offset - windowStart);
+}
+
+SampleStream::Cursor* SampleStream::GetCursor(const void* voice) {
+    std::lock_guard<std::mutex> lock(mCursorsMutex);
+    mFetchCount++;
+
+    Cursor* leastRecent = nullptr;
+    for (const auto& cursor : mCursors) {
+        if (cursor->voice == voice) {
+            cursor->lastFetch = mFetchCount;
+            return cursor.get();
+        }
+        if (leastRecent == nullptr || cursor->lastFetch < leastRecent->lastFetch) {
+            leastRecent = cursor.get();
+        }
+    }
+
+    // Another voice's window still holds this sample's PCM, so whatever it has buffered stays correct
+    Cursor* cursor = leastRecent;
+    if (mCursors.size() < MAX_CURSORS && leastRecent->voice != nullptr) {
+        auto decoder = OpenDecoder();
+        if (decoder != nullptr) {
+            mCursors.push_back(std::make_unique<Cursor>());
+            cursor = mCursors.back().get();
+            cursor->decoder = std::move(decoder);
+            cursor->frameSize = mFrameSize;
+        }
+    }
+    cursor->voice = voice;
+    cursor->lastFetch = mFetchCount;
+    return cursor;
+}
+
+bool SampleStream::Fetch(const void* sample, const void* voice, uint64_t offset, uint32_t size, uint8_t* out) {
+    SampleStream* stream;
+    std::shared_lock<std::shared_mutex> inUse;
+    {
+        std::lock_guard<std::mutex> lock(sStreamsMutex);
+        auto it = sStreams.find(sample);
+        if (it == sStreams.end()) {
+            return false;
+        }
+        stream = it->second;
+        inUse = std::shared_lock<std::shared_mutex>(stream->mInUse);
+    }
+
+    // Voices on other synthesis threads only wait for each other if they share a cursor
+    Cursor* cursor = stream->GetCursor(voice);
+    std::lock_guard<std::mutex> lock(cursor->mutex);
+    memcpy(out, cursor->Fetch(offset, size), size);
+    return true;
+}
+
+} // namespace SF64
+
+extern "C" const uint8_t* SampleStream_Fetch(const void* sample, const void* voice, const uint8_t* sampleAddr,
+                                             uint32_t offset, uint32_t size) {
+    // Only streamed samples come without their data
+    if (sampleAddr != nullptr) {
+        return sampleAddr + offset;
+    }
+
+    // The cursor can be taken over by another voice, so the window is copied out before unlocking it
+    thread_local std::vector<uint8_t> fetched;
+    fetched.resize(size);
+    if (!SF64::SampleStream::Fetch(sample, voice, offset, size, fetched.data())) {
+        return nullptr;
+    }
+    return fetched.data();
+}
+
+extern "C" const int16_t* SampleStream_GetDecoded(const void* sample, uint32_t* numSamples) {
+    std::lock_guard<std::mutex> lock(SF64::sStreamsMutex);
+    auto it = SF64::sDecoded.find(sample);
+    if (it == SF64::sDecoded.end()) {
+        return nullptr;
+    }
+    *numSamples = it->second.numSamples;
+    return it->second.pcm.data();
+}
+
+extern "C" int16_t* SampleStream_AllocDecoded(const void* sample, uint32_t numSamples, uint32_t padding) {
+    std::lock_guard<std::mutex> lock(SF64::sStreamsMutex);
+    SF64::DecodedSample& decoded = SF64::sDecoded[sample];
+    decoded.pcm.assign(numSamples + padding, 0);
+    decoded.numSamples = numSamples;
+    return decoded.pcm.data();
+}
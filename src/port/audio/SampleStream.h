@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace SF64 {
+
+// Decodes a compressed custom sample on demand. Every voice playing it reads through its own cursor, a decoder with a
+// small window of PCM around the position the voice reads from. Reading before the window or far past it seeks that
+// decoder (loop points do this), other voices playing the same sample are not affected.
+class SampleStream {
+  public:
+    enum class Format { Ogg, Mp3 };
+
+    // The stream is looked up by sample, the synthesis passes the same pointer to SampleStream_Fetch.
+    // Returns nullptr if the data can not be decoded.
+    static std::unique_ptr<SampleStream> Open(Format format, std::shared_ptr<std::vector<char>> data,
+                                              const void* sample);
+    ~SampleStream();
+
+    // Drops the PCM SampleStream_AllocDecoded made for the sample, called when the sample is unloaded
+    static void ReleaseDecoded(const void* sample);
+    // Copies size bytes of interleaved PCM starting at offset into out, as read by the voice, zero filled past the
+    // end. Returns false if the sample has no stream.
+    static bool Fetch(const void* sample, const void* voice, uint64_t offset, uint32_t size, uint8_t* out);
+
+    uint32_t GetChannels() const;
+    uint32_t GetSampleRate() const;
+    uint64_t GetFrameCount() const;
+
+  private:
+    struct Decoder;
+    struct SeekTable;
+    struct Cursor;
+
+    SampleStream() = default;
+    // Another decoder on the same data, nullptr if it can not be opened
+    std::unique_ptr<Decoder> OpenDecoder() const;
+    // The cursor of the voice, taking over the least recently used one once there are MAX_CURSORS
+    Cursor* GetCursor(const void* voice);
+
+    Format mFormat = Format::Ogg;
+    std::shared_ptr<std::vector<char>> mData;
+    // MP3 seek points, calculated once for every decoder
+    std::unique_ptr<SeekTable> mSeekTable;
+    const void* mSample = nullptr;
+    uint32_t mChannels = 0;
+    uint32_t mSampleRate = 0;
+    uint64_t mFrameCount = 0;
+    uint32_t mFrameSize = 0;
+    // Held shared while fetching, the destructor waits for it
+    std::shared_mutex mInUse;
+    std::mutex mCursorsMutex;
+    std::vector<std::unique_ptr<Cursor>> mCursors;
+    uint64_t mFetchCount = 0;
+};
+
+} // namespace SF64
+
+extern "C" {
+#endif
+
+// Returns size bytes of the sample's PCM starting at offset. Decodes streamed samples on demand, with a cursor per
+// voice (any pointer that identifies the note), and points into the sample data otherwise. Decoded data stays valid
+// until the next fetch on the same thread.
+const uint8_t* SampleStream_Fetch(const void* sample, const void* voice, const uint8_t* sampleAddr, uint32_t offset,
+                                  uint32_t size);
+// PCM decoded from an in-memory sample, kept until the sample is unloaded. NULL if it is not decoded yet. numSamples
+// does not count the padding.
+const int16_t* SampleStream_GetDecoded(const void* sample, uint32_t* numSamples);
+// Zero filled room for numSamples of decoded PCM followed by padding more zeroes, the caller fills it before anyone
+// gets it
+int16_t* SampleStream_AllocDecoded(const void* sample, uint32_t numSamples, uint32_t padding);
+
+#ifdef __cplusplus
+}
+#endif
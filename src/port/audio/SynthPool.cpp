@@ -0,0 +1,114 @@
+#include "SynthPool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "audio/mixer.h"
+}
+
+struct SynthWorker {
+    std::thread thread;
+    AudioMixerContext* context;
+};
+
+static std::vector<SynthWorker> sWorkers;
+static std::mutex sMutex;
+static std::condition_variable sJobReady;
+static std::condition_variable sJobDone;
+static SynthPoolJob sJob;
+static void* sJobArg;
+// Bumped for every job, workers run each generation once
+static uint64_t sGeneration = 0;
+static int32_t sPending = 0;
+static bool sRunning = false;
+
+static void SynthPool_WorkerLoop(int32_t part) {
+    uint64_t generation = 0;
+
+    aMixerContextSet(sWorkers[part - 1].context);
+    while (true) {
+        SynthPoolJob job;
+        void* arg;
+        {
+            std::unique_lock<std::mutex> lock(sMutex);
+            sJobReady.wait(lock, [&] { return !sRunning || sGeneration != generation; });
+            if (!sRunning) {
+                return;
+            }
+            generation = sGeneration;
+            job = sJob;
+            arg = sJobArg;
+        }
+
+        job(arg, part, sWorkers.size() + 1);
+
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (--sPending == 0) {
+            sJobDone.notify_one();
+        }
+    }
+}
+
+extern "C" void SynthPool_Init(int32_t numThreads) {
+    if (sRunning || numThreads <= 0) {
+        return;
+    }
+    numThreads = std::min(numThreads, SYNTH_POOL_MAX_PARTS - 1);
+    sRunning = true;
+    sWorkers.resize(numThreads);
+    for (auto& worker : sWorkers) {
+        worker.context = aMixerContextCreate();
+    }
+    // Only start the threads once the vector is done growing, they look themselves up in it
+    for (int32_t i = 0; i < numThreads; i++) {
+        sWorkers[i].thread = std::thread(SynthPool_WorkerLoop, i + 1);
+    }
+}
+
+extern "C" void SynthPool_Shutdown(void) {
+    if (!sRunning) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sRunning = false;
+    }
+    sJobReady.notify_all();
+    for (auto& worker : sWorkers) {
+        worker.thread.join();
+        aMixerContextDestroy(worker.context);
+    }
+    sWorkers.clear();
+}
+
+extern "C" int32_t SynthPool_GetNumParts(void) {
+    return sWorkers.size() + 1;
+}
+
+extern "C" void SynthPool_Run(SynthPoolJob job, void* arg) {
+    const int32_t numParts = SynthPool_GetNumParts();
+
+    if (numParts > 1) {
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            sJob = job;
+            sJobArg = arg;
+            sPending = numParts - 1;
+            sGeneration++;
+        }
+        sJobReady.notify_all();
+    }
+
+    job(arg, 0, numParts);
+
+    std::unique_lock<std::mutex> lock(sMutex);
+    sJobDone.wait(lock, [] { return sPending == 0; });
+}
+
+extern "C" AudioMixerContext* SynthPool_GetContext(int32_t part) {
+    return sWorkers[part - 1].context;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// Worker threads for the note synthesis. Every worker mixes into its own mixer context, the caller sums them into
+// the default one afterwards.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYNTH_POOL_MAX_PARTS 8
+
+typedef struct AudioMixerContext AudioMixerContext;
+
+// Called once per part, part 0 on the calling thread and the rest on the workers
+typedef void (*SynthPoolJob)(void* arg, int32_t part, int32_t numParts);
+
+// At most SYNTH_POOL_MAX_PARTS - 1 threads are started
+void SynthPool_Init(int32_t numThreads);
+void SynthPool_Shutdown(void);
+// Number of parts a job is split into, 1 without workers
+int32_t SynthPool_GetNumParts(void);
+// Returns once every part is done
+void SynthPool_Run(SynthPoolJob job, void* arg);
+// Context parts above 0 mixed into
+AudioMixerContext* SynthPool_GetContext(int32_t part);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,272 @@
+#include "AudioRender.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <libultraship.h>
+
+extern "C" {
+#include "sf64audio_provisional.h"
+#include "port/audio/MixerProfile.h"
+#include "audio/mixer.h"
+void Audio_ThreadEntry(void* arg);
+void AudioThread_CreateNextAudioBuffer(s16* samples, u32 num_samples);
+}
+
+namespace SF64::Benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint32_t RENDER_SAMPLE_RATE = 32000;
+static constexpr uint32_t RENDER_VIS_PER_SECOND = 60;
+// The game runs at 30 fps, one Audio_Update per frame and one synthesis update per VI
+static constexpr uint32_t RENDER_VIS_PER_FRAME = 2;
+static constexpr uint32_t RENDER_DEFAULT_FRAMES = 30 * 60;
+static constexpr uint32_t RENDER_MAX_UPDATE_SAMPLES = 1024;
+static constexpr uint32_t RENDER_MAX_CHANNELS = 6;
+
+struct WavHeader {
+    char riff[4];
+    uint32_t riffSize;
+    char wave[4];
+    char fmt[4];
+    uint32_t fmtSize;
+    uint16_t format;
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint32_t byteRate;
+    uint16_t blockAlign;
+    uint16_t bitsPerSample;
+    char data[4];
+    uint32_t dataSize;
+};
+static_assert(sizeof(WavHeader) == 44);
+
+static bool ReadSfxScript(const std::string& path, std::multimap<uint32_t, uint32_t>& events) {
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        fprintf(stderr, "Could not open sfx script %s\n", path.c_str());
+        return false;
+    }
+
+    char line[256];
+    uint32_t lineNumber = 0;
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file) != nullptr) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment != nullptr) {
+            *comment = '\0';
+        }
+
+        char* cursor = line;
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        if (*cursor == '\0' || *cursor == '\n' || *cursor == '\r') {
+            continue;
+        }
+
+        char* end;
+        const uint32_t frame = strtoul(cursor, &end, 10);
+        if (end == cursor) {
+            valid = false;
+            break;
+        }
+        cursor = end;
+        const uint32_t sfxId = strtoul(cursor, &end, 0);
+        if (end == cursor) {
+            valid = false;
+            break;
+        }
+        events.emplace(frame, sfxId);
+    }
+    fclose(file);
+
+    if (!valid) {
+        fprintf(stderr, "%s:%u: expected \"<frame> <sfx id>\"\n", path.c_str(), lineNumber);
+    }
+    return valid;
+}
+
+static bool WriteWav(const std::string& path, const std::vector<int16_t>& pcm, uint16_t channels) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        fprintf(stderr, "Could not write %s\n", path.c_str());
+        return false;
+    }
+
+    WavHeader header;
+    memcpy(header.riff, "RIFF", 4);
+    memcpy(header.wave, "WAVE", 4);
+    memcpy(header.fmt, "fmt ", 4);
+    memcpy(header.data, "data", 4);
+    header.fmtSize = 16;
+    header.format = 1;
+    header.channels = channels;
+    header.sampleRate = RENDER_SAMPLE_RATE;
+    header.bitsPerSample = 16;
+    header.blockAlign = channels * sizeof(int16_t);
+    header.byteRate = RENDER_SAMPLE_RATE * header.blockAlign;
+    header.dataSize = pcm.size() * sizeof(int16_t);
+    header.riffSize = sizeof(header) - 8 + header.dataSize;
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(pcm.data(), sizeof(int16_t), pcm.size(), file);
+    fclose(file);
+    return true;
+}
+
+// Only reads back what WriteWav writes
+static bool ReadWav(const std::string& path, std::vector<int16_t>& pcm, uint16_t& channels) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "Could not open golden render %s\n", path.c_str());
+        return false;
+    }
+
+    WavHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.riff, "RIFF", 4) == 0 &&
+                 memcmp(header.data, "data", 4) == 0 && header.format == 1 && header.bitsPerSample == 16;
+    if (valid) {
+        channels = header.channels;
+        pcm.resize(header.dataSize / sizeof(int16_t));
+        valid = fread(pcm.data(), sizeof(int16_t), pcm.size(), file) == pcm.size();
+    }
+    fclose(file);
+
+    if (!valid) {
+        fprintf(stderr, "%s is not a render from --audio-render\n", path.c_str());
+    }
+    return valid;
+}
+
+static uint64_t HashPcm(const std::vector<int16_t>& pcm) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(pcm.data());
+    for (size_t i = 0; i < pcm.size() * sizeof(int16_t); i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3;
+    }
+    return hash;
+}
+
+static int CompareGolden(const std::string& path, const std::vector<int16_t>& pcm, uint16_t channels) {
+    std::vector<int16_t> golden;
+    uint16_t goldenChannels;
+    if (!ReadWav(path, golden, goldenChannels)) {
+        return 1;
+    }
+    if (goldenChannels != channels) {
+        printf("Golden: %s has %u channels, the render %u\n", path.c_str(), goldenChannels, channels);
+        return 1;
+    }
+
+    const auto mismatch = std::mismatch(pcm.begin(), pcm.begin() + std::min(pcm.size(), golden.size()),
+                                        golden.begin());
+    if (mismatch.first == pcm.begin() + std::min(pcm.size(), golden.size()) && pcm.size() == golden.size()) {
+        printf("Golden: matches %s\n", path.c_str());
+        return 0;
+    }
+
+    const size_t frame = (mismatch.first - pcm.begin()) / channels;
+    printf("Golden: differs from %s at sample %zu (%.3f s)\n", path.c_str(), frame,
+           (double) frame / RENDER_SAMPLE_RATE);
+    return 1;
+}
+
+static uint32_t CountActiveNotes() {
+    uint32_t count = 0;
+    for (s32 i = 0; i < gNumNotes; i++) {
+        if (gNotes[i].noteSubEu.bitField0.enabled) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int RunAudioRender(const AudioRenderOptions& options) {
+    std::multimap<uint32_t, uint32_t> sfxEvents;
+    if (!options.sfxScriptPath.empty() && !ReadSfxScript(options.sfxScriptPath, sfxEvents)) {
+        return 1;
+    }
+
+    aMixerInit();
+    Audio_ThreadEntry(nullptr);
+    if (options.seqId >= 0) {
+        AUDIO_PLAY_BGM(options.seqId);
+    }
+
+    const uint32_t frames = options.frames != 0 ? options.frames : RENDER_DEFAULT_FRAMES;
+    const uint16_t channels = GetNumAudioChannels();
+    std::vector<int16_t> pcm;
+    pcm.reserve((size_t) frames * RENDER_SAMPLE_RATE / (RENDER_VIS_PER_SECOND / RENDER_VIS_PER_FRAME) * channels);
+    s16 buffer[RENDER_MAX_UPDATE_SAMPLES * RENDER_MAX_CHANNELS];
+
+    double synthSeconds = 0.0;
+    double maxUpdateMs = 0.0;
+    uint32_t updates = 0;
+    uint32_t peakNotes = 0;
+    uint32_t owed = 0;
+
+    MixerProfile_SetActive(true);
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        const auto [first, last] = sfxEvents.equal_range(frame);
+        for (auto it = first; it != last; ++it) {
+            AUDIO_PLAY_SFX(it->second, gDefaultSfxSource, 4);
+        }
+        Audio_Update();
+
+        for (uint32_t vi = 0; vi < RENDER_VIS_PER_FRAME; vi++) {
+            // Multiples of 16 samples that average out to the sample rate, the same as the decoupled audio thread
+            owed += RENDER_SAMPLE_RATE;
+            const uint32_t numSamples = (owed / RENDER_VIS_PER_SECOND) & ~15;
+            owed -= numSamples * RENDER_VIS_PER_SECOND;
+
+            const auto start = Clock::now();
+            AudioThread_CreateNextAudioBuffer(buffer, numSamples);
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            synthSeconds += seconds;
+            maxUpdateMs = std::max(maxUpdateMs, seconds * 1000.0);
+            updates++;
+            peakNotes = std::max(peakNotes, CountActiveNotes());
+            pcm.insert(pcm.end(), buffer, buffer + numSamples * channels);
+        }
+    }
+    MixerProfile_SetActive(false);
+
+    const size_t samples = pcm.size() / channels;
+    const double audioSeconds = (double) samples / RENDER_SAMPLE_RATE;
+    printf("Audio render: %zu samples (%.2f s of audio) in %u updates, %u channels\n", samples, audioSeconds, updates,
+           channels);
+    printf("Synthesis: %.2f ms, %.0f samples/s (%.1fx realtime), %.3f ms avg / %.3f ms max per update\n",
+           synthSeconds * 1000.0, samples / synthSeconds, audioSeconds / synthSeconds,
+           synthSeconds * 1000.0 / updates, maxUpdateMs);
+    printf("Peak notes: %u of %d\n", peakNotes, gNumNotes);
+    printf("PCM hash: %016llx\n", (unsigned long long) HashPcm(pcm));
+
+    // Kernel times on the synthesis workers add up, with workers the total can be more than the synthesis time
+    printf("%-14s %10s %12s %8s\n", "kernel", "calls", "total ms", "share");
+    for (int i = 0; i < MIXER_KERNEL_MAX; i++) {
+        const MixerKernel kernel = (MixerKernel) i;
+        const double ms = MixerProfile_GetNs(kernel) / 1000000.0;
+        printf("%-14s %10llu %12.2f %7.1f%%\n", MixerProfile_GetName(kernel),
+               (unsigned long long) MixerProfile_GetCalls(kernel), ms, ms / (synthSeconds * 10.0));
+    }
+    fflush(stdout);
+
+    int result = 0;
+    if (!options.outputPath.empty() && !WriteWav(options.outputPath, pcm, channels)) {
+        result = 1;
+    }
+    if (!options.goldenPath.empty() && CompareGolden(options.goldenPath, pcm, channels) != 0) {
+        result = 1;
+    }
+    return result;
+}
+
+} // namespace SF64::Benchmark
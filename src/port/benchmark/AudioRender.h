@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace SF64::Benchmark {
+
+struct AudioRenderOptions {
+    std::string outputPath;
+    // Reference render to compare the output against
+    std::string goldenPath;
+    // Lines of "<frame> <sfx id>", # starts a comment
+    std::string sfxScriptPath;
+    int32_t seqId = -1;
+    uint32_t frames = 0;
+};
+
+// Runs only the audio engine: plays the sequence and the scripted sfx, synthesizes as fast as it can and writes the
+// mix to a wav. Prints the throughput, the time per mixer kernel and the peak note count. Returns the exit code,
+// non zero if the output does not match the golden render.
+int RunAudioRender(const AudioRenderOptions& options);
+
+} // namespace SF64::Benchmark
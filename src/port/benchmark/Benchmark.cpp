@@ -0,0 +1,406 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "Context.h"
+#include "port/resource/ScenePrefetch.h"
+
+extern "C" {
+#include "sf64level.h"
+}
+
+namespace SF64::Benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr char INPUT_RECORDING_MAGIC[4] = { 'S', 'F', 'I', 'R' };
+static constexpr uint32_t INPUT_RECORDING_VERSION = 1;
+static constexpr uint32_t INPUT_RECORDING_PADS = 4;
+
+struct RecordingHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t level;
+    uint32_t frameCount;
+};
+
+// Only the fields the game reads, in a fixed layout
+struct RecordedPad {
+    uint32_t button;
+    int8_t stickX;
+    int8_t stickY;
+    int8_t rightStickX;
+    int8_t rightStickY;
+    uint8_t errNo;
+    uint8_t pad[3];
+};
+
+struct StageTimes {
+    double total = 0.0;
+    double max = 0.0;
+};
+
+static const char* sStageNames[BENCHMARK_STAGE_MAX] = { "update", "draw", "render", "audio" };
+
+// What the run does, set by at most one argument
+enum class Mode { Play, Record, Replay, AudioRender };
+
+static bool sHeadless = false;
+static Mode sMode = Mode::Play;
+static std::string sInputPath;
+static int32_t sLevel = 0;
+static uint32_t sFrameLimit = 0;
+static AudioRenderOptions sAudioRenderOptions;
+static bool sNoSyncLoads = false;
+static uint32_t sToggleAltAssetsFrame = 0;
+
+static std::vector<RecordedPad> sPads;
+static uint32_t sInputFrame = 0;
+static uint32_t sFrameCount = 0;
+
+// Stages run on the game, render and audio threads, each one adds its time to the current frame
+static std::atomic<int64_t> sFrameStageNs[BENCHMARK_STAGE_MAX];
+static thread_local Clock::time_point sStageStart[BENCHMARK_STAGE_MAX];
+static StageTimes sStageTimes[BENCHMARK_STAGE_MAX];
+static Clock::time_point sStartTime;
+
+// The alternate assets toggle is requested by the game thread, then carried out and measured on the render thread
+enum class ToggleState { None, Requested, Toggled, Measured };
+static std::atomic<ToggleState> sToggleState = ToggleState::None;
+// The frames before the toggle have to upload the same number of textures. A frame that streams in new textures
+// would hide the ones the toggle uploads again.
+static constexpr uint32_t TOGGLE_STEADY_FRAMES = 8;
+static size_t sUploadCount = 0;
+static std::array<size_t, TOGGLE_STEADY_FRAMES> sRecentFrameUploads;
+static uint32_t sRecordedFrames = 0;
+static size_t sSteadyUploadsMin = 0;
+static size_t sSteadyUploadsMax = 0;
+static bool sSteadyBeforeToggle = false;
+static size_t sUploadsAfterToggle = 0;
+static uint32_t sReplacedTextures = 0;
+
+// Levels the game can boot into, the unused ids in between have no level behind them
+static bool IsValidLevel(int32_t level) {
+    return level >= LEVEL_CORNERIA && level <= LEVEL_VERSUS && level != LEVEL_UNK_4 && level != LEVEL_UNK_15;
+}
+
+static bool ReadRecording(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "Could not open input recording %s\n", path.c_str());
+        return false;
+    }
+
+    RecordingHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, INPUT_RECORDING_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == INPUT_RECORDING_VERSION && IsValidLevel(header.level);
+    if (valid) {
+        sLevel = header.level;
+        sPads.resize(header.frameCount * INPUT_RECORDING_PADS);
+        valid = fread(sPads.data(), sizeof(RecordedPad), sPads.size(), file) == sPads.size();
+    }
+    fclose(file);
+
+    if (!valid) {
+        fprintf(stderr, "%s is not a valid input recording\n", path.c_str());
+    }
+    return valid;
+}
+
+static void WriteRecording(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        SPDLOG_ERROR("Could not write input recording {}", path);
+        return;
+    }
+
+    RecordingHeader header;
+    memcpy(header.magic, INPUT_RECORDING_MAGIC, sizeof(header.magic));
+    header.version = INPUT_RECORDING_VERSION;
+    header.level = sLevel;
+    header.frameCount = sInputFrame;
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(sPads.data(), sizeof(RecordedPad), sPads.size(), file);
+    fclose(file);
+
+    SPDLOG_INFO("Recorded {} frames of input to {}", sInputFrame, path);
+}
+
+bool ParseArgs(int argc, char** argv) {
+    std::vector<std::string> unknownArgs;
+    std::string modeArg;
+    bool levelSet = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        Mode mode = Mode::Play;
+
+        if (arg == "--headless") {
+            sHeadless = true;
+        } else if (arg == "--record-input" && hasValue) {
+            mode = Mode::Record;
+            sInputPath = argv[++i];
+        } else if (arg == "--benchmark" && hasValue) {
+            mode = Mode::Replay;
+            sInputPath = argv[++i];
+        } else if (arg == "--frames" && hasValue) {
+            sFrameLimit = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--level" && hasValue) {
+            const char* value = argv[++i];
+            char* end;
+            sLevel = strtol(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || !IsValidLevel(sLevel)) {
+                fprintf(stderr, "--level %s is not a level id, expected %d to %d\n", value, LEVEL_CORNERIA,
+                        LEVEL_VERSUS);
+                return false;
+            }
+            levelSet = true;
+        } else if (arg == "--audio-render" && hasValue) {
+            mode = Mode::AudioRender;
+            sAudioRenderOptions.outputPath = argv[++i];
+        } else if (arg == "--seq" && hasValue) {
+            sAudioRenderOptions.seqId = strtol(argv[++i], nullptr, 0);
+        } else if (arg == "--sfx-script" && hasValue) {
+            sAudioRenderOptions.sfxScriptPath = argv[++i];
+        } else if (arg == "--golden" && hasValue) {
+            sAudioRenderOptions.goldenPath = argv[++i];
+        } else if (arg == "--no-sync-loads") {
+            sNoSyncLoads = true;
+        } else if (arg == "--toggle-alt-assets" && hasValue) {
+            sToggleAltAssetsFrame = strtoul(argv[++i], nullptr, 10);
+        } else {
+            unknownArgs.push_back(arg);
+        }
+
+        if (mode != Mode::Play) {
+            if (sMode != Mode::Play && sMode != mode) {
+                fprintf(stderr, "%s can not be used with %s\n", arg.c_str(), modeArg.c_str());
+                return false;
+            }
+            sMode = mode;
+            modeArg = arg;
+        }
+    }
+
+    // Launchers and the OS add arguments of their own (macOS passes -psn_*), those only fail a benchmark run
+    const bool benchmarkRun = sHeadless || sMode != Mode::Play || levelSet;
+    for (const std::string& arg : unknownArgs) {
+        if (benchmarkRun) {
+            fprintf(stderr, "Unknown or incomplete argument %s\n", arg.c_str());
+            return false;
+        }
+        fprintf(stderr, "Ignoring unknown argument %s\n", arg.c_str());
+    }
+
+    if (sMode == Mode::AudioRender) {
+        // The game never runs, there is nothing to show
+        sHeadless = true;
+        sAudioRenderOptions.frames = sFrameLimit;
+    }
+
+    if (sNoSyncLoads && sMode != Mode::Replay) {
+        fprintf(stderr, "--no-sync-loads needs --benchmark\n");
+        return false;
+    }
+
+    if (sToggleAltAssetsFrame != 0 && sMode != Mode::Replay) {
+        fprintf(stderr, "--toggle-alt-assets needs --benchmark\n");
+        return false;
+    }
+
+    if (sMode == Mode::Replay) {
+        if (!ReadRecording(sInputPath)) {
+            return false;
+        }
+        if (sFrameLimit == 0) {
+            sFrameLimit = sPads.size() / INPUT_RECORDING_PADS;
+        }
+    }
+
+    if (sHeadless) {
+        // There is nothing to play the audio on either, keep SDL from looking for a device
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    }
+
+    sStartTime = Clock::now();
+    return true;
+}
+
+bool IsHeadless() {
+    return sHeadless;
+}
+
+bool IsAudioRender() {
+    return sMode == Mode::AudioRender;
+}
+
+const AudioRenderOptions& GetAudioRenderOptions() {
+    return sAudioRenderOptions;
+}
+
+void EndFrame() {
+    if (sMode != Mode::Record && sMode != Mode::Replay) {
+        return;
+    }
+
+    for (int i = 0; i < BENCHMARK_STAGE_MAX; i++) {
+        const double ms = sFrameStageNs[i].exchange(0, std::memory_order_relaxed) / 1000000.0;
+        sStageTimes[i].total += ms;
+        sStageTimes[i].max = std::max(sStageTimes[i].max, ms);
+    }
+    sFrameCount++;
+
+    if (sMode == Mode::Replay && sToggleAltAssetsFrame != 0 && sFrameCount == sToggleAltAssetsFrame) {
+        CVarSetInteger("gEnhancements.Mods.AlternateAssets", !CVarGetInteger("gEnhancements.Mods.AlternateAssets", 0));
+        sToggleState = ToggleState::Requested;
+    }
+
+    if (sFrameLimit != 0 && sFrameCount == sFrameLimit) {
+        Ship::Context::GetInstance()->GetWindow()->Close();
+    }
+}
+
+void RecordTextureUploads(size_t uploadCount) {
+    const size_t frameUploads = uploadCount - sUploadCount;
+    sUploadCount = uploadCount;
+    sRecentFrameUploads[sRecordedFrames++ % TOGGLE_STEADY_FRAMES] = frameUploads;
+    if (sToggleState == ToggleState::Toggled) {
+        sUploadsAfterToggle = frameUploads;
+        sToggleState = ToggleState::Measured;
+    }
+}
+
+void RecordAltAssetsToggle(uint32_t replacedTextures) {
+    if (sToggleState != ToggleState::Requested) {
+        return;
+    }
+
+    // The first frame also counts the uploads of everything drawn before the benchmark started
+    const uint32_t frames = sRecordedFrames > 0 ? std::min(sRecordedFrames - 1, TOGGLE_STEADY_FRAMES) : 0;
+    if (frames == TOGGLE_STEADY_FRAMES) {
+        sSteadyUploadsMin = *std::min_element(sRecentFrameUploads.begin(), sRecentFrameUploads.end());
+        sSteadyUploadsMax = *std::max_element(sRecentFrameUploads.begin(), sRecentFrameUploads.end());
+        sSteadyBeforeToggle = sSteadyUploadsMin == sSteadyUploadsMax;
+    }
+    sReplacedTextures = replacedTextures;
+    sToggleState = ToggleState::Toggled;
+}
+
+int Exit() {
+    if (sMode == Mode::Record) {
+        WriteRecording(sInputPath);
+    }
+
+    if (sMode != Mode::Replay || sFrameCount == 0) {
+        return 0;
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - sStartTime).count();
+    printf("Benchmark: %u frames in %.2f s (%.1f fps)\n", sFrameCount, seconds, sFrameCount / seconds);
+    printf("%-8s %12s %10s %10s\n", "stage", "total ms", "avg ms", "max ms");
+    for (int i = 0; i < BENCHMARK_STAGE_MAX; i++) {
+        printf("%-8s %12.2f %10.3f %10.3f\n", sStageNames[i], sStageTimes[i].total,
+               sStageTimes[i].total / sFrameCount, sStageTimes[i].max);
+    }
+
+    const uint32_t prefetchedScenes = ScenePrefetch_GetPrefetchCount();
+    const uint32_t syncLoads = ScenePrefetch_GetMissCount();
+    printf("%u prefetched scenes, %u synchronous loads in them\n", prefetchedScenes, syncLoads);
+
+    int result = 0;
+    if (sNoSyncLoads && prefetchedScenes == 0) {
+        printf("No scene was prefetched, replay once without --no-sync-loads to record what they load\n");
+        result = 1;
+    } else if (sNoSyncLoads && syncLoads != 0) {
+        printf("Prefetched scenes still loaded resources synchronously\n");
+        result = 1;
+    }
+
+    if (sToggleAltAssetsFrame != 0) {
+        if (sToggleState != ToggleState::Measured) {
+            printf("The replay ended before the alternate assets toggle after frame %u was measured\n",
+                   sToggleAltAssetsFrame);
+            result = 1;
+        } else {
+            printf("Alternate assets toggle: %u textures replaced, %zu to %zu uploads per frame in the %u frames "
+                   "before, %zu in the frame after\n",
+                   sReplacedTextures, sSteadyUploadsMin, sSteadyUploadsMax, TOGGLE_STEADY_FRAMES, sUploadsAfterToggle);
+            if (!sSteadyBeforeToggle) {
+                printf("The %u frames before frame %u did not upload the same number of textures, toggle where the "
+                       "scene is steady\n",
+                       TOGGLE_STEADY_FRAMES, sToggleAltAssetsFrame);
+                result = 1;
+            } else if (sUploadsAfterToggle > sSteadyUploadsMax + sReplacedTextures) {
+                printf("The toggle uploaded textures again that have no other version\n");
+                result = 1;
+            }
+        }
+    }
+    fflush(stdout);
+    return result;
+}
+
+} // namespace SF64::Benchmark
+
+using namespace SF64::Benchmark;
+
+extern "C" bool Benchmark_IsActive(void) {
+    return sMode == Mode::Record || sMode == Mode::Replay;
+}
+
+extern "C" s32 Benchmark_GetLevel(void) {
+    return sLevel;
+}
+
+extern "C" void Benchmark_FilterInput(OSContPad* pads) {
+    if (sMode == Mode::Record) {
+        for (uint32_t i = 0; i < INPUT_RECORDING_PADS; i++) {
+            RecordedPad recorded = {};
+            recorded.button = pads[i].button;
+            recorded.stickX = pads[i].stick_x;
+            recorded.stickY = pads[i].stick_y;
+            recorded.rightStickX = pads[i].right_stick_x;
+            recorded.rightStickY = pads[i].right_stick_y;
+            recorded.errNo = pads[i].err_no;
+            sPads.push_back(recorded);
+        }
+        sInputFrame++;
+    } else if (sMode == Mode::Replay) {
+        // Past the end of the recording nobody touches the controller
+        const bool recorded = (sInputFrame + 1) * INPUT_RECORDING_PADS <= sPads.size();
+        for (uint32_t i = 0; i < INPUT_RECORDING_PADS; i++) {
+            const RecordedPad pad = recorded ? sPads[sInputFrame * INPUT_RECORDING_PADS + i] : RecordedPad {};
+            pads[i] = {};
+            pads[i].button = pad.button;
+            pads[i].stick_x = pad.stickX;
+            pads[i].stick_y = pad.stickY;
+            pads[i].right_stick_x = pad.rightStickX;
+            pads[i].right_stick_y = pad.rightStickY;
+            pads[i].err_no = pad.errNo;
+        }
+        sInputFrame++;
+    }
+}
+
+extern "C" void Benchmark_StageBegin(BenchmarkStage stage) {
+    if (sMode == Mode::Replay) {
+        sStageStart[stage] = Clock::now();
+    }
+}
+
+extern "C" void Benchmark_StageEnd(BenchmarkStage stage) {
+    if (sMode == Mode::Replay) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sStageStart[stage]);
+        sFrameStageNs[stage].fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <libultraship.h>
+
+typedef enum BenchmarkStage {
+    BENCHMARK_STAGE_UPDATE, // Game_Update, including BENCHMARK_STAGE_DRAW
+    BENCHMARK_STAGE_DRAW,   // Game_Draw, building the display lists
+    BENCHMARK_STAGE_RENDER, // Running the display lists through the interpreter
+    BENCHMARK_STAGE_AUDIO,  // Audio synthesis
+    BENCHMARK_STAGE_MAX,
+} BenchmarkStage;
+
+#ifdef __cplusplus
+
+#include "AudioRender.h"
+
+namespace SF64::Benchmark {
+
+// Handles the benchmark command line:
+//   --headless              run without a window, using the null rendering backend
+//   --record-input <file>   record the controller input of this run
+//   --benchmark <file>      replay a recording and print per stage timings when done
+//   --frames <n>            stop after n frames (replays default to the length of the recording)
+//   --level <id>            boot straight into this level (replays use the level they were recorded in)
+//   --audio-render <file>   only run the audio engine and write its output to a wav, see RunAudioRender
+//   --seq <id>              sequence the audio render plays
+//   --sfx-script <file>     sfx the audio render plays
+//   --golden <file>         wav the audio render has to match
+//   --no-sync-loads         fail the replay if a scene that was prefetched still had to wait for a resource, see
+//                           ScenePrefetch.h. Needs a run without it first to record what the scenes load.
+//   --toggle-alt-assets <n> toggle alternate assets after frame n of the replay and print the texture uploads of the
+//                           frames before and after. The 8 frames before have to upload the same number of textures,
+//                           the frame after may only add the textures that have another version.
+// --record-input, --benchmark and --audio-render each start a run of their own, only one of them can be given.
+// Unknown arguments are ignored with a warning unless one of the above is given. The mixer kernel and archive checks
+// are in the self-check tool, see src/port/selfcheck.
+// Returns false if the command line is invalid or the recording could not be read.
+bool ParseArgs(int argc, char** argv);
+bool IsHeadless();
+bool IsAudioRender();
+const AudioRenderOptions& GetAudioRenderOptions();
+// Called once per game frame, closes the window once the run is over
+void EndFrame();
+// Called by the renderer once per frame with Interpreter::mTextureUploadCount
+void RecordTextureUploads(size_t uploadCount);
+// Called by the renderer when it switched alternate assets, with the number of textures that got another version
+void RecordAltAssetsToggle(uint32_t replacedTextures);
+// Prints the timings of a replay and writes out the recording. Returns the exit code.
+int Exit();
+
+} // namespace SF64::Benchmark
+
+extern "C" {
+#endif
+
+// Whether this is a recording or a replay, the game then boots straight into the level and seeds its RNG the same
+// way on every run
+bool Benchmark_IsActive(void);
+s32 Benchmark_GetLevel(void);
+// Records the pads read this frame, or replaces them with the recorded ones
+void Benchmark_FilterInput(OSContPad* pads);
+void Benchmark_StageBegin(BenchmarkStage stage);
+void Benchmark_StageEnd(BenchmarkStage stage);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,204 @@
+#include "ColPolyBvh.h"
+#include <libultraship/bridge.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "Context.h"
+#include "resource/ResourceManager.h"
+#include "resource/archive/ArchiveManager.h"
+#include "port/resource/type/ColPoly.h"
+#include "port/resource/type/Vec3sArray.h"
+
+namespace SF64 {
+
+static constexpr uint32_t COLPOLY_BVH_LEAF_SIZE = 4;
+static constexpr uint32_t COLPOLY_BVH_MAX_DEPTH = 64;
+
+void ColPolyBvh::Build(const void* polys, const void* mesh, int32_t polyCount) {
+    const auto* polyData = static_cast<const ColPolyData*>(polys);
+    const auto* vtx = static_cast<const Vec3sData*>(mesh);
+
+    mPolyBounds.resize(polyCount);
+    mIndices.resize(polyCount);
+    mNodes.clear();
+
+    for (int32_t i = 0; i < polyCount; i++) {
+        const Vec3sData& v0 = vtx[polyData[i].tri.x];
+        const Vec3sData& v1 = vtx[polyData[i].tri.y];
+        const Vec3sData& v2 = vtx[polyData[i].tri.z];
+        ColPolyBounds& bounds = mPolyBounds[i];
+
+        bounds.min[0] = std::min({ v0.x, v1.x, v2.x });
+        bounds.min[1] = std::min({ v0.y, v1.y, v2.y });
+        bounds.min[2] = std::min({ v0.z, v1.z, v2.z });
+        bounds.max[0] = std::max({ v0.x, v1.x, v2.x });
+        bounds.max[1] = std::max({ v0.y, v1.y, v2.y });
+        bounds.max[2] = std::max({ v0.z, v1.z, v2.z });
+        mIndices[i] = i;
+    }
+
+    if (polyCount > 0) {
+        BuildNode(0, polyCount);
+    }
+}
+
+uint32_t ColPolyBvh::BuildNode(uint32_t first, uint32_t count) {
+    const uint32_t nodeIndex = mNodes.size();
+    mNodes.emplace_back();
+
+    ColPolyBounds bounds = mPolyBounds[mIndices[first]];
+    int32_t centerMin[3] = { INT32_MAX, INT32_MAX, INT32_MAX };
+    int32_t centerMax[3] = { INT32_MIN, INT32_MIN, INT32_MIN };
+
+    for (uint32_t i = first; i < first + count; i++) {
+        const ColPolyBounds& poly = mPolyBounds[mIndices[i]];
+        for (int axis = 0; axis < 3; axis++) {
+            const int32_t center = poly.min[axis] + poly.max[axis];
+            bounds.min[axis] = std::min(bounds.min[axis], poly.min[axis]);
+            bounds.max[axis] = std::max(bounds.max[axis], poly.max[axis]);
+            centerMin[axis] = std::min(centerMin[axis], center);
+            centerMax[axis] = std::max(centerMax[axis], center);
+        }
+    }
+
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if ((centerMax[i] - centerMin[i]) > (centerMax[axis] - centerMin[axis])) {
+            axis = i;
+        }
+    }
+
+    if ((count <= COLPOLY_BVH_LEAF_SIZE) || (centerMax[axis] == centerMin[axis])) {
+        mNodes[nodeIndex] = { bounds, first, count };
+        return nodeIndex;
+    }
+
+    // Median split along the longest axis of the triangle centers
+    const uint32_t half = count / 2;
+    std::nth_element(mIndices.begin() + first, mIndices.begin() + first + half, mIndices.begin() + first + count,
+                     [this, axis](uint16_t a, uint16_t b) {
+                         return (mPolyBounds[a].min[axis] + mPolyBounds[a].max[axis]) <
+                                (mPolyBounds[b].min[axis] + mPolyBounds[b].max[axis]);
+                     });
+
+    BuildNode(first, half);
+    const uint32_t right = BuildNode(first + half, count - half);
+    mNodes[nodeIndex] = { bounds, right, 0 };
+    return nodeIndex;
+}
+
+bool ColPolyBvh::Overlaps(const ColPolyBounds& bounds, const int32_t* min, const int32_t* max) {
+    return (min[0] < bounds.max[0]) && (max[0] > bounds.min[0]) && (min[1] < bounds.max[1]) &&
+           (max[1] > bounds.min[1]) && (min[2] < bounds.max[2]) && (max[2] > bounds.min[2]);
+}
+
+void ColPolyBvh::Query(const int32_t* min, const int32_t* max, std::vector<uint16_t>& out) const {
+    uint32_t stack[COLPOLY_BVH_MAX_DEPTH];
+    uint32_t stackSize = 0;
+
+    out.clear();
+    if (mNodes.empty()) {
+        return;
+    }
+
+    stack[stackSize++] = 0;
+    while (stackSize != 0) {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const ColPolyBvhNode& node = mNodes[nodeIndex];
+
+        if (!Overlaps(node.bounds, min, max)) {
+            continue;
+        }
+        if (node.count != 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                if (Overlaps(mPolyBounds[mIndices[i]], min, max)) {
+                    out.push_back(mIndices[i]);
+                }
+            }
+        } else {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+
+    std::sort(out.begin(), out.end());
+}
+
+} // namespace SF64
+
+namespace {
+struct ColPolyBvhEntry {
+    const void* mesh = nullptr;
+    int32_t polyCount = 0;
+    uint32_t archiveGeneration = 0;
+    SF64::ColPolyBvh bvh;
+};
+
+// Keyed by the loaded poly data, an entry lives as long as its ColPoly resource. Swapping archives can change the
+// mesh behind the same pointer, so entries are also rebuilt when the archive generation moves.
+std::unordered_map<const void*, ColPolyBvhEntry> sColPolyBvhs;
+std::vector<uint16_t> sColPolyCandidates;
+
+// Poly data of ColPoly resources destroyed since the last query, those can be freed on any thread
+std::mutex sReleasedMutex;
+std::vector<const void*> sReleased;
+std::atomic<bool> sHasReleased = false;
+} // namespace
+
+namespace SF64 {
+
+void ColPolyBvh::Release(const void* polys) {
+    std::lock_guard<std::mutex> lock(sReleasedMutex);
+    sReleased.push_back(polys);
+    sHasReleased.store(true, std::memory_order_release);
+}
+
+} // namespace SF64
+
+extern "C" const uint16_t* ColPolyBvh_Query(const void* polys, const void* mesh, int32_t polyCount,
+                                            const int32_t* min, const int32_t* max, int32_t* count) {
+    static const uint16_t sNoCandidates = 0;
+
+    // 0: scan every poly, 1: use the hierarchy, 2: use the hierarchy and check its hits against a scan
+    const int32_t mode = CVarGetInteger("gCollisionBvh", 1);
+
+    if ((mode == 0) || (polys == nullptr) || (mesh == nullptr) || (polyCount <= 0) || (polyCount > UINT16_MAX + 1)) {
+        return nullptr;
+    }
+
+    // Before the lookup, a new resource can have the address of one released since the last query
+    if (sHasReleased.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(sReleasedMutex);
+        for (const void* released : sReleased) {
+            sColPolyBvhs.erase(released);
+        }
+        sReleased.clear();
+        sHasReleased.store(false, std::memory_order_relaxed);
+    }
+
+    const uint32_t archiveGeneration =
+        Ship::Context::GetInstance()->GetResourceManager()->GetArchiveManager()->GetGeneration();
+    auto& entry = sColPolyBvhs[polys];
+    if ((entry.mesh != mesh) || (entry.polyCount != polyCount) || (entry.archiveGeneration != archiveGeneration)) {
+        entry.mesh = mesh;
+        entry.polyCount = polyCount;
+        entry.archiveGeneration = archiveGeneration;
+        entry.bvh.Build(polys, mesh, polyCount);
+    }
+
+    entry.bvh.Query(min, max, sColPolyCandidates);
+
+    *count = sColPolyCandidates.size();
+    return sColPolyCandidates.empty() ? &sNoCandidates : sColPolyCandidates.data();
+}
+
+extern "C" bool ColPolyBvh_IsChecking(void) {
+    return CVarGetInteger("gCollisionBvh", 1) == 2;
+}
+
+extern "C" void ColPolyBvh_ReportMismatch(int32_t polyCount, int32_t hitPoly, int32_t linearHitPoly) {
+    SPDLOG_ERROR("Collision BVH hit poly {} where the scan hit poly {}, in a mesh of {} polys", hitPoly,
+                 linearHitPoly, polyCount);
+}
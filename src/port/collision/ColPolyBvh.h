@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+
+#include <vector>
+
+namespace SF64 {
+
+struct ColPolyBounds {
+    int16_t min[3];
+    int16_t max[3];
+};
+
+struct ColPolyBvhNode {
+    ColPolyBounds bounds;
+    uint32_t first; // Leaves: first slot in the poly index list. Inner nodes: the right child, the left one follows
+    uint32_t count; // Number of polys of a leaf, 0 for inner nodes
+};
+
+// Bounding volume hierarchy over the triangles of a collision mesh, built from the same integer bounds the
+// collision code compares against.
+class ColPolyBvh {
+  public:
+    void Build(const void* polys, const void* mesh, int32_t polyCount);
+    // Collects every poly whose bounds overlap the open box (min, max), in ascending order
+    void Query(const int32_t* min, const int32_t* max, std::vector<uint16_t>& out) const;
+    // Drops the hierarchy built for the poly data, called when the ColPoly resource holding it is destroyed
+    static void Release(const void* polys);
+
+  private:
+    uint32_t BuildNode(uint32_t first, uint32_t count);
+    static bool Overlaps(const ColPolyBounds& bounds, const int32_t* min, const int32_t* max);
+
+    std::vector<ColPolyBounds> mPolyBounds;
+    std::vector<uint16_t> mIndices;
+    std::vector<ColPolyBvhNode> mNodes;
+};
+
+} // namespace SF64
+
+extern "C" {
+#endif
+
+// Returns the polys of a collision mesh whose bounds overlap the box, in ascending order, or NULL if every poly has
+// to be checked. The list stays valid until the next call.
+const uint16_t* ColPolyBvh_Query(const void* polys, const void* mesh, int32_t polyCount, const int32_t* min,
+                                 const int32_t* max, int32_t* count);
+// gCollisionBvh 2, the collision code runs its tests over every poly as well and compares the hits
+bool ColPolyBvh_IsChecking(void);
+// Logs that the hierarchy led to another hit than the scan over every poly, -1 for no hit
+void ColPolyBvh_ReportMismatch(int32_t polyCount, int32_t hitPoly, int32_t linearHitPoly);
+
+#ifdef __cplusplus
+}
+#endif
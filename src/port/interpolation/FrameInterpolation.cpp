@@ -1,8 +1,8 @@
 #include <libultraship/bridge.h>
 
 #include <vector>
-#include <map>
-#include <unordered_map>
+#include <algorithm>
+#include <cstring>
 #include <math.h>
 #include "port/Engine.h"
 
@@ -153,22 +153,174 @@ union Data {
     } open_child;
 };
 
-struct Path {
-    map<label, vector<Path>> children;
-    map<Op, vector<Data>> ops;
-    vector<pair<Op, size_t>> items;
+constexpr size_t kOpCount = (size_t) Op::SkinMatrixMtxFToMtx + 1;
+
+// Open addressing table with generation stamped slots, clearing is O(1) and keeps the storage around so the
+// recordings stop allocating once they have grown to the size of a frame.
+template <typename Key, typename Value, typename Hasher> class FlatTable {
+  public:
+    Value* find(const Key& key) {
+        if (used == 0) {
+            return nullptr;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = Hasher()(key) & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (slot.gen != gen) {
+                return nullptr;
+            }
+            if (slot.key == key) {
+                return &slot.value;
+            }
+        }
+    }
+
+    Value& operator[](const Key& key) {
+        if ((used + 1) * 2 > slots.size()) {
+            grow();
+        }
+        size_t mask = slots.size() - 1;
+        size_t i = Hasher()(key) & mask;
+        for (; slots[i].gen == gen; i = (i + 1) & mask) {
+            if (slots[i].key == key) {
+                return slots[i].value;
+            }
+        }
+        used++;
+        slots[i] = { key, {}, gen };
+        return slots[i].value;
+    }
+
+    void clear() {
+        used = 0;
+        if (++gen == 0) {
+            for (auto& slot : slots) {
+                slot.gen = 0;
+            }
+            gen = 1;
+        }
+    }
+
+  private:
+    struct Slot {
+        Key key;
+        Value value;
+        uint32_t gen;
+    };
+
+    void grow() {
+        vector<Slot> old;
+        old.swap(slots);
+        uint32_t old_gen = gen;
+        slots.assign(std::max<size_t>(old.size() * 2, 1024), Slot{ {}, {}, 0 });
+        gen = 1;
+        used = 0;
+        for (auto& slot : old) {
+            if (slot.gen == old_gen) {
+                (*this)[slot.key] = slot.value;
+            }
+        }
+    }
+
+    vector<Slot> slots;
+    size_t used = 0;
+    uint32_t gen = 1;
+};
+
+struct ChildKey {
+    uint32_t parent;
+    label key;
+    uint32_t idx;
+
+    bool operator==(const ChildKey& other) const {
+        return parent == other.parent && key == other.key && idx == other.idx;
+    }
+};
+
+struct ChildKeyHasher {
+    size_t operator()(const ChildKey& k) const {
+        uint64_t h = (uint64_t) (uintptr_t) k.key.first * 0x9E3779B97F4A7C15ull;
+        h ^= ((uint64_t) k.parent << 32 | (uint32_t) k.key.second) * 0xC2B2AE3D27D4EB4Full;
+        h ^= (uint64_t) k.idx * 0x165667B19E3779F9ull;
+        return (size_t) (h ^ (h >> 29));
+    }
+};
+
+// One entry of the linear op log. Nodes (formerly Path) own the range of the log recorded between their
+// OpenChild and CloseChild, nested children are skipped over through their own range.
+struct Item {
+    Op op;
+    uint32_t node;
+    uint32_t data;     // Index into Recording::data, or the child node for Op::OpenChild
+    uint32_t type_idx; // Index among the ops of the same type in the node, used to match ops between frames
+};
+
+struct Node {
+    label key;
+    uint32_t key_idx; // Occurrence of key among the children of the parent node
+    uint32_t first_item;
+    uint32_t end_item;
+    uint32_t op_count[kOpCount];
+    uint32_t op_offset[kOpCount]; // Into Recording::typed, filled by finalize()
 };
 
 struct Recording {
-    Path root_path;
+    vector<Item> items;
+    vector<Data> data;
+    vector<Node> nodes;
+    vector<uint32_t> typed;
+    FlatTable<ChildKey, uint32_t, ChildKeyHasher> child_counts; // idx unused, counts children per label
+    FlatTable<ChildKey, uint32_t, ChildKeyHasher> children;
+
+    void clear() {
+        items.clear();
+        data.clear();
+        nodes.clear();
+        typed.clear();
+        child_counts.clear();
+        children.clear();
+    }
+
+    uint32_t add_node() {
+        Node& node = nodes.emplace_back();
+        node.first_item = node.end_item = (uint32_t) items.size();
+        memset(node.op_count, 0, sizeof(node.op_count));
+        return (uint32_t) nodes.size() - 1;
+    }
+
+    // Builds the lookup structures needed when this recording is used as the previous frame
+    void finalize() {
+        uint32_t total = 0;
+        for (auto& node : nodes) {
+            for (size_t op = 0; op < kOpCount; op++) {
+                node.op_offset[op] = total;
+                total += node.op_count[op];
+            }
+        }
+        typed.resize(total);
+        for (auto& item : items) {
+            if (item.op != Op::OpenChild) {
+                typed[nodes[item.node].op_offset[(size_t) item.op] + item.type_idx] = item.data;
+            }
+        }
+    }
+
+    Data* find_op(uint32_t node, Op op, uint32_t type_idx) {
+        const Node& n = nodes[node];
+        if (type_idx >= n.op_count[(size_t) op]) {
+            return nullptr;
+        }
+        return &data[typed[n.op_offset[(size_t) op] + type_idx]];
+    }
 };
 
 bool is_recording;
-vector<Path*> current_path;
+vector<uint32_t> current_path;
 uint32_t camera_epoch;
 uint32_t previous_camera_epoch;
-Recording current_recording;
-Recording previous_recording;
+Recording recordings[2];
+Recording* current_recording = &recordings[0];
+Recording* previous_recording = &recordings[1];
 
 bool next_is_actor_pos_rot_matrix;
 bool has_inv_actor_mtx;
@@ -176,9 +328,10 @@ MtxF inv_actor_mtx;
 size_t inv_actor_mtx_path_index;
 
 Data& append(Op op) {
-    auto& m = current_path.back()->ops[op];
-    current_path.back()->items.emplace_back(op, m.size());
-    return m.emplace_back();
+    Recording& rec = *current_recording;
+    uint32_t node = current_path.back();
+    rec.items.push_back({ op, node, (uint32_t) rec.data.size(), rec.nodes[node].op_count[(size_t) op]++ });
+    return rec.data.emplace_back();
 }
 
 MtxF* Matrix_GetCurrent(){
@@ -188,14 +341,14 @@ MtxF* Matrix_GetCurrent(){
 struct InterpolateCtx {
     float step;
     float w;
-    unordered_map<Mtx*, MtxF> mtx_replacements;
+    Fast::MtxReplacementMap* mtx_replacements;
     MtxF tmp_mtxf, tmp_mtxf2;
     Vec3f tmp_vec3f, tmp_vec3f2;
     Vec3s tmp_vec3s;
     MtxF actor_mtx;
 
     MtxF* new_replacement(Mtx* addr) {
-        return &mtx_replacements[addr];
+        return &(*mtx_replacements)[addr];
     }
 
     void interpolate_mtxf(MtxF* res, MtxF* o, MtxF* n) {
@@ -282,120 +435,130 @@ struct InterpolateCtx {
         res->z = interpolate_angle(o->z, n->z);
     }
 
-    void interpolate_branch(Path* old_path, Path* new_path) {
-        for (auto& item : new_path->items) {
-            Data& new_op = new_path->ops[item.first][item.second];
-
-            if (item.first == Op::OpenChild) {
-                if (auto it = old_path->children.find(new_op.open_child.key);
-                    it != old_path->children.end() && new_op.open_child.idx < it->second.size()) {
-                    interpolate_branch(&it->second[new_op.open_child.idx],
-                                       &new_path->children.find(new_op.open_child.key)->second[new_op.open_child.idx]);
-                } else {
-                    interpolate_branch(&new_path->children.find(new_op.open_child.key)->second[new_op.open_child.idx],
-                                       &new_path->children.find(new_op.open_child.key)->second[new_op.open_child.idx]);
+    // old_rec == new_rec means there was no matching node in the previous frame, the node is then interpolated
+    // with itself.
+    void interpolate_branch(Recording* old_rec, uint32_t old_node, Recording* new_rec, uint32_t new_node) {
+        const Node& node = new_rec->nodes[new_node];
+        for (uint32_t i = node.first_item; i < node.end_item;) {
+            const Item& item = new_rec->items[i];
+
+            if (item.op == Op::OpenChild) {
+                uint32_t child = item.data;
+                i = new_rec->nodes[child].end_item;
+
+                if (old_rec != new_rec) {
+                    const Node& n = new_rec->nodes[child];
+                    if (uint32_t* old_child = old_rec->children.find({ old_node, n.key, n.key_idx })) {
+                        interpolate_branch(old_rec, *old_child, new_rec, child);
+                        continue;
+                    }
                 }
+                interpolate_branch(new_rec, child, new_rec, child);
                 continue;
             }
 
-            if (auto it = old_path->ops.find(item.first); it != old_path->ops.end()) {
-                if (item.second < it->second.size()) {
-                    Data& old_op = it->second[item.second];
-                    switch (item.first) {
-                        case Op::OpenChild:
-                        case Op::CloseChild:
-                        case Op::Marker:
-                            break;
-
-                        case Op::MatrixPush:
-                            Matrix_Push(&gInterpolationMatrix);
-                            break;
-
-                        case Op::MatrixPop:
-                            Matrix_Pop(&gInterpolationMatrix);
-                            break;
+            i++;
+            Data& new_op = new_rec->data[item.data];
+            Data* old_op_ptr = old_rec == new_rec ? &new_op : old_rec->find_op(old_node, item.op, item.type_idx);
 
-                     // Unused on SF64
-                     // case Op::MatrixPut:
-                     //     interpolate_mtxf(&tmp_mtxf, &old_op.matrix_put.src, &new_op.matrix_put.src);
-                     //     Matrix_Put(&tmp_mtxf);
-                     //     break;
-
-                        case Op::MatrixMult:
-                            interpolate_mtxf(&tmp_mtxf, &old_op.matrix_mult.mf, &new_op.matrix_mult.mf);
-                            Matrix_Mult(gInterpolationMatrix, (Matrix*) &tmp_mtxf, new_op.matrix_mult.mode);
-                            break;
-
-                        case Op::MatrixTranslate:
-                            Matrix_Translate(gInterpolationMatrix, lerp(old_op.matrix_translate.x, new_op.matrix_translate.x),
-                                             lerp(old_op.matrix_translate.y, new_op.matrix_translate.y),
-                                             lerp(old_op.matrix_translate.z, new_op.matrix_translate.z),
-                                             new_op.matrix_translate.mode);
-                            break;
-
-                        case Op::MatrixScale:
-                            Matrix_Scale(gInterpolationMatrix, lerp(old_op.matrix_scale.x, new_op.matrix_scale.x),
-                                         lerp(old_op.matrix_scale.y, new_op.matrix_scale.y),
-                                         lerp(old_op.matrix_scale.z, new_op.matrix_scale.z), new_op.matrix_scale.mode);
-                            break;
+            if (old_op_ptr == nullptr) {
+                continue;
+            }
 
-                        case Op::MatrixRotate1Coord: {
-                            float v = interpolate_angle(old_op.matrix_rotate_1_coord.value,
-                                                        new_op.matrix_rotate_1_coord.value);
-                            u8 mode = new_op.matrix_rotate_1_coord.mode;
-                            switch (new_op.matrix_rotate_1_coord.coord) {
-                                case 0:
-                                    Matrix_RotateX(gInterpolationMatrix, v, mode);
-                                    break;
-
-                                case 1:
-                                    Matrix_RotateY(gInterpolationMatrix, v, mode);
-                                    break;
-
-                                case 2:
-                                    Matrix_RotateZ(gInterpolationMatrix, v, mode);
-                                    break;
-                            }
-                            break;
-                        }
-                        case Op::MatrixMultVec3fNoTranslate: {
-                            interpolate_vecs(&tmp_vec3f, &old_op.matrix_vec_no_translate.src, &new_op.matrix_vec_no_translate.src);
-                            interpolate_vecs(&tmp_vec3f2, &old_op.matrix_vec_no_translate.dest, &new_op.matrix_vec_no_translate.dest);
-                            Matrix_MultVec3fNoTranslate(gInterpolationMatrix, &tmp_vec3f, &tmp_vec3f2);
+            Data& old_op = *old_op_ptr;
+            switch (item.op) {
+                case Op::OpenChild:
+                case Op::CloseChild:
+                case Op::Marker:
+                    break;
+
+                case Op::MatrixPush:
+                    Matrix_Push(&gInterpolationMatrix);
+                    break;
+
+                case Op::MatrixPop:
+                    Matrix_Pop(&gInterpolationMatrix);
+                    break;
+
+             // Unused on SF64
+             // case Op::MatrixPut:
+             //     interpolate_mtxf(&tmp_mtxf, &old_op.matrix_put.src, &new_op.matrix_put.src);
+             //     Matrix_Put(&tmp_mtxf);
+             //     break;
+
+                case Op::MatrixMult:
+                    interpolate_mtxf(&tmp_mtxf, &old_op.matrix_mult.mf, &new_op.matrix_mult.mf);
+                    Matrix_Mult(gInterpolationMatrix, (Matrix*) &tmp_mtxf, new_op.matrix_mult.mode);
+                    break;
+
+                case Op::MatrixTranslate:
+                    Matrix_Translate(gInterpolationMatrix, lerp(old_op.matrix_translate.x, new_op.matrix_translate.x),
+                                     lerp(old_op.matrix_translate.y, new_op.matrix_translate.y),
+                                     lerp(old_op.matrix_translate.z, new_op.matrix_translate.z),
+                                     new_op.matrix_translate.mode);
+                    break;
+
+                case Op::MatrixScale:
+                    Matrix_Scale(gInterpolationMatrix, lerp(old_op.matrix_scale.x, new_op.matrix_scale.x),
+                                 lerp(old_op.matrix_scale.y, new_op.matrix_scale.y),
+                                 lerp(old_op.matrix_scale.z, new_op.matrix_scale.z), new_op.matrix_scale.mode);
+                    break;
+
+                case Op::MatrixRotate1Coord: {
+                    float v = interpolate_angle(old_op.matrix_rotate_1_coord.value,
+                                                new_op.matrix_rotate_1_coord.value);
+                    u8 mode = new_op.matrix_rotate_1_coord.mode;
+                    switch (new_op.matrix_rotate_1_coord.coord) {
+                        case 0:
+                            Matrix_RotateX(gInterpolationMatrix, v, mode);
                             break;
-                        }
-                        case Op::MatrixMultVec3f: {
-                            interpolate_vecs(&tmp_vec3f, &old_op.matrix_vec_translate.src, &new_op.matrix_vec_translate.src);
-                            interpolate_vecs(&tmp_vec3f2, &old_op.matrix_vec_translate.dest, &new_op.matrix_vec_translate.dest);
-                            Matrix_MultVec3f(gInterpolationMatrix, &tmp_vec3f, &tmp_vec3f2);
-                            break;
-                        }
 
-                        case Op::MatrixMtxFToMtx:
-                            interpolate_mtxf(new_replacement(new_op.matrix_mtxf_to_mtx.dest),
-                                             &old_op.matrix_mtxf_to_mtx.src, &new_op.matrix_mtxf_to_mtx.src);
+                        case 1:
+                            Matrix_RotateY(gInterpolationMatrix, v, mode);
                             break;
 
-                        case Op::MatrixToMtx: {
-                            //*new_replacement(new_op.matrix_to_mtx.dest) = *Matrix_GetCurrent();
-                            if (old_op.matrix_to_mtx.has_adjusted && new_op.matrix_to_mtx.has_adjusted) {
-                                interpolate_mtxf(&tmp_mtxf, &old_op.matrix_to_mtx.src, &new_op.matrix_to_mtx.src);
-                                Matrix_MtxFMtxFMult(&actor_mtx, &tmp_mtxf,
-                                                        new_replacement(new_op.matrix_to_mtx.dest));
-                            } else {
-                                interpolate_mtxf(new_replacement(new_op.matrix_to_mtx.dest), &old_op.matrix_to_mtx.src,
-                                                 &new_op.matrix_to_mtx.src);
-                            }
+                        case 2:
+                            Matrix_RotateZ(gInterpolationMatrix, v, mode);
                             break;
-                        }
+                    }
+                    break;
+                }
+                case Op::MatrixMultVec3fNoTranslate: {
+                    interpolate_vecs(&tmp_vec3f, &old_op.matrix_vec_no_translate.src, &new_op.matrix_vec_no_translate.src);
+                    interpolate_vecs(&tmp_vec3f2, &old_op.matrix_vec_no_translate.dest, &new_op.matrix_vec_no_translate.dest);
+                    Matrix_MultVec3fNoTranslate(gInterpolationMatrix, &tmp_vec3f, &tmp_vec3f2);
+                    break;
+                }
+                case Op::MatrixMultVec3f: {
+                    interpolate_vecs(&tmp_vec3f, &old_op.matrix_vec_translate.src, &new_op.matrix_vec_translate.src);
+                    interpolate_vecs(&tmp_vec3f2, &old_op.matrix_vec_translate.dest, &new_op.matrix_vec_translate.dest);
+                    Matrix_MultVec3f(gInterpolationMatrix, &tmp_vec3f, &tmp_vec3f2);
+                    break;
+                }
 
-                        case Op::MatrixRotateAxis: {
-                            lerp_vec3f(&tmp_vec3f, &old_op.matrix_rotate_axis.axis, &new_op.matrix_rotate_axis.axis);
-                            auto tmp = interpolate_angle(old_op.matrix_rotate_axis.angle, new_op.matrix_rotate_axis.angle);
-                            Matrix_RotateAxis((Matrix*) &tmp_vec3f, tmp, 1.0f, 1.0f, 1.0f, new_op.matrix_rotate_axis.mode);
-                            break;
-                        }
+                case Op::MatrixMtxFToMtx:
+                    interpolate_mtxf(new_replacement(new_op.matrix_mtxf_to_mtx.dest),
+                                     &old_op.matrix_mtxf_to_mtx.src, &new_op.matrix_mtxf_to_mtx.src);
+                    break;
+
+                case Op::MatrixToMtx: {
+                    //*new_replacement(new_op.matrix_to_mtx.dest) = *Matrix_GetCurrent();
+                    if (old_op.matrix_to_mtx.has_adjusted && new_op.matrix_to_mtx.has_adjusted) {
+                        interpolate_mtxf(&tmp_mtxf, &old_op.matrix_to_mtx.src, &new_op.matrix_to_mtx.src);
+                        Matrix_MtxFMtxFMult(&actor_mtx, &tmp_mtxf,
+                                                new_replacement(new_op.matrix_to_mtx.dest));
+                    } else {
+                        interpolate_mtxf(new_replacement(new_op.matrix_to_mtx.dest), &old_op.matrix_to_mtx.src,
+                                         &new_op.matrix_to_mtx.src);
                     }
+                    break;
+                }
+
+                case Op::MatrixRotateAxis: {
+                    lerp_vec3f(&tmp_vec3f, &old_op.matrix_rotate_axis.axis, &new_op.matrix_rotate_axis.axis);
+                    auto tmp = interpolate_angle(old_op.matrix_rotate_axis.angle, new_op.matrix_rotate_axis.angle);
+                    Matrix_RotateAxis((Matrix*) &tmp_vec3f, tmp, 1.0f, 1.0f, 1.0f, new_op.matrix_rotate_axis.mode);
+                    break;
                 }
             }
         }
@@ -404,12 +567,21 @@ struct InterpolateCtx {
 
 } // anonymous namespace
 
-unordered_map<Mtx*, MtxF> FrameInterpolation_Interpolate(float step) {
+void FrameInterpolation_Interpolate(float step, Fast::MtxReplacementMap& mtx_replacements) {
+    mtx_replacements.clear();
+    if (current_recording->nodes.empty()) {
+        return;
+    }
+
     InterpolateCtx ctx;
     ctx.step = step;
     ctx.w = 1.0f - step;
-    ctx.interpolate_branch(&previous_recording.root_path, &current_recording.root_path);
-    return ctx.mtx_replacements;
+    ctx.mtx_replacements = &mtx_replacements;
+    if (previous_recording->nodes.empty()) {
+        // Nothing recorded yet, an empty root matches none of the new ops
+        previous_recording->add_node();
+    }
+    ctx.interpolate_branch(previous_recording, 0, current_recording, 0);
 }
 
 bool camera_interpolation = true;
@@ -419,11 +591,20 @@ void FrameInterpolation_ShouldInterpolateFrame(bool shouldInterpolate) {
     is_recording = shouldInterpolate;
 }
 
+bool FrameInterpolation_IsRecording(void) {
+    return is_recording;
+}
+
 void FrameInterpolation_StartRecord(void) {
-    previous_recording = move(current_recording);
-    current_recording = {};
+    // Nodes left open by unbalanced Open/CloseChild calls end where the recording ends
+    for (uint32_t node : current_path) {
+        current_recording->nodes[node].end_item = (uint32_t) current_recording->items.size();
+    }
+    current_recording->finalize();
+    swap(previous_recording, current_recording);
+    current_recording->clear();
     current_path.clear();
-    current_path.push_back(&current_recording.root_path);
+    current_path.push_back(current_recording->add_node());
     if (!camera_interpolation) {
         // default to interpolating
         camera_interpolation = true;
@@ -438,24 +619,41 @@ void FrameInterpolation_StartRecord(void) {
 void FrameInterpolation_StopRecord(void) {
     previous_camera_epoch = camera_epoch;
     is_recording = false;
+    // Children opened and never closed end with the recording as well, otherwise their end_item points back at their
+    // own OpenChild item and interpolate_branch never gets past it
+    for (uint32_t node : current_path) {
+        current_recording->nodes[node].end_item = (uint32_t) current_recording->items.size();
+    }
+    if (current_path.size() > 1) {
+        current_path.resize(1);
+        has_inv_actor_mtx = false;
+    }
 }
 
 void FrameInterpolation_RecordOpenChild(const void* a, int b) {
     if (!is_recording)
         return;
+    Recording& rec = *current_recording;
     label key = { a, b };
-    auto& m = current_path.back()->children[key];
-    append(Op::OpenChild).open_child = { key, m.size() };
-    current_path.push_back(&m.emplace_back());
+    uint32_t parent = current_path.back();
+    uint32_t idx = rec.child_counts[{ parent, key, 0 }]++;
+    uint32_t child = rec.add_node();
+    rec.nodes[child].key = key;
+    rec.nodes[child].key_idx = idx;
+    rec.children[{ parent, key, idx }] = child;
+    rec.items.push_back({ Op::OpenChild, parent, child, 0 });
+    rec.nodes[child].first_item = (uint32_t) rec.items.size();
+    current_path.push_back(child);
 }
 
 void FrameInterpolation_RecordCloseChild(void) {
-    if (!is_recording)
+    if (!is_recording || current_path.size() <= 1)
         return;
     // append(Op::CloseChild);
     if (has_inv_actor_mtx && current_path.size() == inv_actor_mtx_path_index) {
         has_inv_actor_mtx = false;
     }
+    current_recording->nodes[current_path.back()].end_item = (uint32_t) current_recording->items.size();
     current_path.pop_back();
 }
 
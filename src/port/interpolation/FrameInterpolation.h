@@ -5,9 +5,9 @@
 
 #ifdef __cplusplus
 
-#include <unordered_map>
+#include <Fast3D/MtxReplacementMap.h>
 
-std::unordered_map<Mtx*, MtxF> FrameInterpolation_Interpolate(float step);
+void FrameInterpolation_Interpolate(float step, Fast::MtxReplacementMap& mtx_replacements);
 
 extern "C" {
 
@@ -15,6 +15,8 @@ extern "C" {
 
 void FrameInterpolation_ShouldInterpolateFrame(bool shouldInterpolate);
 
+bool FrameInterpolation_IsRecording(void);
+
 void FrameInterpolation_StartRecord(void);
 
 void FrameInterpolation_StopRecord(void);
@@ -0,0 +1,198 @@
+#include "ScenePrefetch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <libultraship/bridge.h>
+#include <spdlog/spdlog.h>
+#include "Context.h"
+#include "resource/ResourceManager.h"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int32_t NO_SCENE = -1;
+
+// Keyed by scene id << 8 | setup
+static std::unordered_map<int32_t, std::unordered_set<std::string>> sManifests;
+static std::mutex sMutex;
+static bool sEnabled = false;
+static bool sDirty = false;
+static int32_t sScene = NO_SCENE;
+static bool sSceneHasManifest = false;
+static std::atomic<bool> sPlaying = false;
+static std::vector<std::shared_future<std::shared_ptr<Ship::IResource>>> sPending;
+static Clock::time_point sPrefetchStart;
+static uint32_t sPrefetchCount = 0;
+static std::atomic<uint32_t> sMissCount = 0;
+
+static std::string GetManifestPath() {
+    return Ship::Context::GetPathRelativeToAppDirectory("scene_prefetch.txt");
+}
+
+// A "scene <id> <setup>" line followed by the paths on its list, one per line
+static void LoadManifests() {
+    std::ifstream stream(GetManifestPath());
+    std::unordered_set<std::string>* manifest = nullptr;
+    std::string line;
+    while (std::getline(stream, line)) {
+        uint32_t sceneId;
+        uint32_t sceneSetup;
+        if (sscanf(line.c_str(), "scene %u %u", &sceneId, &sceneSetup) == 2) {
+            manifest = &sManifests[(sceneId << 8) | sceneSetup];
+        } else if (manifest != nullptr && !line.empty()) {
+            manifest->insert(line);
+        }
+    }
+}
+
+static void SaveManifests() {
+    std::vector<int32_t> scenes;
+    {
+        const std::lock_guard<std::mutex> lock(sMutex);
+        if (!sDirty) {
+            return;
+        }
+        sDirty = false;
+        for (const auto& [scene, manifest] : sManifests) {
+            scenes.push_back(scene);
+        }
+    }
+    std::sort(scenes.begin(), scenes.end());
+
+    // Written next to it and moved over it once complete, like the fast pack
+    const std::string path = GetManifestPath();
+    const std::string tempPath = path + ".tmp";
+    std::ofstream stream(tempPath, std::ios::trunc);
+    for (int32_t scene : scenes) {
+        std::vector<std::string> paths;
+        {
+            const std::lock_guard<std::mutex> lock(sMutex);
+            const auto& manifest = sManifests[scene];
+            paths.assign(manifest.begin(), manifest.end());
+        }
+        std::sort(paths.begin(), paths.end());
+
+        stream << "scene " << (scene >> 8) << ' ' << (scene & 0xFF) << '\n';
+        for (const auto& resourcePath : paths) {
+            stream << resourcePath << '\n';
+        }
+    }
+    stream.close();
+
+    std::error_code error;
+    if (stream) {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    if (!stream || error) {
+        SPDLOG_ERROR("Failed to write scene prefetch lists to {}", path);
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+static void RecordLoad(const std::string& path, bool waited) {
+    const std::lock_guard<std::mutex> lock(sMutex);
+    if (sScene == NO_SCENE) {
+        return;
+    }
+    if (sManifests[sScene].insert(path).second) {
+        sDirty = true;
+    }
+    if (waited && sSceneHasManifest && sPlaying) {
+        sMissCount++;
+        SPDLOG_DEBUG("Scene {} setup {} waited for {}, it was not on the prefetch list", sScene >> 8, sScene & 0xFF,
+                     path);
+    }
+}
+
+extern "C" void ScenePrefetch_Init(void) {
+    sEnabled = CVarGetInteger("gScenePrefetch", 1);
+    if (!sEnabled) {
+        return;
+    }
+
+    LoadManifests();
+    Ship::Context::GetInstance()->GetResourceManager()->SetLoadObserver(RecordLoad);
+}
+
+extern "C" void ScenePrefetch_Shutdown(void) {
+    if (!sEnabled) {
+        return;
+    }
+
+    ScenePrefetch_Wait();
+    {
+        // The observer stays installed, without a scene RecordLoad ignores whatever is still loaded
+        const std::lock_guard<std::mutex> lock(sMutex);
+        sScene = NO_SCENE;
+    }
+    SaveManifests();
+}
+
+extern "C" void ScenePrefetch_SetScene(uint8_t sceneId, uint8_t sceneSetup) {
+    const int32_t scene = (sceneId << 8) | sceneSetup;
+    if (scene == sScene) {
+        return;
+    }
+
+    auto resourceManager = Ship::Context::GetInstance()->GetResourceManager();
+    // Nothing the new scene uses, including what gets prefetched, is evicted while it runs
+    resourceManager->BeginCacheEpoch();
+    // The bridge hands out the data of resources it returned before without asking the resource manager. Dropping
+    // that makes the new scene ask once for everything it uses, so its list also gets what earlier scenes loaded and
+    // the cache sees it as used.
+    resourceManager->InvalidateCacheGeneration();
+
+    if (!sEnabled) {
+        sScene = scene;
+        return;
+    }
+
+    SaveManifests();
+
+    std::vector<std::string> paths;
+    {
+        const std::lock_guard<std::mutex> lock(sMutex);
+        sScene = scene;
+        sPlaying = false;
+        const auto& manifest = sManifests[scene];
+        sSceneHasManifest = !manifest.empty();
+        paths.assign(manifest.begin(), manifest.end());
+    }
+
+    if (sSceneHasManifest) {
+        sPrefetchCount++;
+        sPrefetchStart = Clock::now();
+        // Below the loads the game waits for
+        for (const auto& path : paths) {
+            sPending.push_back(resourceManager->LoadResourceAsync(path, false, BS::pr::high));
+        }
+    }
+}
+
+extern "C" void ScenePrefetch_Wait(void) {
+    if (!sPending.empty()) {
+        for (const auto& future : sPending) {
+            future.wait();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - sPrefetchStart).count();
+        SPDLOG_INFO("Prefetched {} resources for scene {} setup {} in {:.2f} ms", sPending.size(), sScene >> 8,
+                    sScene & 0xFF, ms);
+        sPending.clear();
+    }
+    sPlaying = true;
+}
+
+extern "C" uint32_t ScenePrefetch_GetPrefetchCount(void) {
+    return sPrefetchCount;
+}
+
+extern "C" uint32_t ScenePrefetch_GetMissCount(void) {
+    return sMissCount;
+}
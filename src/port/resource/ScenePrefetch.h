@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// Lists of the resources the game asked for while each scene and setup ran, kept in scene_prefetch.txt and merged
+// with every run. When a scene starts its list is loaded on the resource threads, all at once, instead of the game
+// loading one resource at a time the first time it draws them. Enabled with gScenePrefetch.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ScenePrefetch_Init(void);
+// Saves what was recorded for the current scene
+void ScenePrefetch_Shutdown(void);
+// Called every frame by Load_SceneSetup. When the scene or its setup changes, the list of the previous one is saved
+// and the resources on the list of the new one start loading. Also starts a new resource cache epoch, so the new
+// scene's resources stay resident whatever the cache budget.
+void ScenePrefetch_SetScene(uint8_t sceneId, uint8_t sceneSetup);
+// Blocks until the resources of the current scene are loaded, called when the scene change is over and gameplay
+// starts
+void ScenePrefetch_Wait(void);
+// Scenes that started with a list
+uint32_t ScenePrefetch_GetPrefetchCount(void);
+// Resources the game had to wait for after gameplay started in those scenes
+uint32_t ScenePrefetch_GetMissCount(void);
+
+#ifdef __cplusplus
+}
+#endif
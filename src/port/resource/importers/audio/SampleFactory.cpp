@@ -2,14 +2,13 @@
 #include "../ResourceUtil.h"
 #include "port/resource/type/audio/Sample.h"
 #include "sf64audio_provisional.h"
+#include "spdlog/spdlog.h"
 #define DR_WAV_IMPLEMENTATION
 #include <dr_wav.h>
 #include <tinyxml2.h>
 #define DR_MP3_IMPLEMENTATION
 #include <dr_mp3.h>
 
-#include "vorbis/vorbisfile.h"
-
 namespace SF64 {
 std::shared_ptr<Ship::IResource> ResourceFactoryBinarySampleV1::ReadResource(std::shared_ptr<Ship::File> file,
                                                                              std::shared_ptr<Ship::ResourceInitData> initData) {
@@ -44,105 +43,6 @@ std::shared_ptr<Ship::IResource> ResourceFactoryBinarySampleV1::ReadResource(std
     return sample;
 }
 
-static size_t VorbisReadCallback(void* out, size_t size, size_t elems, void* src) {
-    OggFileData* data = static_cast<OggFileData*>(src);
-    size_t toRead = size * elems;
-
-    if (toRead > data->size - data->pos) {
-        toRead = data->size - data->pos;
-    }
-
-    memcpy(out, static_cast<uint8_t*>(data->data) + data->pos, toRead);
-    data->pos += toRead;
-
-    return toRead / size;
-}
-
-static int VorbisSeekCallback(void* src, ogg_int64_t pos, int whence) {
-    OggFileData* data = static_cast<OggFileData*>(src);
-    size_t newPos;
-
-    switch (whence) {
-        case SEEK_SET:
-            newPos = pos;
-            break;
-        case SEEK_CUR:
-            newPos = data->pos + pos;
-            break;
-        case SEEK_END:
-            newPos = data->size + pos;
-            break;
-        default:
-            return -1;
-    }
-    if (newPos > data->size) {
-        return -1;
-    }
-    data->pos = newPos;
-    return 0;
-}
-
-static int VorbisCloseCallback([[maybe_unused]] void* src) {
-    return 0;
-}
-
-static long VorbisTellCallback(void* src) {
-    OggFileData* data = static_cast<OggFileData*>(src);
-    return data->pos;
-}
-
-static const ov_callbacks vorbisCallbacks = {
-    VorbisReadCallback,
-    VorbisSeekCallback,
-    VorbisCloseCallback,
-    VorbisTellCallback,
-};
-
-static void Mp3DecoderWorker(std::shared_ptr<Sample> sample, std::shared_ptr<Ship::File> sampleFile) {
-    drmp3 mp3;
-    drwav_uint64 numFrames;
-    drmp3_bool32 ret =
-        drmp3_init_memory(&mp3, sampleFile->Buffer->data(), sampleFile->Buffer->size(), nullptr);
-    numFrames = drmp3_get_pcm_frame_count(&mp3);
-    drwav_uint64 channels = mp3.channels;
-    drwav_uint64 sampleRate = mp3.sampleRate;
-
-    sample->mSample.tuning = (float)(sampleRate * channels) / 32000.0f;
-    sample->mSample.size = numFrames * channels * 2;
-    sample->mSample.sampleAddr = new uint8_t[sample->mSample.size];
-    drmp3_read_pcm_frames_s16(&mp3, numFrames, (int16_t*)sample->mSample.sampleAddr);
-}
-
-static void OggDecoderWorker(std::shared_ptr<Sample> sample, std::shared_ptr<Ship::File> sampleFile) {
-    OggVorbis_File vf;
-    char dataBuff[4096];
-    long read = 0;
-    size_t pos = 0;
-
-    OggFileData fileData = {
-        .data = sampleFile->Buffer.get()->data(),
-        .pos = 0,
-        .size = sampleFile->Buffer.get()->size(),
-    };
-    int ret = ov_open_callbacks(&fileData, &vf, nullptr, 0, vorbisCallbacks);
-
-    vorbis_info* vi = ov_info(&vf, -1);
-
-    uint64_t numFrames = ov_pcm_total(&vf, -1);
-    uint64_t sampleRate = vi->rate;
-    uint64_t numChannels = vi->channels;
-    int bitStream = 0;
-    size_t toRead = numFrames * numChannels * 2;
-    sample->mSample.sampleAddr = new uint8_t[toRead];
-    sample->mSample.tuning = (float)(sampleRate * numChannels) / 32000.0f;
-    do {
-        read = ov_read(&vf, dataBuff, 4096, 0, 2, 1, &bitStream);
-        memcpy(sample->mSample.sampleAddr + pos, dataBuff, read);
-        pos += read;
-    } while (read != 0);
-    ov_clear(&vf);
-}
-
 std::shared_ptr<Ship::IResource> ResourceFactoryXMLSampleV0::ReadResource(std::shared_ptr<Ship::File> file,
                                                                            std::shared_ptr<Ship::ResourceInitData> initData) {
     if (!FileHasValidFormatAndReader(file, initData)) {
@@ -199,8 +99,7 @@ std::shared_ptr<Ship::IResource> ResourceFactoryXMLSampleV0::ReadResource(std::s
             drwav wav;
             drwav_uint64 numFrames;
 
-            drwav_bool32 ret =
-                drwav_init_memory(&wav, sampleFile->Buffer->data(), sampleFile->Buffer->size(), nullptr);
+            drwav_bool32 ret = drwav_init_memory(&wav, sampleFile->GetData(), sampleFile->GetSize(), nullptr);
 
             drwav_get_length_in_pcm_frames(&wav, &numFrames);
 
@@ -210,13 +109,24 @@ std::shared_ptr<Ship::IResource> ResourceFactoryXMLSampleV0::ReadResource(std::s
 
             drwav_read_pcm_frames_s16(&wav, numFrames, (int16_t*)sample->mSample.sampleAddr);
             return sample;
-        } else if (strcmp(customFormatStr, "ogg") == 0) {
-            std::thread fileDecoderThread = std::thread(OggDecoderWorker, sample, sampleFile);
-            fileDecoderThread.detach();
-            return sample;
-        } else if (strcmp(customFormatStr, "mp3") == 0) {
-            std::thread fileDecoderThread = std::thread(Mp3DecoderWorker, sample, sampleFile);
-            fileDecoderThread.detach();
+        } else if (strcmp(customFormatStr, "ogg") == 0 || strcmp(customFormatStr, "mp3") == 0) {
+            // Decoded on demand as the synthesis reads, see SampleStream_Fetch
+            auto format = strcmp(customFormatStr, "ogg") == 0 ? SampleStream::Format::Ogg : SampleStream::Format::Mp3;
+            // Files read in place out of a fast pack have no buffer of their own for the stream to hold on to
+            auto data = sampleFile->Buffer != nullptr
+                            ? sampleFile->Buffer
+                            : std::make_shared<std::vector<char>>(sampleFile->GetData(),
+                                                                  sampleFile->GetData() + sampleFile->GetSize());
+            sample->mStream = SampleStream::Open(format, data, &sample->mSample);
+            if (sample->mStream == nullptr) {
+                SPDLOG_ERROR("Failed to open {} sample {}", customFormatStr, path);
+                return nullptr;
+            }
+
+            const uint32_t channels = sample->mStream->GetChannels();
+            sample->mSample.tuning = (float)(sample->mStream->GetSampleRate() * channels) / 32000.0f;
+            sample->mSample.size = sample->mStream->GetFrameCount() * channels * 2;
+            sample->mSample.sampleAddr = nullptr;
             return sample;
         }
     }
@@ -224,7 +134,7 @@ std::shared_ptr<Ship::IResource> ResourceFactoryXMLSampleV0::ReadResource(std::s
     sample->mSample.sampleAddr = new uint8_t[size];
     // Can't use memcpy due to endianness issues.
     for (uint32_t i = 0; i < size; i++) {
-        sample->mSample.sampleAddr[i] = (*sampleFile->Buffer)[i];
+        sample->mSample.sampleAddr[i] = sampleFile->GetData()[i];
     }
 
     sample->mSample.isRelocated = 1;
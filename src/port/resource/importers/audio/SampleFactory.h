@@ -5,12 +5,6 @@
 #include "ResourceFactoryBinary.h"
 
 namespace SF64 {
-struct OggFileData {
-    void* data;
-    size_t pos;
-    size_t size;
-};
-
 class ResourceFactoryBinarySampleV1 : public Ship::ResourceFactoryBinary {
   public:
     std::shared_ptr<Ship::IResource> ReadResource(std::shared_ptr<Ship::File> file,
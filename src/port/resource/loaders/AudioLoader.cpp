@@ -3,17 +3,40 @@
 #include "assets/ast_audio.h"
 #include "BitConverter.h"
 #include "port/Engine.h"
+#include "port/audio/AdpcmCache.h"
 #include <vector>
 #include <fstream>
 #include <filesystem>
 
 #ifdef OTR_AUDIO
+// Starts decoding the font's samples ahead of the first note when the ADPCM cache is enabled
+static void Audio_QueueFontSamples(const SoundFont* font) {
+    if (font == nullptr) {
+        return;
+    }
+    for (size_t i = 0; font->drums != nullptr && i < font->numDrums; i++) {
+        if (font->drums[i] != nullptr) {
+            AdpcmCache_Queue(font->drums[i]->tunedSample.sample);
+        }
+    }
+    for (size_t i = 0; font->instruments != nullptr && i < font->numInstruments; i++) {
+        const Instrument* inst = font->instruments[i];
+        if (inst != nullptr) {
+            AdpcmCache_Queue(inst->lowPitchTunedSample.sample);
+            AdpcmCache_Queue(inst->normalPitchTunedSample.sample);
+            AdpcmCache_Queue(inst->highPitchTunedSample.sample);
+        }
+    }
+}
+
 extern "C" SoundFont* Audio_LoadFont(AudioTableEntry entry, uint32_t fontId) {
     auto crc = (uint64_t) gSoundFontTable->entries[fontId].romAddr;
     auto path = ResourceGetNameByCrc(crc);
     // printf("Font: %s\n", path);
-  
-    return (SoundFont*) ResourceGetDataByCrc(crc);
+
+    SoundFont* font = (SoundFont*) ResourceGetDataByCrc(crc);
+    Audio_QueueFontSamples(font);
+    return font;
 }
 #else
 namespace fs = std::filesystem;
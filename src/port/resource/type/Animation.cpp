@@ -8,4 +8,8 @@ AnimationData* Animation::GetPointer() {
 size_t Animation::GetPointerSize() {
     return sizeof(mData);
 }
+
+size_t Animation::GetResidentSize() {
+    return sizeof(Animation) + frameData.capacity() * sizeof(uint16_t) + jointKey.capacity() * sizeof(JointKey);
+}
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ class Animation : public Ship::Resource<AnimationData> {
 
     AnimationData* GetPointer();
     size_t GetPointerSize();
+    size_t GetResidentSize();
 
     AnimationData mData;
 
@@ -1,6 +1,11 @@
 #include "ColPoly.h"
+#include "port/collision/ColPolyBvh.h"
 
 namespace SF64 {
+ColPoly::~ColPoly() {
+    ColPolyBvh::Release(mColPolys.data());
+}
+
 ColPolyData* ColPoly::GetPointer() {
     return mColPolys.data();
 }
@@ -8,4 +13,8 @@ ColPolyData* ColPoly::GetPointer() {
 size_t ColPoly::GetPointerSize() {
     return sizeof(mColPolys);
 }
+
+size_t ColPoly::GetResidentSize() {
+    return sizeof(ColPoly) + mColPolys.capacity() * sizeof(ColPolyData);
+}
 }
\ No newline at end of file
@@ -24,9 +24,11 @@ class ColPoly : public Ship::Resource<ColPolyData> {
     using Resource::Resource;
 
     ColPoly() : Resource(std::shared_ptr<Ship::ResourceInitData>()) {}
+    ~ColPoly();
 
     ColPolyData* GetPointer();
     size_t GetPointerSize();
+    size_t GetResidentSize();
 
     std::vector<ColPolyData> mColPolys;
 };
@@ -8,4 +8,8 @@ Vec3fData* Vec3fArray::GetPointer() {
 size_t Vec3fArray::GetPointerSize() {
     return sizeof(mData);
 }
+
+size_t Vec3fArray::GetResidentSize() {
+    return sizeof(Vec3fArray) + mData.capacity() * sizeof(Vec3fData);
+}
 }
\ No newline at end of file
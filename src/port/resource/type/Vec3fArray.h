@@ -19,6 +19,7 @@ class Vec3fArray : public Ship::Resource<Vec3fData> {
 
     Vec3fData* GetPointer();
     size_t GetPointerSize();
+    size_t GetResidentSize();
 
     std::vector<Vec3fData> mData;
 };
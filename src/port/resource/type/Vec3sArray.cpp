@@ -8,4 +8,8 @@ Vec3sData* Vec3sArray::GetPointer() {
 size_t Vec3sArray::GetPointerSize() {
     return sizeof(mData);
 }
+
+size_t Vec3sArray::GetResidentSize() {
+    return sizeof(Vec3sArray) + mData.capacity() * sizeof(Vec3sData);
+}
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ class Vec3sArray : public Ship::Resource<Vec3sData> {
 
     Vec3sData* GetPointer();
     size_t GetPointerSize();
+    size_t GetResidentSize();
 
     std::vector<Vec3sData> mData;
 };
@@ -1,6 +1,12 @@
 #include "Sample.h"
+#include "port/audio/AdpcmCache.h"
 
 namespace SF64 {
+Sample::~Sample() {
+    SampleStream::ReleaseDecoded(&mSample);
+    AdpcmCache_Release(&mSample);
+}
+
 SampleData* Sample::GetPointer() {
     return &mSample;
 }
@@ -8,4 +14,8 @@ SampleData* Sample::GetPointer() {
 size_t Sample::GetPointerSize() {
     return sizeof(mSample);
 }
+
+size_t Sample::GetResidentSize() {
+    return sizeof(Sample) + (mStream == nullptr ? mSample.size : 0);
+}
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Envelope.h"
 #include "AdpcmLoop.h"
 #include "AdpcmBook.h"
+#include "port/audio/SampleStream.h"
 
 namespace SF64 {
 struct SampleData {
@@ -24,10 +25,14 @@ class Sample : public Ship::Resource<SampleData> {
     using Resource::Resource;
 
     Sample() : Resource(std::shared_ptr<Ship::ResourceInitData>()) {}
+    ~Sample();
 
     SampleData* GetPointer();
     size_t GetPointerSize();
+    size_t GetResidentSize();
 
     SampleData mSample;
+    // Set for compressed custom samples, which have no sampleAddr
+    std::unique_ptr<SampleStream> mStream;
 };
 }
\ No newline at end of file
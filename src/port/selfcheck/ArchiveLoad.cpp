@@ -0,0 +1,559 @@
+#include "ArchiveLoad.h"
+
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "resource/File.h"
+#include "resource/ResourceManager.h"
+#include "resource/archive/Archive.h"
+#include "resource/archive/ArchiveIndexCache.h"
+#include "resource/archive/ArchiveManager.h"
+#include "resource/archive/FastPackArchive.h"
+#include "resource/factory/TextureFactory.h"
+#include "resource/type/Texture.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace SF64::SelfCheck {
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint32_t SYNTHETIC_FILES = 4096;
+static constexpr uint32_t SYNTHETIC_MIN_SIZE = 0x400;
+static constexpr uint32_t SYNTHETIC_MAX_SIZE = 0x8000;
+// Many small archives, each overriding half the files of the one before it, like a stack of mods
+static constexpr uint32_t MOUNT_ARCHIVES = 128;
+static constexpr uint32_t MOUNT_FILES = 512;
+static constexpr uint32_t MOUNT_MAX_SIZE = 0x800;
+static constexpr uint32_t EVICT_TEXTURES = 64;
+// Type, width, height and data size of a version 0 texture
+static constexpr uint32_t TEXTURE_HEADER_SIZE = 16;
+
+static uint32_t Crc32(const std::vector<uint8_t>& data) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint8_t byte : data) {
+        crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static void Put16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+
+static void Put32(std::vector<uint8_t>& out, uint32_t value) {
+    Put16(out, value & 0xFFFF);
+    Put16(out, value >> 16);
+}
+
+// Stored entries only, the zip writer would otherwise have to come from libultraship's libzip. The files are named
+// bench/file_<firstFile> on. With textures, each file is the body of a version 0 RGBA16 texture resource.
+static bool WriteSyntheticArchive(const std::string& path, uint32_t fileCount, uint32_t firstFile, uint32_t maxSize,
+                                  uint32_t seed, bool textures = false) {
+    std::vector<uint8_t> archive;
+    std::vector<uint8_t> directory;
+
+    for (uint32_t i = 0; i < fileCount; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "bench/file_%04u", firstFile + i);
+        const uint16_t nameLength = strlen(name);
+
+        // Runs of repeated bytes, roughly what the game's textures and display lists look like
+        seed = seed * 1103515245 + 12345;
+        std::vector<uint8_t> data(SYNTHETIC_MIN_SIZE + (seed >> 8) % (maxSize - SYNTHETIC_MIN_SIZE));
+        for (size_t pos = 0; pos < data.size();) {
+            seed = seed * 1103515245 + 12345;
+            const size_t run = std::min<size_t>(1 + (seed >> 24) % 16, data.size() - pos);
+            std::fill_n(data.begin() + pos, run, (uint8_t) (seed >> 16));
+            pos += run;
+        }
+        if (textures) {
+            std::vector<uint8_t> header;
+            Put32(header, 2); // RGBA16
+            Put32(header, data.size() / 2);
+            Put32(header, 1);
+            Put32(header, data.size());
+            data.insert(data.begin(), header.begin(), header.end());
+        }
+        const uint32_t crc = Crc32(data);
+        const uint32_t offset = archive.size();
+
+        Put32(archive, 0x04034B50);
+        Put16(archive, 20);     // Version needed
+        Put16(archive, 0);      // Flags
+        Put16(archive, 0);      // Stored
+        Put16(archive, 0);      // Time
+        Put16(archive, 0x21);   // Date, 1980-01-01
+        Put32(archive, crc);
+        Put32(archive, data.size());
+        Put32(archive, data.size());
+        Put16(archive, nameLength);
+        Put16(archive, 0);      // Extra field
+        archive.insert(archive.end(), name, name + nameLength);
+        archive.insert(archive.end(), data.begin(), data.end());
+
+        Put32(directory, 0x02014B50);
+        Put16(directory, 20);   // Version made by
+        Put16(directory, 20);   // Version needed
+        Put16(directory, 0);    // Flags
+        Put16(directory, 0);    // Stored
+        Put16(directory, 0);    // Time
+        Put16(directory, 0x21); // Date
+        Put32(directory, crc);
+        Put32(directory, data.size());
+        Put32(directory, data.size());
+        Put16(directory, nameLength);
+        Put16(directory, 0);    // Extra field
+        Put16(directory, 0);    // Comment
+        Put16(directory, 0);    // Disk
+        Put16(directory, 0);    // Internal attributes
+        Put32(directory, 0);    // External attributes
+        Put32(directory, offset);
+        directory.insert(directory.end(), name, name + nameLength);
+    }
+
+    const uint32_t directoryOffset = archive.size();
+    archive.insert(archive.end(), directory.begin(), directory.end());
+    Put32(archive, 0x06054B50);
+    Put16(archive, 0); // Disk
+    Put16(archive, 0); // Disk with the directory
+    Put16(archive, fileCount);
+    Put16(archive, fileCount);
+    Put32(archive, directory.size());
+    Put32(archive, directoryOffset);
+    Put16(archive, 0); // Comment
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        fprintf(stderr, "Could not write %s\n", path.c_str());
+        return false;
+    }
+    fwrite(archive.data(), 1, archive.size(), file);
+    fclose(file);
+    return true;
+}
+
+static uint64_t HashFile(const char* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (uint8_t) data[i]) * 0x100000001B3;
+    }
+    return hash;
+}
+
+// Drops the file from the OS file cache so the next pass reads it from the disk, only Linux can be asked to
+static bool EvictFromFileCache(const std::string& path) {
+#ifdef __linux__
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    // Dirty pages, like those of a pack that was just written, are only dropped once they are on the disk
+    fdatasync(fd);
+    const bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+#else
+    return false;
+#endif
+}
+
+struct LoadResult {
+    double seconds;
+    uint64_t bytes;
+    uint32_t files;
+    // Sum of the per file hashes, the same whichever thread loaded what
+    uint64_t hash;
+};
+
+static LoadResult LoadAll(const std::shared_ptr<Ship::Archive>& archive, const std::vector<std::string>& paths,
+                          uint32_t numThreads) {
+    std::atomic<size_t> next = 0;
+    std::atomic<uint64_t> bytes = 0;
+    std::atomic<uint32_t> files = 0;
+    std::atomic<uint64_t> hash = 0;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            auto file = archive->LoadFile(paths[i]);
+            if (file == nullptr || !file->IsLoaded) {
+                continue;
+            }
+            bytes += file->GetSize();
+            files++;
+            hash += HashFile(file->GetData(), file->GetSize());
+        }
+    };
+
+    const auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    return { seconds, bytes, files, hash };
+}
+
+// Prints a cold pass and then warm passes from more and more threads, reference gets the cold pass
+static int RunLoads(const char* name, const std::shared_ptr<Ship::Archive>& archive, LoadResult& reference) {
+    std::vector<std::string> paths;
+    for (const auto& [hash, path] : *archive->ListFiles()) {
+        paths.push_back(path);
+    }
+    std::sort(paths.begin(), paths.end());
+
+    const bool evicted = EvictFromFileCache(archive->GetPath());
+    reference = LoadAll(archive, paths, 1);
+    printf("%s: %u of %zu files, %.1f MB from %s\n", name, reference.files, paths.size(),
+           reference.bytes / 1048576.0, archive->GetPath().c_str());
+    printf("%8s %10.2f %10.1f %s\n", "cold", reference.seconds * 1000.0,
+           reference.bytes / 1048576.0 / reference.seconds, evicted ? "" : "(may have been cached)");
+    printf("%8s %10s %10s %8s\n", "threads", "ms", "MB/s", "speedup");
+
+    const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    double baseSeconds = 0.0;
+    int result = 0;
+    for (uint32_t numThreads = 1;; numThreads = std::min(numThreads * 2, maxThreads)) {
+        const LoadResult run = LoadAll(archive, paths, numThreads);
+        if (numThreads == 1) {
+            baseSeconds = run.seconds;
+        }
+        printf("%8u %10.2f %10.1f %7.2fx\n", numThreads, run.seconds * 1000.0, run.bytes / 1048576.0 / run.seconds,
+               baseSeconds / run.seconds);
+
+        if (run.files != reference.files || run.hash != reference.hash) {
+            printf("%s: %u threads read back different data\n", name, numThreads);
+            result = 1;
+        }
+        if (numThreads == maxThreads) {
+            break;
+        }
+    }
+    return result;
+}
+
+int RunArchiveLoad(const std::string& archivePath) {
+    if (!std::filesystem::exists(archivePath)) {
+        if (!WriteSyntheticArchive(archivePath, SYNTHETIC_FILES, 0, SYNTHETIC_MAX_SIZE, 0x5F64)) {
+            return 1;
+        }
+        printf("Wrote a synthetic archive of %u files (%.1f MB) to %s\n", SYNTHETIC_FILES,
+               std::filesystem::file_size(archivePath) / 1048576.0, archivePath.c_str());
+    }
+
+    Ship::ArchiveManager archiveManager;
+    auto archive = archiveManager.AddArchive(archivePath);
+    if (archive == nullptr) {
+        fprintf(stderr, "Could not open archive %s\n", archivePath.c_str());
+        return 1;
+    }
+
+    LoadResult archiveResult;
+    int result = RunLoads("Archive load", archive, archiveResult);
+    if (std::dynamic_pointer_cast<Ship::FastPackArchive>(archive) != nullptr) {
+        fflush(stdout);
+        return result;
+    }
+
+    // The same files once more, out of a fast pack written from the archive
+    const std::string packPath = (std::filesystem::temp_directory_path() / "archive-load.fpk").string();
+    if (!Ship::FastPackArchive::Write(packPath, archiveManager, 0)) {
+        fprintf(stderr, "Could not write fast pack %s\n", packPath.c_str());
+        return 1;
+    }
+    {
+        Ship::ArchiveManager packManager;
+        auto pack = packManager.AddArchive(packPath);
+        LoadResult packResult;
+        if (pack == nullptr || RunLoads("Fast pack load", pack, packResult) != 0) {
+            result = 1;
+        } else if (packResult.files != archiveResult.files || packResult.hash != archiveResult.hash) {
+            printf("Fast pack load: the pack reads back different data than the archive\n");
+            result = 1;
+        }
+    }
+    std::filesystem::remove(packPath);
+
+    fflush(stdout);
+    return result;
+}
+
+struct MountResult {
+    double seconds;
+    size_t archives;
+    // Every file with the archive it is read from, sorted
+    std::vector<std::pair<std::string, std::string>> owners;
+    // Sum of the per file hashes of what the archive manager reads back
+    uint64_t hash;
+};
+
+// Mounts every archive in the directory into a new archive manager, serially if there is no thread pool
+static MountResult Mount(const std::string& directory, BS::thread_pool* threadPool,
+                         std::shared_ptr<Ship::ArchiveIndexCache> indexCache, bool readBack) {
+    Ship::ArchiveManager archiveManager;
+    if (indexCache != nullptr) {
+        archiveManager.SetIndexCache(indexCache);
+    }
+
+    const auto start = Clock::now();
+    archiveManager.Init({ directory }, {}, threadPool);
+    MountResult result = {};
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.archives = archiveManager.GetArchives()->size();
+
+    for (const auto& path : *archiveManager.ListFiles()) {
+        auto archive = archiveManager.GetArchiveFromFile(path);
+        result.owners.emplace_back(path, archive != nullptr ? archive->GetPath() : "");
+        if (readBack) {
+            auto file = archiveManager.LoadFile(path);
+            if (file != nullptr && file->IsLoaded) {
+                result.hash += HashFile(file->GetData(), file->GetSize());
+            }
+        }
+    }
+    std::sort(result.owners.begin(), result.owners.end());
+    return result;
+}
+
+int RunArchiveMount(const std::string& directory) {
+    if (!std::filesystem::exists(directory)) {
+        std::filesystem::create_directories(directory);
+        for (uint32_t i = 0; i < MOUNT_ARCHIVES; i++) {
+            char name[32];
+            snprintf(name, sizeof(name), "mount_%03u.o2r", i);
+            const std::string path = (std::filesystem::path(directory) / name).string();
+            if (!WriteSyntheticArchive(path, MOUNT_FILES, i * MOUNT_FILES / 2, MOUNT_MAX_SIZE, 0x5F64 + i)) {
+                return 1;
+            }
+        }
+        printf("Wrote %u synthetic archives of %u files to %s\n", MOUNT_ARCHIVES, MOUNT_FILES, directory.c_str());
+    }
+
+    const std::string cachePath = (std::filesystem::temp_directory_path() / "archive-mount.cache").string();
+    std::filesystem::remove(cachePath);
+    BS::thread_pool threadPool(std::max(std::thread::hardware_concurrency(), 1u));
+
+    const MountResult reference = Mount(directory, nullptr, nullptr, true);
+    printf("Archive mount: %zu archives, %zu files from %s\n", reference.archives, reference.owners.size(),
+           directory.c_str());
+    printf("%-24s %10s %8s\n", "run", "ms", "speedup");
+    printf("%-24s %10.2f %7.2fx\n", "serial", reference.seconds * 1000.0, 1.0);
+
+    int result = 0;
+    auto runMount = [&](const char* name, std::shared_ptr<Ship::ArchiveIndexCache> indexCache, bool readBack) {
+        const MountResult run = Mount(directory, &threadPool, indexCache, readBack);
+        printf("%-24s %10.2f %7.2fx\n", name, run.seconds * 1000.0, reference.seconds / run.seconds);
+        if (run.archives != reference.archives || run.owners != reference.owners) {
+            printf("%s: mounted the archives in a different order than the serial run\n", name);
+            result = 1;
+        }
+        if (readBack && run.hash != reference.hash) {
+            printf("%s: read back different data than the serial run\n", name);
+            result = 1;
+        }
+    };
+
+    runMount("parallel", nullptr, false);
+    // Enumerates like the runs before and writes the cache out
+    runMount("parallel, cold cache", std::make_shared<Ship::ArchiveIndexCache>(cachePath), false);
+    // A new cache object reads back the file, as on the next start
+    runMount("parallel, warm cache", std::make_shared<Ship::ArchiveIndexCache>(cachePath), true);
+    std::filesystem::remove(cachePath);
+
+    fflush(stdout);
+    return result;
+}
+
+// The synthetic files have no resource header, the textures are loaded with init data instead
+static std::shared_ptr<Ship::ResourceInitData> TextureInitData(const std::string& path) {
+    auto initData = std::make_shared<Ship::ResourceInitData>();
+    initData->Path = path;
+    initData->ByteOrder = Ship::Endianness::Little;
+    initData->Type = static_cast<uint32_t>(Fast::ResourceType::Texture);
+    initData->ResourceVersion = 0;
+    initData->Id = 0;
+    initData->IsCustom = false;
+    initData->Format = RESOURCE_FORMAT_BINARY;
+    return initData;
+}
+
+// Evicts from a cache of the archive's textures over its budget and reloads them, returns false if the cache evicted
+// other textures than expected or a reload read back different data than the archive holds
+static bool CheckEviction(const char* name, const std::string& archivePath) {
+    Ship::ResourceManager resourceManager;
+    resourceManager.Init({ archivePath }, {});
+    if (!resourceManager.IsLoaded()) {
+        printf("%s: could not open %s\n", name, archivePath.c_str());
+        return false;
+    }
+    resourceManager.GetResourceLoader()->RegisterResourceFactory(
+        std::make_shared<Fast::ResourceFactoryBinaryTextureV0>(), RESOURCE_FORMAT_BINARY, "Texture",
+        static_cast<uint32_t>(Fast::ResourceType::Texture), 0);
+    resourceManager.SetEvictableResourceTypes({ static_cast<uint32_t>(Fast::ResourceType::Texture) });
+
+    auto paths = *resourceManager.GetArchiveManager()->ListFiles();
+    std::sort(paths.begin(), paths.end());
+    if (paths.size() < 8) {
+        printf("%s: %s holds %zu files, the check needs at least 8\n", name, archivePath.c_str(), paths.size());
+        return false;
+    }
+
+    // LoadResourceProcess instead of LoadResource, a pool thread could otherwise still hold a reference to the
+    // resource it loaded and keep it from being evicted
+    std::unordered_map<std::string, size_t> sizes;
+    std::unordered_map<std::string, std::vector<uint8_t>> expected;
+    for (const auto& path : paths) {
+        auto file = resourceManager.GetArchiveManager()->LoadFile(path);
+        auto resource = resourceManager.LoadResourceProcess(path, true, TextureInitData(path));
+        auto texture = std::static_pointer_cast<Fast::Texture>(resource);
+        if (file == nullptr || texture == nullptr || file->GetSize() != TEXTURE_HEADER_SIZE + texture->ImageDataSize) {
+            printf("%s: could not load %s as a texture\n", name, path.c_str());
+            return false;
+        }
+        sizes[path] = texture->GetResidentSize();
+        expected[path].assign(file->GetData() + TEXTURE_HEADER_SIZE, file->GetData() + file->GetSize());
+
+        // The game writes to some textures, a reload has to read the archive again instead of getting those writes
+        for (uint32_t i = 0; i < texture->ImageDataSize; i++) {
+            texture->ImageData[i] = ~texture->ImageData[i];
+        }
+    }
+
+    // Looked up in this order, the 2nd texture stays referenced, the 1st is the most recently used one that is not
+    // pinned, and the 3rd and 4th are pinned by the epoch. The rest are evicted in the order they were loaded.
+    std::shared_ptr<Ship::IResource> held = resourceManager.GetCachedResource(paths[1]);
+    resourceManager.GetCachedResource(paths[0]);
+    resourceManager.BeginCacheEpoch();
+    resourceManager.GetCachedResource(paths[2]);
+    resourceManager.GetCachedResource(paths[3]);
+
+    std::vector<std::string> order(paths.begin() + 4, paths.end());
+    order.push_back(paths[0]);
+
+    // Evicts with the budget set and checks that it took the next paths of the order, and only as many as it had to
+    size_t evictedCount = 0;
+    auto evict = [&](const char* run, size_t budget, const std::vector<std::string>& expectedOrder) {
+        const size_t residentBefore = resourceManager.GetCacheStats().ResidentBytes;
+        resourceManager.SetCacheBudget(budget);
+        const auto evicted = resourceManager.EvictResources();
+        const size_t target = budget - budget / 8;
+
+        std::vector<std::string> expected;
+        size_t resident = residentBefore;
+        for (size_t i = evictedCount; i < expectedOrder.size() && resident > target; i++) {
+            expected.push_back(expectedOrder[i]);
+            resident -= sizes[expectedOrder[i]];
+        }
+        std::vector<std::string> actual;
+        for (const auto& resource : evicted) {
+            actual.push_back(resource->GetInitData()->Path);
+        }
+
+        const size_t residentAfter = resourceManager.GetCacheStats().ResidentBytes;
+        printf("%s, %s: evicted %zu textures, %zu of %zu KB left\n", name, run, actual.size(), residentAfter / 1024,
+               residentBefore / 1024);
+        if (actual != expected || residentAfter != resident) {
+            printf("%s, %s: evicted other textures than the least recently used ones that are neither pinned nor "
+                   "referenced\n",
+                   name, run);
+            return false;
+        }
+        evictedCount += actual.size();
+        return true;
+    };
+
+    const size_t resident = resourceManager.GetCacheStats().ResidentBytes;
+    if (!evict("half the budget", resident / 2, order) || !evict("no room", 1, order)) {
+        return false;
+    }
+    if (evictedCount != order.size()) {
+        printf("%s: kept textures that are neither pinned nor referenced\n", name);
+        return false;
+    }
+
+    // Once unreferenced and out of the epoch, the rest go as well
+    held.reset();
+    resourceManager.BeginCacheEpoch();
+    evictedCount = 0;
+    if (!evict("unpinned", 1, { paths[1], paths[2], paths[3] }) ||
+        resourceManager.GetCacheStats().ResidentBytes != 0) {
+        return false;
+    }
+
+    const uint64_t missesBefore = resourceManager.GetCacheStats().Misses;
+    for (const auto& path : paths) {
+        auto resource = resourceManager.LoadResourceProcess(path, true, TextureInitData(path));
+        auto texture = std::static_pointer_cast<Fast::Texture>(resource);
+        if (texture == nullptr || texture->ImageDataSize != expected[path].size() ||
+            memcmp(expected[path].data(), texture->ImageData, texture->ImageDataSize) != 0) {
+            printf("%s: reloading %s read back different data than the archive held\n", name, path.c_str());
+            return false;
+        }
+    }
+    if (resourceManager.GetCacheStats().Misses - missesBefore != paths.size()) {
+        printf("%s: reloading found evicted textures still cached\n", name);
+        return false;
+    }
+    printf("%s: reloaded %zu textures\n", name, paths.size());
+    return true;
+}
+
+int RunCacheEviction(const std::string& archivePath) {
+    if (!std::filesystem::exists(archivePath)) {
+        if (!WriteSyntheticArchive(archivePath, EVICT_TEXTURES, 0, SYNTHETIC_MAX_SIZE, 0x5F64, true)) {
+            return 1;
+        }
+        printf("Wrote a synthetic archive of %u textures to %s\n", EVICT_TEXTURES, archivePath.c_str());
+    }
+
+    int result = CheckEviction("Cache eviction", archivePath) ? 0 : 1;
+
+    // Textures of a fast pack are read in place out of its mapping
+    const std::string packPath = (std::filesystem::temp_directory_path() / "cache-eviction.fpk").string();
+    {
+        Ship::ArchiveManager archiveManager;
+        if (archiveManager.AddArchive(archivePath) == nullptr ||
+            !Ship::FastPackArchive::Write(packPath, archiveManager, 0)) {
+            fprintf(stderr, "Could not write fast pack %s\n", packPath.c_str());
+            return 1;
+        }
+    }
+    if (!CheckEviction("Fast pack cache eviction", packPath)) {
+        result = 1;
+    }
+    std::filesystem::remove(packPath);
+
+    fflush(stdout);
+    return result;
+}
+
+} // namespace SF64::SelfCheck
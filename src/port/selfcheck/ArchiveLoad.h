@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+namespace SF64::SelfCheck {
+
+// Loads every file of an archive once from a cold file cache, then from 1, 2, 4... threads up to the core count and
+// prints the throughput of each run. An O2R archive is then written to a fast pack that goes through the same runs.
+// Writes a synthetic O2R to the path first if there is no file there. Returns the exit code, non zero if a run read
+// back different data than the cold one or the pack different data than the O2R.
+int RunArchiveLoad(const std::string& archivePath);
+
+// Times mounting every archive in a directory serially, on a thread pool, and on a thread pool with a cold and a warm
+// archive index cache. Writes many small synthetic O2Rs that override each other's files to the directory first if
+// it does not exist. Returns the exit code, non zero if a run mounted the files from other archives than the serial
+// one or the warm cache run read back different data.
+int RunArchiveMount(const std::string& directory);
+
+// Fills a resource cache with the textures of an archive, then evicts them over a budget and checks that the least
+// recently used ones go first, skipping those pinned by the cache epoch and those still referenced. Every texture is
+// written to once loaded, as the game does with some, and has to reload with the data the archive held. Then does the
+// same out of a fast pack written from the archive. Writes a synthetic archive of textures to the path first if there
+// is no file there. Returns the exit code, non zero if a check failed.
+int RunCacheEviction(const std::string& archivePath);
+
+} // namespace SF64::SelfCheck
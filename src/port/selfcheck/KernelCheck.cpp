@@ -0,0 +1,52 @@
+#include "KernelCheck.h"
+
+#include <cstdio>
+
+extern "C" {
+#include "port/audio/MixerProfile.h"
+#include "audio/mixer.h"
+}
+
+namespace SF64::SelfCheck {
+
+int RunKernelCheck(uint32_t rounds) {
+    // Fixed, so a failure can be reproduced
+    static constexpr uint32_t CHECK_SEED = 0x5F64;
+
+    static const char* const ISA_NAMES[MIXER_ISA_MAX] = { "sse2", "avx2" };
+
+    uint32_t failedKernels = 0;
+    uint32_t checkedKernels = 0;
+    printf("%-14s %5s %8s %8s %12s %12s %8s\n", "kernel", "isa", "rounds", "failed", "simd ms", "scalar ms",
+           "speedup");
+    for (int i = 0; i < MIXER_KERNEL_MAX; i++) {
+        const MixerKernel kernel = (MixerKernel) i;
+        // The versions a build or CPU does not have are skipped
+        for (int isa = 0; isa < MIXER_ISA_MAX; isa++) {
+            uint64_t simdNs = 0;
+            uint64_t scalarNs = 0;
+            const int32_t failed = aMixerCheckKernel(kernel, (MixerIsa) isa, rounds, CHECK_SEED, &simdNs, &scalarNs);
+            if (failed < 0) {
+                continue;
+            }
+            checkedKernels++;
+            failedKernels += failed != 0;
+            printf("%-14s %5s %8u %8d %12.2f %12.2f %7.1fx\n", MixerProfile_GetName(kernel), ISA_NAMES[isa], rounds,
+                   failed, simdNs / 1000000.0, scalarNs / 1000000.0, simdNs != 0 ? (double) scalarNs / simdNs : 0.0);
+        }
+    }
+    fflush(stdout);
+
+    if (checkedKernels == 0) {
+        fprintf(stderr, "This build has no SIMD mixer kernels to check\n");
+        return 0;
+    }
+    if (failedKernels != 0) {
+        fprintf(stderr, "%u of %u kernel versions differ from their scalar reference\n", failedKernels,
+                checkedKernels);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace SF64::SelfCheck
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace SF64::SelfCheck {
+
+// Checks every SIMD mixer kernel, in each instruction set the build and CPU have, bit for bit against its scalar
+// reference on rounds random DMEM states each, see aMixerCheckKernel, and prints the time both took. Returns the exit
+// code, non zero if any kernel differed.
+int RunKernelCheck(uint32_t rounds);
+
+} // namespace SF64::SelfCheck
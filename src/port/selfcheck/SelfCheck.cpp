@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "ArchiveLoad.h"
+#include "KernelCheck.h"
+
+// Checks of the engine's building blocks that do not need the game, built into their own executable so none of them
+// ship in the game binary:
+//   --kernel-check <n>      check the SIMD mixer kernels against the scalar ones on n random inputs each, see
+//                           RunKernelCheck
+//   --archive-load <file>   time loading every file of an archive, cold and warm, see RunArchiveLoad
+//   --archive-mount <dir>   time mounting every archive in a directory, see RunArchiveMount
+//   --cache-evict <file>    check evicting the textures of an archive from a resource cache, see RunCacheEviction
+// One check per run. Returns the exit code of the check, or 2 if the command line is invalid.
+
+namespace SF64::SelfCheck {
+
+enum class Mode { None, KernelCheck, ArchiveLoad, ArchiveMount, CacheEviction };
+
+struct Options {
+    Mode mode = Mode::None;
+    uint32_t kernelCheckRounds = 0;
+    std::string path;
+};
+
+static bool ParseArgs(int argc, char** argv, Options& options) {
+    std::string modeArg;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        Mode mode;
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Unknown or incomplete argument %s\n", arg.c_str());
+            return false;
+        } else if (arg == "--kernel-check") {
+            mode = Mode::KernelCheck;
+            const char* value = argv[++i];
+            char* end;
+            options.kernelCheckRounds = strtoul(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || options.kernelCheckRounds == 0) {
+                fprintf(stderr, "--kernel-check %s is not a number of rounds\n", value);
+                return false;
+            }
+        } else if (arg == "--archive-load") {
+            mode = Mode::ArchiveLoad;
+            options.path = argv[++i];
+        } else if (arg == "--archive-mount") {
+            mode = Mode::ArchiveMount;
+            options.path = argv[++i];
+        } else if (arg == "--cache-evict") {
+            mode = Mode::CacheEviction;
+            options.path = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown argument %s\n", arg.c_str());
+            return false;
+        }
+
+        if (options.mode != Mode::None && options.mode != mode) {
+            fprintf(stderr, "%s can not be used with %s\n", arg.c_str(), modeArg.c_str());
+            return false;
+        }
+        options.mode = mode;
+        modeArg = arg;
+    }
+
+    if (options.mode == Mode::None) {
+        fprintf(stderr, "Usage: %s --kernel-check <rounds> | --archive-load <file> | --archive-mount <dir> | "
+                        "--cache-evict <file>\n",
+                argc > 0 ? argv[0] : "selfcheck");
+        return false;
+    }
+    return true;
+}
+
+} // namespace SF64::SelfCheck
+
+int main(int argc, char** argv) {
+    using namespace SF64::SelfCheck;
+
+    Options options;
+    if (!ParseArgs(argc, argv, options)) {
+        return 2;
+    }
+
+    switch (options.mode) {
+        case Mode::KernelCheck:
+            return RunKernelCheck(options.kernelCheckRounds);
+        case Mode::ArchiveLoad:
+            return RunArchiveLoad(options.path);
+        case Mode::ArchiveMount:
+            return RunArchiveMount(options.path);
+        case Mode::CacheEviction:
+            return RunCacheEviction(options.path);
+        default:
+            return 2;
+    }
+}
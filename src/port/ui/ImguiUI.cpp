@@ -12,6 +12,7 @@
 #include <Fast3D/interpreter.h>
 #include "port/Engine.h"
 #include "port/notification/notification.h"
+#include "port/audio/AudioRateControl.h"
 #include "utils/StringHelper.h"
 
 #ifdef __SWITCH__
@@ -284,7 +285,33 @@ void DrawSettingsMenu(){
             }
             
             UIWidgets::PaddedEnhancementCheckbox("Surround 5.1 (Needs reload)", "gAudioChannelsSetting", 1, 0);
-            
+
+            UIWidgets::PaddedEnhancementCheckbox("Decoupled audio (Needs reload)", "gAudioDecoupled", true, false);
+            UIWidgets::Tooltip(
+                "Renders the audio ahead on its own thread instead of once per frame.\n"
+                "Keeps the sound from crackling when the frame rate drops.");
+
+            UIWidgets::CVarSliderInt("Synthesis threads (Needs reload): %d", "gAudioSynthThreads", 0, 7, 0, {
+                .tooltip = "Extra threads the notes are mixed on. Helps when many sounds play at once, mostly with "
+                           "surround 5.1.",
+            });
+
+            UIWidgets::CVarSliderInt("Audio latency", "gAudioLatency", 0, 200, 0, {
+                .tooltip = "Audio kept queued ahead of the speakers. Lower reacts faster to the game, too low "
+                           "crackles on slower machines. The game's sound is stretched by a fraction of a percent "
+                           "to stay at it. Auto uses the audio backend's default.",
+                .format = CVarGetInteger("gAudioLatency", 0) > 0 ? "%d ms" : "Auto",
+            });
+
+            UIWidgets::PaddedEnhancementCheckbox("Pre-decode ADPCM samples", "gAudioAdpcmCache", true, false);
+            UIWidgets::Tooltip("Decodes the game's samples once in the background and keeps them in memory.\n"
+                               "Uses less CPU for the audio in exchange for RAM.");
+            if (CVarGetInteger("gAudioAdpcmCache", 0)) {
+                UIWidgets::CVarSliderInt("Sample cache size: %d MB", "gAudioAdpcmCacheSize", 8, 512, 64, {
+                    .tooltip = "Samples played the longest time ago are dropped first once the cache is full.",
+                });
+            }
+
             if (CVarGetInteger("gAudioChannelsSetting", 0) == 1) {
                 // Subwoofer threshold
                 UIWidgets::CVarSliderInt("Subwoofer threshold (Hz)", "gSubwooferThreshold", 10u, 1000u, 80u, {
@@ -456,6 +483,14 @@ void DrawSettingsMenu(){
                 "or if you notice other performance problems.\n"
                 "Adds up to one frame of input lag under certain scenarios.");
         }
+
+        UIWidgets::PaddedEnhancementCheckbox("Pipelined rendering (Experimental, Needs reload)", "gRenderPipelined",
+                                             true, false);
+        UIWidgets::Tooltip(
+            "Runs the game logic on its own thread so the next frame is built while the current one is drawn.\n"
+            "Adds one frame of input lag.\n\n"
+            "Experimental: the game reads settings, like the alternative assets toggle, while this menu changes "
+            "them, which can crash. Leave it off unless you are testing it.");
       
         UIWidgets::PaddedSeparator(true, true, 3.0f, 3.0f);
 
@@ -795,6 +830,19 @@ void DrawDebugMenu() {
             .tooltip = "Disables the game's Built-in Gamma Boost. Useful for modders",
             .defaultValue = false
         });
+        UIWidgets::CVarCheckbox("Fast asset pack (Needs restart)", "gFastPack", {
+            .tooltip = "Unpacks every asset into starship.fpk on the next start and maps that instead of reading "
+                       "the O2R files. Loads faster for the disk space, the pack is rewritten when an O2R changes"
+        });
+        UIWidgets::CVarCheckbox("Prefetch scene resources (Needs restart)", "gScenePrefetch", {
+            .tooltip = "Remembers the assets each scene used and loads them all on the resource threads when the "
+                       "scene starts, instead of one by one the first time they are drawn",
+            .defaultValue = true
+        });
+        UIWidgets::CVarSliderInt("Asset cache budget: %d MB", "gResourceCacheBudget", 0, 4096, 0, {
+            .tooltip = "Once the loaded assets take more memory than this, textures earlier scenes used are dropped "
+                       "until they are needed again. 0 keeps everything. Mostly useful with HD texture packs."
+        });
 
         UIWidgets::CVarCheckbox("Spawner Mod", "gSpawnerMod", {
             .tooltip = "Spawn Scenery, Actors, Bosses, Sprites, Items, Effects and even Event Actors.\n"
@@ -876,6 +924,24 @@ void DrawDebugMenu() {
     }
 }
 
+void GameStatsWindow::DrawElement() {
+    Ship::StatsWindow::DrawElement();
+
+    // Audio runs at 32 kHz, 32 samples to the ms
+    const SF64::AudioLatencyStats stats = SF64::AudioRateControl::GetStats();
+    ImGui::Text("Audio: %.1f ms buffered (target %.1f ms)", stats.buffered / 32.0f, stats.target / 32.0f);
+    ImGui::Text("Audio drift: %+d ppm, %u underruns", stats.driftPpm, stats.underruns);
+
+    const Ship::ResourceCacheStats cache = Ship::Context::GetInstance()->GetResourceManager()->GetCacheStats();
+    if (cache.BudgetBytes != 0) {
+        ImGui::Text("Assets: %.1f of %.0f MB cached", cache.ResidentBytes / 1048576.0, cache.BudgetBytes / 1048576.0);
+    } else {
+        ImGui::Text("Assets: %.1f MB cached", cache.ResidentBytes / 1048576.0);
+    }
+    ImGui::Text("Asset cache: %llu hits, %llu misses, %llu evictions", (unsigned long long) cache.Hits,
+                (unsigned long long) cache.Misses, (unsigned long long) cache.Evictions);
+}
+
 void GameMenuBar::DrawElement() {
     if(ImGui::BeginMenuBar()){
         DrawMenuBarIcon();
@@ -13,4 +13,12 @@ class GameMenuBar : public Ship::GuiMenuBar {
     void DrawElement() override;
     void InitElement() override {};
     void UpdateElement() override {};
-};
\ No newline at end of file
+};
+
+// The stats window with the audio latency below
+class GameStatsWindow : public Ship::StatsWindow {
+  public:
+    using Ship::StatsWindow::StatsWindow;
+  protected:
+    void DrawElement() override;
+};
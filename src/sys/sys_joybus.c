@@ -1,4 +1,6 @@
 #include "sys.h"
+#include "port/Engine.h"
+#include "port/benchmark/Benchmark.h"
 
 OSContPad gControllerHold[4];
 OSContPad gControllerPress[4];
@@ -92,8 +94,11 @@ void Controller_ReadData(void) {
         }
     } else {
         osContStartReadData(&gSerialEventQueue);
-        osContGetReadData(sNextController);
+        // @port: The controllers are polled on the main thread when the game runs on its own
+        GameEngine_ContGetReadData(sNextController);
     }
+    // @port: Record the input or play it back
+    Benchmark_FilterInput(sNextController);
 }
 
 bool Save_ReadData(void) {
@@ -2,6 +2,7 @@
 #include "sf64audio_external.h"
 
 #include <functions.h>
+#include "port/benchmark/Benchmark.h"
 
 s32 sGammaMode = 1;
 
@@ -245,7 +246,9 @@ void Graphics_ThreadUpdate() {
     {
         __gSPSegment(gUnkDisp1++, 0, 0);
         gSPDisplayList(gMasterDisp++, gGfxPool->unkDL1);
+        Benchmark_StageBegin(BENCHMARK_STAGE_UPDATE);
         Game_Update();
+        Benchmark_StageEnd(BENCHMARK_STAGE_UPDATE);
         if (gStartNMI == 1) {
             Graphics_NMIWipe();
         }
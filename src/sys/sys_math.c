@@ -1,5 +1,6 @@
 #include "sys.h"
 #include "prevent_bss_reordering.h"
+#include "port/benchmark/Benchmark.h"
 
 s32 sSeededRandSeed3;
 s32 sRandSeed1;
@@ -13,6 +14,13 @@ f32 Math_ModF(f32 value, f32 mod) {
 }
 
 void Rand_Init(void) {
+    // @port: Recorded input only plays back the same way with the same random numbers
+    if (Benchmark_IsActive()) {
+        sRandSeed1 = 1;
+        sRandSeed2 = 29000;
+        sRandSeed3 = 9876;
+        return;
+    }
     sRandSeed1 = (s32) osGetTime() % 30000;
     sRandSeed2 = (s32) osGetTime() % 30000;
     sRandSeed3 = (s32) osGetTime() % 30000;